@@ -0,0 +1,69 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "Common/SyntheticCfa.h"
+
+#include "gazer/Automaton/CfaTransforms.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace gazer;
+
+namespace
+{
+
+void BM_CloneAutomaton(benchmark::State& state)
+{
+    GazerContext ctx;
+    AutomataSystem system(ctx);
+    Cfa* cfa = bench::createDiamondChainCfa(system, "main", state.range(0));
+
+    unsigned cloneCnt = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CloneAutomaton(cfa, "clone" + std::to_string(cloneCnt++)));
+    }
+
+    state.SetItemsProcessed(state.iterations() * cfa->getNumTransitions());
+}
+BENCHMARK(BM_CloneAutomaton)->RangeMultiplier(4)->Range(16, 4096);
+
+/// Measures the inlining of tail-recursive calls into their parent.
+void BM_TransformRecursiveToCyclic(benchmark::State& state)
+{
+    size_t numTransitions = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto ctx = std::make_unique<GazerContext>();
+        auto system = std::make_unique<AutomataSystem>(*ctx);
+        Cfa* loop = bench::createTailRecursiveCfa(*system, "loop", state.range(0));
+        Cfa* main = bench::createLoopCallerCfa(*system, "main", loop);
+        numTransitions = loop->getNumTransitions();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(TransformRecursiveToCyclic(main));
+
+        state.PauseTiming();
+        system.reset();
+        ctx.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numTransitions);
+}
+BENCHMARK(BM_TransformRecursiveToCyclic)->RangeMultiplier(4)->Range(16, 4096);
+
+} // end anonymous namespace
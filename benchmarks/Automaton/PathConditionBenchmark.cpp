@@ -0,0 +1,199 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "Common/SyntheticCfa.h"
+
+#include "gazer/Automaton/CfaDominators.h"
+#include "gazer/Automaton/CfaUtils.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Creates a callee with a single input and output, used as a placeholder
+/// for call transitions in the synthetic automata.
+Cfa* createCallee(AutomataSystem& system)
+{
+    GazerContext& ctx = system.getContext();
+    Cfa* callee = system.createCfa("callee");
+    Variable* input = callee->createInput("x", BvType::Get(ctx, 32));
+    callee->addOutput(input);
+    callee->createAssignTransition(callee->getEntry(), callee->getExit());
+
+    return callee;
+}
+
+void BM_PathConditionEncode(benchmark::State& state)
+{
+    GazerContext ctx;
+    AutomataSystem system(ctx);
+    Cfa* cfa = bench::createDiamondChainCfa(system, "main", state.range(0));
+
+    std::vector<Location*> topo;
+    createTopologicalSort(*cfa, topo);
+    CfaTopoOrder order(topo);
+
+    Location* error = cfa->error_begin()->first;
+    auto builder = CreateFoldingExprBuilder(ctx);
+
+    for (auto _ : state) {
+        PathConditionCalculator pathCond(
+            order, *builder,
+            [&ctx](auto t) { return BoolLiteralExpr::True(ctx); },
+            nullptr
+        );
+
+        benchmark::DoNotOptimize(pathCond.encode(cfa->getEntry(), error));
+    }
+
+    state.SetItemsProcessed(state.iterations() * cfa->getNumTransitions());
+}
+BENCHMARK(BM_PathConditionEncode)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_PathConditionEncodeWithPredecessors(benchmark::State& state)
+{
+    size_t numTransitions = 0;
+    for (auto _ : state) {
+        // The predecessor variables are registered in the context under
+        // fixed names, so each iteration needs a fresh context.
+        state.PauseTiming();
+        auto ctx = std::make_unique<GazerContext>();
+        auto system = std::make_unique<AutomataSystem>(*ctx);
+        Cfa* cfa = bench::createDiamondChainCfa(*system, "main", state.range(0));
+        numTransitions = cfa->getNumTransitions();
+
+        std::vector<Location*> topo;
+        createTopologicalSort(*cfa, topo);
+        CfaTopoOrder order(topo);
+
+        Location* error = cfa->error_begin()->first;
+        auto builder = CreateFoldingExprBuilder(*ctx);
+        state.ResumeTiming();
+
+        PathConditionCalculator pathCond(
+            order, *builder,
+            [&ctx](auto t) { return BoolLiteralExpr::True(*ctx); },
+            [](Location* loc, ExprPtr expr) { benchmark::DoNotOptimize(expr); }
+        );
+
+        benchmark::DoNotOptimize(pathCond.encode(cfa->getEntry(), error));
+
+        state.PauseTiming();
+        builder.reset();
+        system.reset();
+        ctx.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numTransitions);
+}
+BENCHMARK(BM_PathConditionEncodeWithPredecessors)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_FindLowestCommonDominator(benchmark::State& state)
+{
+    GazerContext ctx;
+    AutomataSystem system(ctx);
+    Cfa* callee = createCallee(system);
+    Cfa* cfa = bench::createDiamondChainCfa(system, "main", state.range(0), callee, 4);
+
+    std::vector<Location*> topo;
+    llvm::DenseMap<Location*, size_t> indexMap;
+    createTopologicalSort(*cfa, topo, &indexMap);
+
+    std::vector<Transition*> targets;
+    for (Transition* edge : cfa->edges()) {
+        if (llvm::isa<CallTransition>(edge)) {
+            targets.push_back(edge);
+        }
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(findLowestCommonDominator(
+            targets, topo, [&indexMap](auto l) { return indexMap[l]; }
+        ));
+    }
+
+    state.SetItemsProcessed(state.iterations() * cfa->getNumLocations());
+    state.counters["targets"] = targets.size();
+}
+BENCHMARK(BM_FindLowestCommonDominator)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_FindHighestCommonPostDominator(benchmark::State& state)
+{
+    GazerContext ctx;
+    AutomataSystem system(ctx);
+    Cfa* callee = createCallee(system);
+    Cfa* cfa = bench::createDiamondChainCfa(system, "main", state.range(0), callee, 4);
+
+    std::vector<Location*> topo;
+    llvm::DenseMap<Location*, size_t> indexMap;
+    createTopologicalSort(*cfa, topo, &indexMap);
+
+    std::vector<Transition*> targets;
+    for (Transition* edge : cfa->edges()) {
+        if (llvm::isa<CallTransition>(edge)) {
+            targets.push_back(edge);
+        }
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(findHighestCommonPostDominator(
+            targets, topo, [&indexMap](auto l) { return indexMap[l]; }, cfa->getExit()
+        ));
+    }
+
+    state.SetItemsProcessed(state.iterations() * cfa->getNumLocations());
+    state.counters["targets"] = targets.size();
+}
+BENCHMARK(BM_FindHighestCommonPostDominator)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_DominatorTreeQuery(benchmark::State& state)
+{
+    GazerContext ctx;
+    AutomataSystem system(ctx);
+    Cfa* callee = createCallee(system);
+    Cfa* cfa = bench::createDiamondChainCfa(system, "main", state.range(0), callee, 4);
+
+    std::vector<Location*> topo;
+    llvm::DenseMap<Location*, size_t> indexMap;
+    createTopologicalSort(*cfa, topo, &indexMap);
+
+    std::vector<Location*> sources;
+    for (Transition* edge : cfa->edges()) {
+        if (llvm::isa<CallTransition>(edge)) {
+            sources.push_back(edge->getSource());
+        }
+    }
+
+    // Only measure the queries, the tree is built once, similarly to the BMC engine.
+    DagDominatorTree domTree([&indexMap](auto l) { return indexMap[l]; });
+    domTree.recalculate(cfa->getEntry(), topo);
+    benchmark::DoNotOptimize(domTree.findNearestCommonDominator(sources));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(domTree.findNearestCommonDominator(sources));
+    }
+
+    state.SetItemsProcessed(state.iterations() * sources.size());
+}
+BENCHMARK(BM_DominatorTreeQuery)->RangeMultiplier(4)->Range(16, 4096);
+
+} // end anonymous namespace
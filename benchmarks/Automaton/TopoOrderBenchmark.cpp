@@ -0,0 +1,134 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaTopoOrder.h"
+
+#include <llvm/ADT/DenseMap.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Simulates the topological order updates of the BMC engine: the main
+/// automaton has a call site in every `CallPeriod` locations, and each
+/// inlined callee body contains two further call sites. Every call site
+/// is inlined up to the given depth.
+class InliningScenario
+{
+public:
+    static constexpr unsigned MainSize = 1024;
+    static constexpr unsigned CallPeriod = 16;
+    static constexpr unsigned BodySize = 16;
+    static constexpr unsigned CallsInBody[] = { 5, 11 };
+
+    InliningScenario(Cfa* cfa, unsigned depth)
+    {
+        for (unsigned i = 0; i < MainSize; ++i) {
+            mMain.push_back(cfa->createLocation());
+        }
+
+        std::vector<Location*> sites;
+        for (unsigned i = CallPeriod; i < MainSize; i += CallPeriod) {
+            sites.push_back(mMain[i]);
+        }
+
+        for (unsigned level = 0; level < depth; ++level) {
+            std::vector<Location*> nextSites;
+            for (Location* site : sites) {
+                std::vector<Location*> body;
+                for (unsigned i = 0; i < BodySize; ++i) {
+                    body.push_back(cfa->createLocation());
+                }
+                for (unsigned idx : CallsInBody) {
+                    nextSites.push_back(body[idx]);
+                }
+                mInlines.emplace_back(site, std::move(body));
+            }
+            sites = std::move(nextSites);
+        }
+    }
+
+    const std::vector<Location*>& getMain() const { return mMain; }
+    const std::vector<std::pair<Location*, std::vector<Location*>>>& getInlines() const { return mInlines; }
+
+private:
+    std::vector<Location*> mMain;
+    std::vector<std::pair<Location*, std::vector<Location*>>> mInlines;
+};
+
+/// The previous approach: splice into a vector and renumber the tail.
+void BM_TopoOrderInlineVector(benchmark::State& state)
+{
+    GazerContext ctx;
+    AutomataSystem system(ctx);
+    InliningScenario scenario(system.createCfa("main"), state.range(0));
+
+    size_t numLocs = 0;
+    for (auto _ : state) {
+        std::vector<Location*> topo(scenario.getMain());
+        llvm::DenseMap<Location*, size_t> locNumbers;
+        for (size_t i = 0; i < topo.size(); ++i) {
+            locNumbers[topo[i]] = i;
+        }
+
+        for (auto& [site, body] : scenario.getInlines()) {
+            auto insertPos = topo.insert(
+                std::next(topo.begin(), locNumbers[site]), body.begin(), body.end()
+            );
+            for (auto it = insertPos, ie = topo.end(); it != ie; ++it) {
+                locNumbers[*it] = std::distance(topo.begin(), it);
+            }
+        }
+
+        numLocs = topo.size();
+        benchmark::DoNotOptimize(locNumbers);
+    }
+
+    state.counters["inlined"] = scenario.getInlines().size();
+    state.counters["locations"] = numLocs;
+}
+BENCHMARK(BM_TopoOrderInlineVector)->DenseRange(1, 6)->Unit(benchmark::kMicrosecond);
+
+void BM_TopoOrderInlineDynamic(benchmark::State& state)
+{
+    GazerContext ctx;
+    AutomataSystem system(ctx);
+    InliningScenario scenario(system.createCfa("main"), state.range(0));
+
+    size_t numLocs = 0;
+    size_t numRelabeled = 0;
+    for (auto _ : state) {
+        CfaTopoOrder order(scenario.getMain());
+        for (auto& [site, body] : scenario.getInlines()) {
+            order.insertBefore(site, body);
+        }
+
+        numLocs = order.size();
+        numRelabeled = order.getNumRelabeled();
+        benchmark::DoNotOptimize(order.getLabel(scenario.getMain().back()));
+    }
+
+    state.counters["inlined"] = scenario.getInlines().size();
+    state.counters["locations"] = numLocs;
+    state.counters["relabeled"] = numRelabeled;
+}
+BENCHMARK(BM_TopoOrderInlineDynamic)->DenseRange(1, 6)->Unit(benchmark::kMicrosecond);
+
+} // end anonymous namespace
@@ -0,0 +1,165 @@
+//==- ExprGenerator.h - Synthetic expressions for benchmarks ----*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_BENCHMARKS_COMMON_EXPRGENERATOR_H
+#define GAZER_BENCHMARKS_COMMON_EXPRGENERATOR_H
+
+#include "gazer/Core/Expr/ExprBuilder.h"
+#include "gazer/Core/LiteralExpr.h"
+
+#include <llvm/ADT/Twine.h>
+
+#include <algorithm>
+#include <random>
+
+namespace gazer::bench
+{
+
+/// Creates \p num 32-bit bit-vector variables in \p context.
+inline std::vector<Variable*> createBvVariables(GazerContext& context, unsigned num, llvm::StringRef prefix = "x")
+{
+    std::vector<Variable*> result;
+    for (unsigned i = 0; i < num; ++i) {
+        result.push_back(context.createVariable((prefix + llvm::Twine(i)).str(), BvType::Get(context, 32)));
+    }
+
+    return result;
+}
+
+namespace detail
+{
+
+inline ExprPtr createRandomBvOp(ExprBuilder& builder, const ExprPtr& left, const ExprPtr& right, std::mt19937& rng)
+{
+    switch (rng() % 7) {
+        case 0: return builder.Add(left, right);
+        case 1: return builder.Sub(left, right);
+        case 2: return builder.Mul(left, right);
+        case 3: return builder.BvAnd(left, right);
+        case 4: return builder.BvOr(left, right);
+        case 5: return builder.BvXor(left, right);
+        case 6: return builder.Select(builder.BvULt(left, right), left, right);
+        default:
+            llvm_unreachable("Invalid operation index!");
+    }
+}
+
+inline ExprPtr createRandomBvTree(
+    ExprBuilder& builder, llvm::ArrayRef<Variable*> variables, unsigned numNodes, std::mt19937& rng)
+{
+    if (numNodes == 0) {
+        if (rng() % 4 == 0) {
+            return builder.BvLit32(rng() % 1024);
+        }
+        return variables[rng() % variables.size()]->getRefExpr();
+    }
+
+    unsigned leftNodes = (numNodes - 1) / 2;
+    ExprPtr left = createRandomBvTree(builder, variables, leftNodes, rng);
+    ExprPtr right = createRandomBvTree(builder, variables, numNodes - 1 - leftNodes, rng);
+
+    return createRandomBvOp(builder, left, right, rng);
+}
+
+/// Applies \p kind to \p ops using a random association.
+inline ExprPtr createRandomChain(
+    ExprBuilder& builder, Expr::ExprKind kind, llvm::ArrayRef<ExprPtr> ops, std::mt19937& rng)
+{
+    if (ops.size() == 1) {
+        return ops[0];
+    }
+
+    size_t split = 1 + rng() % (ops.size() - 1);
+    ExprPtr left = createRandomChain(builder, kind, ops.take_front(split), rng);
+    ExprPtr right = createRandomChain(builder, kind, ops.drop_front(split), rng);
+
+    return kind == Expr::Add ? builder.Add(left, right) : builder.Mul(left, right);
+}
+
+} // end namespace detail
+
+/// Builds a pseudo-random bit-vector expression DAG with \p numNodes internal
+/// nodes over the given variables. Each new node picks its operands from all
+/// previously created nodes, so subexpressions are heavily shared and the
+/// DAG is deep: only walkers which cache their results can traverse it.
+/// The returned expression is boolean, so it may be passed to solvers and
+/// path conditions directly.
+inline ExprPtr createRandomExprDag(
+    ExprBuilder& builder, llvm::ArrayRef<Variable*> variables, unsigned numNodes, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<ExprPtr> pool;
+    for (Variable* variable : variables) {
+        pool.push_back(variable->getRefExpr());
+    }
+    for (unsigned i = 0; i < 4; ++i) {
+        pool.push_back(builder.BvLit32(rng() % 1024));
+    }
+
+    for (unsigned i = 0; i < numNodes; ++i) {
+        // Prefer recent nodes to get deep expressions instead of wide ones.
+        std::uniform_int_distribution<size_t> recent(pool.size() > 8 ? pool.size() - 8 : 0, pool.size() - 1);
+        std::uniform_int_distribution<size_t> any(0, pool.size() - 1);
+        ExprPtr left = pool[recent(rng)];
+        ExprPtr right = pool[any(rng)];
+
+        pool.push_back(detail::createRandomBvOp(builder, left, right, rng));
+    }
+
+    return builder.NotEq(pool.back(), builder.BvLit32(0));
+}
+
+/// Builds a pseudo-random, balanced bit-vector expression tree with
+/// \p numNodes internal nodes. Apart from accidental hash-consing hits,
+/// subexpressions are not shared, thus the expression may be traversed
+/// without caching. The returned expression is boolean.
+inline ExprPtr createRandomExprTree(
+    ExprBuilder& builder, llvm::ArrayRef<Variable*> variables, unsigned numNodes, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    return builder.NotEq(detail::createRandomBvTree(builder, variables, numNodes, rng), builder.BvLit32(0));
+}
+
+/// Builds a sum of \p numTerms products of three variables. The terms only
+/// depend on \p seed, while \p variant shuffles the operands and picks a
+/// random association for each sum and product. Thus the variants of the
+/// same seed are equal modulo commutativity and associativity.
+inline ExprPtr createAcVariant(
+    ExprBuilder& builder, llvm::ArrayRef<Variable*> variables, unsigned numTerms, unsigned seed, unsigned variant)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::vector<ExprPtr>> terms(numTerms);
+    for (auto& factors : terms) {
+        for (unsigned i = 0; i < 3; ++i) {
+            factors.push_back(variables[rng() % variables.size()]->getRefExpr());
+        }
+    }
+
+    std::mt19937 shuffle(variant);
+    std::vector<ExprPtr> products;
+    for (auto& factors : terms) {
+        std::shuffle(factors.begin(), factors.end(), shuffle);
+        products.push_back(detail::createRandomChain(builder, Expr::Mul, factors, shuffle));
+    }
+
+    std::shuffle(products.begin(), products.end(), shuffle);
+    return detail::createRandomChain(builder, Expr::Add, products, shuffle);
+}
+
+} // end namespace gazer::bench
+
+#endif
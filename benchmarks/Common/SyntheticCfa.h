@@ -0,0 +1,165 @@
+//==- SyntheticCfa.h - Synthetic automata for benchmarks -------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_BENCHMARKS_COMMON_SYNTHETICCFA_H
+#define GAZER_BENCHMARKS_COMMON_SYNTHETICCFA_H
+
+#include "gazer/Automaton/Cfa.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+
+#include <llvm/ADT/Twine.h>
+
+namespace gazer::bench
+{
+
+/// Builds an acyclic automaton in \p system made of \p numDiamonds
+/// consecutive if-then-else diamonds, followed by an error check.
+/// Every diamond branches on a nondeterministic input and updates a
+/// 32-bit accumulator, yielding 2^numDiamonds paths to the error location.
+///
+/// If \p callee is not null, every \p callPeriod-th diamond calls it on its
+/// then-branch. The callee must have a single Bv32 input and output.
+inline Cfa* createDiamondChainCfa(
+    AutomataSystem& system, llvm::StringRef name, unsigned numDiamonds,
+    Cfa* callee = nullptr, unsigned callPeriod = 1)
+{
+    GazerContext& ctx = system.getContext();
+    auto builder = CreateExprBuilder(ctx);
+
+    Cfa* cfa = system.createCfa(name.str());
+    Variable* acc = cfa->createLocal("acc", BvType::Get(ctx, 32));
+    cfa->addOutput(acc);
+
+    Location* current = cfa->createLocation();
+    cfa->createAssignTransition(cfa->getEntry(), current, {
+        { acc, builder->BvLit32(0) }
+    });
+
+    for (unsigned i = 0; i < numDiamonds; ++i) {
+        Variable* cond = cfa->createInput(("c" + llvm::Twine(i)).str(), BoolType::Get(ctx));
+        Location* thenLoc = cfa->createLocation();
+        Location* elseLoc = cfa->createLocation();
+        Location* join = cfa->createLocation();
+
+        if (callee != nullptr && i % callPeriod == 0) {
+            cfa->createCallTransition(current, thenLoc, cond->getRefExpr(), callee, {
+                { callee->getInput(0), acc->getRefExpr() }
+            }, {
+                { acc, callee->getOutput(0)->getRefExpr() }
+            });
+        } else {
+            cfa->createAssignTransition(current, thenLoc, cond->getRefExpr(), {
+                { acc, builder->Add(acc->getRefExpr(), builder->BvLit32(i + 1)) }
+            });
+        }
+
+        cfa->createAssignTransition(current, elseLoc, builder->Not(cond->getRefExpr()), {
+            { acc, builder->Mul(acc->getRefExpr(), builder->BvLit32(3)) }
+        });
+        cfa->createAssignTransition(thenLoc, join);
+        cfa->createAssignTransition(elseLoc, join);
+
+        current = join;
+    }
+
+    Location* error = cfa->createErrorLocation();
+    cfa->addErrorCode(error, builder->IntLit(1));
+
+    ExprPtr check = builder->Eq(acc->getRefExpr(), builder->BvLit32(42));
+    cfa->createAssignTransition(current, error, check);
+    cfa->createAssignTransition(current, cfa->getExit(), builder->Not(check));
+
+    return cfa;
+}
+
+/// Builds a tail-recursive automaton, as produced by the LLVM frontend for
+/// loops. The body is a diamond chain of \p numDiamonds diamonds.
+/// The automaton has a single Bv32 input and output.
+///
+/// \see createLoopCallerCfa
+inline Cfa* createTailRecursiveCfa(AutomataSystem& system, llvm::StringRef name, unsigned numDiamonds)
+{
+    GazerContext& ctx = system.getContext();
+    auto builder = CreateExprBuilder(ctx);
+
+    Cfa* cfa = system.createCfa(name.str());
+    Variable* counter = cfa->createInput("i", BvType::Get(ctx, 32));
+    Variable* result = cfa->createLocal("result", BvType::Get(ctx, 32));
+    cfa->addOutput(result);
+
+    Location* current = cfa->createLocation();
+    cfa->createAssignTransition(cfa->getEntry(), current, {
+        { result, counter->getRefExpr() }
+    });
+
+    for (unsigned i = 0; i < numDiamonds; ++i) {
+        Variable* cond = cfa->createLocal(("c" + llvm::Twine(i)).str(), BoolType::Get(ctx));
+        Location* thenLoc = cfa->createLocation();
+        Location* elseLoc = cfa->createLocation();
+        Location* join = cfa->createLocation();
+
+        cfa->createAssignTransition(current, thenLoc, cond->getRefExpr(), {
+            { result, builder->Add(result->getRefExpr(), builder->BvLit32(i + 1)) }
+        });
+        cfa->createAssignTransition(current, elseLoc, builder->Not(cond->getRefExpr()));
+        cfa->createAssignTransition(thenLoc, join);
+        cfa->createAssignTransition(elseLoc, join);
+
+        current = join;
+    }
+
+    ExprPtr loopCond = builder->BvULt(result->getRefExpr(), builder->BvLit32(100));
+    cfa->createCallTransition(current, cfa->getExit(), loopCond, cfa, {
+        { counter, builder->Add(counter->getRefExpr(), builder->BvLit32(1)) }
+    }, {
+        { result, result->getRefExpr() }
+    });
+    cfa->createAssignTransition(current, cfa->getExit(), builder->Not(loopCond));
+
+    return cfa;
+}
+
+/// Builds an automaton which calls the single-input, single-output
+/// automaton \p loop and checks its result.
+inline Cfa* createLoopCallerCfa(AutomataSystem& system, llvm::StringRef name, Cfa* loop)
+{
+    GazerContext& ctx = system.getContext();
+    auto builder = CreateExprBuilder(ctx);
+
+    Cfa* cfa = system.createCfa(name.str());
+    Variable* result = cfa->createLocal("result", BvType::Get(ctx, 32));
+
+    Location* afterCall = cfa->createLocation();
+    Location* error = cfa->createErrorLocation();
+    cfa->addErrorCode(error, builder->IntLit(1));
+
+    cfa->createCallTransition(cfa->getEntry(), afterCall, builder->True(), loop, {
+        { loop->getInput(0), builder->BvLit32(0) }
+    }, {
+        { result, loop->getOutput(0)->getRefExpr() }
+    });
+
+    ExprPtr check = builder->Eq(result->getRefExpr(), builder->BvLit32(42));
+    cfa->createAssignTransition(afterCall, error, check);
+    cfa->createAssignTransition(afterCall, cfa->getExit(), builder->Not(check));
+
+    return cfa;
+}
+
+} // end namespace gazer::bench
+
+#endif
@@ -0,0 +1,159 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "Common/ExprGenerator.h"
+
+#include "gazer/Core/Expr/ExprBuilder.h"
+
+#include <llvm/ADT/DenseSet.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Returns the number of distinct nodes reachable from \p roots.
+size_t countNodes(llvm::ArrayRef<ExprPtr> roots)
+{
+    llvm::DenseSet<ExprView<>> visited;
+    std::vector<ExprView<>> worklist(roots.begin(), roots.end());
+    while (!worklist.empty()) {
+        ExprView<> current = worklist.back();
+        worklist.pop_back();
+
+        if (!visited.insert(current).second) {
+            continue;
+        }
+
+        if (auto nn = dyn_expr_cast<NonNullaryExpr>(current)) {
+            worklist.insert(worklist.end(), nn->op_begin(), nn->op_end());
+        }
+    }
+
+    return visited.size();
+}
+
+/// Measures the cost of creating new, unique expression nodes.
+void BM_ExprStorageCreate(benchmark::State& state)
+{
+    unsigned numNodes = state.range(0);
+    unsigned seed = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto context = std::make_unique<GazerContext>();
+        auto builder = CreateExprBuilder(*context);
+        auto vars = bench::createBvVariables(*context, 16);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(bench::createRandomExprDag(*builder, vars, numNodes, seed++));
+
+        state.PauseTiming();
+        context.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numNodes);
+}
+BENCHMARK(BM_ExprStorageCreate)->RangeMultiplier(8)->Range(64, 32768);
+
+/// Measures the cost of creating expressions which are already present in
+/// the expression storage.
+void BM_ExprStorageLookup(benchmark::State& state)
+{
+    unsigned numNodes = state.range(0);
+
+    GazerContext context;
+    auto builder = CreateExprBuilder(context);
+    auto vars = bench::createBvVariables(context, 16);
+
+    ExprPtr original = bench::createRandomExprDag(*builder, vars, numNodes, 0);
+
+    for (auto _ : state) {
+        ExprPtr expr = bench::createRandomExprDag(*builder, vars, numNodes, 0);
+        assert(expr == original);
+        benchmark::DoNotOptimize(expr);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numNodes);
+}
+BENCHMARK(BM_ExprStorageLookup)->RangeMultiplier(8)->Range(64, 32768);
+
+/// Measures the overhead of the simplifications done by the folding builder
+/// compared to the plain builder.
+void BM_FoldingExprBuilder(benchmark::State& state)
+{
+    unsigned numNodes = state.range(0);
+    bool folding = state.range(1) != 0;
+
+    GazerContext context;
+    auto builder = folding ? CreateFoldingExprBuilder(context) : CreateExprBuilder(context);
+
+    // Use few variables and literal-heavy expressions, so the folding builder
+    // has something to simplify.
+    auto vars = bench::createBvVariables(context, 2);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench::createRandomExprDag(*builder, vars, numNodes, 0));
+    }
+
+    state.SetItemsProcessed(state.iterations() * numNodes);
+    state.SetLabel(folding ? "folding" : "plain");
+}
+BENCHMARK(BM_FoldingExprBuilder)
+    ->ArgsProduct({ benchmark::CreateRange(64, 4096, 8), { 0, 1 } });
+
+/// Measures the cost and the node count reduction of creating commutative
+/// and associative expressions in canonical form. The variants are equal
+/// modulo commutativity and associativity, thus with canonicalization they
+/// all map to the same node.
+void BM_ExprCanonicalization(benchmark::State& state)
+{
+    unsigned numVariants = state.range(0);
+    bool canonical = state.range(1) != 0;
+
+    size_t numNodes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto context = std::make_unique<GazerContext>();
+        context->setExprCanonicalization(canonical);
+        auto builder = CreateExprBuilder(*context);
+        auto vars = bench::createBvVariables(*context, 8);
+        ExprVector variants;
+        state.ResumeTiming();
+
+        for (unsigned i = 0; i < numVariants; ++i) {
+            variants.push_back(bench::createAcVariant(*builder, vars, 16, 0, i));
+        }
+
+        state.PauseTiming();
+        numNodes = countNodes(variants);
+        variants.clear();
+        context.reset();
+        state.ResumeTiming();
+    }
+
+    state.counters["nodes"] = numNodes;
+    state.SetItemsProcessed(state.iterations() * numVariants);
+    state.SetLabel(canonical ? "canonical" : "plain");
+}
+BENCHMARK(BM_ExprCanonicalization)
+    ->ArgsProduct({ benchmark::CreateRange(1, 64, 4), { 0, 1 } });
+
+} // end anonymous namespace
@@ -0,0 +1,127 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "Common/ExprGenerator.h"
+
+#include "gazer/Core/Expr/BatchExprEvaluator.h"
+#include "gazer/Core/Expr/ExprEvaluator.h"
+#include "gazer/Core/Valuation.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace gazer;
+
+namespace
+{
+
+void BM_ValuationExprEvaluator(benchmark::State& state)
+{
+    unsigned numNodes = state.range(0);
+
+    GazerContext context;
+    auto builder = CreateExprBuilder(context);
+    auto vars = bench::createBvVariables(context, 16);
+    // The evaluator does not cache intermediate results, use a tree.
+    ExprPtr expr = bench::createRandomExprTree(*builder, vars, numNodes, 0);
+
+    std::mt19937 rng(0);
+    auto vb = Valuation::CreateBuilder();
+    for (Variable* variable : vars) {
+        vb.put(variable, builder->BvLit32(rng()));
+    }
+    Valuation valuation = vb.build();
+
+    for (auto _ : state) {
+        ValuationExprEvaluator eval(valuation);
+        benchmark::DoNotOptimize(eval.evaluate(expr));
+    }
+
+    state.SetItemsProcessed(state.iterations() * numNodes);
+}
+BENCHMARK(BM_ValuationExprEvaluator)->RangeMultiplier(8)->Range(64, 32768);
+
+constexpr size_t NumLanes = 1024;
+
+std::vector<uint64_t> createRandomColumns(size_t numVariables, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint64_t> columns(numVariables * NumLanes);
+    for (uint64_t& value : columns) {
+        value = rng();
+    }
+
+    return columns;
+}
+
+// Evaluates an expression under NumLanes valuations one by one, as a
+// baseline for BM_BatchExprEvaluator.
+void BM_ValuationExprEvaluatorLanes(benchmark::State& state)
+{
+    unsigned numNodes = state.range(0);
+
+    GazerContext context;
+    auto builder = CreateExprBuilder(context);
+    auto vars = bench::createBvVariables(context, 16);
+    ExprPtr expr = bench::createRandomExprTree(*builder, vars, numNodes, 0);
+
+    auto columns = createRandomColumns(vars.size(), 0);
+    std::vector<Valuation> valuations;
+    for (size_t lane = 0; lane < NumLanes; ++lane) {
+        auto vb = Valuation::CreateBuilder();
+        for (size_t i = 0; i < vars.size(); ++i) {
+            vb.put(vars[i], builder->BvLit32(columns[i * NumLanes + lane]));
+        }
+        valuations.push_back(vb.build());
+    }
+
+    for (auto _ : state) {
+        for (const Valuation& valuation : valuations) {
+            ValuationExprEvaluator eval(valuation);
+            benchmark::DoNotOptimize(eval.evaluate(expr));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * NumLanes);
+}
+BENCHMARK(BM_ValuationExprEvaluatorLanes)->RangeMultiplier(8)->Range(64, 512);
+
+void BM_BatchExprEvaluator(benchmark::State& state)
+{
+    unsigned numNodes = state.range(0);
+
+    GazerContext context;
+    auto builder = CreateExprBuilder(context);
+    auto vars = bench::createBvVariables(context, 16);
+    ExprPtr expr = bench::createRandomExprTree(*builder, vars, numNodes, 0);
+
+    auto columns = createRandomColumns(vars.size(), 0);
+    std::vector<uint64_t> result(NumLanes);
+    auto eval = BatchExprEvaluator::Create(expr, vars);
+
+    for (auto _ : state) {
+        eval->evaluate(columns, NumLanes, result);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * NumLanes);
+}
+BENCHMARK(BM_BatchExprEvaluator)->RangeMultiplier(8)->Range(64, 512);
+
+} // end anonymous namespace
@@ -0,0 +1,121 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "Common/ExprGenerator.h"
+
+#include "gazer/Core/Expr/ExprWalker.h"
+
+#include <llvm/ADT/DenseSet.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Counts the nodes of an expression, visiting shared subexpressions
+/// as many times as they occur. The hooks receive HandleT handles: ExprView
+/// borrows the visited nodes, while ExprRef takes a reference to each of them.
+template<template<class> class HandleT>
+class CountingWalker : public ExprWalker<CountingWalker<HandleT>, size_t>
+{
+public:
+    size_t visitExpr(const HandleT<Expr>& expr) { return 1; }
+
+    size_t visitNonNullary(const HandleT<NonNullaryExpr>& expr)
+    {
+        size_t result = 1;
+        for (size_t i = 0; i < expr->getNumOperands(); ++i) {
+            result += this->getOperand(i);
+        }
+
+        return result;
+    }
+};
+
+/// Counts the distinct nodes of an expression, skipping already visited ones.
+template<template<class> class HandleT>
+class CachingCountingWalker : public ExprWalker<CachingCountingWalker<HandleT>, size_t>
+{
+public:
+    bool shouldSkip(const HandleT<Expr>& expr, size_t* ret)
+    {
+        auto it = mCache.find(expr.get());
+        if (it != mCache.end()) {
+            *ret = 0;
+            return true;
+        }
+
+        return false;
+    }
+
+    void handleResult(const HandleT<Expr>& expr, size_t& ret)
+    {
+        mCache.insert(expr.get());
+    }
+
+    size_t visitExpr(const HandleT<Expr>& expr) { return 1; }
+
+    size_t visitNonNullary(const HandleT<NonNullaryExpr>& expr)
+    {
+        size_t result = 1;
+        for (size_t i = 0; i < expr->getNumOperands(); ++i) {
+            result += this->getOperand(i);
+        }
+
+        return result;
+    }
+
+private:
+    llvm::DenseSet<Expr*> mCache;
+};
+
+template<class Walker, bool Shared>
+void BM_ExprWalker(benchmark::State& state)
+{
+    GazerContext context;
+    auto builder = CreateExprBuilder(context);
+    auto vars = bench::createBvVariables(context, 16);
+
+    ExprPtr expr = Shared
+        ? bench::createRandomExprDag(*builder, vars, state.range(0), 0)
+        : bench::createRandomExprTree(*builder, vars, state.range(0), 0);
+
+    size_t visited = 0;
+    for (auto _ : state) {
+        Walker walker;
+        visited = walker.walk(expr);
+        benchmark::DoNotOptimize(visited);
+    }
+
+    state.SetItemsProcessed(state.iterations() * visited);
+    state.counters["nodes"] = visited;
+}
+// Walkers without a cache would visit exponentially many paths in a shared
+// DAG, so they are only measured on trees.
+BENCHMARK_TEMPLATE(BM_ExprWalker, CountingWalker<ExprView>, false)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_ExprWalker, CachingCountingWalker<ExprView>, false)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_ExprWalker, CachingCountingWalker<ExprView>, true)->RangeMultiplier(8)->Range(64, 32768);
+
+// The same walkers with owning hook parameters, measuring the cost of the
+// reference counting avoided by views.
+BENCHMARK_TEMPLATE(BM_ExprWalker, CountingWalker<ExprRef>, false)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_ExprWalker, CachingCountingWalker<ExprRef>, false)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK_TEMPLATE(BM_ExprWalker, CachingCountingWalker<ExprRef>, true)->RangeMultiplier(8)->Range(64, 32768);
+
+} // end anonymous namespace
@@ -0,0 +1,86 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Core/Type.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Measures the lookup of already interned bit-vector types. The first
+/// argument is the width, with 57 and 128 not being predefined types.
+void BM_BvTypeGet(benchmark::State& state)
+{
+    unsigned width = state.range(0);
+
+    GazerContext context;
+    BvType::Get(context, width);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&BvType::Get(context, width));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BvTypeGet)->Arg(8)->Arg(32)->Arg(57)->Arg(128);
+
+/// Measures the lookup of already interned array types, such as the memory
+/// array type of the flat memory model.
+void BM_ArrayTypeGet(benchmark::State& state)
+{
+    GazerContext context;
+    BvType& ptrTy = BvType::Get(context, 32);
+    BvType& cellTy = BvType::Get(context, 8);
+
+    // Add some other array types to the table.
+    for (unsigned i = 1; i <= 16; ++i) {
+        ArrayType::Get(ptrTy, BvType::Get(context, i * 8));
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&ArrayType::Get(ptrTy, cellTy));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ArrayTypeGet);
+
+/// Measures the lookup of already interned tuple types. The argument is the
+/// number of subtypes.
+void BM_TupleTypeGet(benchmark::State& state)
+{
+    unsigned numSubtypes = state.range(0);
+
+    GazerContext context;
+    std::vector<Type*> subtypes;
+    for (unsigned i = 0; i < numSubtypes; ++i) {
+        subtypes.push_back(&BvType::Get(context, 8 + i));
+    }
+    TupleType::Get(subtypes);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&TupleType::Get(subtypes));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TupleTypeGet)->Arg(2)->Arg(8);
+
+} // end anonymous namespace
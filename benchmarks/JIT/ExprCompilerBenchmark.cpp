@@ -0,0 +1,95 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "Common/ExprGenerator.h"
+
+#include "gazer/JIT/ExprCompiler.h"
+#include "gazer/Core/Valuation.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace gazer;
+
+namespace
+{
+
+void BM_CompiledExprEvaluator(benchmark::State& state)
+{
+    unsigned numNodes = state.range(0);
+
+    GazerContext context;
+    auto builder = CreateExprBuilder(context);
+    auto vars = bench::createBvVariables(context, 16);
+    // Use the same trees as BM_ValuationExprEvaluator.
+    ExprPtr expr = bench::createRandomExprTree(*builder, vars, numNodes, 0);
+
+    std::mt19937 rng(0);
+    auto vb = Valuation::CreateBuilder();
+    for (Variable* variable : vars) {
+        vb.put(variable, builder->BvLit32(rng()));
+    }
+    Valuation valuation = vb.build();
+
+    auto compiler = ExprCompiler::Create();
+    if (compiler == nullptr) {
+        state.SkipWithError("Native target is not available");
+        return;
+    }
+
+    // Compile outside of the measured loop, the compiled code is cached.
+    CompiledExprEvaluator eval(*compiler, valuation);
+    eval.evaluate(expr);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(eval.evaluate(expr));
+    }
+
+    state.SetItemsProcessed(state.iterations() * numNodes);
+}
+BENCHMARK(BM_CompiledExprEvaluator)->RangeMultiplier(8)->Range(64, 32768);
+
+void BM_ExprCompilerCompile(benchmark::State& state)
+{
+    unsigned numNodes = state.range(0);
+
+    GazerContext context;
+    auto builder = CreateExprBuilder(context);
+    auto vars = bench::createBvVariables(context, 16);
+
+    auto compiler = ExprCompiler::Create();
+    if (compiler == nullptr) {
+        state.SkipWithError("Native target is not available");
+        return;
+    }
+
+    unsigned seed = 0;
+    for (auto _ : state) {
+        // Each iteration needs a fresh expression to avoid the cache.
+        state.PauseTiming();
+        ExprPtr expr = bench::createRandomExprTree(*builder, vars, numNodes, seed++);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(compiler->compile(expr));
+    }
+
+    state.SetItemsProcessed(state.iterations() * numNodes);
+}
+BENCHMARK(BM_ExprCompilerCompile)->RangeMultiplier(8)->Range(64, 4096);
+
+} // end anonymous namespace
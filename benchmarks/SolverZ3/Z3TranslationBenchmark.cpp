@@ -0,0 +1,90 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "Common/ExprGenerator.h"
+
+#include "gazer/Z3Solver/Z3Solver.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Measures the translation of gazer expressions into Z3 terms.
+/// The translation cache of the solver is scoped, thus each push-add-pop
+/// cycle translates the whole expression again. The solver itself is not run.
+void BM_Z3ExprTransformer(benchmark::State& state)
+{
+    unsigned numNodes = state.range(0);
+
+    GazerContext context;
+    auto builder = CreateExprBuilder(context);
+    auto vars = bench::createBvVariables(context, 16);
+    ExprPtr expr = bench::createRandomExprDag(*builder, vars, numNodes, 0);
+
+    Z3SolverFactory factory;
+    auto solver = factory.createSolver(context);
+
+    for (auto _ : state) {
+        solver->push();
+        solver->add(expr);
+        solver->pop();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numNodes);
+}
+BENCHMARK(BM_Z3ExprTransformer)->RangeMultiplier(4)->Range(64, 4096);
+
+/// Measures the solver time of proving that expressions which are equal
+/// modulo commutativity and associativity are equivalent, with and without
+/// canonical expression creation.
+void BM_Z3CanonicalEquivalence(benchmark::State& state)
+{
+    unsigned numVariants = state.range(0);
+    bool canonical = state.range(1) != 0;
+
+    GazerContext context;
+    context.setExprCanonicalization(canonical);
+    auto builder = CreateExprBuilder(context);
+    auto vars = bench::createBvVariables(context, 8);
+
+    ExprPtr first = bench::createAcVariant(*builder, vars, 16, 0, 0);
+    ExprVector differs;
+    for (unsigned i = 1; i < numVariants; ++i) {
+        differs.push_back(builder->NotEq(first, bench::createAcVariant(*builder, vars, 16, 0, i)));
+    }
+    ExprPtr expr = builder->Or(differs);
+
+    Z3SolverFactory factory;
+    for (auto _ : state) {
+        auto solver = factory.createSolver(context);
+        solver->add(expr);
+        auto status = solver->run();
+        assert(status == Solver::UNSAT);
+        benchmark::DoNotOptimize(status);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numVariants);
+    state.SetLabel(canonical ? "canonical" : "plain");
+}
+BENCHMARK(BM_Z3CanonicalEquivalence)
+    ->ArgsProduct({ { 4, 16, 64 }, { 0, 1 } })
+    ->Unit(benchmark::kMillisecond);
+
+} // end anonymous namespace
@@ -0,0 +1,65 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Support/SExpr.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Generates a random, well-formed s-expression with \p numAtoms atoms.
+std::string createRandomSExpr(unsigned numAtoms, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::string result = "(";
+    unsigned depth = 1;
+
+    for (unsigned i = 0; i < numAtoms; ++i) {
+        unsigned choice = rng() % 8;
+        if (choice == 0 && depth < 32) {
+            result += "(";
+            ++depth;
+        } else if (choice == 1 && depth > 1) {
+            result += ") ";
+            --depth;
+        }
+
+        result += "atom" + std::to_string(rng() % 1000) + " ";
+    }
+
+    result.append(depth, ')');
+    return result;
+}
+
+void BM_SExprParse(benchmark::State& state)
+{
+    std::string input = createRandomSExpr(state.range(0), 0);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sexpr::parse(input));
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_SExprParse)->RangeMultiplier(8)->Range(64, 32768);
+
+} // end anonymous namespace
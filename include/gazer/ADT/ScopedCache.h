@@ -59,14 +59,26 @@ public:
     /// traverse all parent scopes. If the requested element was not found
     /// in any of the scopes, returns an empty optional.
     std::optional<ValueT> get(const KeyT& key) const {
+        if (const ValueT* value = this->lookup(key)) {
+            return std::make_optional(*value);
+        }
+
+        return std::nullopt;
+    }
+
+    /// Returns a pointer to the value corresponding to the given key, or
+    /// nullptr if it was not found in any of the scopes. Unlike get(), this
+    /// method does not copy the value. The pointer is invalidated by any
+    /// further insertion or by popping the scope containing the value.
+    const ValueT* lookup(const KeyT& key) const {
         for (auto it = mStorage.rbegin(), ie = mStorage.rend(); it != ie; ++it) {
             auto result = it->find(key);
             if (result != it->end()) {
-                return std::make_optional(result->second);
+                return &result->second;
             }
         }
 
-        return std::nullopt;
+        return nullptr;
     }
 
     void clear() {
@@ -114,6 +114,19 @@ public:
         mAssignments.push_back(assignment);
     }
 
+    /// Removes the assignments for which \p p returns true. The predicate
+    /// is called exactly once for each assignment, in order.
+    template<class Predicate>
+    void removeAssignmentsIf(Predicate p) {
+        std::vector<VariableAssignment> remaining;
+        for (const VariableAssignment& assignment : mAssignments) {
+            if (!p(assignment)) {
+                remaining.push_back(assignment);
+            }
+        }
+        mAssignments = std::move(remaining);
+    }
+
     static bool classof(const Transition* edge) {
         return edge->getKind() == Edge_Assign;
     }
@@ -214,6 +227,11 @@ public:
     Variable* createInput(const std::string& name, Type& type);
     Variable* createLocal(const std::string& name, Type& type);
 
+    /// Creates an anonymous local variable with the type of \p base,
+    /// e.g. for the copy of a callee's local during inlining. The name of
+    /// the new variable is only built on request, see GazerContext::createFreshVariable().
+    Variable* createFreshLocal(const Variable* base);
+
     /// Marks an already existing variable as an output.
     void addOutput(Variable* variable);
 
@@ -280,6 +298,14 @@ public:
     Variable* getInput(size_t i) const { return mInputs[i]; }
     Variable* getOutput(size_t i) const { return mOutputs[i]; }
 
+    /// Returns the name of a member variable as it was passed to createInput()
+    /// or createLocal(), without the automaton name prefix. For fresh locals,
+    /// this is the name of the variable itself.
+    std::string getSymbolName(Variable* variable) const {
+        auto it = mSymbolNames.find(variable);
+        return it != mSymbolNames.end() ? it->second : variable->getName();
+    }
+
     Location* findLocationById(unsigned id);
 
     bool isOutput(Variable* variable) const;
@@ -304,7 +330,11 @@ public:
 
     using Graph::disconnectNode;
     using Graph::disconnectEdge;
-    using Graph::clearDisconnectedElements;
+
+    /// Deletes all locations without incoming and outgoing transitions and all
+    /// transitions without a source or target, along with the error codes of
+    /// the deleted error locations.
+    void clearDisconnectedElements();
 
     ~Cfa();
 
@@ -348,6 +378,10 @@ public:
 public:
     Cfa* createCfa(std::string name);
 
+    /// Deletes \p cfa from the system. It must not be the main automaton
+    /// and must not be called by other automata.
+    void removeCfa(Cfa* cfa);
+
     using iterator = boost::indirect_iterator<std::vector<std::unique_ptr<Cfa>>::iterator>;
     using const_iterator = boost::indirect_iterator<std::vector<std::unique_ptr<Cfa>>::const_iterator>;
 
@@ -0,0 +1,140 @@
+//==- CfaDominators.h - Dominator trees for acyclic automata ----*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file defines dominator and post-dominator trees for acyclic
+/// automata. Unlike LLVM's generic dominator tree, these exploit the
+/// availability of a topological sort: the tree is built in a single pass
+/// and can be updated incrementally when new locations (e.g. an inlined
+/// procedure body) are inserted into the automaton.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_AUTOMATON_CFADOMINATORS_H
+#define GAZER_AUTOMATON_CFADOMINATORS_H
+
+#include "gazer/Automaton/Cfa.h"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <functional>
+
+namespace gazer
+{
+
+/// A (post-)dominator tree of an acyclic automaton.
+///
+/// Immediate dominators are calculated with the algorithm of Cooper, Harvey
+/// and Kennedy, which finishes in a single pass if the locations are visited
+/// in topological order. Nearest common dominator queries are answered in
+/// constant time using an Euler tour of the tree and a sparse table for
+/// range minimum queries. This index is rebuilt lazily after the tree changes.
+///
+/// The tree only contains the locations reachable from its root (in the
+/// reverse direction for post-dominator trees).
+///
+/// \tparam IsPostDom Whether this is a post-dominator tree.
+template<bool IsPostDom>
+class DagDominatorTreeBase
+{
+    using NodeId = unsigned;
+    static constexpr NodeId InvalidNode = ~0u;
+public:
+    /// \param index A function returning the index of a location in a
+    ///     topological sort of the automaton. The index must remain valid
+    ///     (but not necessarily unchanged) during the lifetime of the tree.
+    explicit DagDominatorTreeBase(std::function<size_t(Location*)> index)
+        : mIndex(std::move(index))
+    {}
+
+    DagDominatorTreeBase(const DagDominatorTreeBase&) = delete;
+    DagDominatorTreeBase& operator=(const DagDominatorTreeBase&) = delete;
+
+    /// Calculates the tree rooted at \p root from scratch.
+    /// \param topo Topological sort of the automaton locations.
+    void recalculate(Location* root, llvm::ArrayRef<Location*> topo);
+
+    /// Updates the tree after the locations in \p locations were inserted
+    /// into the automaton. The new locations must be already connected and
+    /// the index function must already reflect their position.
+    ///
+    /// Only the new locations and the existing locations whose immediate
+    /// dominator changes are visited. Edges between existing locations may
+    /// be removed, as long as every location in the tree remains reachable
+    /// from the root, e.g. when a call transition is replaced by the body of
+    /// the callee.
+    void insertLocations(llvm::ArrayRef<Location*> locations);
+
+    Location* getRoot() const { return mLocations.empty() ? nullptr : mLocations[0]; }
+    size_t size() const { return mLocations.size(); }
+
+    bool contains(Location* loc) const { return mNodeIds.count(loc) != 0; }
+
+    /// Returns the immediate (post-)dominator of \p loc, or nullptr for the root.
+    Location* getIDom(Location* loc) const;
+
+    /// Returns true if \p a (post-)dominates \p b.
+    bool dominates(Location* a, Location* b);
+
+    /// Returns the nearest common (post-)dominator of \p a and \p b.
+    Location* findNearestCommonDominator(Location* a, Location* b);
+
+    /// Returns the nearest common (post-)dominator of all locations in \p locs.
+    /// Locations which are not present in the tree are ignored. If none of
+    /// them are present, returns nullptr.
+    Location* findNearestCommonDominator(llvm::ArrayRef<Location*> locs);
+
+private:
+    /// Returns true if \p a comes before \p b in the direction of the tree.
+    bool comesBefore(NodeId a, NodeId b) const;
+    NodeId intersect(NodeId a, NodeId b) const;
+    NodeId calculateIDom(Location* loc) const;
+    NodeId lookup(Location* loc) const;
+
+    NodeId addNode(Location* loc, NodeId idom);
+    void setIDom(NodeId node, NodeId idom);
+
+    void buildIndex();
+    size_t findMinDepth(size_t first, size_t last) const;
+
+private:
+    std::function<size_t(Location*)> mIndex;
+
+    llvm::DenseMap<Location*, NodeId> mNodeIds;
+    std::vector<Location*> mLocations;
+    std::vector<NodeId> mIDoms;
+    std::vector<llvm::SmallVector<NodeId, 2>> mChildren;
+
+    // Euler tour index for nearest common dominator queries.
+    bool mIndexValid = false;
+    std::vector<NodeId> mEulerTour;
+    std::vector<unsigned> mEulerDepth;
+    std::vector<size_t> mFirstVisit;
+    std::vector<size_t> mLastVisit;
+    std::vector<std::vector<unsigned>> mSparseTable;
+};
+
+using DagDominatorTree = DagDominatorTreeBase<false>;
+using DagPostDominatorTree = DagDominatorTreeBase<true>;
+
+extern template class DagDominatorTreeBase<false>;
+extern template class DagDominatorTreeBase<true>;
+
+} // end namespace gazer
+
+#endif
@@ -0,0 +1,157 @@
+//==- CfaTopoOrder.h - Dynamic topological order of automata ----*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file defines a topological order of an acyclic automaton which
+/// can be updated incrementally when new locations are inserted into it.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_AUTOMATON_CFATOPOORDER_H
+#define GAZER_AUTOMATON_CFATOPOORDER_H
+
+#include "gazer/Automaton/Cfa.h"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/iterator.h>
+
+#include <functional>
+#include <limits>
+
+namespace gazer
+{
+
+/// Maintains a topological order of the locations of an acyclic automaton.
+///
+/// Each location is assigned an integer label such that a location precedes
+/// another in the order if and only if its label is smaller. Labels are
+/// spread across the whole label space, leaving gaps between neighbouring
+/// locations. Inserting a sequence of locations into a gap only touches the
+/// inserted locations; if the gap is too small, the labels of a surrounding
+/// window are redistributed, growing the window until it is sparse enough.
+///
+/// Labels may change on insertion, but the relative order of the already
+/// present locations never does.
+class CfaTopoOrder
+{
+    using NodeId = unsigned;
+    static constexpr NodeId Head = 0;
+    static constexpr NodeId Tail = 1;
+
+    struct Node
+    {
+        Location* loc;
+        size_t label;
+        NodeId prev;
+        NodeId next;
+    };
+public:
+    class iterator : public llvm::iterator_facade_base<
+        iterator, std::forward_iterator_tag, Location*, ptrdiff_t, Location**, Location*>
+    {
+    public:
+        iterator(const CfaTopoOrder* order, NodeId node)
+            : mOrder(order), mNode(node)
+        {}
+
+        bool operator==(const iterator& rhs) const { return mNode == rhs.mNode; }
+        Location* operator*() const { return mOrder->mNodes[mNode].loc; }
+
+        /// Returns the label of the pointed location.
+        size_t getLabel() const { return mOrder->mNodes[mNode].label; }
+
+        iterator& operator++()
+        {
+            mNode = mOrder->mNodes[mNode].next;
+            return *this;
+        }
+
+    private:
+        const CfaTopoOrder* mOrder;
+        NodeId mNode;
+    };
+
+public:
+    CfaTopoOrder();
+
+    /// Creates an order from a topological sort of the automaton.
+    explicit CfaTopoOrder(llvm::ArrayRef<Location*> topo);
+
+    CfaTopoOrder(const CfaTopoOrder&) = delete;
+    CfaTopoOrder& operator=(const CfaTopoOrder&) = delete;
+
+    /// Inserts \p locs directly before the location \p pos. The inserted
+    /// locations must be in topological order and they must not be present
+    /// in the order. The caller is responsible for keeping the order valid
+    /// with respect to the edges of the automaton.
+    void insertBefore(Location* pos, llvm::ArrayRef<Location*> locs);
+
+    /// Inserts \p locs at the end of the order.
+    void append(llvm::ArrayRef<Location*> locs);
+
+    /// Returns the current label of \p loc.
+    size_t getLabel(Location* loc) const { return mNodes[lookup(loc)].label; }
+
+    /// Returns true if \p lhs strictly precedes \p rhs in the order.
+    bool comesBefore(Location* lhs, Location* rhs) const { return getLabel(lhs) < getLabel(rhs); }
+
+    bool contains(Location* loc) const { return mNodeIds.count(loc) != 0; }
+
+    /// Returns the location following \p loc, or nullptr if \p loc is the last one.
+    Location* getNext(Location* loc) const { return mNodes[mNodes[lookup(loc)].next].loc; }
+
+    /// Returns the location preceding \p loc, or nullptr if \p loc is the first one.
+    Location* getPrev(Location* loc) const { return mNodes[mNodes[lookup(loc)].prev].loc; }
+
+    /// Returns a function which maps locations to their labels, suitable
+    /// as the index function of the utilities in CfaUtils.h.
+    std::function<size_t(Location*)> getIndexFunction() const
+    {
+        return [this](Location* loc) { return this->getLabel(loc); };
+    }
+
+    iterator begin() const { return iterator(this, mNodes[Head].next); }
+    iterator end() const { return iterator(this, Tail); }
+
+    /// Returns an iterator pointing to \p loc.
+    iterator find(Location* loc) const { return iterator(this, lookup(loc)); }
+
+    size_t size() const { return mNodeIds.size(); }
+    bool empty() const { return mNodeIds.empty(); }
+
+    /// Returns the number of labels updated by redistributions so far.
+    size_t getNumRelabeled() const { return mNumRelabeled; }
+
+private:
+    NodeId lookup(Location* loc) const
+    {
+        auto it = mNodeIds.find(loc);
+        assert(it != mNodeIds.end() && "The location must be present in the topological order!");
+        return it->second;
+    }
+
+    void relabel(NodeId prev, NodeId next, size_t numInserted);
+
+private:
+    std::vector<Node> mNodes;
+    llvm::DenseMap<Location*, NodeId> mNodeIds;
+    size_t mNumRelabeled = 0;
+};
+
+} // end namespace gazer
+
+#endif
@@ -24,18 +24,50 @@
 
 #include "gazer/Automaton/Cfa.h"
 
+#include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/StringRef.h>
 #include <llvm/ADT/DenseMap.h>
 
+#include <functional>
+
 namespace gazer
 {
 
 //===----------------------------------------------------------------------===//
+/// Maps the locations and variables of a cloned CFA to the ones they were
+/// cloned from.
+struct CloneOrigins
+{
+    llvm::DenseMap<Location*, Location*> locations;
+    llvm::DenseMap<Variable*, Variable*> variables;
+};
+
 /// Creates a clone of the given CFA with the given name.
 /// Note that the clone shall be shallow one: automata called by the source
-/// CFA shall be the same in the cloned one.
-Cfa* CloneAutomaton(Cfa* cfa, llvm::StringRef name);
+/// CFA shall be the same in the cloned one. If \p origins is not null, it
+/// is filled with the origin of each location and variable of the clone.
+Cfa* CloneAutomaton(Cfa* cfa, llvm::StringRef name, CloneOrigins* origins = nullptr);
 
+//===----------------------------------------------------------------------===//
+/// Restricts the verification goal of the given system to a set of error codes.
+/// Error locations with a literal error code outside of \p errorCodes are
+/// removed, so the paths leading into them become sinks. Error locations with
+/// a non-literal error code are only reachable if the code is in \p errorCodes.
+void SliceErrorLocations(AutomataSystem& system, llvm::ArrayRef<unsigned> errorCodes);
+
+//===----------------------------------------------------------------------===//
+/// Compacts \p cfa by merging chains of assign transitions and diamond-shaped
+/// branches of them into single transitions (large-block encoding). The entry,
+/// exit and error locations are always preserved, as well as the locations for
+/// which \p keep returns true. Returns the number of removed locations.
+unsigned LargeBlockEncoding(Cfa* cfa, std::function<bool(Location*)> keep = nullptr);
+
+//===----------------------------------------------------------------------===//
+/// Removes the assignments to local variables of \p cfa which are never read
+/// afterwards, then the locals which are no longer referenced. Outputs and the
+/// locals for which \p keep returns true are preserved. Returns the number of
+/// removed locals.
+unsigned EliminateDeadLocals(Cfa* cfa, std::function<bool(Variable*)> keep = nullptr);
 
 //===----------------------------------------------------------------------===//
 struct RecursiveToCyclicResult
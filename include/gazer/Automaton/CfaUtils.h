@@ -19,6 +19,7 @@
 #define GAZER_AUTOMATON_CFAUTILS_H
 
 #include "gazer/Automaton/Cfa.h"
+#include "gazer/Automaton/CfaTopoOrder.h"
 
 #include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/PostOrderIterator.h>
@@ -49,9 +50,8 @@ class PathConditionCalculator
 {
 public:
     PathConditionCalculator(
-        const std::vector<Location*>& topo,
+        const CfaTopoOrder& topo,
         ExprBuilder& builder,
-        std::function<size_t(Location*)> index,
         std::function<ExprPtr(CallTransition*)> calls,
         std::function<void(Location*, ExprPtr)> preds = nullptr
     );
@@ -60,12 +60,10 @@ public:
     ExprPtr encode(Location* source, Location* target);
 
 private:
-    const std::vector<Location*>& mTopo;
+    const CfaTopoOrder& mTopo;
     ExprBuilder& mExprBuilder;
-    std::function<size_t(Location*)> mIndex;
     std::function<ExprPtr(CallTransition*)> mCalls;
     std::function<void(Location*, ExprPtr)> mPredecessors;
-    unsigned mPredIdx = 0;
 };
 
 /// Returns the lowest common dominator of each transition in \p targets.
@@ -28,4 +28,8 @@
 
 #define GAZER_VERSION_STRING "${PACKAGE_VERSION}"
 
+#cmakedefine GAZER_HAS_CLANG_LIBRARIES
+
+#cmakedefine GAZER_CLANG_RESOURCE_DIR "${GAZER_CLANG_RESOURCE_DIR}"
+
 #endif
\ No newline at end of file
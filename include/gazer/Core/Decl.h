@@ -53,12 +53,20 @@ protected:
 // Variables
 //===----------------------------------------------------------------------===//
 
+/// Represents a variable of a given type.
+///
+/// Each variable has a unique, dense integer identifier within its context,
+/// which may be used to index side tables. Named variables are registered
+/// in the context's symbol table. Fresh variables are anonymous: their name
+/// is only built when requested, from a prefix or the name of the variable
+/// they were derived from, and their identifier.
 class Variable final : public Decl
 {
     friend class GazerContext;
     friend class GazerContextImpl;
 
-    Variable(llvm::StringRef name, Type& type);
+    Variable(unsigned id, llvm::StringRef name, Type& type);
+    Variable(unsigned id, llvm::StringRef prefix, const Variable* base, Type& type);
 public:
     Variable(const Variable&) = delete;
     Variable& operator=(const Variable&) = delete;
@@ -66,14 +74,27 @@ public:
     bool operator==(const Variable& other) const;
     bool operator!=(const Variable& other) const { return !operator==(other); }
 
-    std::string getName() const { return mName; }
+    unsigned getId() const { return mId; }
+    bool isFresh() const { return mIsFresh; }
+
+    /// Returns the name of this variable. For fresh variables,
+    /// the name is materialized on each call.
+    std::string getName() const;
+
     Type& getType() const { return mType; }
     ExprRef<VarRefExpr> getRefExpr() const { return mExpr; }
 
     [[nodiscard]] GazerContext& getContext() const { return mType.getContext(); }
 
 private:
+    unsigned mId;
+    bool mIsFresh;
     std::string mName;
+
+    // The name of a fresh variable is built from these fields.
+    llvm::StringRef mPrefix;
+    const Variable* mBase = nullptr;
+
     ExprRef<VarRefExpr> mExpr;
 };
 
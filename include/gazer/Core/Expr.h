@@ -28,6 +28,7 @@
 #include "gazer/Core/Decl.h"
 #include "gazer/Core/ExprRef.h"
 
+#include <llvm/ADT/DenseMapInfo.h>
 #include <llvm/ADT/StringRef.h>
 
 #include <boost/intrusive_ptr.hpp>
@@ -167,6 +168,11 @@ public:
     /// Calculates a hash code for this expression.
     std::size_t getHashCode() const;
 
+    /// Returns the identifier of this expression. Identifiers are assigned
+    /// in creation order and are unique within a context, thus, unlike
+    /// addresses, they give an ordering which is stable between runs.
+    unsigned getId() const { return mId; }
+
     virtual void print(llvm::raw_ostream& os) const = 0;
     virtual ~Expr() = default;
 
@@ -192,6 +198,7 @@ protected:
 
 private:
     mutable unsigned mRefCount;
+    unsigned mId = 0;
     Expr* mNextPtr = nullptr;
     mutable size_t mHashCode = 0;
 };
@@ -214,6 +221,16 @@ inline ExprRef<ToT> dyn_expr_cast(const ExprRef<FromT>& value) {
     return llvm::isa<ToT>(value.get()) ? boost::static_pointer_cast<ToT>(value) : nullptr;
 }
 
+template<class ToT, class FromT>
+inline ExprView<ToT> expr_cast(ExprView<FromT> value) {
+    return ExprView<ToT>(llvm::cast<ToT>(value.get()));
+}
+
+template<class ToT, class FromT>
+inline ExprView<ToT> dyn_expr_cast(ExprView<FromT> value) {
+    return ExprView<ToT>(llvm::dyn_cast<ToT>(value.get()));
+}
+
 llvm::raw_ostream& operator<<(llvm::raw_ostream& os, const Expr& expr);
 
 /// Expression base class for atomic expression values.
@@ -336,6 +353,34 @@ struct simplify_type<const gazer::ExprRef<T>> {
     static SimpleType getSimplifiedValue(const gazer::ExprRef<T> &Val) { return Val.get(); }
 };
 
+template<class T>
+struct simplify_type<gazer::ExprView<T>> {
+    typedef T* SimpleType;
+    static SimpleType getSimplifiedValue(gazer::ExprView<T> &Val) { return Val.get(); }
+};
+
+template<class T>
+struct simplify_type<const gazer::ExprView<T>> {
+    typedef T* SimpleType;
+    static SimpleType getSimplifiedValue(const gazer::ExprView<T> &Val) { return Val.get(); }
+};
+
+template<class T>
+struct DenseMapInfo<gazer::ExprView<T>> {
+    static gazer::ExprView<T> getEmptyKey() {
+        return gazer::ExprView<T>(DenseMapInfo<T*>::getEmptyKey());
+    }
+    static gazer::ExprView<T> getTombstoneKey() {
+        return gazer::ExprView<T>(DenseMapInfo<T*>::getTombstoneKey());
+    }
+    static unsigned getHashValue(gazer::ExprView<T> view) {
+        return DenseMapInfo<T*>::getHashValue(view.get());
+    }
+    static bool isEqual(gazer::ExprView<T> lhs, gazer::ExprView<T> rhs) {
+        return lhs == rhs;
+    }
+};
+
 } // end namespace llvm
 
 #if BOOST_VERSION < 107400
@@ -362,4 +407,17 @@ struct hash<gazer::ExprRef<T>>
 } // end namespace std
 #endif
 
+namespace std
+{
+
+template<class T>
+struct hash<gazer::ExprView<T>>
+{
+    size_t operator()(gazer::ExprView<T> expr) const {
+        return std::hash<T*>{}(expr.get());
+    }
+};
+
+} // end namespace std
+
 #endif
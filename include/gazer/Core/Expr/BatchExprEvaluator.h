@@ -0,0 +1,105 @@
+//==- BatchExprEvaluator.h - Multi-valuation evaluation ---------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares an evaluator which computes the value of an
+/// expression under many valuations at once.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_CORE_EXPR_BATCHEXPREVALUATOR_H
+#define GAZER_CORE_EXPR_BATCHEXPREVALUATOR_H
+
+#include "gazer/Core/Expr.h"
+
+#include <llvm/ADT/ArrayRef.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gazer
+{
+
+/// Evaluates an expression under a batch of valuations.
+///
+/// The valuations are passed in a column-major buffer: the values of the
+/// i-th variable in all N valuations (lanes) form the contiguous column
+/// [i * N, (i + 1) * N). Booleans are stored as 0 or 1, bit-vectors as their
+/// zero-extended value. Only booleans and bit-vectors of at most 64 bits are
+/// supported, bit-vector division by zero and out-of-range shifts follow the
+/// SMT-LIB semantics.
+///
+/// The expression is flattened into a sequence of lane-wise operations when
+/// the evaluator is created. Evaluation runs these operations over blocks of
+/// lanes in simple loops which the compiler vectorizes, and does not create
+/// any expressions, thus it may be used concurrently by multiple threads
+/// if each thread owns its evaluator.
+class BatchExprEvaluator
+{
+    struct Instruction
+    {
+        Expr::ExprKind kind;
+        unsigned width;
+        unsigned operandWidth;
+        unsigned offset;
+        unsigned result;
+        unsigned operands[3];
+    };
+
+public:
+    /// The number of lanes evaluated at once by each operation.
+    static constexpr size_t BlockSize = 256;
+
+    /// Creates an evaluator for \p expr over the columns of \p variables.
+    /// Returns nullptr if the expression contains unsupported types,
+    /// operators or variables not present in \p variables.
+    static std::unique_ptr<BatchExprEvaluator> Create(
+        const ExprPtr& expr, llvm::ArrayRef<Variable*> variables
+    );
+
+    /// Evaluates the expression over \p numLanes valuations. The buffer
+    /// \p columns must contain a column of \p numLanes values for each
+    /// variable given to Create(), the results are written into \p result.
+    void evaluate(llvm::ArrayRef<uint64_t> columns, size_t numLanes, llvm::MutableArrayRef<uint64_t> result);
+
+    size_t getNumVariables() const { return mNumVariables; }
+    size_t getNumInstructions() const { return mInstructions.size(); }
+
+private:
+    BatchExprEvaluator(
+        size_t numVariables, llvm::ArrayRef<uint64_t> constants,
+        std::vector<Instruction> instructions, size_t numRegisters, unsigned resultSlot
+    );
+
+    void execute(const Instruction& inst, size_t numLanes);
+
+private:
+    size_t mNumVariables;
+    size_t mFirstRegister;
+    std::vector<Instruction> mInstructions;
+    unsigned mResultSlot;
+
+    // Slots are numbered as variables, then constants, then registers.
+    // Before each block, mSlots points to the current block of each slot.
+    std::vector<const uint64_t*> mSlots;
+    std::vector<uint64_t> mConstantBlocks;
+    std::vector<uint64_t> mRegisters;
+};
+
+} // end namespace gazer
+
+#endif
@@ -47,96 +47,96 @@ protected:
     virtual ExprRef<AtomicExpr> getVariableValue(Variable& variable) = 0;
 
 private:
-    ExprRef<AtomicExpr> visitExpr(const ExprPtr& expr);
+    ExprRef<AtomicExpr> visitExpr(ExprView<> expr);
 
     // Nullary
-    ExprRef<AtomicExpr> visitUndef(const ExprRef<UndefExpr>& expr);
-    ExprRef<AtomicExpr> visitLiteral(const ExprRef<AtomicExpr>& expr);
-    ExprRef<AtomicExpr> visitVarRef(const ExprRef<VarRefExpr>& expr);
+    ExprRef<AtomicExpr> visitUndef(ExprView<UndefExpr> expr);
+    ExprRef<AtomicExpr> visitLiteral(ExprView<AtomicExpr> expr);
+    ExprRef<AtomicExpr> visitVarRef(ExprView<VarRefExpr> expr);
 
     // Unary
-    ExprRef<AtomicExpr> visitNot(const ExprRef<NotExpr>& expr);
-    ExprRef<AtomicExpr> visitZExt(const ExprRef<ZExtExpr>& expr);
-    ExprRef<AtomicExpr> visitSExt(const ExprRef<SExtExpr>& expr);
-    ExprRef<AtomicExpr> visitExtract(const ExprRef<ExtractExpr>& expr);
-    ExprRef<AtomicExpr> visitBvConcat(const ExprRef<BvConcatExpr>& expr);
+    ExprRef<AtomicExpr> visitNot(ExprView<NotExpr> expr);
+    ExprRef<AtomicExpr> visitZExt(ExprView<ZExtExpr> expr);
+    ExprRef<AtomicExpr> visitSExt(ExprView<SExtExpr> expr);
+    ExprRef<AtomicExpr> visitExtract(ExprView<ExtractExpr> expr);
+    ExprRef<AtomicExpr> visitBvConcat(ExprView<BvConcatExpr> expr);
 
     // Binary
-    ExprRef<AtomicExpr> visitAdd(const ExprRef<AddExpr>& expr);
-    ExprRef<AtomicExpr> visitSub(const ExprRef<SubExpr>& expr);
-    ExprRef<AtomicExpr> visitMul(const ExprRef<MulExpr>& expr);
-    ExprRef<AtomicExpr> visitDiv(const ExprRef<DivExpr>& expr);
-    ExprRef<AtomicExpr> visitMod(const ExprRef<ModExpr>& expr);
-    ExprRef<AtomicExpr> visitRem(const ExprRef<RemExpr>& expr);
-
-    ExprRef<AtomicExpr> visitBvSDiv(const ExprRef<BvSDivExpr>& expr);
-    ExprRef<AtomicExpr> visitBvUDiv(const ExprRef<BvUDivExpr>& expr);
-    ExprRef<AtomicExpr> visitBvSRem(const ExprRef<BvSRemExpr>& expr);
-    ExprRef<AtomicExpr> visitBvURem(const ExprRef<BvURemExpr>& expr);
-
-    ExprRef<AtomicExpr> visitShl(const ExprRef<ShlExpr>& expr);
-    ExprRef<AtomicExpr> visitLShr(const ExprRef<LShrExpr>& expr);
-    ExprRef<AtomicExpr> visitAShr(const ExprRef<AShrExpr>& expr);
-    ExprRef<AtomicExpr> visitBvAnd(const ExprRef<BvAndExpr>& expr);
-    ExprRef<AtomicExpr> visitBvOr(const ExprRef<BvOrExpr>& expr);
-    ExprRef<AtomicExpr> visitBvXor(const ExprRef<BvXorExpr>& expr);
+    ExprRef<AtomicExpr> visitAdd(ExprView<AddExpr> expr);
+    ExprRef<AtomicExpr> visitSub(ExprView<SubExpr> expr);
+    ExprRef<AtomicExpr> visitMul(ExprView<MulExpr> expr);
+    ExprRef<AtomicExpr> visitDiv(ExprView<DivExpr> expr);
+    ExprRef<AtomicExpr> visitMod(ExprView<ModExpr> expr);
+    ExprRef<AtomicExpr> visitRem(ExprView<RemExpr> expr);
+
+    ExprRef<AtomicExpr> visitBvSDiv(ExprView<BvSDivExpr> expr);
+    ExprRef<AtomicExpr> visitBvUDiv(ExprView<BvUDivExpr> expr);
+    ExprRef<AtomicExpr> visitBvSRem(ExprView<BvSRemExpr> expr);
+    ExprRef<AtomicExpr> visitBvURem(ExprView<BvURemExpr> expr);
+
+    ExprRef<AtomicExpr> visitShl(ExprView<ShlExpr> expr);
+    ExprRef<AtomicExpr> visitLShr(ExprView<LShrExpr> expr);
+    ExprRef<AtomicExpr> visitAShr(ExprView<AShrExpr> expr);
+    ExprRef<AtomicExpr> visitBvAnd(ExprView<BvAndExpr> expr);
+    ExprRef<AtomicExpr> visitBvOr(ExprView<BvOrExpr> expr);
+    ExprRef<AtomicExpr> visitBvXor(ExprView<BvXorExpr> expr);
 
     // Logic
-    ExprRef<AtomicExpr> visitAnd(const ExprRef<AndExpr>& expr);
-    ExprRef<AtomicExpr> visitOr(const ExprRef<OrExpr>& expr);
-    ExprRef<AtomicExpr> visitImply(const ExprRef<ImplyExpr>& expr);
+    ExprRef<AtomicExpr> visitAnd(ExprView<AndExpr> expr);
+    ExprRef<AtomicExpr> visitOr(ExprView<OrExpr> expr);
+    ExprRef<AtomicExpr> visitImply(ExprView<ImplyExpr> expr);
 
     // Compare
-    ExprRef<AtomicExpr> visitEq(const ExprRef<EqExpr>& expr);
-    ExprRef<AtomicExpr> visitNotEq(const ExprRef<NotEqExpr>& expr);
+    ExprRef<AtomicExpr> visitEq(ExprView<EqExpr> expr);
+    ExprRef<AtomicExpr> visitNotEq(ExprView<NotEqExpr> expr);
 
-    ExprRef<AtomicExpr> visitLt(const ExprRef<LtExpr>& expr);
-    ExprRef<AtomicExpr> visitLtEq(const ExprRef<LtEqExpr>& expr);
-    ExprRef<AtomicExpr> visitGt(const ExprRef<GtExpr>& expr);
-    ExprRef<AtomicExpr> visitGtEq(const ExprRef<GtEqExpr>& expr);
+    ExprRef<AtomicExpr> visitLt(ExprView<LtExpr> expr);
+    ExprRef<AtomicExpr> visitLtEq(ExprView<LtEqExpr> expr);
+    ExprRef<AtomicExpr> visitGt(ExprView<GtExpr> expr);
+    ExprRef<AtomicExpr> visitGtEq(ExprView<GtEqExpr> expr);
 
-    ExprRef<AtomicExpr> visitBvSLt(const ExprRef<BvSLtExpr>& expr);
-    ExprRef<AtomicExpr> visitBvSLtEq(const ExprRef<BvSLtEqExpr>& expr);
-    ExprRef<AtomicExpr> visitBvSGt(const ExprRef<BvSGtExpr>& expr);
-    ExprRef<AtomicExpr> visitBvSGtEq(const ExprRef<BvSGtEqExpr>& expr);
+    ExprRef<AtomicExpr> visitBvSLt(ExprView<BvSLtExpr> expr);
+    ExprRef<AtomicExpr> visitBvSLtEq(ExprView<BvSLtEqExpr> expr);
+    ExprRef<AtomicExpr> visitBvSGt(ExprView<BvSGtExpr> expr);
+    ExprRef<AtomicExpr> visitBvSGtEq(ExprView<BvSGtEqExpr> expr);
 
-    ExprRef<AtomicExpr> visitBvULt(const ExprRef<BvULtExpr>& expr);
-    ExprRef<AtomicExpr> visitBvULtEq(const ExprRef<BvULtEqExpr>& expr);
-    ExprRef<AtomicExpr> visitBvUGt(const ExprRef<BvUGtExpr>& expr);
-    ExprRef<AtomicExpr> visitBvUGtEq(const ExprRef<BvUGtEqExpr>& expr);
+    ExprRef<AtomicExpr> visitBvULt(ExprView<BvULtExpr> expr);
+    ExprRef<AtomicExpr> visitBvULtEq(ExprView<BvULtEqExpr> expr);
+    ExprRef<AtomicExpr> visitBvUGt(ExprView<BvUGtExpr> expr);
+    ExprRef<AtomicExpr> visitBvUGtEq(ExprView<BvUGtEqExpr> expr);
 
     // Floating-point queries
-    ExprRef<AtomicExpr> visitFIsNan(const ExprRef<FIsNanExpr>& expr);
-    ExprRef<AtomicExpr> visitFIsInf(const ExprRef<FIsInfExpr>& expr);
+    ExprRef<AtomicExpr> visitFIsNan(ExprView<FIsNanExpr> expr);
+    ExprRef<AtomicExpr> visitFIsInf(ExprView<FIsInfExpr> expr);
 
     // Floating-point arithmetic
-    ExprRef<AtomicExpr> visitFAdd(const ExprRef<FAddExpr>& expr);
-    ExprRef<AtomicExpr> visitFSub(const ExprRef<FSubExpr>& expr);
-    ExprRef<AtomicExpr> visitFMul(const ExprRef<FMulExpr>& expr);
-    ExprRef<AtomicExpr> visitFDiv(const ExprRef<FDivExpr>& expr);
+    ExprRef<AtomicExpr> visitFAdd(ExprView<FAddExpr> expr);
+    ExprRef<AtomicExpr> visitFSub(ExprView<FSubExpr> expr);
+    ExprRef<AtomicExpr> visitFMul(ExprView<FMulExpr> expr);
+    ExprRef<AtomicExpr> visitFDiv(ExprView<FDivExpr> expr);
 
     // Floating-point compare
-    ExprRef<AtomicExpr> visitFEq(const ExprRef<FEqExpr>& expr);
-    ExprRef<AtomicExpr> visitFGt(const ExprRef<FGtExpr>& expr);
-    ExprRef<AtomicExpr> visitFGtEq(const ExprRef<FGtEqExpr>& expr);
-    ExprRef<AtomicExpr> visitFLt(const ExprRef<FLtExpr>& expr);
-    ExprRef<AtomicExpr> visitFLtEq(const ExprRef<FLtEqExpr>& expr);
+    ExprRef<AtomicExpr> visitFEq(ExprView<FEqExpr> expr);
+    ExprRef<AtomicExpr> visitFGt(ExprView<FGtExpr> expr);
+    ExprRef<AtomicExpr> visitFGtEq(ExprView<FGtEqExpr> expr);
+    ExprRef<AtomicExpr> visitFLt(ExprView<FLtExpr> expr);
+    ExprRef<AtomicExpr> visitFLtEq(ExprView<FLtEqExpr> expr);
 
 
     // Floating-point casts
-    ExprRef<AtomicExpr> visitFCast(const ExprRef<FCastExpr>& expr);
-    ExprRef<AtomicExpr> visitSignedToFp(const ExprRef<SignedToFpExpr>& expr);
-    ExprRef<AtomicExpr> visitUnsignedToFp(const ExprRef<UnsignedToFpExpr>& expr);
-    ExprRef<AtomicExpr> visitFpToSigned(const ExprRef<FpToSignedExpr>& expr);
-    ExprRef<AtomicExpr> visitFpToUnsigned(const ExprRef<FpToUnsignedExpr>& expr);
-    ExprRef<AtomicExpr> visitFpToBv(const ExprRef<FpToBvExpr>& expr);
-    ExprRef<AtomicExpr> visitBvToFp(const ExprRef<BvToFpExpr>& expr);
+    ExprRef<AtomicExpr> visitFCast(ExprView<FCastExpr> expr);
+    ExprRef<AtomicExpr> visitSignedToFp(ExprView<SignedToFpExpr> expr);
+    ExprRef<AtomicExpr> visitUnsignedToFp(ExprView<UnsignedToFpExpr> expr);
+    ExprRef<AtomicExpr> visitFpToSigned(ExprView<FpToSignedExpr> expr);
+    ExprRef<AtomicExpr> visitFpToUnsigned(ExprView<FpToUnsignedExpr> expr);
+    ExprRef<AtomicExpr> visitFpToBv(ExprView<FpToBvExpr> expr);
+    ExprRef<AtomicExpr> visitBvToFp(ExprView<BvToFpExpr> expr);
 
     // Ternary
-    ExprRef<AtomicExpr> visitSelect(const ExprRef<SelectExpr>& expr);
+    ExprRef<AtomicExpr> visitSelect(ExprView<SelectExpr> expr);
     // Arrays
-    ExprRef<AtomicExpr> visitArrayRead(const ExprRef<ArrayReadExpr>& expr);
-    ExprRef<AtomicExpr> visitArrayWrite(const ExprRef<ArrayWriteExpr>& expr);
+    ExprRef<AtomicExpr> visitArrayRead(ExprView<ArrayReadExpr> expr);
+    ExprRef<AtomicExpr> visitArrayWrite(ExprView<ArrayWriteExpr> expr);
 };
 
 /// Evaluates expressions based on a Valuation object
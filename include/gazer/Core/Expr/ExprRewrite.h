@@ -32,7 +32,7 @@ protected:
         : mExprBuilder(builder)
     {}
 
-    ExprPtr rewriteNonNullary(const ExprRef<NonNullaryExpr>& expr, const ExprVector& ops);
+    ExprPtr rewriteNonNullary(ExprView<NonNullaryExpr> expr, const ExprVector& ops);
 protected:
     ExprBuilder& mExprBuilder;
 };
@@ -48,9 +48,9 @@ public:
     {}
 
 protected:
-    ExprPtr visitExpr(const ExprPtr& expr) { return expr; }
+    ExprPtr visitExpr(ExprView<> expr) { return expr.ref(); }
 
-    ExprPtr visitNonNullary(const ExprRef<NonNullaryExpr>& expr)
+    ExprPtr visitNonNullary(ExprView<NonNullaryExpr> expr)
     {
         ExprVector ops(expr->getNumOperands(), nullptr);
         for (size_t i = 0; i < expr->getNumOperands(); ++i) {
@@ -74,7 +74,7 @@ public:
     ExprPtr& operator[](Variable* variable);
 
 protected:
-    ExprPtr visitVarRef(const ExprRef<VarRefExpr>& expr);
+    ExprPtr visitVarRef(ExprView<VarRefExpr> expr);
 
 private:
     llvm::DenseMap<Variable*, ExprPtr> mRewriteMap;
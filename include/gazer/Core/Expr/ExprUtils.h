@@ -25,6 +25,11 @@ namespace gazer
 
 unsigned ExprDepth(const ExprPtr& expr);
 
+/// Returns true if the shared DAG of \p expr has at most \p maxNodes distinct
+/// nodes and a depth of at most \p maxDepth. The traversal stops as soon as
+/// either limit is exceeded.
+bool ExprFitsInBudget(const ExprPtr& expr, unsigned maxNodes, unsigned maxDepth);
+
 void FormatPrintExpr(const ExprPtr& expr, llvm::raw_ostream& os);
 
 void InfixPrintExpr(const ExprPtr& expr, llvm::raw_ostream& os, unsigned bvRadix = 10);
@@ -42,6 +42,14 @@ namespace gazer
 /// handleResult() functions. The former should return true if the cache
 /// was hit and set the found value. The latter should be used to insert
 /// new entries into the cache.
+///
+/// The walker does not take ownership of the visited nodes: each of them is
+/// kept alive by the expression passed to walk(). Therefore all hooks receive
+/// borrowed ExprView handles, so that the traversal does not update reference
+/// counters. Derived classes may still declare their hooks with owning ExprRef
+/// parameters, in which case a reference is taken for each call. Views must
+/// be converted into owning references if they escape the walk, e.g. when
+/// they are returned or stored in a cache outliving the walked expression.
 /// 
 /// \tparam DerivedT A Curiously Recurring Template Pattern (CRTP) parameter of
 ///     the derived class.
@@ -58,14 +66,14 @@ class ExprWalker
 
     struct Frame
     {
-        ExprPtr mExpr;
+        ExprView<> mExpr;
         size_t mIndex;
         Frame* mParent = nullptr;
         size_t mState = 0;
         llvm::SmallVector<ReturnT, 2> mVisitedOps;
 
-        Frame(ExprPtr expr, size_t index, Frame* parent)
-            : mExpr(std::move(expr)),
+        Frame(ExprView<> expr, size_t index, Frame* parent)
+            : mExpr(expr),
             mIndex(index),
             mParent(parent),
             mVisitedOps(
@@ -79,7 +87,7 @@ class ExprWalker
         }
     };
 private:
-    Frame* createFrame(const ExprPtr& expr, size_t idx, Frame* parent)
+    Frame* createFrame(ExprView<> expr, size_t idx, Frame* parent)
     {
         size_t siz = sizeof(Frame);
         void* ptr = mAllocator.Allocate(siz, alignof(Frame));
@@ -146,7 +154,8 @@ public:
             auto nn = llvm::cast<NonNullaryExpr>(current->mExpr);
             size_t i = current->mState;
 
-            auto frame = createFrame(nn->getOperand(i), i, current);
+            // The operand is kept alive by its parent, borrow it.
+            auto frame = createFrame(nn->op_begin()[i], i, current);
             mTop = frame;
             current->mState++;
         }
@@ -155,8 +164,9 @@ public:
     }
 
 protected:
-    /// Returns the operand of index \p i in the topmost frame.
-    [[nodiscard]] ReturnT getOperand(size_t i) const
+    /// Returns the operand of index \p i in the topmost frame. The reference
+    /// is only valid until the current visit returns.
+    [[nodiscard]] const ReturnT& getOperand(size_t i) const
     {
         assert(mTop != nullptr);
         assert(i < mTop->mVisitedOps.size());
@@ -166,18 +176,18 @@ protected:
 public:
     /// If this function returns true, the walker will not visit \p expr
     /// and will use the value contained in \p ret.
-    bool shouldSkip(const ExprPtr& expr, ReturnT* ret) { return false; }
+    bool shouldSkip(ExprView<> expr, ReturnT* ret) { return false; }
 
     /// This function is called by the walker if an actual visit took place
     /// for \p expr. The visit result is contained in \p ret.
-    void handleResult(const ExprPtr& expr, ReturnT& ret) {}
+    void handleResult(ExprView<> expr, ReturnT& ret) {}
 
-    ReturnT doVisit(const ExprPtr& expr)
+    ReturnT doVisit(ExprView<> expr)
     {
         #define GAZER_EXPR_KIND(KIND)                                       \
             case Expr::KIND:                                                \
                 return static_cast<DerivedT*>(this)->visit##KIND(           \
-                    llvm::cast<KIND##Expr>(expr)                            \
+                    expr_cast<KIND##Expr>(expr)                             \
                 );                                                          \
 
         switch (expr->getKind()) {
@@ -189,18 +199,18 @@ public:
         #undef GAZER_EXPR_KIND
     }
 
-    void visitExpr(const ExprPtr& expr) {}
+    void visitExpr(ExprView<> expr) {}
 
-    ReturnT visitNonNullary(const ExprRef<NonNullaryExpr>& expr) {
+    ReturnT visitNonNullary(ExprView<NonNullaryExpr> expr) {
         return static_cast<DerivedT*>(this)->visitExpr(expr);
     }
 
     // Nullary
-    ReturnT visitUndef(const ExprRef<UndefExpr>& expr) {
+    ReturnT visitUndef(ExprView<UndefExpr> expr) {
         return static_cast<DerivedT*>(this)->visitExpr(expr);
     }
 
-    ReturnT visitLiteral(const ExprRef<LiteralExpr>& expr)
+    ReturnT visitLiteral(ExprView<LiteralExpr> expr)
     {
         // Disambiguate here for each literal type
         #define EXPR_LITERAL_CASE(TYPE)                                         \
@@ -226,240 +236,240 @@ public:
         llvm_unreachable("Unknown literal expression kind!");
     }
 
-    ReturnT visitVarRef(const ExprRef<VarRefExpr>& expr) {
+    ReturnT visitVarRef(ExprView<VarRefExpr> expr) {
         return static_cast<DerivedT*>(this)->visitExpr(expr);
     }
 
     // Literals
-    ReturnT visitBoolLiteral(const ExprRef<BoolLiteralExpr>& expr) {
+    ReturnT visitBoolLiteral(ExprView<BoolLiteralExpr> expr) {
         return static_cast<DerivedT*>(this)->visitExpr(expr);
     }
-    ReturnT visitIntLiteral(const ExprRef<IntLiteralExpr>& expr) {
+    ReturnT visitIntLiteral(ExprView<IntLiteralExpr> expr) {
         return static_cast<DerivedT*>(this)->visitExpr(expr);
     }
-    ReturnT visitRealLiteral(const ExprRef<RealLiteralExpr>& expr) {
+    ReturnT visitRealLiteral(ExprView<RealLiteralExpr> expr) {
         return static_cast<DerivedT*>(this)->visitExpr(expr);
     }
-    ReturnT visitBvLiteral(const ExprRef<BvLiteralExpr>& expr) {
+    ReturnT visitBvLiteral(ExprView<BvLiteralExpr> expr) {
         return static_cast<DerivedT*>(this)->visitExpr(expr);
     }
-    ReturnT visitFloatLiteral(const ExprRef<FloatLiteralExpr>& expr) {
+    ReturnT visitFloatLiteral(ExprView<FloatLiteralExpr> expr) {
         return static_cast<DerivedT*>(this)->visitExpr(expr);
     }
-    ReturnT visitArrayLiteral(const ExprRef<ArrayLiteralExpr>& expr) {
+    ReturnT visitArrayLiteral(ExprView<ArrayLiteralExpr> expr) {
         return static_cast<DerivedT*>(this)->visitExpr(expr);
     }
 
     // Unary
-    ReturnT visitNot(const ExprRef<NotExpr>& expr) {
+    ReturnT visitNot(ExprView<NotExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitZExt(const ExprRef<ZExtExpr>& expr) {
+    ReturnT visitZExt(ExprView<ZExtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitSExt(const ExprRef<SExtExpr>& expr) {
+    ReturnT visitSExt(ExprView<SExtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitExtract(const ExprRef<ExtractExpr>& expr) {
+    ReturnT visitExtract(ExprView<ExtractExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
     // Binary
-    ReturnT visitAdd(const ExprRef<AddExpr>& expr) {
+    ReturnT visitAdd(ExprView<AddExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitSub(const ExprRef<SubExpr>& expr) {
+    ReturnT visitSub(ExprView<SubExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitMul(const ExprRef<MulExpr>& expr) {
+    ReturnT visitMul(ExprView<MulExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitDiv(const ExprRef<DivExpr>& expr) {
+    ReturnT visitDiv(ExprView<DivExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitMod(const ExprRef<ModExpr>& expr) {
+    ReturnT visitMod(ExprView<ModExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitRem(const ExprRef<RemExpr>& expr) {
+    ReturnT visitRem(ExprView<RemExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
-    ReturnT visitBvSDiv(const ExprRef<BvSDivExpr>& expr) {
+    ReturnT visitBvSDiv(ExprView<BvSDivExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvUDiv(const ExprRef<BvUDivExpr>& expr) {
+    ReturnT visitBvUDiv(ExprView<BvUDivExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvSRem(const ExprRef<BvSRemExpr>& expr) {
+    ReturnT visitBvSRem(ExprView<BvSRemExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvURem(const ExprRef<BvURemExpr>& expr) {
+    ReturnT visitBvURem(ExprView<BvURemExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
-    ReturnT visitShl(const ExprRef<ShlExpr>& expr) {
+    ReturnT visitShl(ExprView<ShlExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitLShr(const ExprRef<LShrExpr>& expr) {
+    ReturnT visitLShr(ExprView<LShrExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitAShr(const ExprRef<AShrExpr>& expr) {
+    ReturnT visitAShr(ExprView<AShrExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvAnd(const ExprRef<BvAndExpr>& expr) {
+    ReturnT visitBvAnd(ExprView<BvAndExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvOr(const ExprRef<BvOrExpr>& expr) {
+    ReturnT visitBvOr(ExprView<BvOrExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvXor(const ExprRef<BvXorExpr>& expr) {
+    ReturnT visitBvXor(ExprView<BvXorExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvConcat(const ExprRef<BvConcatExpr>& expr) {
+    ReturnT visitBvConcat(ExprView<BvConcatExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
     // Logic
-    ReturnT visitAnd(const ExprRef<AndExpr>& expr) {
+    ReturnT visitAnd(ExprView<AndExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitOr(const ExprRef<OrExpr>& expr) {
+    ReturnT visitOr(ExprView<OrExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitImply(const ExprRef<ImplyExpr>& expr) {
+    ReturnT visitImply(ExprView<ImplyExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
     // Compare
-    ReturnT visitEq(const ExprRef<EqExpr>& expr) {
+    ReturnT visitEq(ExprView<EqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitNotEq(const ExprRef<NotEqExpr>& expr) {
+    ReturnT visitNotEq(ExprView<NotEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
-    ReturnT visitLt(const ExprRef<LtExpr>& expr) {
+    ReturnT visitLt(ExprView<LtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitLtEq(const ExprRef<LtEqExpr>& expr) {
+    ReturnT visitLtEq(ExprView<LtEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitGt(const ExprRef<GtExpr>& expr) {
+    ReturnT visitGt(ExprView<GtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitGtEq(const ExprRef<GtEqExpr>& expr) {
+    ReturnT visitGtEq(ExprView<GtEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
     
-    ReturnT visitBvSLt(const ExprRef<BvSLtExpr>& expr) {
+    ReturnT visitBvSLt(ExprView<BvSLtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvSLtEq(const ExprRef<BvSLtEqExpr>& expr) {
+    ReturnT visitBvSLtEq(ExprView<BvSLtEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvSGt(const ExprRef<BvSGtExpr>& expr) {
+    ReturnT visitBvSGt(ExprView<BvSGtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvSGtEq(const ExprRef<BvSGtEqExpr>& expr) {
+    ReturnT visitBvSGtEq(ExprView<BvSGtEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
-    ReturnT visitBvULt(const ExprRef<BvULtExpr>& expr) {
+    ReturnT visitBvULt(ExprView<BvULtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvULtEq(const ExprRef<BvULtEqExpr>& expr) {
+    ReturnT visitBvULtEq(ExprView<BvULtEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvUGt(const ExprRef<BvUGtExpr>& expr) {
+    ReturnT visitBvUGt(ExprView<BvUGtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvUGtEq(const ExprRef<BvUGtEqExpr>& expr) {
+    ReturnT visitBvUGtEq(ExprView<BvUGtEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
     // Floating-point queries
-    ReturnT visitFIsNan(const ExprRef<FIsNanExpr>& expr) {
+    ReturnT visitFIsNan(ExprView<FIsNanExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFIsInf(const ExprRef<FIsInfExpr>& expr) {
+    ReturnT visitFIsInf(ExprView<FIsInfExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
     // Floating-point casts
-    ReturnT visitFCast(const ExprRef<FCastExpr>& expr) {
+    ReturnT visitFCast(ExprView<FCastExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
-    ReturnT visitSignedToFp(const ExprRef<SignedToFpExpr>& expr) {
+    ReturnT visitSignedToFp(ExprView<SignedToFpExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitUnsignedToFp(const ExprRef<UnsignedToFpExpr>& expr) {
+    ReturnT visitUnsignedToFp(ExprView<UnsignedToFpExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFpToSigned(const ExprRef<FpToSignedExpr>& expr) {
+    ReturnT visitFpToSigned(ExprView<FpToSignedExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFpToUnsigned(const ExprRef<FpToUnsignedExpr>& expr) {
+    ReturnT visitFpToUnsigned(ExprView<FpToUnsignedExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
-    ReturnT visitFpToBv(const ExprRef<FpToBvExpr>& expr) {
+    ReturnT visitFpToBv(ExprView<FpToBvExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitBvToFp(const ExprRef<BvToFpExpr>& expr) {
+    ReturnT visitBvToFp(ExprView<BvToFpExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
     // Floating-point arithmetic
-    ReturnT visitFAdd(const ExprRef<FAddExpr>& expr) {
+    ReturnT visitFAdd(ExprView<FAddExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFSub(const ExprRef<FSubExpr>& expr) {
+    ReturnT visitFSub(ExprView<FSubExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFMul(const ExprRef<FMulExpr>& expr) {
+    ReturnT visitFMul(ExprView<FMulExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFDiv(const ExprRef<FDivExpr>& expr) {
+    ReturnT visitFDiv(ExprView<FDivExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
     // Floating-point compare
-    ReturnT visitFEq(const ExprRef<FEqExpr>& expr) {
+    ReturnT visitFEq(ExprView<FEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFGt(const ExprRef<FGtExpr>& expr) {
+    ReturnT visitFGt(ExprView<FGtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFGtEq(const ExprRef<FGtEqExpr>& expr) {
+    ReturnT visitFGtEq(ExprView<FGtEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFLt(const ExprRef<FLtExpr>& expr) {
+    ReturnT visitFLt(ExprView<FLtExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
-    ReturnT visitFLtEq(const ExprRef<FLtEqExpr>& expr) {
+    ReturnT visitFLtEq(ExprView<FLtEqExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
     // Ternary
-    ReturnT visitSelect(const ExprRef<SelectExpr>& expr) {
+    ReturnT visitSelect(ExprView<SelectExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
     // Arrays
-    ReturnT visitArrayRead(const ExprRef<ArrayReadExpr>& expr) {
+    ReturnT visitArrayRead(ExprView<ArrayReadExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
-    ReturnT visitArrayWrite(const ExprRef<ArrayWriteExpr>& expr) {
+    ReturnT visitArrayWrite(ExprView<ArrayWriteExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
-    ReturnT visitTupleSelect(const ExprRef<TupleSelectExpr>& expr) {
+    ReturnT visitTupleSelect(ExprView<TupleSelectExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 
-    ReturnT visitTupleConstruct(const ExprRef<TupleConstructExpr>& expr) {
+    ReturnT visitTupleConstruct(ExprView<TupleConstructExpr> expr) {
         return static_cast<DerivedT*>(this)->visitNonNullary(expr);
     }
 };
@@ -16,7 +16,8 @@
 //
 //===----------------------------------------------------------------------===//
 //
-/// \file This file contains a forward declaration for Expr and ExprRef.
+/// \file This file contains a forward declaration for Expr and the
+/// expression handle types ExprRef and ExprView.
 //
 //===----------------------------------------------------------------------===//
 #ifndef GAZER_CORE_EXPRREF_H
@@ -24,6 +25,9 @@
 
 #include <boost/intrusive_ptr.hpp>
 
+#include <cstddef>
+#include <type_traits>
+
 namespace gazer
 {
 
@@ -32,6 +36,68 @@ class Expr;
 template<class T = Expr> using ExprRef = boost::intrusive_ptr<T>;
 using ExprPtr = ExprRef<Expr>;
 
+/// A borrowed, non-owning handle to an expression.
+///
+/// Copying an ExprRef updates the reference counter of the expression, which
+/// is a considerable cost in traversals touching every node. Views do not
+/// own the expression, thus they are trivially copyable, but they must not
+/// outlive the owning reference they were created from. To catch the most
+/// common misuse at compile time, a view cannot be created from a temporary
+/// ExprRef. Owning references are only taken by calling ref() or converting
+/// the view into an ExprRef, which should be done when an expression escapes
+/// the scope of its owner, e.g. when it is stored in a container or returned.
+template<class T = Expr>
+class ExprView
+{
+    template<class U>
+    using EnableIfConvertible = std::enable_if_t<std::is_convertible_v<U*, T*>>;
+public:
+    ExprView() = default;
+    ExprView(std::nullptr_t) {}
+
+    /// Borrows \p ptr, which must be kept alive by some owning reference.
+    explicit ExprView(T* ptr)
+        : mPtr(ptr)
+    {}
+
+    template<class U, class = EnableIfConvertible<U>>
+    ExprView(const ExprRef<U>& ref)
+        : mPtr(ref.get())
+    {}
+
+    /// Temporaries die at the end of the full expression, views borrowing
+    /// them would dangle.
+    template<class U, class = EnableIfConvertible<U>>
+    ExprView(ExprRef<U>&& ref) = delete;
+
+    template<class U, class = EnableIfConvertible<U>>
+    ExprView(ExprView<U> other)
+        : mPtr(other.get())
+    {}
+
+    T* get() const { return mPtr; }
+    T* operator->() const { return mPtr; }
+    T& operator*() const { return *mPtr; }
+    explicit operator bool() const { return mPtr != nullptr; }
+
+    /// Takes an owning reference to the viewed expression.
+    ExprRef<T> ref() const { return ExprRef<T>(mPtr); }
+
+    template<class U, class = std::enable_if_t<std::is_convertible_v<T*, U*>>>
+    operator ExprRef<U>() const { return ExprRef<U>(mPtr); }
+
+    template<class U>
+    bool operator==(ExprView<U> other) const { return mPtr == other.get(); }
+    template<class U>
+    bool operator!=(ExprView<U> other) const { return mPtr != other.get(); }
+
+    bool operator==(std::nullptr_t) const { return mPtr == nullptr; }
+    bool operator!=(std::nullptr_t) const { return mPtr != nullptr; }
+
+private:
+    T* mPtr = nullptr;
+};
+
 }
 
 #endif
\ No newline at end of file
@@ -45,11 +45,43 @@ public:
     ~GazerContext();
 
 public:
+    /// Returns the variable registered with \p name, or nullptr if there is none.
     Variable *getVariable(llvm::StringRef name);
+
+    /// Creates a new variable and registers it under \p name, which must be
+    /// unique within this context. The character '#' is reserved for fresh
+    /// variables and must not appear in \p name.
     Variable *createVariable(const std::string& name, Type &type);
 
+    /// Creates an anonymous variable, which is not registered by name.
+    /// Its name is only built when requested, as "<prefix>#<id>". The prefix
+    /// is not copied, thus it must outlive this context (e.g. a literal).
+    Variable *createFreshVariable(llvm::StringRef prefix, Type& type);
+
+    /// Creates an anonymous variable derived from \p base, e.g. a copy of
+    /// a callee's local in an inlined call. Its name is built on request
+    /// as "<base name>#<id>".
+    Variable *createFreshVariable(const Variable* base, Type& type);
+
+    /// Returns the variable with the identifier \p id, or nullptr
+    /// if it was removed.
+    Variable *getVariableById(unsigned id);
+
+    /// Returns an upper bound for the identifiers of the variables
+    /// in this context.
+    unsigned getNumVariableIds() const;
+
     void removeVariable(Variable* variable);
 
+    /// If enabled, commutative and associative expressions are created in
+    /// a canonical form: associative chains are flattened and commutative
+    /// operands are sorted, thus structurally equal terms such as (a + b) + c
+    /// and c + (b + a) share the same node. Only expressions created while
+    /// this is enabled are canonical, so it should be set before building
+    /// any expressions. Disabled by default.
+    void setExprCanonicalization(bool enabled);
+    bool isExprCanonicalizationEnabled() const;
+
     void dumpStats(llvm::raw_ostream& os) const;
 
 public:
@@ -20,6 +20,8 @@
 
 #include "gazer/Core/Expr.h"
 
+#include <llvm/ADT/ArrayRef.h>
+
 namespace gazer
 {
 
@@ -61,6 +63,21 @@ public:
     virtual SolverStatus run() = 0;
     virtual std::unique_ptr<Model> getModel() = 0;
 
+    /// Checks the satisfiability of the constraints, assuming that each
+    /// formula in \p assumptions holds. The assumptions must be boolean
+    /// variables or their negations, and only hold for this call.
+    virtual SolverStatus run(llvm::ArrayRef<ExprPtr> assumptions) = 0;
+
+    /// Returns a subset of the assumptions of the last run(assumptions) call
+    /// which is already inconsistent with the constraints. The last call must
+    /// have returned UNSAT.
+    virtual std::vector<ExprPtr> getUnsatCore() = 0;
+
+    /// Asks a running call of run() to stop as soon as possible, in which case
+    /// it returns UNKNOWN. This is the only method that may be called from
+    /// another thread. It has no effect if the solver is not running.
+    virtual void interrupt() = 0;
+
     virtual void reset() = 0;
 
     virtual void push() = 0;
@@ -85,6 +102,7 @@ class ItpSolver : public Solver
     using ItpGroupMapTy = std::unordered_map<ItpGroup, llvm::SmallVector<ExprPtr, 1>>;
 public:
     using Solver::Solver;
+    using Solver::add;
 
     void add(ItpGroup group, const ExprPtr& expr)
     {
@@ -105,7 +123,11 @@ public:
         return mGroupFormulae[group].end();
     }
 
-    /// Returns an interpolant for a given interpolation group.
+    /// Returns an interpolant for a given interpolation group: a formula
+    /// implied by the constraints of \p group, inconsistent with all other
+    /// constraints, and only referring to variables shared between the two.
+    /// The last call to run() must have returned UNSAT. Returns nullptr if
+    /// no interpolant could be computed.
     virtual ExprPtr getInterpolant(ItpGroup group) = 0;
 
 protected:
@@ -123,6 +145,12 @@ class SolverFactory
 public:
     /// Creates a new solver instance with a given symbol table.
     virtual std::unique_ptr<Solver> createSolver(GazerContext& symbols) = 0;
+
+    /// Creates a new interpolating solver instance. Returns nullptr if the
+    /// underlying solver does not support interpolation.
+    virtual std::unique_ptr<ItpSolver> createItpSolver(GazerContext& symbols) {
+        return nullptr;
+    }
 };
 
 }
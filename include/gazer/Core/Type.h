@@ -26,6 +26,7 @@
 
 #include <boost/iterator/indirect_iterator.hpp>
 
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
@@ -299,11 +300,11 @@ public:
     static typename std::enable_if<(std::is_base_of_v<Type, Tys> && ...), TupleType&>::type
     Get(Type& first, Tys&... tail)
     {
-        std::vector<Type*> subtypeList({ &first, &tail... });
+        std::array<Type*, 1 + sizeof...(Tys)> subtypeList = { &first, &tail... };
         return TupleType::Get(subtypeList);
     }
 
-    static TupleType& Get(std::vector<Type*> subtypes);
+    static TupleType& Get(llvm::ArrayRef<Type*> subtypes);
 
     static bool classof(const Type* type) {
         return type->getTypeID() == TupleTypeID;
@@ -0,0 +1,176 @@
+//==- ExprCompiler.h - Native compilation of expressions ---------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares a compiler which translates expressions into
+/// native code using LLVM's ORC JIT, for fast repeated concrete evaluation.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_JIT_EXPRCOMPILER_H
+#define GAZER_JIT_EXPRCOMPILER_H
+
+#include "gazer/Core/Expr/ExprEvaluator.h"
+#include "gazer/Core/Valuation.h"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace llvm::orc
+{
+    class LLJIT;
+    class ThreadSafeContext;
+} // end namespace llvm::orc
+
+namespace gazer
+{
+
+/// Compiles expressions into native functions.
+///
+/// Compiled expressions read the values of their variables from a flat
+/// buffer of 64-bit words. Each variable gets a slot in this buffer when it
+/// is first seen by the compiler, so the same buffer may be shared between
+/// all expressions compiled by the same instance. Values are stored in the
+/// encoding of encodeValue(): booleans as 0 or 1, bit-vectors (up to 64 bits)
+/// and floats zero-extended, integers as two's complement 64-bit words and
+/// arrays as a pointer to their literal.
+///
+/// Booleans, integers, bit-vectors of at most 64 bits, single and double
+/// precision floats (with the default rounding mode), and reads from arrays
+/// of these types are supported. Bit-vector division by zero and
+/// out-of-range shifts follow the SMT-LIB semantics, while integer results
+/// which do not fit into 64 bits are undefined. Other expressions are
+/// not compiled, and compile() returns nullptr for them. Compiled expressions
+/// are cached, so compiling an expression again is cheap. This class is not
+/// thread-safe.
+class ExprCompiler
+{
+public:
+    /// Reads an element of an array literal, see CompiledExpr.
+    using ArrayReadFn = bool(*)(uint64_t array, uint64_t index, uint64_t* result);
+    using FunctionTy = bool(*)(const uint64_t* values, uint64_t* result, ArrayReadFn readArray);
+
+    class CompiledExpr
+    {
+        friend class ExprCompiler;
+    public:
+        CompiledExpr(
+            ExprPtr expr, FunctionTy function,
+            std::vector<Variable*> variables, std::vector<unsigned> slots
+        ) : mExpr(std::move(expr)), mFunction(function),
+            mVariables(std::move(variables)), mSlots(std::move(slots))
+        {}
+
+        /// Evaluates the expression over \p values, storing the encoded
+        /// result in \p result. Returns false if the result is not defined,
+        /// e.g. because of an integer division by zero.
+        bool run(const uint64_t* values, uint64_t* result) const {
+            return mFunction(values, result, &ReadArrayElement);
+        }
+
+        const ExprPtr& getExpr() const { return mExpr; }
+
+        /// Returns the variables read by this expression.
+        llvm::ArrayRef<Variable*> getVariables() const { return mVariables; }
+
+        /// Returns the slots of the variables in getVariables().
+        llvm::ArrayRef<unsigned> getSlots() const { return mSlots; }
+
+    private:
+        static bool ReadArrayElement(uint64_t array, uint64_t index, uint64_t* result);
+
+    private:
+        ExprPtr mExpr;
+        FunctionTy mFunction;
+        std::vector<Variable*> mVariables;
+        std::vector<unsigned> mSlots;
+    };
+
+private:
+    ExprCompiler(std::unique_ptr<llvm::orc::LLJIT> jit);
+
+public:
+    /// Creates a compiler for the host machine. Returns nullptr if the
+    /// native target is not available.
+    static std::unique_ptr<ExprCompiler> Create();
+
+    ExprCompiler(const ExprCompiler&) = delete;
+    ExprCompiler& operator=(const ExprCompiler&) = delete;
+
+    ~ExprCompiler();
+
+    /// Compiles \p expr, or returns a previously compiled instance of it.
+    /// Returns nullptr if the expression is not supported.
+    const CompiledExpr* compile(const ExprPtr& expr);
+
+    /// Compiles all expressions of \p exprs at once, which is much cheaper
+    /// than compiling them one by one. The result contains the compiled
+    /// expressions in the same order, with nullptr for unsupported ones.
+    std::vector<const CompiledExpr*> compile(llvm::ArrayRef<ExprPtr> exprs);
+
+    /// Returns the slot of \p variable in the value buffer, assigning a new
+    /// one if the variable was not seen before.
+    unsigned getSlot(Variable* variable);
+
+    /// Returns the number of slots assigned so far.
+    unsigned getNumSlots() const { return mSlots.size(); }
+
+    /// Returns true if values of \p type can be stored in a slot.
+    static bool isSupportedType(Type& type);
+
+    /// Encodes a literal into a slot value. The literal must be of a
+    /// supported type, and array literals must outlive the slot value.
+    static uint64_t encodeValue(const ExprRef<LiteralExpr>& literal);
+
+    /// Builds a literal of \p type from an encoded slot value.
+    static ExprRef<LiteralExpr> decodeValue(Type& type, uint64_t value);
+
+private:
+    std::unique_ptr<llvm::orc::LLJIT> mJit;
+    std::unique_ptr<llvm::orc::ThreadSafeContext> mContext;
+
+    llvm::DenseMap<Variable*, unsigned> mSlots;
+    llvm::DenseMap<Expr*, std::unique_ptr<CompiledExpr>> mCache;
+    unsigned mNumFunctions = 0;
+};
+
+/// Evaluates expressions over a valuation using compiled code.
+///
+/// Expressions which cannot be compiled, read variables missing from the
+/// valuation, or have an undefined result are evaluated by the interpreting
+/// ValuationExprEvaluator instead, so the results are always the same.
+class CompiledExprEvaluator : public ExprEvaluator
+{
+public:
+    CompiledExprEvaluator(ExprCompiler& compiler, const Valuation& valuation)
+        : mCompiler(compiler), mValuation(valuation)
+    {}
+
+    ExprRef<AtomicExpr> evaluate(const ExprPtr& expr) override;
+
+private:
+    ExprCompiler& mCompiler;
+    const Valuation& mValuation;
+    std::vector<uint64_t> mValues;
+};
+
+} // end namespace gazer
+
+#endif
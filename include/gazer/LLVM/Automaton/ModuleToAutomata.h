@@ -25,6 +25,7 @@
 #include "gazer/LLVM/LLVMTraceBuilder.h"
 
 #include <llvm/Pass.h>
+#include <llvm/ADT/DenseSet.h>
 
 #include <variant>
 
@@ -177,6 +178,9 @@ public:
     ExprPtr getExpressionForValue(const Cfa* parent, const llvm::Value* value);
     Variable* getVariableForValue(const Cfa* parent, const llvm::Value* value);
 
+    /// Collects the variables of \p parent which represent an LLVM value.
+    void getValueVariables(const Cfa* parent, llvm::DenseSet<Variable*>& variables);
+
 private:
     llvm::DenseMap<const Location*, BlockToLocationInfo> mLocationsToBlocks;
     llvm::DenseMap<const Cfa*, ValueMappingInfo> mValueMaps;
@@ -44,8 +44,12 @@ private:
     std::set<std::string> mSanitizerFlags;
 };
 
-/// Compiles a set of C and/or LLVM bitcode files using clang, links them
-/// together with llvm-link and parses the resulting module.
+/// Compiles a set of C and/or LLVM bitcode files and links them together.
+///
+/// If gazer was built with the clang libraries, the C sources are compiled
+/// in-process on a thread pool and linked in memory. Otherwise, or if
+/// -external-clang is given, the clang and llvm-link executables are run
+/// on temporary files and the resulting module is parsed back.
 std::unique_ptr<llvm::Module> ClangCompileAndLink(
     llvm::ArrayRef<std::string> files,
     llvm::LLVMContext& llvmContext,
@@ -21,6 +21,7 @@
 #include <llvm/Pass.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/PassManager.h>
 
 namespace gazer
 {
@@ -127,6 +128,11 @@ public:
     /// after calling this method.
     void registerPasses(llvm::legacy::PassManager& pm);
 
+    /// Registers a single pass running all enabled checks into a new pass
+    /// manager pipeline. The registry keeps the ownership of the checks,
+    /// thus it must outlive the pass manager.
+    void registerPasses(llvm::ModulePassManager& pm);
+
     /// Creates a new check violation with a unique error code
     /// for a given check and location.
     /// \return An LLVM value representing the error code.
@@ -134,6 +140,12 @@ public:
 
     std::string messageForCode(unsigned ec) const;
 
+    /// Returns the check which created the violation with the given error code.
+    Check* getCheckForCode(unsigned ec) const;
+
+    /// Returns the error codes of all check violations in increasing order.
+    std::vector<unsigned> getErrorCodes() const;
+
     ~CheckRegistry();
 private:
     llvm::LLVMContext& mLlvmContext;
@@ -20,6 +20,7 @@
 
 #include <llvm/Pass.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/PassManager.h>
 
 namespace gazer
 {
@@ -33,8 +34,25 @@ public:
 
 llvm::Pass* createMarkFunctionEntriesPass();
 
+class MarkFunctionEntriesPass : public llvm::PassInfoMixin<MarkFunctionEntriesPass>
+{
+public:
+    llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager& mam);
+};
+
 llvm::Pass* createInsertLastAddressPass();
 
+/// This pass removes the error edges of instrumented checks which are
+/// proven to be unreachable using interval reasoning, before the checks
+/// are turned into error locations of the automata.
+llvm::Pass* createDischargeSafeChecksPass();
+
+class DischargeSafeChecksPass : public llvm::PassInfoMixin<DischargeSafeChecksPass>
+{
+public:
+    llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager& mam);
+};
+
 }
 
 #endif
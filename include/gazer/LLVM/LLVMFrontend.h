@@ -25,6 +25,7 @@
 
 #include <llvm/Pass.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/PassManager.h>
 #include <llvm/Support/ToolOutputFile.h>
 
 namespace gazer
@@ -101,6 +102,10 @@ public:
 class LLVMFrontend
 {
 public:
+    /// Property workers exit with this value plus the status of their result,
+    /// so that it cannot be mistaken for the usual error exit codes.
+    static constexpr int PropertyExitCodeBase = 100;
+
     LLVMFrontend(
         std::unique_ptr<llvm::Module> module,
         GazerContext& context,
@@ -124,7 +129,9 @@ public:
     /// backend algorithm, it will be run.
     void registerVerificationPipeline();
 
-    /// Registers an arbitrary pass into the pipeline.
+    /// Registers an arbitrary pass into the pipeline. Such passes are
+    /// executed after the preprocessing and translation steps of the
+    /// verification pipeline.
     void registerPass(llvm::Pass* pass);
 
     /// Sets the backend algorithm to be used in the verification process.
@@ -144,23 +151,41 @@ public:
 
     GazerContext& getContext() const { return mContext; }
     llvm::Module& getModule() const { return *mModule; }
+
+    /// Returns the result of the backend algorithm, or nullptr if it was not run.
+    VerificationResult* getResult() const { return mResult.get(); }
 private:
     //---------------------- Individual pipeline steps ---------------------//
-    void registerEnabledChecks();
+    void registerPreprocessing();
     void registerEarlyOptimizations();
     void registerLateOptimizations();
     void registerInlining();
     void registerVerificationStep();
 
+    //------------- Pipeline steps for the legacy pass manager -------------//
+    void registerLegacyPreprocessing();
+    void registerLegacyEarlyOptimizations();
+    void registerLegacyLateOptimizations();
+    void registerLegacyInlining();
+
+    void runPreprocessing();
+
 private:
     GazerContext& mContext;
     std::unique_ptr<llvm::Module> mModule;
 
     CheckRegistry mChecks;
+
+    // The preprocessing steps run on the new pass manager, then the passes
+    // depending on legacy analyses (translation, backends and registered
+    // passes) run on the legacy one.
+    llvm::ModulePassManager mPreprocessing;
+    bool mHasPreprocessing = false;
     llvm::legacy::PassManager mPassManager;
 
     LLVMFrontendSettings& mSettings;
     std::unique_ptr<VerificationAlgorithm> mBackendAlgorithm = nullptr; 
+    std::unique_ptr<VerificationResult> mResult = nullptr;
 
     std::unique_ptr<llvm::ToolOutputFile> mModuleOutput = nullptr;
 };
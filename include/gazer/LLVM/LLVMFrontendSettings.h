@@ -18,7 +18,9 @@
 #ifndef GAZER_LLVM_LLVMFRONTENDSETTINGS_H
 #define GAZER_LLVM_LLVMFRONTENDSETTINGS_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace llvm
 {
@@ -62,6 +64,7 @@ enum class ElimVarsLevel
 {
     Off,       ///< Do not try to eliminate variables
     Normal,    ///< Inline variables which have only one use
+    Budget,    ///< Inline variables while their expressions stay within a size budget
     Aggressive ///< Inline all suitable variables
 };
 
@@ -71,6 +74,13 @@ enum class MemoryModelSetting
     Flat
 };
 
+enum class PropertyDecomposition
+{
+    Off,        ///< Verify all checks at once
+    Check,      ///< Verify each check separately
+    Violation   ///< Verify each check violation separately
+};
+
 class LLVMFrontendSettings
 {
 public:
@@ -98,13 +108,29 @@ public:
 
     // Checks
     std::string checks = "";
+    bool dischargeChecks = true;
+    PropertyDecomposition decomposition = PropertyDecomposition::Off;
+    unsigned propertyJobs = 0;
+    unsigned propertyTimeout = 0;
+
+    /// The error codes checked by a property worker process, empty otherwise.
+    std::vector<unsigned> propertyCodes;
+
+    /// The command line of the tool, property workers are started with the same arguments.
+    std::vector<std::string> commandLine;
 
     // IR translation
     ElimVarsLevel elimVars = ElimVarsLevel::Off;
+    unsigned elimVarsMaxNodes = 64;
+    unsigned elimVarsMaxDepth = 16;
     LoopRepresentation loops = LoopRepresentation::Recursion;
     IntRepresentation ints = IntRepresentation::BitVectors;
     FloatRepresentation floats = FloatRepresentation::Fpa;
     bool simplifyExpr = true;
+    bool canonicalizeExpr = false;
+    bool narrowInts = true;
+    bool deadLocalElimination = true;
+    bool largeBlockEncoding = true;
     bool strict = false;
 
     std::string function = "main";
@@ -112,6 +138,9 @@ public:
     // Memory models
     bool debugDumpMemorySSA = false;
     MemoryModelSetting memoryModel = MemoryModelSetting::Flat;
+    bool compactPointers = false;
+    uint64_t globalBase = 0x00000001;
+    uint64_t stackBase  = 0x40000000;
 
 public:
     /// Returns true if the current settings can be applied to the given module.
@@ -121,6 +150,7 @@ public:
 
     bool isElimVarsOff() const { return elimVars == ElimVarsLevel::Off; }
     bool isElimVarsNormal() const { return elimVars == ElimVarsLevel::Normal; }
+    bool isElimVarsBudget() const { return elimVars == ElimVarsLevel::Budget; }
     bool isElimVarsAggressive() const { return elimVars == ElimVarsLevel::Aggressive; }
 
 public:
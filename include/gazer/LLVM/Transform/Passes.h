@@ -21,6 +21,7 @@
 #include "gazer/LLVM/LLVMFrontendSettings.h"
 
 #include <llvm/Pass.h>
+#include <llvm/IR/PassManager.h>
 
 namespace gazer
 {
@@ -41,6 +42,65 @@ llvm::Pass* createSimpleInlinerPass(llvm::Function& entry, InlineLevel level);
 
 llvm::Pass* createCanonizeLoopExitsPass();
 
+/// Narrows integer operations to the bit width they actually need, based on
+/// their demanded bits and value ranges.
+llvm::Pass* createNarrowIntegerWidthPass();
+
+//===----------------------------------------------------------------------===//
+// New pass manager versions of the passes above
+//===----------------------------------------------------------------------===//
+
+class InlineGlobalVariablesPass : public llvm::PassInfoMixin<InlineGlobalVariablesPass>
+{
+public:
+    llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager& mam);
+};
+
+class LiftErrorCallsPass : public llvm::PassInfoMixin<LiftErrorCallsPass>
+{
+public:
+    explicit LiftErrorCallsPass(llvm::Function& entry)
+        : mEntryFunction(&entry)
+    {}
+
+    llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager& mam);
+
+private:
+    llvm::Function* mEntryFunction;
+};
+
+class NormalizeVerifierCallsPass : public llvm::PassInfoMixin<NormalizeVerifierCallsPass>
+{
+public:
+    llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager& mam);
+};
+
+class SimpleInlinerPass : public llvm::PassInfoMixin<SimpleInlinerPass>
+{
+public:
+    SimpleInlinerPass(llvm::Function& entry, InlineLevel level)
+        : mEntryFunction(&entry), mLevel(level)
+    {}
+
+    llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager& mam);
+
+private:
+    llvm::Function* mEntryFunction;
+    InlineLevel mLevel;
+};
+
+class CanonizeLoopExitsPass : public llvm::PassInfoMixin<CanonizeLoopExitsPass>
+{
+public:
+    llvm::PreservedAnalyses run(llvm::Function& function, llvm::FunctionAnalysisManager& fam);
+};
+
+class NarrowIntegerWidthPass : public llvm::PassInfoMixin<NarrowIntegerWidthPass>
+{
+public:
+    llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager& mam);
+};
+
 }
 
 #endif
@@ -19,6 +19,7 @@
 #define GAZER_LLVM_TRANSFORM_UNDEFTONONDET_H
 
 #include <llvm/Pass.h>
+#include <llvm/IR/PassManager.h>
 
 namespace gazer
 {
@@ -41,6 +42,13 @@ public:
 
 llvm::Pass* createPromoteUndefsPass();
 
+/// New pass manager version of UndefToNondetCallPass.
+class PromoteUndefsPass : public llvm::PassInfoMixin<PromoteUndefsPass>
+{
+public:
+    llvm::PreservedAnalyses run(llvm::Function& function, llvm::FunctionAnalysisManager& fam);
+};
+
 }
 
 #endif
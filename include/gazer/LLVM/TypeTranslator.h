@@ -23,6 +23,7 @@
 
 #include <llvm/IR/Type.h>
 #include "llvm/IR/DerivedTypes.h"
+#include <llvm/ADT/DenseMap.h>
 
 namespace gazer
 {
@@ -37,11 +38,17 @@ public:
         : mMemoryTypes(memoryTypes), mSettings(settings)
     {}
 
+    /// Returns the gazer type of \p type. Translated types are cached,
+    /// as each instruction operand requests its type.
     gazer::Type& get(const llvm::Type* type);
 
+private:
+    gazer::Type& translate(const llvm::Type* type);
+
 protected:
     MemoryTypeTranslator& mMemoryTypes;
     const LLVMFrontendSettings& mSettings;
+    llvm::DenseMap<const llvm::Type*, gazer::Type*> mCache;
 };
 
 } // end namespace gazer
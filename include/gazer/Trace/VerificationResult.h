@@ -64,24 +64,45 @@ private:
 class FailResult final : public VerificationResult
 {
 public:
+    /// A violated property along with its error trace.
+    struct Violation
+    {
+        unsigned errorCode;
+        std::unique_ptr<Trace> trace;
+    };
+
     explicit FailResult(
         unsigned errorCode,
         std::unique_ptr<Trace> trace = nullptr
-    ) : VerificationResult(VerificationResult::Fail), mErrorID(errorCode),
-        mTrace(std::move(trace))
-    {}
+    ) : VerificationResult(VerificationResult::Fail)
+    {
+        mViolations.push_back({errorCode, std::move(trace)});
+    }
 
-    [[nodiscard]] bool hasTrace() const { return mTrace != nullptr; }
-    [[nodiscard]] Trace& getTrace() const { return *mTrace; }
-    [[nodiscard]] unsigned getErrorID() const { return mErrorID; }
+    [[nodiscard]] bool hasTrace() const { return mViolations.front().trace != nullptr; }
+    [[nodiscard]] Trace& getTrace() const { return *mViolations.front().trace; }
+    [[nodiscard]] unsigned getErrorID() const { return mViolations.front().errorCode; }
+
+    /// Returns all violations in the order they were found. The first one is
+    /// the violation returned by getErrorID() and getTrace().
+    [[nodiscard]] const std::vector<Violation>& violations() const { return mViolations; }
+
+    /// Appends the violations of \p other to this result. Engines which do not
+    /// stop at the first violation may use this to report all of them.
+    void append(FailResult&& other)
+    {
+        for (Violation& violation : other.mViolations) {
+            mViolations.push_back(std::move(violation));
+        }
+        other.mViolations.clear();
+    }
 
     static bool classof(const VerificationResult* result) {
         return result->getStatus() == VerificationResult::Fail;
     }
 
 private:
-    unsigned mErrorID;
-    std::unique_ptr<Trace> mTrace;
+    std::vector<Violation> mViolations;
 };
 
 } // end namespace gazer
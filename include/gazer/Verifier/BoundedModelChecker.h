@@ -49,6 +49,14 @@ struct BmcSettings
     unsigned maxBound;
     unsigned eagerUnroll;
     bool simplifyExpr;
+
+    /// Solve the under- and over-approximation queries of an
+    /// iteration concurrently, on separate solver instances.
+    bool parallelApprox;
+
+    /// Do not stop at the first violation: block its error code and
+    /// continue the search for violations of other checks.
+    bool allViolations;
 };
 
 class BoundedModelChecker : public VerificationAlgorithm
@@ -0,0 +1,76 @@
+//==- InterpolationModelChecker.h - IMC engine interface --------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares an unbounded, interpolation-based model checking
+/// backend, following K. L. McMillan: Interpolation and SAT-based model
+/// checking (CAV 2003).
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_VERIFIER_INTERPOLATIONMODELCHECKER_H
+#define GAZER_VERIFIER_INTERPOLATIONMODELCHECKER_H
+
+#include "gazer/Verifier/VerificationAlgorithm.h"
+
+namespace gazer
+{
+
+class SolverFactory;
+
+struct ImcSettings
+{
+    // Environment
+    bool trace;
+
+    // Debug
+    bool dumpSolverModel;
+    bool printSolverStats;
+
+    // Algorithm settings
+
+    /// The maximum length of the bounded suffix used for interpolation.
+    unsigned maxBound;
+};
+
+/// Interpolation-based model checker.
+///
+/// The main automaton is transformed into a cyclic CFA and encoded as a
+/// symbolic transition system over its variables and a program counter.
+/// Starting from the initial states, the engine repeatedly over-approximates
+/// the image of the reachable states using interpolants from k-step bounded
+/// checks, until either a fixpoint (an inductive invariant) is found or a
+/// real counterexample is hit. Spurious counterexamples increase k.
+class InterpolationModelChecker : public VerificationAlgorithm
+{
+public:
+    InterpolationModelChecker(SolverFactory& solverFactory, ImcSettings settings)
+        : mSolverFactory(solverFactory), mSettings(settings)
+    {}
+
+    std::unique_ptr<VerificationResult> check(
+        AutomataSystem& system,
+        CfaTraceBuilder& traceBuilder
+    ) override;
+
+private:
+    SolverFactory& mSolverFactory;
+    ImcSettings mSettings;
+};
+
+} // end namespace gazer
+
+#endif
@@ -0,0 +1,78 @@
+//==- KInductionModelChecker.h - k-induction engine interface ---*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares a k-induction based unbounded model checking
+/// backend.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_VERIFIER_KINDUCTIONMODELCHECKER_H
+#define GAZER_VERIFIER_KINDUCTIONMODELCHECKER_H
+
+#include "gazer/Verifier/VerificationAlgorithm.h"
+
+namespace gazer
+{
+
+class SolverFactory;
+
+struct KInductionSettings
+{
+    // Environment
+    bool trace;
+
+    // Debug
+    bool dumpSolverModel;
+    bool printSolverStats;
+
+    // Algorithm settings
+
+    /// The maximum induction depth.
+    unsigned maxBound;
+
+    /// Strengthen the step case with invariants mined from the loops.
+    bool mineInvariants;
+};
+
+/// K-induction model checker.
+///
+/// The main automaton is transformed into a cyclic CFA and encoded as a
+/// symbolic transition system. For increasing values of k, the base case
+/// (no error is reachable within k steps) and the inductive step (k+1
+/// consecutive non-error states cannot be followed by an error) are solved
+/// concurrently, on separate solver instances. The program is safe if the
+/// step case holds for a k for which the base case also holds.
+class KInductionModelChecker : public VerificationAlgorithm
+{
+public:
+    KInductionModelChecker(SolverFactory& solverFactory, KInductionSettings settings)
+        : mSolverFactory(solverFactory), mSettings(settings)
+    {}
+
+    std::unique_ptr<VerificationResult> check(
+        AutomataSystem& system,
+        CfaTraceBuilder& traceBuilder
+    ) override;
+
+private:
+    SolverFactory& mSolverFactory;
+    KInductionSettings mSettings;
+};
+
+} // end namespace gazer
+
+#endif
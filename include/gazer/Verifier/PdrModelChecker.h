@@ -0,0 +1,76 @@
+//==- PdrModelChecker.h - IC3/PDR engine interface --------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares an IC3/PDR based unbounded model checking
+/// backend.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_VERIFIER_PDRMODELCHECKER_H
+#define GAZER_VERIFIER_PDRMODELCHECKER_H
+
+#include "gazer/Verifier/VerificationAlgorithm.h"
+
+namespace gazer
+{
+
+class SolverFactory;
+
+struct PdrSettings
+{
+    // Environment
+    bool trace;
+
+    // Debug
+    bool dumpSolverModel;
+    bool printSolverStats;
+
+    // Algorithm settings
+
+    /// The maximum number of frames.
+    unsigned maxBound;
+};
+
+/// Location-based IC3/PDR model checker.
+///
+/// The main automaton is transformed into a cyclic CFA. Instead of encoding
+/// the program counter into the state, each frame holds a set of lemmas for
+/// each location, and the transitions of the CFA are checked one edge at a
+/// time. Proof obligations are blocked with incremental solver queries
+/// under assumptions, and the blocked cubes are generalized using the unsat
+/// cores of these queries. The program is safe if two consecutive frames
+/// become equal.
+class PdrModelChecker : public VerificationAlgorithm
+{
+public:
+    PdrModelChecker(SolverFactory& solverFactory, PdrSettings settings)
+        : mSolverFactory(solverFactory), mSettings(settings)
+    {}
+
+    std::unique_ptr<VerificationResult> check(
+        AutomataSystem& system,
+        CfaTraceBuilder& traceBuilder
+    ) override;
+
+private:
+    SolverFactory& mSolverFactory;
+    PdrSettings mSettings;
+};
+
+} // end namespace gazer
+
+#endif
@@ -0,0 +1,82 @@
+//==- RandomSimulation.h - Random simulation of CFAs ------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares a random simulation stage which looks for
+/// shallow bugs by executing the automata system with random inputs before
+/// handing it over to a symbolic verification engine.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_VERIFIER_RANDOMSIMULATION_H
+#define GAZER_VERIFIER_RANDOMSIMULATION_H
+
+#include "gazer/Verifier/VerificationAlgorithm.h"
+
+#include <memory>
+
+namespace gazer
+{
+
+struct SimulationSettings
+{
+    // Environment
+    bool trace;
+
+    // Algorithm settings
+
+    /// The time limit of the simulation in seconds.
+    unsigned timeLimit;
+
+    /// The number of simulation threads, 0 uses all hardware threads.
+    unsigned numThreads;
+
+    /// The maximum number of transitions taken in a single run.
+    unsigned maxSteps;
+
+    /// The seed of the random input generator.
+    unsigned seed;
+};
+
+/// Concretely executes the automata system with random and boundary values
+/// for its nondeterministic inputs, as a cheap first stage of verification.
+///
+/// The guards and assignments of the system are compiled into native code,
+/// and the runs are distributed between several threads. If a run reaches
+/// an error location, it is replayed to build a counterexample trace.
+/// Otherwise, the system is passed on to the next algorithm after the time
+/// limit is reached. Systems with values which cannot be compiled (e.g.
+/// arrays) are passed on immediately.
+class RandomSimulation : public VerificationAlgorithm
+{
+public:
+    RandomSimulation(SimulationSettings settings, std::unique_ptr<VerificationAlgorithm> next)
+        : mSettings(settings), mNext(std::move(next))
+    {}
+
+    std::unique_ptr<VerificationResult> check(
+        AutomataSystem& system,
+        CfaTraceBuilder& traceBuilder
+    ) override;
+
+private:
+    SimulationSettings mSettings;
+    std::unique_ptr<VerificationAlgorithm> mNext;
+};
+
+} // end namespace gazer
+
+#endif
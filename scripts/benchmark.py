@@ -0,0 +1,371 @@
+#!/usr/bin/env python3
+# ==- benchmark.py - End-to-end benchmark runner -------------*- python -*--===//
+#
+#  Copyright 2019 Contributors to the Gazer project
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+#
+# ===----------------------------------------------------------------------===//
+"""Runs gazer-bmc and gazer-cfa over the lit test corpus and tracks performance regressions.
+
+Tasks are discovered from the RUN lines of the lit tests: each '%bmc' or '%cfa' invocation
+becomes a benchmark run, with the expected verdict taken from the matching FileCheck lines.
+Runs are executed sequentially under fixed resource limits, and the wall time, peak memory
+usage, verdict and the statistics printed by the tools are collected into a JSON file.
+If a baseline result file is given, the results are compared against it and the script
+exits with a non-zero status if a regression is found.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import pathlib
+import re
+import resource
+import shlex
+import signal
+import statistics
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+TOOLS = {
+    'bmc': 'gazer-bmc/gazer-bmc',
+    'cfa': 'gazer-cfa/gazer-cfa',
+}
+
+# Directories which need external dependencies (e.g. theta) or other drivers.
+EXCLUDED_DIRS = ['theta', 'portfolio']
+
+RUN_PATTERN = re.compile(r'^\s*(?://|;)\s*RUN:\s*%(bmc|cfa)\s+(.*)$')
+VERDICT_PATTERN = re.compile(r'^Verification ([A-Z ]+)\.$', re.MULTILINE)
+STAT_PATTERN = re.compile(r'^(Total solver time|Number of [a-z ]+):\s*([\d.]+)\s*s?$', re.MULTILINE)
+
+# A row of LLVM's legacy timer report: a list of "time (percent%)" columns, followed by the name.
+TIMER_ROW_PATTERN = re.compile(r'^\s*((?:[\d.]+\s+\(\s*[\d.]+%\)\s+)+)(\S.*)$')
+TIMER_VALUE_PATTERN = re.compile(r'([\d.]+)\s+\(\s*[\d.]+%\)')
+
+
+class Task:
+    def __init__(self, task_id: str, tool: str, file: pathlib.Path, args, expected):
+        self.task_id = task_id
+        self.tool = tool
+        self.file = file
+        self.args = args
+        self.expected = expected
+
+
+def parse_expected_verdicts(lines, prefix: str):
+    """Returns the set of verdicts accepted by FileCheck lines with the given prefix."""
+    pattern = re.compile(r'(?://|;)\s*' + re.escape(prefix) + r':\s*Verification\s+(.*)$')
+    for line in lines:
+        match = pattern.search(line)
+        if match is None:
+            continue
+
+        # Handle simple FileCheck regexes, such as {{(SUCCESSFUL|BOUND REACHED)}}.
+        text = match.group(1).strip().rstrip('.')
+        text = text.replace('{{', '').replace('}}', '').strip('()')
+        return sorted(v.strip() for v in text.split('|'))
+
+    return None
+
+
+def parse_run_line(command: str, workdir: pathlib.Path):
+    """Splits a lit RUN command into the tool arguments and the FileCheck prefix."""
+    command, _, pipeline = command.partition('|')
+    prefix_match = re.search(r'--check-prefix[= ](\S+)', pipeline)
+    prefix = prefix_match.group(1) if prefix_match else 'CHECK'
+
+    args = []
+    for arg in shlex.split(command):
+        if arg == '%s':
+            continue
+        # Temporary files (e.g. test harnesses) are redirected into a scratch directory.
+        args.append(re.sub(r'%t', str(workdir / 't'), arg))
+
+    return args, prefix
+
+
+def discover_tasks(roots, tools, all_runs: bool, workdir: pathlib.Path, pattern):
+    tasks = []
+    for root in roots:
+        root = pathlib.Path(root)
+        files = [root] if root.is_file() else sorted(
+            f for f in root.rglob('*') if f.suffix in ('.c', '.ll')
+        )
+
+        for file in files:
+            if any(part in EXCLUDED_DIRS for part in file.parts):
+                continue
+            if pattern is not None and not re.search(pattern, str(file)):
+                continue
+
+            lines = file.read_text(errors='replace').splitlines()
+            seen_tools = set()
+            for idx, line in enumerate(lines):
+                match = RUN_PATTERN.match(line)
+                if match is None:
+                    continue
+
+                tool = match.group(1)
+                if tool not in tools or (tool in seen_tools and not all_runs):
+                    continue
+                seen_tools.add(tool)
+
+                args, prefix = parse_run_line(match.group(2), workdir)
+                expected = parse_expected_verdicts(lines, prefix) if tool == 'bmc' else None
+                task_id = '{0}:{1}'.format(file.absolute().as_posix(), idx + 1)
+                tasks.append(Task(task_id, tool, file.absolute(), args, expected))
+
+    return tasks
+
+
+def set_limits(memory_mb: int, cpu_seconds: int):
+    def apply():
+        if memory_mb > 0:
+            limit = memory_mb * 1024 * 1024
+            resource.setrlimit(resource.RLIMIT_AS, (limit, limit))
+        if cpu_seconds > 0:
+            resource.setrlimit(resource.RLIMIT_CPU, (cpu_seconds, cpu_seconds + 1))
+        # Put the tool into its own process group, so child processes (e.g. clang) are killed on timeout.
+        os.setsid()
+
+    return apply
+
+
+def run_once(cmd, timeout: int, memory_mb: int):
+    """Runs a command under resource limits and returns its output and resource usage."""
+    with tempfile.TemporaryFile() as out, tempfile.TemporaryFile() as err:
+        start = time.monotonic()
+        proc = subprocess.Popen(cmd, stdout=out, stderr=err, preexec_fn=set_limits(memory_mb, timeout))
+
+        timed_out = threading.Event()
+
+        def kill():
+            timed_out.set()
+            try:
+                os.killpg(proc.pid, signal.SIGKILL)
+            except ProcessLookupError:
+                pass
+
+        timer = threading.Timer(timeout, kill)
+        timer.start()
+        _, status, usage = os.wait4(proc.pid, 0)
+        timer.cancel()
+        wall = time.monotonic() - start
+        proc.returncode = os.waitstatus_to_exitcode(status) if hasattr(os, 'waitstatus_to_exitcode') else status
+
+        out.seek(0)
+        err.seek(0)
+        return {
+            'wall_time': wall,
+            'cpu_time': usage.ru_utime + usage.ru_stime,
+            # ru_maxrss is in kilobytes on Linux.
+            'max_rss_kb': usage.ru_maxrss,
+            'exit_code': proc.returncode,
+            'timeout': timed_out.is_set(),
+            'stdout': out.read().decode(errors='replace'),
+            'stderr': err.read().decode(errors='replace'),
+        }
+
+
+def parse_phase_times(text: str):
+    """Parses the wall clock times from LLVM's -time-passes report."""
+    phases = {}
+    for line in text.splitlines():
+        match = TIMER_ROW_PATTERN.match(line)
+        if match is None:
+            continue
+        values = TIMER_VALUE_PATTERN.findall(match.group(1))
+        name = match.group(2).strip()
+        if name == 'Total':
+            continue
+        # The wall time is always the last column.
+        phases[name] = phases.get(name, 0.0) + float(values[-1])
+
+    return phases
+
+
+def engine_args(args, engine: str):
+    """Replaces the verification engine selected by a gazer-bmc RUN line."""
+    args = [arg for arg in args if not arg.startswith('-engine=')]
+    if engine == 'bmc':
+        return args
+
+    # The unbounded engines need the procedures inlined into the main automaton.
+    args = [arg for arg in args if not arg.startswith('-inline=')]
+    return ['-engine=' + engine, '-inline=all'] + args
+
+
+def run_task(task: Task, tools_dir: pathlib.Path, options):
+    args = task.args
+    if task.tool == 'bmc' and options.engine is not None:
+        args = engine_args(args, options.engine)
+
+    cmd = [str(tools_dir / TOOLS[task.tool])] + args + options.extra_args
+    if options.time_passes:
+        cmd.append('-time-passes')
+    cmd.append(str(task.file))
+
+    samples = [run_once(cmd, options.timeout, options.memory_limit) for _ in range(options.repeat)]
+    last = samples[-1]
+
+    verdict_match = VERDICT_PATTERN.search(last['stdout'])
+    if last['timeout']:
+        status = 'TIMEOUT'
+    elif verdict_match is not None:
+        status = verdict_match.group(1)
+    elif last['exit_code'] == 0 and task.tool == 'cfa':
+        status = 'DONE'
+    else:
+        status = 'ERROR'
+
+    result = {
+        'tool': task.tool,
+        'command': cmd,
+        'status': status,
+        'expected': task.expected,
+        'correct': task.expected is None or status in task.expected,
+        'wall_time': statistics.median(s['wall_time'] for s in samples),
+        'cpu_time': statistics.median(s['cpu_time'] for s in samples),
+        'max_rss_kb': max(s['max_rss_kb'] for s in samples),
+        'exit_code': last['exit_code'],
+        'stats': {k: float(v) for k, v in STAT_PATTERN.findall(last['stdout'])},
+    }
+    if options.time_passes:
+        result['phases'] = parse_phase_times(last['stderr'])
+
+    return result
+
+
+def compare(results, baseline, threshold: float, min_time: float, min_rss_kb: int):
+    """Returns a list of human-readable regression descriptions."""
+    regressions = []
+    for task_id, new in sorted(results.items()):
+        old = baseline.get(task_id)
+        if old is None:
+            continue
+
+        if old['status'] != new['status']:
+            regressions.append('{0}: verdict changed from {1} to {2}'.format(task_id, old['status'], new['status']))
+        if old['correct'] and not new['correct']:
+            regressions.append('{0}: result is no longer correct'.format(task_id))
+
+        # Small absolute differences are dominated by noise, ignore them.
+        if new['wall_time'] > old['wall_time'] * (1 + threshold) and new['wall_time'] - old['wall_time'] > min_time:
+            regressions.append('{0}: wall time {1:.3f}s -> {2:.3f}s (+{3:.1f}%)'.format(
+                task_id, old['wall_time'], new['wall_time'], 100 * (new['wall_time'] / max(old['wall_time'], 1e-9) - 1)))
+        if new['max_rss_kb'] > old['max_rss_kb'] * (1 + threshold) and new['max_rss_kb'] - old['max_rss_kb'] > min_rss_kb:
+            regressions.append('{0}: peak RSS {1}KB -> {2}KB (+{3:.1f}%)'.format(
+                task_id, old['max_rss_kb'], new['max_rss_kb'], 100 * (new['max_rss_kb'] / max(old['max_rss_kb'], 1) - 1)))
+
+    return regressions
+
+
+def print_summary(results, baseline):
+    print('{0:<70} {1:>14} {2:>10} {3:>10} {4:>10}'.format('Task', 'Status', 'Wall (s)', 'RSS (MB)', 'Baseline'))
+    for task_id, result in sorted(results.items()):
+        base = baseline.get(task_id) if baseline else None
+        name = task_id if len(task_id) <= 70 else '...' + task_id[-67:]
+        print('{0:<70} {1:>14} {2:>10.3f} {3:>10.1f} {4:>10}'.format(
+            name,
+            result['status'] + ('' if result['correct'] else '!'),
+            result['wall_time'],
+            result['max_rss_kb'] / 1024,
+            '{0:.3f}'.format(base['wall_time']) if base else '-'
+        ))
+
+    total = sum(r['wall_time'] for r in results.values())
+    incorrect = sum(1 for r in results.values() if not r['correct'])
+    print('Total: {0} runs, {1:.2f}s wall time, {2} incorrect verdicts'.format(len(results), total, incorrect))
+
+
+if __name__ == "__main__":
+    source_root = pathlib.Path(__file__).absolute().parent.parent
+
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('tasks', nargs='*', help='Test files or directories to run (default: test/verif and test/cfa)')
+    parser.add_argument('--tools-dir', required=True, help='The tools directory of a gazer build')
+    parser.add_argument('--tools', default='bmc,cfa', help='Comma-separated list of tools to benchmark (bmc, cfa)')
+    parser.add_argument('--filter', default=None, help='Only run tasks whose path matches this regex')
+    parser.add_argument('--all-runs', action='store_true', help='Run every RUN line instead of the first one per tool')
+    parser.add_argument('--timeout', type=int, default=60, help='Wall and CPU time limit per run in seconds')
+    parser.add_argument('--memory-limit', type=int, default=4096, help='Address space limit per run in MB, 0 disables it')
+    parser.add_argument('--repeat', type=int, default=1, help='Run each task this many times and report the median time')
+    parser.add_argument('--time-passes', action='store_true', help='Collect per-pass timing using -time-passes')
+    parser.add_argument('--engine', choices=['bmc', 'imc', 'kind', 'pdr'], default=None,
+                        help='Run all gazer-bmc tasks with the given engine instead of the one in their RUN line')
+    parser.add_argument('--extra-args', default='', help='Additional arguments passed to each tool, enclosed in quotes')
+    parser.add_argument('--output', '-o', default='benchmark-results.json', help='Output JSON file')
+    parser.add_argument('--baseline', default=None, help='Baseline JSON file to compare against')
+    parser.add_argument('--threshold', type=float, default=0.1, help='Relative slowdown or memory increase considered a regression')
+    parser.add_argument('--min-time-diff', type=float, default=0.1, help='Ignore wall time differences smaller than this (seconds)')
+    parser.add_argument('--min-rss-diff', type=int, default=8192, help='Ignore peak RSS differences smaller than this (KB)')
+
+    options = parser.parse_args()
+    options.extra_args = shlex.split(options.extra_args)
+
+    tools_dir = pathlib.Path(options.tools_dir).absolute()
+    tools = options.tools.split(',')
+    for tool in tools:
+        if tool not in TOOLS:
+            parser.error('unknown tool: ' + tool)
+        if not (tools_dir / TOOLS[tool]).exists():
+            parser.error('{0} does not exist'.format(tools_dir / TOOLS[tool]))
+
+    roots = options.tasks or [source_root / 'test' / 'verif', source_root / 'test' / 'cfa']
+
+    baseline = None
+    if options.baseline is not None:
+        with open(options.baseline) as f:
+            baseline = json.load(f)['results']
+
+    with tempfile.TemporaryDirectory(prefix='gazer-bench-') as workdir:
+        tasks = discover_tasks(roots, tools, options.all_runs, pathlib.Path(workdir), options.filter)
+        if not tasks:
+            print('No tasks found.', file=sys.stderr)
+            sys.exit(1)
+
+        results = {}
+        for i, task in enumerate(tasks):
+            # Report task identifiers relative to the source root, so results from different checkouts can be compared.
+            try:
+                task_id = str(pathlib.Path(task.task_id).relative_to(source_root))
+            except ValueError:
+                task_id = task.task_id
+
+            print('[{0}/{1}] {2}'.format(i + 1, len(tasks), task_id), file=sys.stderr, flush=True)
+            results[task_id] = run_task(task, tools_dir, options)
+
+    with open(options.output, 'w') as f:
+        json.dump({
+            'date': datetime.datetime.now().isoformat(),
+            'limits': {'timeout': options.timeout, 'memory_mb': options.memory_limit, 'repeat': options.repeat},
+            'results': results,
+        }, f, indent=2)
+
+    print_summary(results, baseline)
+
+    if baseline is not None:
+        regressions = compare(results, baseline, options.threshold, options.min_time_diff, options.min_rss_diff)
+        if regressions:
+            print('\n{0} regressions found:'.format(len(regressions)))
+            for regression in regressions:
+                print('  ' + regression)
+            sys.exit(1)
+
+        print('\nNo regressions found.')
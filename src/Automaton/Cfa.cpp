@@ -157,6 +157,14 @@ Variable *Cfa::createLocal(const std::string& name, Type& type)
     return variable;
 }
 
+Variable *Cfa::createFreshLocal(const Variable* base)
+{
+    Variable* variable = mContext.createFreshVariable(base, base->getType());
+    mLocals.push_back(variable);
+
+    return variable;
+}
+
 Variable *Cfa::createMemberVariable(const std::string& name, Type &type)
 {
     std::string baseName = mName + "/" + name;
@@ -195,18 +203,14 @@ bool Cfa::isOutput(Variable* variable) const
 
 Variable* Cfa::findVariableByName(const std::vector<Variable*>& vec, llvm::StringRef name) const
 {
-    auto variableName = (llvm::Twine(mName, "/") + name).str();
-    Variable* variable = mContext.getVariable(variableName);
-    if (variable == nullptr) {
-        return nullptr;
-    }
-
-    // We must also make sure that the required vector contains said variable.
-    if (std::find(vec.begin(), vec.end(), variable) == vec.end()) {
-        return nullptr;
-    }
+    // Compare the symbol names directly instead of building the
+    // qualified name and looking it up in the context.
+    auto it = std::find_if(vec.begin(), vec.end(), [this, name](Variable* variable) {
+        auto symbol = mSymbolNames.find(variable);
+        return symbol != mSymbolNames.end() && symbol->second == name;
+    });
 
-    return variable;
+    return it != vec.end() ? *it : nullptr;
 }
 
 Variable* Cfa::findInputByName(llvm::StringRef name) const
@@ -248,6 +252,26 @@ void Cfa::removeUnreachableLocations()
     this->clearDisconnectedElements();
 }
 
+void Cfa::clearDisconnectedElements()
+{
+    auto isDisconnected = [](Location* loc) {
+        return loc->getNumIncoming() == 0 && loc->getNumOutgoing() == 0;
+    };
+
+    for (Location* loc : nodes()) {
+        if (isDisconnected(loc)) {
+            mErrorFieldExprs.erase(loc);
+            mLocationNumbers.erase(loc->getId());
+        }
+    }
+
+    mErrorLocations.erase(
+        llvm::remove_if(mErrorLocations, isDisconnected), mErrorLocations.end()
+    );
+
+    Graph::clearDisconnectedElements();
+}
+
 Cfa::~Cfa() {}
 
 // Transitions
@@ -323,6 +347,18 @@ Cfa *AutomataSystem::createCfa(std::string name)
     return cfa;
 }
 
+void AutomataSystem::removeCfa(Cfa* cfa)
+{
+    assert(cfa != mMainAutomaton && "Cannot remove the main automaton!");
+
+    auto it = std::find_if(mAutomata.begin(), mAutomata.end(), [cfa](auto& ptr) {
+        return ptr.get() == cfa;
+    });
+
+    assert(it != mAutomata.end() && "The automaton must be present in the system!");
+    mAutomata.erase(it);
+}
+
 Cfa* AutomataSystem::getAutomatonByName(llvm::StringRef name) const
 {
     auto result = std::find_if(begin(), end(), [name](Cfa& cfa) {
@@ -0,0 +1,378 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaDominators.h"
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/Support/MathExtras.h>
+
+#include <queue>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Iterates over the locations preceding or following \p loc in the
+/// direction of the tree.
+template<bool IsPostDom, class F>
+void forEachPredecessor(Location* loc, F func)
+{
+    if constexpr (IsPostDom) {
+        for (Transition* edge : loc->outgoing()) { func(edge->getTarget()); }
+    } else {
+        for (Transition* edge : loc->incoming()) { func(edge->getSource()); }
+    }
+}
+
+template<bool IsPostDom, class F>
+void forEachSuccessor(Location* loc, F func)
+{
+    forEachPredecessor<!IsPostDom>(loc, func);
+}
+
+} // end anonymous namespace
+
+template<bool IsPostDom>
+bool DagDominatorTreeBase<IsPostDom>::comesBefore(NodeId a, NodeId b) const
+{
+    size_t ai = mIndex(mLocations[a]);
+    size_t bi = mIndex(mLocations[b]);
+
+    return IsPostDom ? ai > bi : ai < bi;
+}
+
+template<bool IsPostDom>
+auto DagDominatorTreeBase<IsPostDom>::lookup(Location* loc) const -> NodeId
+{
+    auto it = mNodeIds.find(loc);
+    return it == mNodeIds.end() ? InvalidNode : it->second;
+}
+
+template<bool IsPostDom>
+auto DagDominatorTreeBase<IsPostDom>::intersect(NodeId a, NodeId b) const -> NodeId
+{
+    // The immediate dominator of a node always precedes it in the topological
+    // sort, so we can walk up on the tree from the node which comes later.
+    while (a != b) {
+        while (comesBefore(b, a)) {
+            a = mIDoms[a];
+        }
+        while (comesBefore(a, b)) {
+            b = mIDoms[b];
+        }
+    }
+
+    return a;
+}
+
+template<bool IsPostDom>
+auto DagDominatorTreeBase<IsPostDom>::calculateIDom(Location* loc) const -> NodeId
+{
+    NodeId idom = InvalidNode;
+    forEachPredecessor<IsPostDom>(loc, [&](Location* pred) {
+        NodeId predNode = this->lookup(pred);
+        if (predNode == InvalidNode) {
+            // This predecessor is not reachable from the root.
+            return;
+        }
+
+        idom = idom == InvalidNode ? predNode : this->intersect(idom, predNode);
+    });
+
+    return idom;
+}
+
+template<bool IsPostDom>
+auto DagDominatorTreeBase<IsPostDom>::addNode(Location* loc, NodeId idom) -> NodeId
+{
+    NodeId node = mLocations.size();
+    mNodeIds[loc] = node;
+    mLocations.push_back(loc);
+    mIDoms.push_back(idom);
+    mChildren.emplace_back();
+
+    if (idom != InvalidNode) {
+        mChildren[idom].push_back(node);
+    }
+
+    return node;
+}
+
+template<bool IsPostDom>
+void DagDominatorTreeBase<IsPostDom>::setIDom(NodeId node, NodeId idom)
+{
+    auto& siblings = mChildren[mIDoms[node]];
+    siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+
+    mIDoms[node] = idom;
+    mChildren[idom].push_back(node);
+}
+
+template<bool IsPostDom>
+void DagDominatorTreeBase<IsPostDom>::recalculate(Location* root, llvm::ArrayRef<Location*> topo)
+{
+    mNodeIds.clear();
+    mLocations.clear();
+    mIDoms.clear();
+    mChildren.clear();
+    mIndexValid = false;
+
+    addNode(root, InvalidNode);
+
+    // The index function need not return contiguous indices, find the
+    // root in the topological sort.
+    size_t rootIdx = std::distance(topo.begin(), llvm::find(topo, root));
+    assert(rootIdx < topo.size() && "The root must be present in the topological sort!");
+
+    auto visit = [this](Location* loc) {
+        NodeId idom = this->calculateIDom(loc);
+        if (idom != InvalidNode) {
+            this->addNode(loc, idom);
+        }
+    };
+
+    if constexpr (IsPostDom) {
+        for (size_t i = rootIdx; i-- > 0;) {
+            visit(topo[i]);
+        }
+    } else {
+        for (size_t i = rootIdx + 1; i < topo.size(); ++i) {
+            visit(topo[i]);
+        }
+    }
+}
+
+template<bool IsPostDom>
+void DagDominatorTreeBase<IsPostDom>::insertLocations(llvm::ArrayRef<Location*> locations)
+{
+    assert(!mLocations.empty() && "Cannot update an empty tree!");
+    mIndexValid = false;
+
+    // Process every location in topological order (in the direction of the
+    // tree), so all predecessors are final when a location is visited.
+    auto compare = [this](Location* a, Location* b) {
+        return IsPostDom ? mIndex(a) < mIndex(b) : mIndex(a) > mIndex(b);
+    };
+    std::priority_queue<Location*, std::vector<Location*>, decltype(compare)> worklist(compare);
+    llvm::DenseSet<Location*> queued;
+    llvm::DenseSet<Location*> inserted(locations.begin(), locations.end());
+
+    auto enqueue = [&worklist, &queued](Location* loc) {
+        if (queued.insert(loc).second) {
+            worklist.push(loc);
+        }
+    };
+
+    for (Location* loc : locations) {
+        assert(!this->contains(loc) && "Inserted locations must not be present in the tree!");
+        enqueue(loc);
+    }
+
+    Location* root = this->getRoot();
+    llvm::SmallVector<NodeId, 16> stack;
+
+    while (!worklist.empty()) {
+        Location* loc = worklist.top();
+        worklist.pop();
+        queued.erase(loc);
+
+        if (loc == root) {
+            continue;
+        }
+
+        NodeId idom = this->calculateIDom(loc);
+        NodeId node = this->lookup(loc);
+
+        if (node == InvalidNode) {
+            if (idom != InvalidNode) {
+                this->addNode(loc, idom);
+                // Successors which already existed may have a new dominator now.
+                forEachSuccessor<IsPostDom>(loc, [&](Location* succ) {
+                    if (inserted.count(succ) == 0) { enqueue(succ); }
+                });
+            }
+            continue;
+        }
+
+        assert(idom != InvalidNode && "Locations must not become unreachable from the root!");
+        if (idom == mIDoms[node]) {
+            continue;
+        }
+
+        this->setIDom(node, idom);
+
+        // The dominators of the nodes in the subtree of `node` changed as well,
+        // which may affect the locations reachable from them which are not in
+        // the subtree.
+        llvm::DenseSet<NodeId> subtree;
+        stack.push_back(node);
+        while (!stack.empty()) {
+            NodeId current = stack.pop_back_val();
+            subtree.insert(current);
+            stack.append(mChildren[current].begin(), mChildren[current].end());
+        }
+
+        for (NodeId current : subtree) {
+            forEachSuccessor<IsPostDom>(mLocations[current], [&](Location* succ) {
+                NodeId succNode = this->lookup(succ);
+                if (succNode == InvalidNode || subtree.count(succNode) == 0) {
+                    enqueue(succ);
+                }
+            });
+        }
+    }
+}
+
+template<bool IsPostDom>
+Location* DagDominatorTreeBase<IsPostDom>::getIDom(Location* loc) const
+{
+    NodeId node = this->lookup(loc);
+    assert(node != InvalidNode && "The location must be present in the tree!");
+
+    NodeId idom = mIDoms[node];
+    return idom == InvalidNode ? nullptr : mLocations[idom];
+}
+
+template<bool IsPostDom>
+void DagDominatorTreeBase<IsPostDom>::buildIndex()
+{
+    size_t numNodes = mLocations.size();
+    size_t tourLength = 2 * numNodes - 1;
+
+    mEulerTour.clear();
+    mEulerDepth.clear();
+    mEulerTour.reserve(tourLength);
+    mEulerDepth.reserve(tourLength);
+    mFirstVisit.assign(numNodes, 0);
+    mLastVisit.assign(numNodes, 0);
+
+    // Iterative DFS on the tree. Each node is written into the tour when it
+    // is entered and after each of its children was visited.
+    struct Frame { NodeId node; unsigned depth; size_t nextChild; };
+    std::vector<Frame> stack;
+    stack.push_back({ 0, 0, 0 });
+    mFirstVisit[0] = 0;
+
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        mEulerTour.push_back(frame.node);
+        mEulerDepth.push_back(frame.depth);
+        mLastVisit[frame.node] = mEulerTour.size() - 1;
+
+        if (frame.nextChild < mChildren[frame.node].size()) {
+            NodeId child = mChildren[frame.node][frame.nextChild++];
+            mFirstVisit[child] = mEulerTour.size();
+            stack.push_back({ child, frame.depth + 1, 0 });
+        } else {
+            stack.pop_back();
+        }
+    }
+
+    assert(mEulerTour.size() == tourLength && "The tree must be connected!");
+
+    // Build the sparse table: mSparseTable[k][i] is the tour position with
+    // the smallest depth in the range [i, i + 2^k).
+    unsigned levels = llvm::Log2_64(tourLength) + 1;
+    mSparseTable.resize(levels);
+    mSparseTable[0].resize(tourLength);
+    for (size_t i = 0; i < tourLength; ++i) {
+        mSparseTable[0][i] = i;
+    }
+
+    for (unsigned k = 1; k < levels; ++k) {
+        size_t width = size_t(1) << k;
+        auto& prev = mSparseTable[k - 1];
+        auto& current = mSparseTable[k];
+        current.resize(tourLength - width + 1);
+
+        for (size_t i = 0; i + width <= tourLength; ++i) {
+            unsigned left = prev[i];
+            unsigned right = prev[i + width / 2];
+            current[i] = mEulerDepth[left] <= mEulerDepth[right] ? left : right;
+        }
+    }
+
+    mIndexValid = true;
+}
+
+template<bool IsPostDom>
+size_t DagDominatorTreeBase<IsPostDom>::findMinDepth(size_t first, size_t last) const
+{
+    assert(first <= last);
+    unsigned k = llvm::Log2_64(last - first + 1);
+    unsigned left = mSparseTable[k][first];
+    unsigned right = mSparseTable[k][last + 1 - (size_t(1) << k)];
+
+    return mEulerDepth[left] <= mEulerDepth[right] ? left : right;
+}
+
+template<bool IsPostDom>
+bool DagDominatorTreeBase<IsPostDom>::dominates(Location* a, Location* b)
+{
+    NodeId aNode = this->lookup(a);
+    NodeId bNode = this->lookup(b);
+    assert(aNode != InvalidNode && bNode != InvalidNode && "Locations must be present in the tree!");
+
+    if (!mIndexValid) {
+        this->buildIndex();
+    }
+
+    return mFirstVisit[aNode] <= mFirstVisit[bNode] && mLastVisit[bNode] <= mLastVisit[aNode];
+}
+
+template<bool IsPostDom>
+Location* DagDominatorTreeBase<IsPostDom>::findNearestCommonDominator(Location* a, Location* b)
+{
+    Location* locs[] = { a, b };
+    return this->findNearestCommonDominator(locs);
+}
+
+template<bool IsPostDom>
+Location* DagDominatorTreeBase<IsPostDom>::findNearestCommonDominator(llvm::ArrayRef<Location*> locs)
+{
+    if (!mIndexValid) {
+        this->buildIndex();
+    }
+
+    // The nearest common ancestor of a set of nodes is the shallowest node
+    // of the Euler tour between the first visits of the nodes.
+    size_t first = mEulerTour.size();
+    size_t last = 0;
+    for (Location* loc : locs) {
+        NodeId node = this->lookup(loc);
+        if (node == InvalidNode) {
+            continue;
+        }
+
+        first = std::min(first, mFirstVisit[node]);
+        last = std::max(last, mFirstVisit[node]);
+    }
+
+    if (first == mEulerTour.size()) {
+        return nullptr;
+    }
+
+    return mLocations[mEulerTour[this->findMinDepth(first, last)]];
+}
+
+namespace gazer
+{
+    template class DagDominatorTreeBase<false>;
+    template class DagDominatorTreeBase<true>;
+} // end namespace gazer
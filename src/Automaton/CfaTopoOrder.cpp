@@ -0,0 +1,139 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaTopoOrder.h"
+
+using namespace gazer;
+
+namespace
+{
+
+/// The minimal average gap a redistributed window must have.
+constexpr size_t MinSpacing = 1 << 16;
+
+} // end anonymous namespace
+
+CfaTopoOrder::CfaTopoOrder()
+{
+    // The two sentinel nodes bound the label space.
+    mNodes.push_back({ nullptr, 0, Head, Tail });
+    mNodes.push_back({ nullptr, std::numeric_limits<size_t>::max(), Head, Tail });
+}
+
+CfaTopoOrder::CfaTopoOrder(llvm::ArrayRef<Location*> topo)
+    : CfaTopoOrder()
+{
+    this->append(topo);
+}
+
+void CfaTopoOrder::append(llvm::ArrayRef<Location*> locs)
+{
+    if (locs.empty()) {
+        return;
+    }
+
+    NodeId last = mNodes[Tail].prev;
+    NodeId prev = last;
+    for (Location* loc : locs) {
+        NodeId node = mNodes.size();
+        mNodes.push_back({ loc, 0, prev, Tail });
+        mNodes[prev].next = node;
+        auto inserted = mNodeIds.try_emplace(loc, node).second;
+        assert(inserted && "Locations may only be inserted once!");
+        (void) inserted;
+        prev = node;
+    }
+    mNodes[Tail].prev = prev;
+
+    this->relabel(last, Tail, locs.size());
+}
+
+void CfaTopoOrder::insertBefore(Location* pos, llvm::ArrayRef<Location*> locs)
+{
+    if (locs.empty()) {
+        return;
+    }
+
+    NodeId next = this->lookup(pos);
+    NodeId first = mNodes[next].prev;
+    NodeId prev = first;
+
+    for (Location* loc : locs) {
+        NodeId node = mNodes.size();
+        mNodes.push_back({ loc, 0, prev, next });
+        mNodes[prev].next = node;
+        auto inserted = mNodeIds.try_emplace(loc, node).second;
+        assert(inserted && "Locations may only be inserted once!");
+        (void) inserted;
+        prev = node;
+    }
+    mNodes[next].prev = prev;
+
+    this->relabel(first, next, locs.size());
+}
+
+/// Assigns labels to the \p numInserted unlabeled nodes between \p prev and
+/// \p next. If the gap between the two is too narrow, the window is extended
+/// in both directions (doubling the number of nodes in it each time) until
+/// its labels can be spread with sufficient spacing.
+void CfaTopoOrder::relabel(NodeId prev, NodeId next, size_t numInserted)
+{
+    size_t gap = mNodes[next].label - mNodes[prev].label;
+    if (gap / (numInserted + 1) > 0) {
+        // Fast path: the new nodes fit into the gap.
+        size_t spacing = gap / (numInserted + 1);
+        size_t label = mNodes[prev].label;
+        for (NodeId node = mNodes[prev].next; node != next; node = mNodes[node].next) {
+            label += spacing;
+            mNodes[node].label = label;
+        }
+        return;
+    }
+
+    NodeId lo = prev;
+    NodeId hi = next;
+    size_t count = numInserted;
+    size_t step = 1;
+
+    while (true) {
+        size_t span = mNodes[hi].label - mNodes[lo].label;
+        if (span / (count + 1) >= MinSpacing || (lo == Head && hi == Tail)) {
+            break;
+        }
+
+        for (size_t i = 0; i < step && lo != Head; ++i) {
+            lo = mNodes[lo].prev;
+            ++count;
+        }
+        for (size_t i = 0; i < step && hi != Tail; ++i) {
+            hi = mNodes[hi].next;
+            ++count;
+        }
+        step *= 2;
+    }
+
+    size_t span = mNodes[hi].label - mNodes[lo].label;
+    size_t spacing = span / (count + 1);
+    assert(spacing > 0 && "The label space is exhausted!");
+
+    size_t label = mNodes[lo].label;
+    for (NodeId node = mNodes[lo].next; node != hi; node = mNodes[node].next) {
+        label += spacing;
+        mNodes[node].label = label;
+    }
+    mNumRelabeled += count - numInserted;
+}
@@ -16,22 +16,20 @@
 //
 //===----------------------------------------------------------------------===//
 #include "gazer/Automaton/CfaUtils.h"
+#include "gazer/Automaton/CfaDominators.h"
 #include "gazer/Core/Expr/ExprBuilder.h"
 
-#include <boost/dynamic_bitset.hpp>
-
 using namespace gazer;
 
 // Calculating path conditions
 //===----------------------------------------------------------------------===//
 
 PathConditionCalculator::PathConditionCalculator(
-    const std::vector<Location*>& topo,
+    const CfaTopoOrder& topo,
     ExprBuilder& builder,
-    std::function<size_t(Location*)> index,
     std::function<ExprPtr(CallTransition*)> calls,
     std::function<void(Location*, ExprPtr)> preds
-) : mTopo(topo), mExprBuilder(builder), mIndex(index), mCalls(calls), mPredecessors(preds)
+) : mTopo(topo), mExprBuilder(builder), mCalls(calls), mPredecessors(preds)
 {}
 
 namespace
@@ -58,35 +56,42 @@ ExprPtr PathConditionCalculator::encode(Location* source, Location* target)
         return mExprBuilder.True();
     }
 
-    size_t startIdx = mIndex(source);
-    size_t targetIdx = mIndex(target);
-
     auto& ctx = mExprBuilder.getContext();
-    assert(startIdx < targetIdx && "The source location must be before the target in a topological sort!");
-    assert(targetIdx < mTopo.size() && "The target index is out of range in the VC array!");
+    assert(mTopo.comesBefore(source, target)
+        && "The source location must be before the target in a topological sort!");
 
-    std::vector<ExprPtr> dp(targetIdx - startIdx + 1);
+    // The labels of the topological order are not contiguous, the index of a
+    // location in the region is found by a binary search on the labels seen so far.
+    std::vector<size_t> labels;
+    std::vector<ExprPtr> dp;
 
-    std::fill(dp.begin(), dp.end(), mExprBuilder.False());
+    auto it = mTopo.find(source);
+    auto end = std::next(mTopo.find(target));
+    size_t startLabel = it.getLabel();
 
     // The first location is always reachable from itself.
-    dp[0] = mExprBuilder.True();
+    labels.push_back(startLabel);
+    dp.push_back(mExprBuilder.True());
 
-    for (size_t i = 1; i < dp.size(); ++i) {
-        Location* loc = mTopo[i + startIdx];
+    for (++it; it != end; ++it) {
+        Location* loc = *it;
+        labels.push_back(it.getLabel());
         ExprVector exprs;
 
         llvm::SmallVector<PathPredecessor, 16> preds;
         for (Transition* edge : loc->incoming()) {
-            size_t predIdx = mIndex(edge->getSource());
-            assert(predIdx < i + startIdx
+            size_t predLabel = mTopo.getLabel(edge->getSource());
+            assert(predLabel < labels.back()
                 && "Predecessors must be before block in a topological sort. "
                 "Maybe there is a loop in the automaton?");
 
-            if (predIdx >= startIdx) {
+            if (predLabel >= startLabel) {
                 // We are skipping the predecessors which are outside the region we are interested in.
+                size_t predIdx = std::distance(
+                    labels.begin(), std::lower_bound(labels.begin(), labels.end(), predLabel)
+                );
                 ExprPtr formula = mExprBuilder.And({
-                    dp[predIdx - startIdx],
+                    dp[predIdx],
                     edge->getGuard()
                 });
 
@@ -113,20 +118,18 @@ ExprPtr PathConditionCalculator::encode(Location* source, Location* target)
         }
 
         if (LLVM_UNLIKELY(preds.empty())) {
-            dp[i] = mExprBuilder.False();
+            dp.push_back(mExprBuilder.False());
         } else if (preds.size() == 1) {
             if (mPredecessors != nullptr) {
                 mPredecessors(loc, mExprBuilder.IntLit(preds[0].edge->getSource()->getId()));
             }
-            dp[i] = preds[0].expr;
+            dp.push_back(preds[0].expr);
         } else if (preds.size() == 2) {
             ExprPtr p1 = mExprBuilder.True();
             ExprPtr p2 = mExprBuilder.True();
 
             if (mPredecessors != nullptr) {
-                Variable* predDisc = ctx.createVariable(
-                    "__gazer_pred_" + std::to_string(mPredIdx++), BoolType::Get(ctx)
-                );
+                Variable* predDisc = ctx.createFreshVariable("__gazer_pred", BoolType::Get(ctx));
 
                 unsigned first  = preds[0].edge->getSource()->getId();
                 unsigned second = preds[1].edge->getSource()->getId();
@@ -139,16 +142,14 @@ ExprPtr PathConditionCalculator::encode(Location* source, Location* target)
                 p2 = mExprBuilder.Not(predDisc->getRefExpr());
             }
 
-            dp[i] = mExprBuilder.Or(
+            dp.push_back(mExprBuilder.Or(
                 mExprBuilder.And(preds[0].expr, p1),
                 mExprBuilder.And(preds[1].expr, p2)
-            );
+            ));
         } else {
             Variable* predDisc = nullptr;
             if (mPredecessors != nullptr) {
-                predDisc = ctx.createVariable(
-                    "__gazer_pred_" + std::to_string(mPredIdx++), IntType::Get(ctx)
-                );
+                predDisc = ctx.createFreshVariable("__gazer_pred", IntType::Get(ctx));
                 mPredecessors(loc, predDisc->getRefExpr());
             }
 
@@ -173,7 +174,7 @@ ExprPtr PathConditionCalculator::encode(Location* source, Location* target)
                 exprs.push_back(formula);
             }
 
-            dp[i] = mExprBuilder.Or(exprs);
+            dp.push_back(mExprBuilder.Or(exprs));
         }
     }
 
@@ -198,74 +199,22 @@ Location* gazer::findLowestCommonDominator(
         start = topo[0];
     }
 
-    // Find the last interesting index in the topological sort.
-    auto end = std::max_element(targets.begin(), targets.end(), [index](auto& a, auto& b) {
-        return index(a->getSource()) < index(b->getSource());
-    });
-
-    size_t startIdx = index(start);
-    size_t lastIdx  = index((*end)->getTarget());
-
-    assert(lastIdx > startIdx && "The last interesting index must be larger than the start index!");
-
-    // Count the number of locations between start and last in the topological sort.
-    size_t numLocs = lastIdx - startIdx;
-
-    // We will calculate dominators in one go, exploiting that the graph is guaranteed to be
-    // a DAG and that we already have the topological sort. We will use the standard definition:
-    //      Dom(n_0) = { n_0 }
-    //      Dom(n) = Union({ n }, Intersect({ p in pred(n): Dom(p) }))
-    // To represent the Dom sets for each node n, we will use a bitset, where a bit i is set if
-    // topo[i] dominates n.
-    std::vector<boost::dynamic_bitset<>> dominators(numLocs, boost::dynamic_bitset(numLocs));
-    dominators[0][0] = true;
-
-    for (size_t i = 1; i < numLocs; ++i) {
-        Location* loc = topo[startIdx + i];
-
-        boost::dynamic_bitset<> bs(numLocs);
-        bs.set();
-        for (Transition* edge : loc->incoming()) {
-            size_t predIdx = index(edge->getSource());
-            assert(predIdx < i + startIdx
-                && "Predecessors must be before node in a topological sort. "
-                "Maybe there is a loop in the automaton?");
-
-            if (predIdx < startIdx) {
-                // We are skipping the predecessors we are not interested in.
-                // Note that this is only safe because we *know* that `start`
-                // dominates each target, therefore all initial paths to the
-                // targets must already go through `start`.
-                continue;
-            }
-
-            bs = bs & dominators[predIdx - startIdx];
-        }
-        bs[i] = true;
-        dominators[i] = bs;
-    }
+    // As `start` dominates each target, all initial paths to the targets must
+    // go through `start`. Thus we may calculate the dominator tree rooted
+    // at `start` instead of the entry location.
+    DagDominatorTree domTree(index);
+    domTree.recalculate(start, topo);
 
-    // Now that we have the dominators, find the common dominators for the target edges.
-    boost::dynamic_bitset<> commonDominators(numLocs);
-    commonDominators.set();
+    std::vector<Location*> sources;
+    sources.reserve(targets.size());
     for (Transition* edge : targets) {
-        size_t idx = index(edge->getSource());
-        commonDominators = commonDominators & dominators[idx - startIdx];
+        sources.push_back(edge->getSource());
     }
 
-    assert(commonDominators.test(0)
-        && "There must be at least one possible common dominator (the start location)!");
+    Location* result = domTree.findNearestCommonDominator(sources);
+    assert(result != nullptr && "There must be at least one possible common dominator (the start location)!");
 
-    // Find the highest set bit
-    size_t commonDominatorIndex = 0;
-    for (size_t i = commonDominators.size() - 1; i > 0; --i) {
-        if (commonDominators[i]) {
-            commonDominatorIndex = i;
-            break;
-        }
-    }
-
-    return topo[commonDominatorIndex + startIdx];
+    return result;
 }
 
 Location* gazer::findHighestCommonPostDominator(
@@ -274,7 +223,6 @@ Location* gazer::findHighestCommonPostDominator(
     std::function<size_t(Location*)> index,
     Location* start
 ) {
-
     if (targets.empty()) {
         // There cannot be a suitable ancestor, just return the start node.
         return nullptr;
@@ -284,69 +232,17 @@ Location* gazer::findHighestCommonPostDominator(
         start = targets[0]->getSource()->getAutomaton()->getExit();
     }
 
-    // Find the last interesting index in the topological sort.
-    auto end = std::min_element(targets.begin(), targets.end(), [index](auto& a, auto& b) {
-        return index(a->getSource()) < index(b->getSource());
-    });
-
-    size_t startIdx = index(start);
-    size_t lastIdx  = index((*end)->getSource());
-
-    assert(lastIdx < startIdx && "The last interesting index must be larger than the start index!");
-
-    // Count the number of locations between start and last in the topological sort.
-    size_t numLocs = startIdx - lastIdx;
-
-    // We will calculate dominators in one go, exploiting that the graph is guaranteed to be
-    // a DAG and that we already have the topological sort. We will use the standard definition:
-    //      Dom(n_0) = { n_0 }
-    //      Dom(n) = Union({ n }, Intersect({ p in pred(n): Dom(p) }))
-    // To represent the Dom sets for each node n, we will use a bitset, where a bit i is set if
-    // topo[i] dominates n.
-    std::vector<boost::dynamic_bitset<>> dominators(numLocs, boost::dynamic_bitset(numLocs));
-    dominators[0][0] = true;
-
-    for (size_t i = 1; i < numLocs; ++i) {
-        Location* loc = topo[startIdx - i];
-
-        boost::dynamic_bitset<> bs(numLocs);
-        bs.set();
-        for (Transition* edge : loc->outgoing()) {
-            size_t succIdx = index(edge->getTarget());
-
-            if (succIdx > startIdx) {
-                // We are skipping the predecessors we are not interested in.
-                // Note that this is only safe because we *know* that `start`
-                // dominates each target, therefore all initial paths to the
-                // targets must already go through `start`.
-                continue;
-            }
-
-            bs = bs & dominators[startIdx - succIdx];
-        }
-        bs[i] = true;
-        dominators[i] = bs;
-    }
+    DagPostDominatorTree postDomTree(index);
+    postDomTree.recalculate(start, topo);
 
-    // Now that we have the dominators, find the common dominators for the target edges.
-    boost::dynamic_bitset<> commonDominators(numLocs);
-    commonDominators.set();
+    std::vector<Location*> successors;
+    successors.reserve(targets.size());
     for (Transition* edge : targets) {
-        size_t idx = index(edge->getTarget());
-        commonDominators = commonDominators & dominators[startIdx - idx];
+        successors.push_back(edge->getTarget());
     }
 
-    assert(commonDominators.test(0)
-        && "There must be at least one possible common dominator (the start location)!");
+    Location* result = postDomTree.findNearestCommonDominator(successors);
+    assert(result != nullptr && "There must be at least one possible common post-dominator (the start location)!");
 
-    // Find the highest set bit
-    size_t commonDominatorIndex = 0;
-    for (size_t i = commonDominators.size() - 1; i > 0; --i) {
-        if (commonDominators[i]) {
-            commonDominatorIndex = i;
-            break;
-        }
-    }
-
-    return topo[startIdx - commonDominatorIndex];
-}
\ No newline at end of file
+    return result;
+}
@@ -0,0 +1,115 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaTransforms.h"
+#include "gazer/Core/Expr/ExprRewrite.h"
+
+using namespace gazer;
+
+Cfa* gazer::CloneAutomaton(Cfa* cfa, llvm::StringRef name, CloneOrigins* origins)
+{
+    Cfa* clone = cfa->getParent().createCfa(name.str());
+    auto builder = CreateExprBuilder(cfa->getParent().getContext());
+
+    VariableExprRewrite rewrite(*builder);
+    llvm::DenseMap<Variable*, Variable*> varToVar;
+    llvm::DenseMap<Location*, Location*> locToLoc;
+
+    for (Variable& input : cfa->inputs()) {
+        Variable* newInput = clone->createInput(cfa->getSymbolName(&input), input.getType());
+        varToVar[&input] = newInput;
+        rewrite[&input] = newInput->getRefExpr();
+    }
+
+    for (Variable& local : cfa->locals()) {
+        // Fresh locals, e.g. the ones created by inlining, have no symbol name to reuse.
+        Variable* newLocal = local.isFresh()
+            ? clone->createFreshLocal(&local)
+            : clone->createLocal(cfa->getSymbolName(&local), local.getType());
+        varToVar[&local] = newLocal;
+        rewrite[&local] = newLocal->getRefExpr();
+    }
+
+    for (Variable& output : cfa->outputs()) {
+        Variable* newOutput = varToVar.lookup(&output);
+        assert(newOutput != nullptr && "Outputs must be declared as inputs or locals!");
+        clone->addOutput(newOutput);
+    }
+
+    // Entry and exit locations are created by the constructor.
+    locToLoc[cfa->getEntry()] = clone->getEntry();
+    locToLoc[cfa->getExit()] = clone->getExit();
+
+    for (Location* loc : cfa->nodes()) {
+        if (loc == cfa->getEntry() || loc == cfa->getExit()) {
+            continue;
+        }
+
+        if (loc->isError()) {
+            Location* newLoc = clone->createErrorLocation();
+            clone->addErrorCode(newLoc, rewrite.walk(cfa->getErrorFieldExpr(loc)));
+            locToLoc[loc] = newLoc;
+        } else {
+            locToLoc[loc] = clone->createLocation();
+        }
+    }
+
+    for (Transition* edge : cfa->edges()) {
+        Location* source = locToLoc[edge->getSource()];
+        Location* target = locToLoc[edge->getTarget()];
+        ExprPtr guard = rewrite.walk(edge->getGuard());
+
+        if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+            std::vector<VariableAssignment> newAssigns;
+            for (const VariableAssignment& va : *assign) {
+                newAssigns.emplace_back(varToVar[va.getVariable()], rewrite.walk(va.getValue()));
+            }
+
+            clone->createAssignTransition(source, target, guard, newAssigns);
+        } else if (auto call = llvm::dyn_cast<CallTransition>(edge)) {
+            // Input arguments are assignments to the callee's inputs, thus only
+            // their values need to be rewritten. Output arguments assign the
+            // callee's outputs to our variables, so the target changes instead.
+            std::vector<VariableAssignment> newInputs;
+            for (const VariableAssignment& va : call->inputs()) {
+                newInputs.emplace_back(va.getVariable(), rewrite.walk(va.getValue()));
+            }
+
+            std::vector<VariableAssignment> newOutputs;
+            for (const VariableAssignment& va : call->outputs()) {
+                newOutputs.emplace_back(varToVar[va.getVariable()], va.getValue());
+            }
+
+            clone->createCallTransition(
+                source, target, guard, call->getCalledAutomaton(), newInputs, newOutputs
+            );
+        } else {
+            llvm_unreachable("Unknown transition kind!");
+        }
+    }
+
+    if (origins != nullptr) {
+        for (auto& [original, cloned] : varToVar) {
+            origins->variables[cloned] = original;
+        }
+        for (auto& [original, cloned] : locToLoc) {
+            origins->locations[cloned] = original;
+        }
+    }
+
+    return clone;
+}
@@ -0,0 +1,335 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file implements a backward live variable analysis over CFAs
+/// and the removal of the local variables it finds to be dead.
+///
+/// The analysis computes strong liveness: the operands of an assignment only
+/// become live if the assigned variable is live after it. This way chains of
+/// assignments which only feed each other are removed in one pass. The outputs
+/// of the automaton are live at its exit location, the error code expression
+/// is read at each error location. Call transitions read the expressions
+/// passed as inputs and define the variables receiving the outputs. As every
+/// callee output must be bound in a call, output variables are never removed.
+///
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaTransforms.h"
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/SmallVector.h>
+
+using namespace gazer;
+
+namespace
+{
+
+class DeadLocalEliminator
+{
+    using UseList = llvm::SmallVector<unsigned, 4>;
+
+    /// The variables read by a transition, precomputed for the fixpoint.
+    struct TransitionInfo
+    {
+        UseList guard;
+        std::vector<UseList> values;
+    };
+
+public:
+    DeadLocalEliminator(Cfa& cfa, std::function<bool(Variable*)> keep)
+        : mCfa(cfa), mKeep(std::move(keep))
+    {}
+
+    unsigned run();
+
+private:
+    void collectUses(const ExprPtr& expr, UseList& uses);
+    int getIndex(Variable* variable) const;
+
+    void calculateLiveness();
+    llvm::BitVector transfer(Transition* edge, const llvm::BitVector& liveOut);
+
+    /// Walks the assignments of \p edge backwards, turning \p live from the set of
+    /// variables live after the edge into the set live before its assignments.
+    /// If \p isDead is given, the assignments of dead variables are marked in it.
+    void walkAssignments(AssignTransition* edge, llvm::BitVector& live, std::vector<bool>* isDead = nullptr);
+    void removeDeadAssignments(AssignTransition* edge);
+
+private:
+    Cfa& mCfa;
+    std::function<bool(Variable*)> mKeep;
+
+    /// The candidate locals, indexed by their position in the bit vectors.
+    std::vector<Variable*> mCandidates;
+    llvm::DenseMap<Variable*, unsigned> mIndices;
+
+    llvm::DenseMap<Transition*, TransitionInfo> mTransitionInfo;
+    llvm::DenseMap<Location*, llvm::BitVector> mLiveIn;
+};
+
+} // end anonymous namespace
+
+int DeadLocalEliminator::getIndex(Variable* variable) const
+{
+    auto it = mIndices.find(variable);
+    return it == mIndices.end() ? -1 : static_cast<int>(it->second);
+}
+
+void DeadLocalEliminator::collectUses(const ExprPtr& expr, UseList& uses)
+{
+    llvm::SmallVector<Expr*, 16> worklist;
+    llvm::DenseSet<Expr*> visited;
+    worklist.push_back(expr.get());
+
+    while (!worklist.empty()) {
+        Expr* current = worklist.pop_back_val();
+        if (!visited.insert(current).second) {
+            continue;
+        }
+
+        if (auto varRef = llvm::dyn_cast<VarRefExpr>(current)) {
+            int idx = this->getIndex(&varRef->getVariable());
+            if (idx != -1) {
+                uses.push_back(idx);
+            }
+        } else if (auto nn = llvm::dyn_cast<NonNullaryExpr>(current)) {
+            for (const ExprPtr& op : nn->operands()) {
+                worklist.push_back(op.get());
+            }
+        }
+    }
+}
+
+llvm::BitVector DeadLocalEliminator::transfer(Transition* edge, const llvm::BitVector& liveOut)
+{
+    llvm::BitVector live = liveOut;
+    TransitionInfo& info = mTransitionInfo[edge];
+
+    if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+        this->walkAssignments(assign, live);
+    } else if (auto call = llvm::dyn_cast<CallTransition>(edge)) {
+        for (const VariableAssignment& output : call->outputs()) {
+            int idx = this->getIndex(output.getVariable());
+            if (idx != -1) {
+                live.reset(idx);
+            }
+        }
+
+        for (const UseList& uses : info.values) {
+            for (unsigned use : uses) {
+                live.set(use);
+            }
+        }
+    }
+
+    for (unsigned use : info.guard) {
+        live.set(use);
+    }
+
+    return live;
+}
+
+void DeadLocalEliminator::calculateLiveness()
+{
+    unsigned numVars = mCandidates.size();
+
+    llvm::BitVector exitLive(numVars);
+    for (Variable& output : mCfa.outputs()) {
+        int idx = this->getIndex(&output);
+        if (idx != -1) {
+            exitLive.set(idx);
+        }
+    }
+
+    llvm::DenseMap<Location*, UseList> errorUses;
+    for (auto& [location, errorCode] : mCfa.errors()) {
+        this->collectUses(errorCode, errorUses[location]);
+    }
+
+    llvm::SmallSetVector<Location*, 32> worklist;
+    for (Location* loc : mCfa.nodes()) {
+        mLiveIn[loc] = llvm::BitVector(numVars);
+        worklist.insert(loc);
+    }
+
+    while (!worklist.empty()) {
+        Location* loc = worklist.pop_back_val();
+
+        llvm::BitVector live(numVars);
+        if (loc == mCfa.getExit()) {
+            live |= exitLive;
+        }
+
+        auto errorIt = errorUses.find(loc);
+        if (errorIt != errorUses.end()) {
+            for (unsigned use : errorIt->second) {
+                live.set(use);
+            }
+        }
+
+        for (Transition* edge : loc->outgoing()) {
+            live |= this->transfer(edge, mLiveIn[edge->getTarget()]);
+        }
+
+        if (live != mLiveIn[loc]) {
+            mLiveIn[loc] = std::move(live);
+            for (Transition* edge : loc->incoming()) {
+                worklist.insert(edge->getSource());
+            }
+        }
+    }
+}
+
+void DeadLocalEliminator::walkAssignments(AssignTransition* edge, llvm::BitVector& live, std::vector<bool>* isDead)
+{
+    TransitionInfo& info = mTransitionInfo[edge];
+
+    // Assignments are sequential, walk them backwards.
+    size_t i = edge->getNumAssignments();
+    for (auto it = edge->end(); it != edge->begin();) {
+        --it;
+        --i;
+        int idx = this->getIndex(it->getVariable());
+        if (idx != -1) {
+            if (!live.test(idx)) {
+                if (isDead != nullptr) {
+                    (*isDead)[i] = true;
+                }
+                continue;
+            }
+            live.reset(idx);
+        }
+
+        for (unsigned use : info.values[i]) {
+            live.set(use);
+        }
+    }
+}
+
+void DeadLocalEliminator::removeDeadAssignments(AssignTransition* edge)
+{
+    // Find the dead assignments by walking backwards from the target.
+    llvm::BitVector live = mLiveIn[edge->getTarget()];
+    std::vector<bool> isDead(edge->getNumAssignments(), false);
+    this->walkAssignments(edge, live, &isDead);
+
+    size_t current = 0;
+    edge->removeAssignmentsIf([&isDead, &current](const VariableAssignment&) {
+        return isDead[current++];
+    });
+}
+
+unsigned DeadLocalEliminator::run()
+{
+    for (Variable& local : mCfa.locals()) {
+        if (mCfa.isOutput(&local) || (mKeep != nullptr && mKeep(&local))) {
+            continue;
+        }
+
+        mIndices[&local] = mCandidates.size();
+        mCandidates.push_back(&local);
+    }
+
+    if (mCandidates.empty()) {
+        return 0;
+    }
+
+    for (Transition* edge : mCfa.edges()) {
+        TransitionInfo& info = mTransitionInfo[edge];
+        this->collectUses(edge->getGuard(), info.guard);
+
+        if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+            for (const VariableAssignment& assignment : *assign) {
+                this->collectUses(assignment.getValue(), info.values.emplace_back());
+            }
+        } else if (auto call = llvm::dyn_cast<CallTransition>(edge)) {
+            for (const VariableAssignment& input : call->inputs()) {
+                this->collectUses(input.getValue(), info.values.emplace_back());
+            }
+        }
+    }
+
+    this->calculateLiveness();
+
+    for (Transition* edge : mCfa.edges()) {
+        if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+            this->removeDeadAssignments(assign);
+        }
+    }
+
+    // Remove the candidates which are not referenced anymore.
+    llvm::BitVector isUsed(mCandidates.size());
+    auto markUsed = [this, &isUsed](Variable* variable) {
+        int idx = this->getIndex(variable);
+        if (idx != -1) {
+            isUsed.set(idx);
+        }
+    };
+
+    for (Transition* edge : mCfa.edges()) {
+        TransitionInfo& info = mTransitionInfo[edge];
+        for (unsigned use : info.guard) {
+            isUsed.set(use);
+        }
+
+        if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+            for (const VariableAssignment& assignment : *assign) {
+                markUsed(assignment.getVariable());
+                UseList uses;
+                this->collectUses(assignment.getValue(), uses);
+                for (unsigned use : uses) {
+                    isUsed.set(use);
+                }
+            }
+        } else if (auto call = llvm::dyn_cast<CallTransition>(edge)) {
+            for (const VariableAssignment& output : call->outputs()) {
+                markUsed(output.getVariable());
+            }
+            for (const UseList& uses : info.values) {
+                for (unsigned use : uses) {
+                    isUsed.set(use);
+                }
+            }
+        }
+    }
+
+    for (auto& [location, errorCode] : mCfa.errors()) {
+        UseList uses;
+        this->collectUses(errorCode, uses);
+        for (unsigned use : uses) {
+            isUsed.set(use);
+        }
+    }
+
+    unsigned numRemoved = mCandidates.size() - isUsed.count();
+    if (numRemoved != 0) {
+        mCfa.removeLocalsIf([this, &isUsed](Variable* variable) {
+            int idx = this->getIndex(variable);
+            return idx != -1 && !isUsed.test(idx);
+        });
+    }
+
+    return numRemoved;
+}
+
+unsigned gazer::EliminateDeadLocals(Cfa* cfa, std::function<bool(Variable*)> keep)
+{
+    DeadLocalEliminator eliminator(*cfa, std::move(keep));
+    return eliminator.run();
+}
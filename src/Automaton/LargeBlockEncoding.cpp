@@ -0,0 +1,295 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file implements large-block encoding for CFAs: chains of assign
+/// transitions and diamond-shaped branches of them are merged into single
+/// transitions.
+///
+/// Assignments on a transition are sequential, and its guard is evaluated
+/// before them. A chain of two transitions therefore becomes a transition
+/// whose guard is the conjunction of the first guard and the second guard
+/// rewritten with the effect of the first assignments, followed by both
+/// assignment lists. Two transitions between the same locations with
+/// complementary guards become an unguarded transition, which assigns each
+/// variable its value on the taken branch.
+///
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaTransforms.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+#include "gazer/Core/Expr/ExprRewrite.h"
+#include "gazer/Core/ExprTypes.h"
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/SmallVector.h>
+
+using namespace gazer;
+
+namespace
+{
+
+class LargeBlockEncoder
+{
+public:
+    LargeBlockEncoder(Cfa& cfa, std::function<bool(Location*)> keep)
+        : mCfa(cfa), mKeep(std::move(keep)),
+        mExprBuilder(CreateFoldingExprBuilder(cfa.getParent().getContext()))
+    {}
+
+    unsigned run();
+
+private:
+    bool canRemove(Location* loc);
+    bool mergeSequence(Location* loc);
+    bool mergeBranches(Location* loc);
+
+    bool isComplement(const ExprPtr& left, const ExprPtr& right);
+
+private:
+    Cfa& mCfa;
+    std::function<bool(Location*)> mKeep;
+    std::unique_ptr<ExprBuilder> mExprBuilder;
+};
+
+} // end anonymous namespace
+
+static void collectVariables(const ExprPtr& expr, llvm::DenseSet<Variable*>& variables)
+{
+    llvm::SmallVector<Expr*, 16> worklist;
+    llvm::DenseSet<Expr*> visited;
+    worklist.push_back(expr.get());
+
+    while (!worklist.empty()) {
+        Expr* current = worklist.pop_back_val();
+        if (!visited.insert(current).second) {
+            continue;
+        }
+
+        if (auto varRef = llvm::dyn_cast<VarRefExpr>(current)) {
+            variables.insert(&varRef->getVariable());
+        } else if (auto nn = llvm::dyn_cast<NonNullaryExpr>(current)) {
+            for (const ExprPtr& op : nn->operands()) {
+                worklist.push_back(op.get());
+            }
+        }
+    }
+}
+
+bool LargeBlockEncoder::canRemove(Location* loc)
+{
+    return loc != mCfa.getEntry() && loc != mCfa.getExit() && !loc->isError()
+        && (mKeep == nullptr || !mKeep(loc));
+}
+
+bool LargeBlockEncoder::isComplement(const ExprPtr& left, const ExprPtr& right)
+{
+    auto isNegationOf = [](const ExprPtr& expr, const ExprPtr& operand) {
+        auto notExpr = llvm::dyn_cast<NotExpr>(expr);
+        return notExpr != nullptr && notExpr->getOperand(0) == operand;
+    };
+
+    return isNegationOf(left, right) || isNegationOf(right, left)
+        || mExprBuilder->Not(left) == right || mExprBuilder->Not(right) == left;
+}
+
+bool LargeBlockEncoder::mergeSequence(Location* loc)
+{
+    if (loc->getNumIncoming() != 1 || loc->getNumOutgoing() != 1) {
+        return false;
+    }
+
+    auto first = llvm::dyn_cast<AssignTransition>(*loc->incoming_begin());
+    auto second = llvm::dyn_cast<AssignTransition>(*loc->outgoing_begin());
+    if (first == nullptr || second == nullptr || first->getSource() == loc || second->getTarget() == loc) {
+        return false;
+    }
+
+    // Rewrite the second guard to use the values before the first assignments.
+    // Havocked values cannot be rewritten, and variables assigned on both
+    // transitions would be assigned twice on the merged one.
+    VariableExprRewrite rewrite(*mExprBuilder);
+    llvm::DenseSet<Variable*> assigned;
+    llvm::DenseSet<Variable*> havocked;
+    for (const VariableAssignment& assignment : *first) {
+        Variable* variable = assignment.getVariable();
+        assigned.insert(variable);
+        if (assignment.getValue()->getKind() == Expr::Undef) {
+            havocked.insert(variable);
+            rewrite[variable] = nullptr;
+        } else {
+            rewrite[variable] = rewrite.walk(assignment.getValue());
+        }
+    }
+
+    for (const VariableAssignment& assignment : *second) {
+        if (assigned.count(assignment.getVariable()) != 0) {
+            return false;
+        }
+    }
+
+    llvm::DenseSet<Variable*> guardVariables;
+    collectVariables(second->getGuard(), guardVariables);
+    for (Variable* variable : guardVariables) {
+        if (havocked.count(variable) != 0) {
+            return false;
+        }
+    }
+
+    ExprPtr guard = mExprBuilder->And(first->getGuard(), rewrite.walk(second->getGuard()));
+
+    std::vector<VariableAssignment> assignments(first->begin(), first->end());
+    assignments.insert(assignments.end(), second->begin(), second->end());
+
+    mCfa.createAssignTransition(first->getSource(), second->getTarget(), guard, assignments);
+    mCfa.disconnectNode(loc);
+
+    return true;
+}
+
+/// Returns the final value of each variable assigned on \p edge in terms of
+/// the values before the transition, or false if a variable is havocked.
+static bool getAssignedValues(
+    AssignTransition* edge, ExprBuilder& builder,
+    std::vector<Variable*>& variables, llvm::DenseMap<Variable*, ExprPtr>& values)
+{
+    VariableExprRewrite rewrite(builder);
+    for (const VariableAssignment& assignment : *edge) {
+        if (assignment.getValue()->getKind() == Expr::Undef) {
+            return false;
+        }
+
+        Variable* variable = assignment.getVariable();
+        ExprPtr value = rewrite.walk(assignment.getValue());
+        rewrite[variable] = value;
+
+        if (!llvm::is_contained(variables, variable)) {
+            variables.push_back(variable);
+        }
+        values[variable] = value;
+    }
+
+    return true;
+}
+
+bool LargeBlockEncoder::mergeBranches(Location* loc)
+{
+    llvm::SmallVector<AssignTransition*, 4> outgoing;
+    for (Transition* edge : loc->outgoing()) {
+        if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+            outgoing.push_back(assign);
+        }
+    }
+
+    for (size_t i = 0; i < outgoing.size(); ++i) {
+        for (size_t j = i + 1; j < outgoing.size(); ++j) {
+            AssignTransition* first = outgoing[i];
+            AssignTransition* second = outgoing[j];
+
+            if (first->getTarget() != second->getTarget()
+                || !isComplement(first->getGuard(), second->getGuard())
+            ) {
+                continue;
+            }
+
+            std::vector<Variable*> variables;
+            llvm::DenseMap<Variable*, ExprPtr> firstValues;
+            llvm::DenseMap<Variable*, ExprPtr> secondValues;
+            if (!getAssignedValues(first, *mExprBuilder, variables, firstValues)
+                || !getAssignedValues(second, *mExprBuilder, variables, secondValues)
+            ) {
+                continue;
+            }
+
+            // The merged assignments are evaluated in parallel, which only matches
+            // the sequential semantics if no value reads another assigned variable.
+            llvm::DenseSet<Variable*> assigned(variables.begin(), variables.end());
+            std::vector<VariableAssignment> assignments;
+            bool isParallel = true;
+
+            for (Variable* variable : variables) {
+                ExprPtr firstValue = firstValues.lookup(variable);
+                ExprPtr secondValue = secondValues.lookup(variable);
+                ExprPtr value = mExprBuilder->Select(
+                    first->getGuard(),
+                    firstValue != nullptr ? firstValue : variable->getRefExpr(),
+                    secondValue != nullptr ? secondValue : variable->getRefExpr()
+                );
+
+                llvm::DenseSet<Variable*> reads;
+                collectVariables(value, reads);
+                isParallel = llvm::all_of(reads, [&](Variable* read) {
+                    return read == variable || assigned.count(read) == 0;
+                });
+
+                if (!isParallel) {
+                    break;
+                }
+
+                assignments.emplace_back(variable, value);
+            }
+
+            if (!isParallel) {
+                continue;
+            }
+
+            mCfa.createAssignTransition(loc, first->getTarget(), mExprBuilder->True(), assignments);
+            mCfa.disconnectEdge(first);
+            mCfa.disconnectEdge(second);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+unsigned LargeBlockEncoder::run()
+{
+    unsigned numRemoved = 0;
+    bool modified = false;
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+
+        llvm::SmallVector<Location*, 32> locations(mCfa.nodes().begin(), mCfa.nodes().end());
+        for (Location* loc : locations) {
+            while (this->mergeBranches(loc)) {
+                changed = true;
+            }
+
+            if (this->canRemove(loc) && this->mergeSequence(loc)) {
+                ++numRemoved;
+                changed = true;
+            }
+        }
+
+        modified |= changed;
+    }
+
+    if (modified) {
+        mCfa.clearDisconnectedElements();
+    }
+
+    return numRemoved;
+}
+
+unsigned gazer::LargeBlockEncoding(Cfa* cfa, std::function<bool(Location*)> keep)
+{
+    LargeBlockEncoder encoder(*cfa, std::move(keep));
+    return encoder.run();
+}
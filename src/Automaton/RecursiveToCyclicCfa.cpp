@@ -22,7 +22,6 @@
 #include "gazer/Core/Expr/ExprRewrite.h"
 #include "gazer/Core/Expr/ExprBuilder.h"
 
-#include <llvm/ADT/Twine.h>
 #include <llvm/ADT/DenseSet.h>
 #include <llvm/Support/raw_ostream.h>
 
@@ -43,7 +42,7 @@ public:
 
 private:
     void addUniqueErrorLocation();
-    void inlineCallIntoRoot(CallTransition* call, llvm::Twine suffix);
+    void inlineCallIntoRoot(CallTransition* call);
 
 private:
     Cfa* mRoot;
@@ -54,7 +53,6 @@ private:
     llvm::DenseMap<Location*, Location*> mInlinedLocations;
     llvm::DenseMap<Variable*, Variable*> mInlinedVariables;
     std::unique_ptr<ExprBuilder> mExprBuilder;
-    unsigned mInlineCnt = 0;
 };
 
 } // end anonymous namespace
@@ -76,7 +74,7 @@ RecursiveToCyclicResult RecursiveToCyclicTransformer::transform()
         CallTransition* call = mTailRecursiveCalls.back();
         mTailRecursiveCalls.pop_back();
 
-        this->inlineCallIntoRoot(call, "_inlined" + llvm::Twine(mInlineCnt++));
+        this->inlineCallIntoRoot(call);
     }
     mRoot->clearDisconnectedElements();
 
@@ -91,7 +89,7 @@ RecursiveToCyclicResult RecursiveToCyclicTransformer::transform()
     };
 }
 
-void RecursiveToCyclicTransformer::inlineCallIntoRoot(CallTransition* call, llvm::Twine suffix)
+void RecursiveToCyclicTransformer::inlineCallIntoRoot(CallTransition* call)
 {
     Cfa* callee = call->getCalledAutomaton();
     Location* before = call->getSource();
@@ -104,8 +102,7 @@ void RecursiveToCyclicTransformer::inlineCallIntoRoot(CallTransition* call, llvm
     // Clone all local variables into the parent
     for (Variable& local : callee->locals()) {
         if (!callee->isOutput(&local)) {
-            auto varname = (local.getName() + suffix).str();
-            auto newLocal = mRoot->createLocal(varname, local.getType());
+            auto newLocal = mRoot->createFreshLocal(&local);
             oldVarToNew[&local] = newLocal;
             mInlinedVariables[newLocal] = &local;
             rewrite[&local] = newLocal->getRefExpr();
@@ -117,14 +114,13 @@ void RecursiveToCyclicTransformer::inlineCallIntoRoot(CallTransition* call, llvm
     std::vector<Variable*> inputTemporaries;
     for (Variable& input : callee->inputs()) {
         if (!callee->isOutput(&input)) {
-            auto varname = (input.getName() + suffix).str();
-            auto newInput = mRoot->createLocal(varname, input.getType());
+            auto newInput = mRoot->createFreshLocal(&input);
             oldVarToNew[&input] = newInput;
             mInlinedVariables[newInput] = &input;
             //rewrite[input] = call->getInputArgument(i);
             rewrite[&input] = newInput->getRefExpr();
 
-            auto val = mRoot->createLocal(varname+"_", input.getType());
+            auto val = mRoot->createFreshLocal(&input);
             inputTemporaries.emplace_back(val);
         }
     }
@@ -281,9 +277,18 @@ void RecursiveToCyclicTransformer::inlineCallIntoRoot(CallTransition* call, llvm
 
 void RecursiveToCyclicTransformer::addUniqueErrorLocation()
 {
-    auto& intTy = IntType::Get(mRoot->getParent().getContext());
     auto& ctx = mRoot->getParent().getContext();
 
+    // The error field has the type of the error codes, which is the same
+    // across all automata of the system.
+    Type* errorFieldTy = &IntType::Get(ctx);
+    for (Cfa& cfa : mRoot->getParent()) {
+        if (cfa.getNumErrors() != 0) {
+            errorFieldTy = &cfa.error_begin()->second->getType();
+            break;
+        }
+    }
+
     llvm::SmallVector<Location*, 1> errors;
     for (Location* loc : mRoot->nodes()) {
         if (loc->isError()) {
@@ -292,20 +297,27 @@ void RecursiveToCyclicTransformer::addUniqueErrorLocation()
     }
     
     mError = mRoot->createErrorLocation();
-    mErrorFieldVariable = mRoot->createLocal("__gazer_error_field", intTy);
+    mErrorFieldVariable = mRoot->createLocal("__gazer_error_field", *errorFieldTy);
 
     if (errors.empty()) {
         // If there are no error locations in the main automaton, they might still exist in a called CFA.
         // A dummy error location will be used as a goal.
+        ExprPtr zero;
+        if (auto bvTy = llvm::dyn_cast<BvType>(errorFieldTy)) {
+            zero = BvLiteralExpr::Get(*bvTy, llvm::APInt{bvTy->getWidth(), 0});
+        } else {
+            zero = IntLiteralExpr::Get(IntType::Get(ctx), 0);
+        }
+
         mRoot->createAssignTransition(mRoot->getEntry(), mError, BoolLiteralExpr::False(ctx), {
-            VariableAssignment{ mErrorFieldVariable, IntLiteralExpr::Get(intTy, 0) }
+            VariableAssignment{ mErrorFieldVariable, zero }
         });        
     } else {
         // The error location will be directly reachable from already existing error locations.
         for (Location* err : errors) {
             auto errorExpr = mRoot->getErrorFieldExpr(err);
 
-            assert(errorExpr->getType().isIntType() && "Error expression must be arithmetic integers in the theta backend!");
+            assert(errorExpr->getType() == *errorFieldTy && "Error codes must have the same type!");
 
             mRoot->createAssignTransition(err, mError, BoolLiteralExpr::True(ctx), {
                 VariableAssignment { mErrorFieldVariable, errorExpr }
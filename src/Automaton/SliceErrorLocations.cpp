@@ -0,0 +1,105 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaTransforms.h"
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <optional>
+
+using namespace gazer;
+
+static std::optional<unsigned> getLiteralErrorCode(const ExprPtr& expr)
+{
+    if (auto bvLit = llvm::dyn_cast<BvLiteralExpr>(expr)) {
+        return bvLit->getValue().getLimitedValue();
+    }
+
+    if (auto intLit = llvm::dyn_cast<IntLiteralExpr>(expr)) {
+        return intLit->getValue();
+    }
+
+    return std::nullopt;
+}
+
+static ExprPtr createErrorCodeLiteral(ExprBuilder& builder, Type& type, unsigned code)
+{
+    if (auto bvTy = llvm::dyn_cast<BvType>(&type)) {
+        return builder.BvLit(code, bvTy->getWidth());
+    }
+
+    assert(type.isIntType() && "Error codes must be bit-vectors or integers!");
+    return builder.IntLit(code);
+}
+
+void gazer::SliceErrorLocations(AutomataSystem& system, llvm::ArrayRef<unsigned> errorCodes)
+{
+    auto builder = CreateFoldingExprBuilder(system.getContext());
+
+    for (Cfa& cfa : system) {
+        // Collect the error locations first, as new ones may be inserted below.
+        llvm::SmallVector<std::pair<Location*, ExprPtr>, 4> errors(cfa.error_begin(), cfa.error_end());
+
+        for (auto& [location, errorCode] : errors) {
+            assert(location->getNumOutgoing() == 0 && "Error locations must not have outgoing transitions!");
+
+            if (auto code = getLiteralErrorCode(errorCode)) {
+                if (!llvm::is_contained(errorCodes, *code)) {
+                    cfa.disconnectNode(location);
+                }
+                continue;
+            }
+
+            // The value of the error code is only known at runtime. Redirect the incoming
+            // transitions into a fresh location and only step into the error location if
+            // the code is one of the requested ones.
+            Location* guarded = cfa.createLocation();
+            llvm::SmallVector<Transition*, 4> incoming(location->incoming_begin(), location->incoming_end());
+            for (Transition* edge : incoming) {
+                if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+                    std::vector<VariableAssignment> assigns(assign->begin(), assign->end());
+                    cfa.createAssignTransition(edge->getSource(), guarded, edge->getGuard(), assigns);
+                } else if (auto call = llvm::dyn_cast<CallTransition>(edge)) {
+                    std::vector<VariableAssignment> inputs(call->input_begin(), call->input_end());
+                    std::vector<VariableAssignment> outputs(call->output_begin(), call->output_end());
+                    cfa.createCallTransition(
+                        edge->getSource(), guarded, edge->getGuard(), call->getCalledAutomaton(), inputs, outputs
+                    );
+                } else {
+                    llvm_unreachable("Unknown transition kind!");
+                }
+            }
+
+            ExprVector isRequested;
+            for (unsigned code : errorCodes) {
+                isRequested.push_back(
+                    builder->Eq(errorCode, createErrorCodeLiteral(*builder, errorCode->getType(), code))
+                );
+            }
+
+            Location* error = cfa.createErrorLocation();
+            cfa.addErrorCode(error, errorCode);
+            cfa.createAssignTransition(guarded, error, builder->Or(isRequested));
+
+            cfa.disconnectNode(location);
+        }
+
+        cfa.clearDisconnectedElements();
+    }
+}
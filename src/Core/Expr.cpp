@@ -420,6 +420,8 @@ llvm::StringRef Expr::getKindName(ExprKind kind)
 bool Expr::isCommutative(ExprKind kind)
 {
     switch (kind) {
+        case And:
+        case Or:
         case Add:
         case Mul:
         case BvAnd:
@@ -438,6 +440,8 @@ bool Expr::isCommutative(ExprKind kind)
 bool Expr::isAssociative(ExprKind kind)
 {
     switch (kind) {
+        case And:
+        case Or:
         case Add:
         case Mul:
         case BvAnd:
@@ -0,0 +1,504 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Core/Expr/BatchExprEvaluator.h"
+#include "gazer/Core/Expr/ExprWalker.h"
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace gazer;
+using llvm::cast;
+using llvm::dyn_cast;
+
+namespace
+{
+
+/// Returns the width of a supported type, booleans have a width of 1.
+/// Returns zero for unsupported types.
+unsigned getValueWidth(Type& type)
+{
+    if (type.isBoolType()) {
+        return 1;
+    }
+
+    if (auto bvTy = dyn_cast<BvType>(&type)) {
+        return bvTy->getWidth() <= 64 ? bvTy->getWidth() : 0;
+    }
+
+    return 0;
+}
+
+inline uint64_t getMask(unsigned width)
+{
+    return width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+}
+
+inline int64_t signExtend(uint64_t value, unsigned width)
+{
+    return static_cast<int64_t>(value << (64 - width)) >> (64 - width);
+}
+
+/// Writes fn(i) into each lane of \p result. The lambdas passed here are
+/// inlined, leaving simple counted loops which the compiler vectorizes.
+template<class Fn>
+inline void forEachLane(uint64_t* result, size_t numLanes, Fn fn)
+{
+    for (size_t i = 0; i < numLanes; ++i) {
+        result[i] = fn(i);
+    }
+}
+
+/// Flattens an expression into a sequence of lane-wise instructions.
+/// The walker returns the index of the value computing each expression,
+/// or -1 if the expression is not supported.
+class BatchExprFlattener : public ExprWalker<BatchExprFlattener, int>
+{
+public:
+    struct Value
+    {
+        bool isInstruction;
+        unsigned index;
+    };
+
+    struct PendingInstruction
+    {
+        Expr::ExprKind kind;
+        unsigned width;
+        unsigned operandWidth;
+        unsigned offset;
+        llvm::SmallVector<int, 3> operands;
+    };
+
+    explicit BatchExprFlattener(llvm::ArrayRef<Variable*> variables)
+        : mNumVariables(variables.size())
+    {
+        for (size_t i = 0; i < variables.size(); ++i) {
+            mVariables[variables[i]] = i;
+        }
+    }
+
+    std::vector<Value>& getValues() { return mValues; }
+    std::vector<PendingInstruction>& getInstructions() { return mInstructions; }
+    std::vector<uint64_t>& getConstants() { return mConstants; }
+
+public:
+    bool shouldSkip(ExprView<> expr, int* ret)
+    {
+        auto it = mCache.find(expr.get());
+        if (it != mCache.end()) {
+            *ret = it->second;
+            return true;
+        }
+
+        return false;
+    }
+
+    void handleResult(ExprView<> expr, int& ret)
+    {
+        mCache[expr.get()] = ret;
+    }
+
+    int visitExpr(ExprView<> expr);
+
+private:
+    int createValue(bool isInstruction, unsigned index)
+    {
+        mValues.push_back({isInstruction, index});
+        return mValues.size() - 1;
+    }
+
+    int createInstruction(
+        Expr::ExprKind kind, unsigned width, unsigned operandWidth,
+        unsigned offset, llvm::ArrayRef<int> operands)
+    {
+        mInstructions.push_back({kind, width, operandWidth, offset, {operands.begin(), operands.end()}});
+        return this->createValue(true, mInstructions.size() - 1);
+    }
+
+private:
+    size_t mNumVariables;
+    llvm::DenseMap<Variable*, unsigned> mVariables;
+    llvm::DenseMap<Expr*, int> mCache;
+    std::vector<Value> mValues;
+    std::vector<PendingInstruction> mInstructions;
+    std::vector<uint64_t> mConstants;
+};
+
+} // end anonymous namespace
+
+int BatchExprFlattener::visitExpr(ExprView<> expr)
+{
+    unsigned width = getValueWidth(expr->getType());
+    if (width == 0) {
+        return -1;
+    }
+
+    if (auto boolLit = dyn_cast<BoolLiteralExpr>(expr)) {
+        mConstants.push_back(boolLit->getValue() ? 1 : 0);
+        return this->createValue(false, mNumVariables + mConstants.size() - 1);
+    }
+
+    if (auto bvLit = dyn_cast<BvLiteralExpr>(expr)) {
+        mConstants.push_back(bvLit->getValue().getZExtValue());
+        return this->createValue(false, mNumVariables + mConstants.size() - 1);
+    }
+
+    if (auto varRef = dyn_cast<VarRefExpr>(expr)) {
+        auto it = mVariables.find(&varRef->getVariable());
+        if (it == mVariables.end()) {
+            return -1;
+        }
+
+        return this->createValue(false, it->second);
+    }
+
+    if (expr->isNullary()) {
+        return -1;
+    }
+
+    auto nn = cast<NonNullaryExpr>(expr);
+    llvm::SmallVector<int, 3> ops;
+    for (size_t i = 0; i < nn->getNumOperands(); ++i) {
+        if (getOperand(i) < 0) {
+            return -1;
+        }
+        ops.push_back(getOperand(i));
+    }
+
+    unsigned operandWidth = getValueWidth(nn->getOperand(0)->getType());
+
+    switch (expr->getKind()) {
+        case Expr::Not:
+        case Expr::ZExt:
+        case Expr::SExt:
+            return this->createInstruction(expr->getKind(), width, operandWidth, 0, ops);
+        case Expr::Extract:
+            return this->createInstruction(
+                Expr::Extract, width, operandWidth, cast<ExtractExpr>(expr)->getOffset(), ops
+            );
+        case Expr::BvConcat:
+            // The right operand forms the low-order bits of the result.
+            return this->createInstruction(
+                Expr::BvConcat, width, operandWidth, getValueWidth(nn->getOperand(1)->getType()), ops
+            );
+        case Expr::And:
+        case Expr::Or: {
+            int result = ops[0];
+            for (size_t i = 1; i < ops.size(); ++i) {
+                result = this->createInstruction(expr->getKind(), 1, 1, 0, {result, ops[i]});
+            }
+            return result;
+        }
+        case Expr::Imply:
+        case Expr::Add:
+        case Expr::Sub:
+        case Expr::Mul:
+        case Expr::BvSDiv:
+        case Expr::BvUDiv:
+        case Expr::BvSRem:
+        case Expr::BvURem:
+        case Expr::Shl:
+        case Expr::LShr:
+        case Expr::AShr:
+        case Expr::BvAnd:
+        case Expr::BvOr:
+        case Expr::BvXor:
+        case Expr::Eq:
+        case Expr::NotEq:
+        case Expr::BvSLt:
+        case Expr::BvSLtEq:
+        case Expr::BvSGt:
+        case Expr::BvSGtEq:
+        case Expr::BvULt:
+        case Expr::BvULtEq:
+        case Expr::BvUGt:
+        case Expr::BvUGtEq:
+        case Expr::Select:
+            return this->createInstruction(expr->getKind(), width, operandWidth, 0, ops);
+        default:
+            return -1;
+    }
+}
+
+auto BatchExprEvaluator::Create(const ExprPtr& expr, llvm::ArrayRef<Variable*> variables)
+    -> std::unique_ptr<BatchExprEvaluator>
+{
+    BatchExprFlattener flattener(variables);
+    int root = flattener.walk(expr);
+    if (root < 0) {
+        return nullptr;
+    }
+
+    auto& values = flattener.getValues();
+    auto& pending = flattener.getInstructions();
+    size_t firstRegister = variables.size() + flattener.getConstants().size();
+
+    // Assign registers to the instructions: a register is released after the
+    // last instruction reading it, but only once the result register of that
+    // instruction has been allocated, so results never alias their operands.
+    constexpr size_t Released = std::numeric_limits<size_t>::max();
+    std::vector<size_t> lastUse(pending.size(), 0);
+    for (size_t i = 0; i < pending.size(); ++i) {
+        for (int op : pending[i].operands) {
+            if (values[op].isInstruction) {
+                lastUse[values[op].index] = i;
+            }
+        }
+    }
+
+    if (values[root].isInstruction) {
+        lastUse[values[root].index] = Released;
+    }
+
+    std::vector<unsigned> registers(pending.size());
+    std::vector<unsigned> freeRegisters;
+    unsigned numRegisters = 0;
+
+    auto getSlot = [&](int value) -> unsigned {
+        return values[value].isInstruction
+            ? firstRegister + registers[values[value].index]
+            : values[value].index;
+    };
+
+    std::vector<Instruction> instructions;
+    instructions.reserve(pending.size());
+
+    for (size_t i = 0; i < pending.size(); ++i) {
+        if (freeRegisters.empty()) {
+            registers[i] = numRegisters++;
+        } else {
+            registers[i] = freeRegisters.back();
+            freeRegisters.pop_back();
+        }
+
+        Instruction inst;
+        inst.kind = pending[i].kind;
+        inst.width = pending[i].width;
+        inst.operandWidth = pending[i].operandWidth;
+        inst.offset = pending[i].offset;
+        inst.result = firstRegister + registers[i];
+        for (size_t j = 0; j < 3; ++j) {
+            // Unused operands repeat the first one to keep their slot valid.
+            int op = j < pending[i].operands.size() ? pending[i].operands[j] : pending[i].operands[0];
+            inst.operands[j] = getSlot(op);
+        }
+        instructions.push_back(inst);
+
+        for (int op : pending[i].operands) {
+            if (values[op].isInstruction && lastUse[values[op].index] == i) {
+                freeRegisters.push_back(registers[values[op].index]);
+                lastUse[values[op].index] = Released;
+            }
+        }
+    }
+
+    return std::unique_ptr<BatchExprEvaluator>(new BatchExprEvaluator(
+        variables.size(), flattener.getConstants(), std::move(instructions), numRegisters, getSlot(root)
+    ));
+}
+
+BatchExprEvaluator::BatchExprEvaluator(
+    size_t numVariables, llvm::ArrayRef<uint64_t> constants,
+    std::vector<Instruction> instructions, size_t numRegisters, unsigned resultSlot
+) : mNumVariables(numVariables), mFirstRegister(numVariables + constants.size()),
+    mInstructions(std::move(instructions)), mResultSlot(resultSlot),
+    mSlots(mFirstRegister + numRegisters, nullptr),
+    mConstantBlocks(constants.size() * BlockSize),
+    mRegisters(numRegisters * BlockSize)
+{
+    for (size_t i = 0; i < constants.size(); ++i) {
+        uint64_t* block = &mConstantBlocks[i * BlockSize];
+        std::fill_n(block, BlockSize, constants[i]);
+        mSlots[numVariables + i] = block;
+    }
+
+    for (size_t i = 0; i < numRegisters; ++i) {
+        mSlots[mFirstRegister + i] = &mRegisters[i * BlockSize];
+    }
+}
+
+void BatchExprEvaluator::evaluate(
+    llvm::ArrayRef<uint64_t> columns, size_t numLanes, llvm::MutableArrayRef<uint64_t> result)
+{
+    assert(columns.size() == mNumVariables * numLanes && "Column buffer size mismatch!");
+    assert(result.size() >= numLanes && "Result buffer is too small!");
+
+    for (size_t start = 0; start < numLanes; start += BlockSize) {
+        size_t blockLanes = std::min(BlockSize, numLanes - start);
+        for (size_t i = 0; i < mNumVariables; ++i) {
+            mSlots[i] = columns.data() + i * numLanes + start;
+        }
+
+        for (const Instruction& inst : mInstructions) {
+            this->execute(inst, blockLanes);
+        }
+
+        std::copy_n(mSlots[mResultSlot], blockLanes, result.data() + start);
+    }
+}
+
+void BatchExprEvaluator::execute(const Instruction& inst, size_t numLanes)
+{
+    uint64_t* r = &mRegisters[(inst.result - mFirstRegister) * BlockSize];
+    const uint64_t* a = mSlots[inst.operands[0]];
+    const uint64_t* b = mSlots[inst.operands[1]];
+    const uint64_t* c = mSlots[inst.operands[2]];
+
+    uint64_t mask = getMask(inst.width);
+    unsigned w = inst.operandWidth;
+    unsigned offset = inst.offset;
+
+    switch (inst.kind) {
+        case Expr::Not:
+            forEachLane(r, numLanes, [=](size_t i) { return a[i] ^ mask; });
+            break;
+        case Expr::ZExt:
+            forEachLane(r, numLanes, [=](size_t i) { return a[i]; });
+            break;
+        case Expr::SExt:
+            forEachLane(r, numLanes, [=](size_t i) {
+                return static_cast<uint64_t>(signExtend(a[i], w)) & mask;
+            });
+            break;
+        case Expr::Extract:
+            forEachLane(r, numLanes, [=](size_t i) { return (a[i] >> offset) & mask; });
+            break;
+        case Expr::BvConcat:
+            forEachLane(r, numLanes, [=](size_t i) { return (a[i] << offset) | b[i]; });
+            break;
+        case Expr::Add:
+            forEachLane(r, numLanes, [=](size_t i) { return (a[i] + b[i]) & mask; });
+            break;
+        case Expr::Sub:
+            forEachLane(r, numLanes, [=](size_t i) { return (a[i] - b[i]) & mask; });
+            break;
+        case Expr::Mul:
+            forEachLane(r, numLanes, [=](size_t i) { return (a[i] * b[i]) & mask; });
+            break;
+        case Expr::BvUDiv:
+            forEachLane(r, numLanes, [=](size_t i) { return b[i] == 0 ? mask : a[i] / b[i]; });
+            break;
+        case Expr::BvURem:
+            forEachLane(r, numLanes, [=](size_t i) { return b[i] == 0 ? a[i] : a[i] % b[i]; });
+            break;
+        case Expr::BvSDiv:
+            // SMT-LIB: s / 0 is -1 for non-negative s and 1 otherwise.
+            // Division by -1 is a negation, which may wrap around.
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t {
+                int64_t sa = signExtend(a[i], w);
+                int64_t sb = signExtend(b[i], w);
+                if (sb == 0) {
+                    return sa < 0 ? 1 : mask;
+                }
+                if (sb == -1) {
+                    return (0 - a[i]) & mask;
+                }
+                return static_cast<uint64_t>(sa / sb) & mask;
+            });
+            break;
+        case Expr::BvSRem:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t {
+                int64_t sa = signExtend(a[i], w);
+                int64_t sb = signExtend(b[i], w);
+                if (sb == 0) {
+                    return a[i];
+                }
+                if (sb == -1) {
+                    return 0;
+                }
+                return static_cast<uint64_t>(sa % sb) & mask;
+            });
+            break;
+        case Expr::Shl:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t {
+                return b[i] >= w ? 0 : (a[i] << (b[i] & 63)) & mask;
+            });
+            break;
+        case Expr::LShr:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t {
+                return b[i] >= w ? 0 : a[i] >> (b[i] & 63);
+            });
+            break;
+        case Expr::AShr:
+            forEachLane(r, numLanes, [=](size_t i) {
+                uint64_t amount = std::min<uint64_t>(b[i], w - 1);
+                return static_cast<uint64_t>(signExtend(a[i], w) >> amount) & mask;
+            });
+            break;
+        case Expr::BvAnd:
+        case Expr::And:
+            forEachLane(r, numLanes, [=](size_t i) { return a[i] & b[i]; });
+            break;
+        case Expr::BvOr:
+        case Expr::Or:
+            forEachLane(r, numLanes, [=](size_t i) { return a[i] | b[i]; });
+            break;
+        case Expr::BvXor:
+            forEachLane(r, numLanes, [=](size_t i) { return a[i] ^ b[i]; });
+            break;
+        case Expr::Imply:
+            forEachLane(r, numLanes, [=](size_t i) { return (a[i] ^ 1) | b[i]; });
+            break;
+        case Expr::Eq:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t { return a[i] == b[i]; });
+            break;
+        case Expr::NotEq:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t { return a[i] != b[i]; });
+            break;
+        case Expr::BvSLt:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t {
+                return signExtend(a[i], w) < signExtend(b[i], w);
+            });
+            break;
+        case Expr::BvSLtEq:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t {
+                return signExtend(a[i], w) <= signExtend(b[i], w);
+            });
+            break;
+        case Expr::BvSGt:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t {
+                return signExtend(a[i], w) > signExtend(b[i], w);
+            });
+            break;
+        case Expr::BvSGtEq:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t {
+                return signExtend(a[i], w) >= signExtend(b[i], w);
+            });
+            break;
+        case Expr::BvULt:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t { return a[i] < b[i]; });
+            break;
+        case Expr::BvULtEq:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t { return a[i] <= b[i]; });
+            break;
+        case Expr::BvUGt:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t { return a[i] > b[i]; });
+            break;
+        case Expr::BvUGtEq:
+            forEachLane(r, numLanes, [=](size_t i) -> uint64_t { return a[i] >= b[i]; });
+            break;
+        case Expr::Select:
+            forEachLane(r, numLanes, [=](size_t i) { return a[i] != 0 ? b[i] : c[i]; });
+            break;
+        default:
+            llvm_unreachable("Unsupported batch instruction!");
+    }
+}
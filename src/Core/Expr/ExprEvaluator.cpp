@@ -37,26 +37,26 @@ auto ValuationExprEvaluator::getVariableValue(Variable& variable)
     return result->second;
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitUndef(const ExprRef<UndefExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitUndef(ExprView<UndefExpr> expr)
 {
-    return expr;
+    return expr.ref();
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitExpr(const ExprPtr& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitExpr(ExprView<> expr)
 {
     LLVM_DEBUG(llvm::dbgs() << "Unhandled expression: " << *expr << "\n");
     llvm_unreachable("Unhandled expression type in ExprEvaluatorBase");
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitLiteral(const ExprRef<AtomicExpr>& expr) {
-    return expr;
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitLiteral(ExprView<AtomicExpr> expr) {
+    return expr.ref();
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitVarRef(const ExprRef<VarRefExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitVarRef(ExprView<VarRefExpr> expr) {
     return this->getVariableValue(expr->getVariable());
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitZExt(const ExprRef<ZExtExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitZExt(ExprView<ZExtExpr> expr)
 {
     auto bvLit = dyn_cast<BvLiteralExpr>(getOperand(0));
     auto& type = llvm::cast<BvType>(expr->getType());
@@ -64,7 +64,7 @@ ExprRef<AtomicExpr> ExprEvaluatorBase::visitZExt(const ExprRef<ZExtExpr>& expr)
     return BvLiteralExpr::Get(type, bvLit->getValue().zext(expr->getExtendedWidth()));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitSExt(const ExprRef<SExtExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitSExt(ExprView<SExtExpr> expr)
 {
     auto bvLit = dyn_cast<BvLiteralExpr>(getOperand(0));
     auto& type = llvm::cast<BvType>(expr->getType());
@@ -72,7 +72,7 @@ ExprRef<AtomicExpr> ExprEvaluatorBase::visitSExt(const ExprRef<SExtExpr>& expr)
     return BvLiteralExpr::Get(type, bvLit->getValue().sext(expr->getExtendedWidth()));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvConcat(const ExprRef<BvConcatExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvConcat(ExprView<BvConcatExpr> expr)
 {
     auto left = getOperand(0);
     auto right = getOperand(1);
@@ -93,7 +93,7 @@ ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvConcat(const ExprRef<BvConcatExpr>
     return BvLiteralExpr::Get(BvType::Get(expr->getContext(), size), result);
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitExtract(const ExprRef<ExtractExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitExtract(ExprView<ExtractExpr> expr)
 {
     auto bvLit = dyn_cast<BvLiteralExpr>(getOperand(0));
 
@@ -176,82 +176,82 @@ static ExprRef<AtomicExpr> EvalBinaryArithmetic(
 }
 
 // Binary
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitAdd(const ExprRef<AddExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitAdd(ExprView<AddExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitSub(const ExprRef<SubExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitSub(ExprView<SubExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitMul(const ExprRef<MulExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitMul(ExprView<MulExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitDiv(const ExprRef<DivExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitDiv(ExprView<DivExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitMod(const ExprRef<ModExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitMod(ExprView<ModExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitRem(const ExprRef<RemExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitRem(ExprView<RemExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvSDiv(const ExprRef<BvSDivExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvSDiv(ExprView<BvSDivExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvUDiv(const ExprRef<BvUDivExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvUDiv(ExprView<BvUDivExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvSRem(const ExprRef<BvSRemExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvSRem(ExprView<BvSRemExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvURem(const ExprRef<BvURemExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvURem(ExprView<BvURemExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitShl(const ExprRef<ShlExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitShl(ExprView<ShlExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitLShr(const ExprRef<LShrExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitLShr(ExprView<LShrExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitAShr(const ExprRef<AShrExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitAShr(ExprView<AShrExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvAnd(const ExprRef<BvAndExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvAnd(ExprView<BvAndExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvOr(const ExprRef<BvOrExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvOr(ExprView<BvOrExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvXor(const ExprRef<BvXorExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvXor(ExprView<BvXorExpr> expr)
 {
     return EvalBinaryArithmetic(expr->getKind(), getOperand(0), getOperand(1));
 }
@@ -259,13 +259,13 @@ ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvXor(const ExprRef<BvXorExpr>& expr
 // Logic
 //-----------------------------------------------------------------------------
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitNot(const ExprRef<NotExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitNot(ExprView<NotExpr> expr)
 {
     auto boolLit = cast<BoolLiteralExpr>(getOperand(0).get());
     return BoolLiteralExpr::Get(cast<BoolType>(expr->getType()), !boolLit->getValue());
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitAnd(const ExprRef<AndExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitAnd(ExprView<AndExpr> expr)
 {
     bool isUndef = false;
 
@@ -288,7 +288,7 @@ ExprRef<AtomicExpr> ExprEvaluatorBase::visitAnd(const ExprRef<AndExpr>& expr)
     return BoolLiteralExpr::True(BoolType::Get(expr->getContext()));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitOr(const ExprRef<OrExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitOr(ExprView<OrExpr> expr)
 {
     bool isUndef = false;
 
@@ -311,7 +311,7 @@ ExprRef<AtomicExpr> ExprEvaluatorBase::visitOr(const ExprRef<OrExpr>& expr)
     return BoolLiteralExpr::False(BoolType::Get(expr->getContext()));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitImply(const ExprRef<ImplyExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitImply(ExprView<ImplyExpr> expr)
 {
     auto left  = getOperand(0);
     auto right = getOperand(1);
@@ -432,7 +432,7 @@ static ExprRef<AtomicExpr> EvalBinaryCompare(
 }
 
 #define HANDLE_BINARY_COMPARE(KIND)                                                         \
-    ExprRef<AtomicExpr> ExprEvaluatorBase::visit##KIND(const ExprRef<KIND##Expr>& expr) {   \
+    ExprRef<AtomicExpr> ExprEvaluatorBase::visit##KIND(ExprView<KIND##Expr> expr) {         \
         return EvalBinaryCompare(Expr::KIND, getOperand(0), getOperand(1));                 \
     }                                                                                       \
 
@@ -454,76 +454,76 @@ HANDLE_BINARY_COMPARE(BvUGtEq)
 #undef HANDLE_BINARY_COMPARE
 
 // Floating-point queries
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFIsNan(const ExprRef<FIsNanExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFIsNan(ExprView<FIsNanExpr> expr)
 {
     auto fpLit = llvm::cast<FloatLiteralExpr>(getOperand(0));
     return BoolLiteralExpr::Get(BoolType::Get(expr->getContext()), fpLit->getValue().isNaN());
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFIsInf(const ExprRef<FIsInfExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFIsInf(ExprView<FIsInfExpr> expr)
 {
     auto fpLit = llvm::cast<FloatLiteralExpr>(getOperand(0));
     return BoolLiteralExpr::Get(BoolType::Get(expr->getContext()), fpLit->getValue().isInfinity());
 }
 
 // Floating-point arithmetic
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFAdd(const ExprRef<FAddExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFAdd(ExprView<FAddExpr> expr) {
     return this->visitNonNullary(expr);
 }
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFSub(const ExprRef<FSubExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFSub(ExprView<FSubExpr> expr) {
     return this->visitNonNullary(expr);
 }
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFMul(const ExprRef<FMulExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFMul(ExprView<FMulExpr> expr) {
     return this->visitNonNullary(expr);
 }
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFDiv(const ExprRef<FDivExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFDiv(ExprView<FDivExpr> expr) {
     return this->visitNonNullary(expr);
 }
 
 // Floating-point compare
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFEq(const ExprRef<FEqExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFEq(ExprView<FEqExpr> expr) {
     return this->visitNonNullary(expr);
 }
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFGt(const ExprRef<FGtExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFGt(ExprView<FGtExpr> expr) {
     return this->visitNonNullary(expr);
 }
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFGtEq(const ExprRef<FGtEqExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFGtEq(ExprView<FGtEqExpr> expr) {
     return this->visitNonNullary(expr);
 }
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFLt(const ExprRef<FLtExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFLt(ExprView<FLtExpr> expr) {
     return this->visitNonNullary(expr);
 }
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFLtEq(const ExprRef<FLtEqExpr>& expr) {
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFLtEq(ExprView<FLtEqExpr> expr) {
     return this->visitNonNullary(expr);
 }
 
 // Floating-point casts
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFCast(const ExprRef<FCastExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFCast(ExprView<FCastExpr> expr)
 {
     return this->visitNonNullary(expr);
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitSignedToFp(const ExprRef<SignedToFpExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitSignedToFp(ExprView<SignedToFpExpr> expr)
 {
     return this->visitNonNullary(expr);
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitUnsignedToFp(const ExprRef<UnsignedToFpExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitUnsignedToFp(ExprView<UnsignedToFpExpr> expr)
 {
     return this->visitNonNullary(expr);
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFpToSigned(const ExprRef<FpToSignedExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFpToSigned(ExprView<FpToSignedExpr> expr)
 {
     return this->visitNonNullary(expr);
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFpToUnsigned(const ExprRef<FpToUnsignedExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFpToUnsigned(ExprView<FpToUnsignedExpr> expr)
 {
     return this->visitNonNullary(expr);
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitFpToBv(const ExprRef<FpToBvExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitFpToBv(ExprView<FpToBvExpr> expr)
 {
     auto fpLit = llvm::cast<FloatLiteralExpr>(getOperand(0));
     auto& bvType = llvm::cast<BvType>(expr->getType());
@@ -531,7 +531,7 @@ ExprRef<AtomicExpr> ExprEvaluatorBase::visitFpToBv(const ExprRef<FpToBvExpr>& ex
     return BvLiteralExpr::Get(bvType, fpLit->getValue().bitcastToAPInt());
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvToFp(const ExprRef<BvToFpExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitBvToFp(ExprView<BvToFpExpr> expr)
 {
     auto bvLit = llvm::cast<BvLiteralExpr>(getOperand(0));
     auto& fltTy = llvm::cast<FloatType>(expr->getType());
@@ -553,7 +553,7 @@ ExprRef<AtomicExpr> EvalSelect(
 }
 
 // Ternary
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitSelect(const ExprRef<SelectExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitSelect(ExprView<SelectExpr> expr)
 {
     auto cond = cast<BoolLiteralExpr>(getOperand(0));
     auto then = getOperand(1);
@@ -576,7 +576,7 @@ ExprRef<AtomicExpr> ExprEvaluatorBase::visitSelect(const ExprRef<SelectExpr>& ex
 }
 
 // Arrays
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitArrayRead(const ExprRef<ArrayReadExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitArrayRead(ExprView<ArrayReadExpr> expr)
 {
     auto array = getOperand(0);
     if (array->isUndef()) {
@@ -593,7 +593,7 @@ ExprRef<AtomicExpr> ExprEvaluatorBase::visitArrayRead(const ExprRef<ArrayReadExp
     return litArray->getValue(llvm::cast<LiteralExpr>(index));
 }
 
-ExprRef<AtomicExpr> ExprEvaluatorBase::visitArrayWrite(const ExprRef<ArrayWriteExpr>& expr)
+ExprRef<AtomicExpr> ExprEvaluatorBase::visitArrayWrite(ExprView<ArrayWriteExpr> expr)
 {
     return this->visitNonNullary(expr);
 }
\ No newline at end of file
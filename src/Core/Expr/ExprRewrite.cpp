@@ -19,7 +19,7 @@
 
 using namespace gazer;
 
-ExprPtr ExprRewriteBase::rewriteNonNullary(const ExprRef<NonNullaryExpr>& expr, const ExprVector& ops)
+ExprPtr ExprRewriteBase::rewriteNonNullary(ExprView<NonNullaryExpr> expr, const ExprVector& ops)
 {
     switch (expr->getKind()) {
         case Expr::Not: return mExprBuilder.Not(ops[0]);
@@ -129,14 +129,14 @@ ExprPtr ExprRewriteBase::rewriteNonNullary(const ExprRef<NonNullaryExpr>& expr,
     llvm_unreachable("Invalid non-nullary expression kind.");
 }
 
-ExprPtr VariableExprRewrite::visitVarRef(const ExprRef<VarRefExpr>& expr)
+ExprPtr VariableExprRewrite::visitVarRef(ExprView<VarRefExpr> expr)
 {
-    auto result = mRewriteMap[&expr->getVariable()];
-    if (result != nullptr) {
-        return result;
+    auto it = mRewriteMap.find(&expr->getVariable());
+    if (it != mRewriteMap.end() && it->second != nullptr) {
+        return it->second;
     }
 
-    return expr;
+    return expr.ref();
 }
 
 ExprPtr& VariableExprRewrite::operator[](Variable* variable)
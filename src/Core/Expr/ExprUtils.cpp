@@ -17,6 +17,9 @@
 //===----------------------------------------------------------------------===//
 #include "gazer/Core/Expr/ExprUtils.h"
 
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/Optional.h>
+
 #include <numeric>
 
 using namespace gazer;
@@ -41,3 +44,60 @@ unsigned gazer::ExprDepth(const ExprPtr& expr)
 
     llvm_unreachable("An expression cannot be nullary and non-nullary at the same time!");
 }
+
+namespace
+{
+
+/// Walks an expression DAG, visiting each shared node once.
+class BudgetedExprWalker
+{
+public:
+    BudgetedExprWalker(unsigned maxNodes, unsigned maxDepth)
+        : mMaxNodes(maxNodes), mMaxDepth(maxDepth)
+    {}
+
+    /// Returns the height of \p expr, visited at the given \p level, or
+    /// None if the budget was exceeded.
+    llvm::Optional<unsigned> visit(Expr* expr, unsigned level)
+    {
+        auto it = mHeights.find(expr);
+        if (it != mHeights.end()) {
+            if (level + it->second - 1 > mMaxDepth) {
+                return llvm::None;
+            }
+            return it->second;
+        }
+
+        if (level > mMaxDepth || ++mNumNodes > mMaxNodes) {
+            return llvm::None;
+        }
+
+        unsigned height = 1;
+        if (auto nn = llvm::dyn_cast<NonNullaryExpr>(expr)) {
+            for (const ExprPtr& op : nn->operands()) {
+                auto opHeight = this->visit(op.get(), level + 1);
+                if (!opHeight.hasValue()) {
+                    return llvm::None;
+                }
+                height = std::max(height, *opHeight + 1);
+            }
+        }
+
+        mHeights[expr] = height;
+        return height;
+    }
+
+private:
+    unsigned mMaxNodes;
+    unsigned mMaxDepth;
+    unsigned mNumNodes = 0;
+    llvm::DenseMap<Expr*, unsigned> mHeights;
+};
+
+} // end anonymous namespace
+
+bool gazer::ExprFitsInBudget(const ExprPtr& expr, unsigned maxNodes, unsigned maxDepth)
+{
+    BudgetedExprWalker walker(maxNodes, maxDepth);
+    return walker.visit(expr.get(), 1).hasValue();
+}
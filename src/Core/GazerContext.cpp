@@ -72,9 +72,12 @@ GazerContext::~GazerContext() = default;
 Variable* GazerContext::createVariable(const std::string& name, Type &type)
 {
     LLVM_DEBUG(llvm::dbgs() << "Adding variable with name " << name << " and type " << type << "\n");
-    GAZER_DEBUG_ASSERT(pImpl->VariableTable.count(name) == 0);
-    auto ptr = new Variable(name, type);
-    pImpl->VariableTable[name] = std::unique_ptr<Variable>(ptr);
+    GAZER_DEBUG_ASSERT(pImpl->VariableNames.count(name) == 0);
+    assert(name.find('#') == std::string::npos && "The '#' character is reserved for fresh variables!");
+
+    auto ptr = new Variable(pImpl->Variables.size(), name, type);
+    pImpl->Variables.emplace_back(ptr);
+    pImpl->VariableNames[name] = ptr;
 
     GAZER_DEBUG(llvm::errs()
         << "[GazerContext] Adding variable with name: '"
@@ -86,22 +89,48 @@ Variable* GazerContext::createVariable(const std::string& name, Type &type)
     return ptr;
 }
 
+Variable* GazerContext::createFreshVariable(llvm::StringRef prefix, Type& type)
+{
+    auto ptr = new Variable(pImpl->Variables.size(), prefix, nullptr, type);
+    pImpl->Variables.emplace_back(ptr);
+
+    return ptr;
+}
+
+Variable* GazerContext::createFreshVariable(const Variable* base, Type& type)
+{
+    assert(base != nullptr && "Fresh variables must be derived from a valid variable!");
+    auto ptr = new Variable(pImpl->Variables.size(), "", base, type);
+    pImpl->Variables.emplace_back(ptr);
+
+    return ptr;
+}
+
 Variable* GazerContext::getVariable(llvm::StringRef name)
 {
-    auto result = pImpl->VariableTable.find(name);
-    if (result == pImpl->VariableTable.end()) {
-        return nullptr;
-    }
+    return pImpl->VariableNames.lookup(name);
+}
 
-    return result->second.get();
+Variable* GazerContext::getVariableById(unsigned id)
+{
+    assert(id < pImpl->Variables.size() && "Invalid variable identifier!");
+    return pImpl->Variables[id].get();
+}
+
+unsigned GazerContext::getNumVariableIds() const
+{
+    return pImpl->Variables.size();
 }
 
 void GazerContext::removeVariable(Variable* variable)
 {
-    auto result = pImpl->VariableTable.find(variable->getName());
-    assert(result != pImpl->VariableTable.end() && "Attempting to delete a non-existant variable!");
+    assert(pImpl->Variables[variable->getId()].get() == variable
+        && "Attempting to delete a non-existant variable!");
 
-    pImpl->VariableTable.erase(result);
+    if (!variable->isFresh()) {
+        pImpl->VariableNames.erase(variable->getName());
+    }
+    pImpl->Variables[variable->getId()].reset();
 }
 
 //------------------------------- Expressions -------------------------------//
@@ -205,6 +234,40 @@ void ExprStorage::destroy(Expr *expr)
     }
 }
 
+ExprVector ExprStorage::flattenOperands(Expr::ExprKind kind, const ExprVector& ops)
+{
+    ExprVector result;
+    result.reserve(ops.size());
+
+    // Use an explicit worklist, as associative chains may be very deep.
+    ExprVector worklist(ops.rbegin(), ops.rend());
+    while (!worklist.empty()) {
+        ExprPtr current = std::move(worklist.back());
+        worklist.pop_back();
+
+        if (current->getKind() == kind) {
+            auto nn = llvm::cast<NonNullaryExpr>(current);
+            worklist.insert(worklist.end(), nn->op_begin(), nn->op_end());
+            std::reverse(worklist.end() - nn->getNumOperands(), worklist.end());
+        } else {
+            result.emplace_back(std::move(current));
+        }
+    }
+
+    return result;
+}
+
+bool ExprStorage::isCanonicalOrder(const ExprPtr& lhs, const ExprPtr& rhs)
+{
+    bool lhsLit = llvm::isa<LiteralExpr>(lhs);
+    bool rhsLit = llvm::isa<LiteralExpr>(rhs);
+    if (lhsLit != rhsLit) {
+        return rhsLit;
+    }
+
+    return lhs->getId() < rhs->getId();
+}
+
 void ExprStorage::rehashTable(size_t newSize)
 {
     GAZER_DEBUG(llvm::errs() << "[ExprStorage] Extending table " << newSize << "\n")
@@ -254,10 +317,20 @@ ExprStorage::~ExprStorage()
     delete[] mStorage;
 }
 
+void GazerContext::setExprCanonicalization(bool enabled)
+{
+    pImpl->Exprs.setCanonicalization(enabled);
+}
+
+bool GazerContext::isExprCanonicalizationEnabled() const
+{
+    return pImpl->Exprs.isCanonicalizing();
+}
+
 void GazerContext::dumpStats(llvm::raw_ostream& os) const
 {
     os << "Number of expressions: " << pImpl->Exprs.size() << "\n";
-    os << "Number of variables: " << pImpl->VariableTable.size() << "\n";
+    os << "Number of variables: " << pImpl->Variables.size() << "\n";
 }
 
 //-------------------------------- Resources --------------------------------//
@@ -273,8 +346,16 @@ GazerContextImpl::GazerContextImpl(GazerContext& ctx)
     TrueLit(new BoolLiteralExpr(BoolTy, true)),
     FalseLit(new BoolLiteralExpr(BoolTy, false))
 {
+    BvTypeSlots[1] = &Bv1Ty;
+    BvTypeSlots[8] = &Bv8Ty;
+    BvTypeSlots[16] = &Bv16Ty;
+    BvTypeSlots[32] = &Bv32Ty;
+    BvTypeSlots[64] = &Bv64Ty;
+
     TrueLit->mHashCode = llvm::hash_value(TrueLit.get());
+    TrueLit->mId = Exprs.createId();
     FalseLit->mHashCode = llvm::hash_value(FalseLit.get());
+    FalseLit->mId = Exprs.createId();
 }
 
 GazerContextImpl::~GazerContextImpl() = default;
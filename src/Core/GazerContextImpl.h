@@ -33,6 +33,8 @@
 
 #include <boost/container_hash/hash.hpp>
 
+#include <algorithm>
+#include <array>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -281,6 +283,36 @@ template<> struct expr_hasher<TupleSelectExpr>
     }
 };
 
+//------------------------------ Type storage -------------------------------//
+
+/// DenseMap key information for type lists. The keys of an interned type
+/// refer to the subtype list stored in the type itself, thus lookups may
+/// pass any contiguous range of types without building a key.
+struct TypeListKeyInfo
+{
+    static llvm::ArrayRef<Type*> getEmptyKey() {
+        return llvm::ArrayRef<Type*>(
+            reinterpret_cast<Type* const*>(~static_cast<uintptr_t>(0)), static_cast<size_t>(0));
+    }
+
+    static llvm::ArrayRef<Type*> getTombstoneKey() {
+        return llvm::ArrayRef<Type*>(
+            reinterpret_cast<Type* const*>(~static_cast<uintptr_t>(1)), static_cast<size_t>(0));
+    }
+
+    static unsigned getHashValue(llvm::ArrayRef<Type*> key) {
+        return static_cast<unsigned>(llvm::hash_combine_range(key.begin(), key.end()));
+    }
+
+    static bool isEqual(llvm::ArrayRef<Type*> lhs, llvm::ArrayRef<Type*> rhs) {
+        if (rhs.data() == getEmptyKey().data() || rhs.data() == getTombstoneKey().data()) {
+            return lhs.data() == rhs.data();
+        }
+
+        return lhs == rhs;
+    }
+};
+
 //--------------------------- Expression storage ----------------------------//
 
 /// \brief Internal hashed set storage for all non-nullary expressions
@@ -334,6 +366,10 @@ public:
         InputIterator op_begin, InputIterator op_end,
         SubclassData&&... subclassData
     ) {
+        if (mCanonicalize && (Expr::isCommutative(Kind) || Expr::isAssociative(Kind))) {
+            return createCanonical<ExprTy>(Kind, type, op_begin, op_end, subclassData...);
+        }
+
         return createIfNotExists<ExprTy>(Kind, type, op_begin, op_end, std::forward<SubclassData>(subclassData)...);
     }
 
@@ -351,7 +387,54 @@ public:
 
     size_t size() const { return mEntryCount; }
 
+    /// Returns the next expression identifier.
+    unsigned createId() { return mNextId++; }
+
+    void setCanonicalization(bool enabled) { mCanonicalize = enabled; }
+    bool isCanonicalizing() const { return mCanonicalize; }
+
 private:
+    /// Creates a commutative or associative expression in canonical form:
+    /// nested applications of an associative operator are flattened and
+    /// the operands of a commutative operator are sorted by their identifier.
+    /// Multiary operators become a single node, binary ones a left-deep chain.
+    template<class ExprTy, class InputIterator, class... SubclassData>
+    ExprRef<ExprTy> createCanonical(
+        Expr::ExprKind kind, Type& type,
+        InputIterator op_begin, InputIterator op_end,
+        SubclassData&... subclassData
+    ) {
+        ExprVector ops(op_begin, op_end);
+        if (Expr::isAssociative(kind)) {
+            ops = flattenOperands(kind, ops);
+        }
+
+        if (Expr::isCommutative(kind)) {
+            std::sort(ops.begin(), ops.end(), &ExprStorage::isCanonicalOrder);
+        }
+
+        if constexpr (std::is_base_of_v<BinaryExpr, ExprTy>) {
+            assert(ops.size() >= 2 && "Binary expressions must have at least two operands!");
+            for (size_t i = 1; i < ops.size() - 1; ++i) {
+                std::array<ExprPtr, 2> pair = { ops[i - 1], ops[i] };
+                ops[i] = createIfNotExists<ExprTy>(kind, type, pair.begin(), pair.end(), subclassData...);
+            }
+
+            std::array<ExprPtr, 2> last = { ops[ops.size() - 2], ops.back() };
+            return createIfNotExists<ExprTy>(kind, type, last.begin(), last.end(), subclassData...);
+        } else {
+            return createIfNotExists<ExprTy>(kind, type, ops.begin(), ops.end(), subclassData...);
+        }
+    }
+
+    /// Replaces each operand which is an application of \p kind with its
+    /// own operands, recursively.
+    static ExprVector flattenOperands(Expr::ExprKind kind, const ExprVector& ops);
+
+    /// Orders non-literal operands before literals, so folding builders
+    /// still find constants on the right-hand side.
+    static bool isCanonicalOrder(const ExprPtr& lhs, const ExprPtr& rhs);
+
     template<class ExprTy, class... ConstructorArgs>
     ExprRef<ExprTy> createIfNotExists(ConstructorArgs&&... args)
     {
@@ -377,6 +460,7 @@ private:
 
         auto expr = new ExprTy(args...);
         expr->mHashCode = hash;
+        expr->mId = this->createId();
 
         GAZER_DEBUG(
             llvm::errs()
@@ -407,6 +491,8 @@ private:
     Bucket* mStorage;
     size_t  mBucketCount;
     size_t  mEntryCount = 0;
+    unsigned mNextId = 0;
+    bool mCanonicalize = false;
 };
 
 class GazerContextImpl
@@ -419,22 +505,20 @@ public:
 
 public:
     //---------------------- Types ----------------------//
+    static constexpr unsigned MaxDirectBvWidth = 64;
+
     BoolType BoolTy;
     IntType IntTy;
     RealType RealTy;
     BvType Bv1Ty, Bv8Ty, Bv16Ty, Bv32Ty, Bv64Ty;
-    std::unordered_map<unsigned, std::unique_ptr<BvType>> BvTypes;
+    // Bit-vector types up to MaxDirectBvWidth are found by indexing into
+    // BvTypeSlots, wider ones by a lookup in BvTypes. Types not declared
+    // above are owned by BvTypes.
+    std::array<BvType*, MaxDirectBvWidth + 1> BvTypeSlots = {};
+    llvm::DenseMap<unsigned, std::unique_ptr<BvType>> BvTypes;
     FloatType FpHalfTy, FpSingleTy, FpDoubleTy, FpQuadTy;
-    std::unordered_map<
-        std::vector<Type*>,
-        std::unique_ptr<ArrayType>,
-        boost::hash<std::vector<Type*>>
-    > ArrayTypes;
-    std::unordered_map<
-        std::vector<Type*>,
-        std::unique_ptr<TupleType>,
-        boost::hash<std::vector<Type*>>
-    > TupleTypes;
+    llvm::DenseMap<std::pair<Type*, Type*>, std::unique_ptr<ArrayType>> ArrayTypes;
+    llvm::DenseMap<llvm::ArrayRef<Type*>, std::unique_ptr<TupleType>, TypeListKeyInfo> TupleTypes;
     std::unordered_map<
         std::pair<Type*, std::vector<Type*>>,
         std::unique_ptr<FunctionType>,
@@ -444,7 +528,12 @@ public:
     //------------------- Expressions -------------------//
     ExprStorage Exprs;
     ExprRef<BoolLiteralExpr> TrueLit, FalseLit;
-    llvm::StringMap<std::unique_ptr<Variable>> VariableTable;
+
+    //-------------------- Variables --------------------//
+    // Variables are indexed by their identifier, removed variables leave
+    // an empty slot. Only named variables are present in the name table.
+    std::vector<std::unique_ptr<Variable>> Variables;
+    llvm::StringMap<Variable*> VariableNames;
 
 private:
 };
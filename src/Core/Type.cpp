@@ -132,24 +132,22 @@ auto BvType::Get(GazerContext& context, unsigned width) -> BvType&
 {
     auto& pImpl = context.pImpl;
 
-    switch (width) {
-        case 8:  return pImpl->Bv8Ty;
-        case 16: return pImpl->Bv16Ty;
-        case 32: return pImpl->Bv32Ty;
-        case 64: return pImpl->Bv64Ty;
-        default:
-            break;
-    }
+    if (width <= GazerContextImpl::MaxDirectBvWidth) {
+        BvType*& slot = pImpl->BvTypeSlots[width];
+        if (slot == nullptr) {
+            slot = new BvType(context, width);
+            pImpl->BvTypes.try_emplace(width, slot);
+        }
 
-    auto result = pImpl->BvTypes.find(width);
-    if (result == pImpl->BvTypes.end()) {
-        auto ptr = new BvType(context, width);
-        pImpl->BvTypes.emplace(width, ptr);
+        return *slot;
+    }
 
-        return *ptr;
+    auto& result = pImpl->BvTypes[width];
+    if (result == nullptr) {
+        result.reset(new BvType(context, width));
     }
 
-    return *result->second;
+    return *result;
 }
 
 auto FloatType::Get(
@@ -221,20 +219,15 @@ ArrayType& ArrayType::Get(Type& indexType, Type& elementType)
     auto& ctx = indexType.getContext();
     auto& pImpl = ctx.pImpl;
 
-    std::vector<Type*> subtypes = { &indexType, &elementType };
-
-    auto result = pImpl->ArrayTypes.find(subtypes);
-    if (result == pImpl->ArrayTypes.end()) {
-        auto ptr = new ArrayType(ctx, subtypes);
-        pImpl->ArrayTypes.emplace(subtypes, ptr);
-
-        return *ptr;
+    auto& result = pImpl->ArrayTypes[{ &indexType, &elementType }];
+    if (result == nullptr) {
+        result.reset(new ArrayType(ctx, { &indexType, &elementType }));
     }
 
-    return *result->second;
+    return *result;
 }
 
-TupleType& TupleType::Get(std::vector<Type*> subtypes)
+TupleType& TupleType::Get(llvm::ArrayRef<Type*> subtypes)
 {
     assert(!subtypes.empty());
     assert(subtypes.size() >= 2);
@@ -247,8 +240,10 @@ TupleType& TupleType::Get(std::vector<Type*> subtypes)
 
     auto result = pImpl->TupleTypes.find(subtypes);
     if (result == pImpl->TupleTypes.end()) {
-        auto ptr = new TupleType(ctx, subtypes);
-        pImpl->TupleTypes.emplace(subtypes, ptr);
+        auto ptr = new TupleType(ctx, subtypes.vec());
+
+        // The key must refer to the list owned by the new type.
+        pImpl->TupleTypes.try_emplace(ptr->mSubtypeList, ptr);
 
         return *ptr;
     }
@@ -21,12 +21,34 @@
 
 using namespace gazer;
 
-Variable::Variable(llvm::StringRef name, Type& type)
-    : Decl(Decl::Variable, type), mName(name)
+Variable::Variable(unsigned id, llvm::StringRef name, Type& type)
+    : Decl(Decl::Variable, type), mId(id), mIsFresh(false), mName(name)
 {
     mExpr = type.getContext().pImpl->Exprs.create<VarRefExpr>(this);
 }
 
+Variable::Variable(unsigned id, llvm::StringRef prefix, const Variable* base, Type& type)
+    : Decl(Decl::Variable, type), mId(id), mIsFresh(true), mPrefix(prefix), mBase(base)
+{
+    mExpr = type.getContext().pImpl->Exprs.create<VarRefExpr>(this);
+}
+
+std::string Variable::getName() const
+{
+    if (!mIsFresh) {
+        return mName;
+    }
+
+    // The '#' character is reserved for fresh variables, their names cannot
+    // clash with the names of registered variables.
+    std::string name = mBase != nullptr ? mBase->getName() : std::string();
+    name += mPrefix;
+    name += '#';
+    name += std::to_string(mId);
+
+    return name;
+}
+
 VarRefExpr::VarRefExpr(Variable* variable)
     : Expr(Expr::VarRef, variable->getType()), mVariable(variable)
 {
@@ -38,7 +60,7 @@ bool Variable::operator==(const Variable &other) const
         return false;
     }
 
-    return mName == other.mName;
+    return mId == other.mId;
 }
 
 void VarRefExpr::print(llvm::raw_ostream& os) const {
@@ -0,0 +1,804 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/JIT/ExprCompiler.h"
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Expr/ExprWalker.h"
+
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/TargetSelect.h>
+
+using namespace gazer;
+using llvm::cast;
+using llvm::dyn_cast;
+using llvm::isa;
+
+namespace
+{
+
+/// Translates an expression into the body of a compiled function.
+///
+/// The result of each subexpression is an LLVM value of the type given by
+/// getValueType(), or nullptr if the subexpression is not supported.
+/// Operations which may have an undefined result are computed with safe
+/// operands, and the conditions of their definedness are collected into
+/// mDefined.
+class ExprCodeGen : public ExprWalker<ExprCodeGen, llvm::Value*>
+{
+public:
+    ExprCodeGen(
+        ExprCompiler& compiler, llvm::IRBuilder<>& ir,
+        llvm::Value* values, llvm::Value* readArray, llvm::FunctionType* readArrayTy
+    ) : mCompiler(compiler), mIR(ir), mContext(ir.getContext()),
+        mValues(values), mReadArray(readArray), mReadArrayTy(readArrayTy)
+    {
+        mDefined = mIR.getTrue();
+    }
+
+    /// Returns the LLVM type representing values of \p type,
+    /// or nullptr if the type is not supported.
+    llvm::Type* getValueType(Type& type);
+
+    /// Converts a 64-bit slot value into a value of \p type.
+    llvm::Value* fromSlot(llvm::Value* value, Type& type);
+
+    /// Converts a value of \p type into a 64-bit slot value.
+    llvm::Value* toSlot(llvm::Value* value, Type& type);
+
+    llvm::Value* getDefined() const { return mDefined; }
+
+    std::vector<Variable*>& getVariables() { return mVariables; }
+    std::vector<unsigned>& getSlots() { return mSlots; }
+
+public:
+    bool shouldSkip(ExprView<> expr, llvm::Value** ret)
+    {
+        auto it = mCache.find(expr.get());
+        if (it != mCache.end()) {
+            *ret = it->second;
+            return true;
+        }
+
+        return false;
+    }
+
+    void handleResult(ExprView<> expr, llvm::Value*& ret)
+    {
+        mCache[expr.get()] = ret;
+    }
+
+    llvm::Value* visitExpr(ExprView<> expr);
+
+private:
+    llvm::Value* emitLiteral(const ExprRef<LiteralExpr>& expr);
+    llvm::Value* emitVarRef(const ExprRef<VarRefExpr>& expr);
+
+    llvm::Value* visitArithmetic(const ExprPtr& expr, llvm::Value* left, llvm::Value* right);
+    llvm::Value* visitCompare(const ExprPtr& expr, llvm::Value* left, llvm::Value* right);
+    llvm::Value* visitFloat(const ExprPtr& expr);
+
+    /// Marks the result of the current expression undefined if \p cond holds.
+    void addUndefinedIf(llvm::Value* cond)
+    {
+        mDefined = mIR.CreateAnd(mDefined, mIR.CreateNot(cond));
+    }
+
+    llvm::Value* createIntArithmetic(Expr::ExprKind kind, llvm::Value* left, llvm::Value* right);
+    llvm::Value* createDivision(Expr::ExprKind kind, llvm::Value* left, llvm::Value* right);
+    llvm::Value* createShift(Expr::ExprKind kind, llvm::Value* left, llvm::Value* right);
+
+private:
+    ExprCompiler& mCompiler;
+    llvm::IRBuilder<>& mIR;
+    llvm::LLVMContext& mContext;
+    llvm::Value* mValues;
+    llvm::Value* mReadArray;
+    llvm::FunctionType* mReadArrayTy;
+    llvm::Value* mDefined;
+    llvm::Value* mArrayResult = nullptr;
+
+    llvm::DenseMap<Expr*, llvm::Value*> mCache;
+    llvm::DenseMap<Variable*, llvm::Value*> mLoads;
+    std::vector<Variable*> mVariables;
+    std::vector<unsigned> mSlots;
+};
+
+} // end anonymous namespace
+
+llvm::Type* ExprCodeGen::getValueType(Type& type)
+{
+    switch (type.getTypeID()) {
+        case Type::BoolTypeID:
+            return mIR.getInt1Ty();
+        case Type::IntTypeID:
+            return mIR.getInt64Ty();
+        case Type::BvTypeID: {
+            unsigned width = cast<BvType>(type).getWidth();
+            return width <= 64 ? mIR.getIntNTy(width) : nullptr;
+        }
+        case Type::FloatTypeID:
+            switch (cast<FloatType>(type).getPrecision()) {
+                case FloatType::Single: return mIR.getFloatTy();
+                case FloatType::Double: return mIR.getDoubleTy();
+                default: return nullptr;
+            }
+        case Type::ArrayTypeID:
+            return ExprCompiler::isSupportedType(type) ? mIR.getInt64Ty() : nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+llvm::Value* ExprCodeGen::fromSlot(llvm::Value* value, Type& type)
+{
+    llvm::Type* valueTy = this->getValueType(type);
+    if (type.isFloatType()) {
+        unsigned width = cast<FloatType>(type).getWidth();
+        return mIR.CreateBitCast(mIR.CreateTrunc(value, mIR.getIntNTy(width)), valueTy);
+    }
+
+    return mIR.CreateTrunc(value, valueTy);
+}
+
+llvm::Value* ExprCodeGen::toSlot(llvm::Value* value, Type& type)
+{
+    if (type.isFloatType()) {
+        unsigned width = cast<FloatType>(type).getWidth();
+        value = mIR.CreateBitCast(value, mIR.getIntNTy(width));
+    }
+
+    return mIR.CreateZExt(value, mIR.getInt64Ty());
+}
+
+llvm::Value* ExprCodeGen::emitLiteral(const ExprRef<LiteralExpr>& expr)
+{
+    llvm::Type* valueTy = this->getValueType(expr->getType());
+    if (valueTy == nullptr) {
+        return nullptr;
+    }
+
+    // Array literals are represented by their address, kept alive by the
+    // compiled expression.
+    if (expr->getType().isArrayType() || expr->getType().isIntType()) {
+        return llvm::ConstantInt::get(valueTy, ExprCompiler::encodeValue(expr));
+    }
+
+    if (auto boolLit = dyn_cast<BoolLiteralExpr>(expr)) {
+        return mIR.getInt1(boolLit->getValue());
+    }
+
+    if (auto bvLit = dyn_cast<BvLiteralExpr>(expr)) {
+        return llvm::ConstantInt::get(mContext, bvLit->getValue());
+    }
+
+    if (auto fltLit = dyn_cast<FloatLiteralExpr>(expr)) {
+        return llvm::ConstantFP::get(mContext, fltLit->getValue());
+    }
+
+    return nullptr;
+}
+
+llvm::Value* ExprCodeGen::emitVarRef(const ExprRef<VarRefExpr>& expr)
+{
+    Variable* variable = &expr->getVariable();
+    if (this->getValueType(variable->getType()) == nullptr) {
+        return nullptr;
+    }
+
+    auto it = mLoads.find(variable);
+    if (it != mLoads.end()) {
+        return it->second;
+    }
+
+    unsigned slot = mCompiler.getSlot(variable);
+    mVariables.push_back(variable);
+    mSlots.push_back(slot);
+
+    auto ptr = mIR.CreateGEP(mIR.getInt64Ty(), mValues, mIR.getInt64(slot));
+    auto value = this->fromSlot(mIR.CreateLoad(mIR.getInt64Ty(), ptr), variable->getType());
+    mLoads[variable] = value;
+
+    return value;
+}
+
+llvm::Value* ExprCodeGen::createIntArithmetic(Expr::ExprKind kind, llvm::Value* left, llvm::Value* right)
+{
+    // Mathematical integers are evaluated in 64 bits. Results which do not
+    // fit are undefined instead of wrapping around.
+    llvm::Intrinsic::ID intrinsic;
+    switch (kind) {
+        case Expr::Add: intrinsic = llvm::Intrinsic::sadd_with_overflow; break;
+        case Expr::Sub: intrinsic = llvm::Intrinsic::ssub_with_overflow; break;
+        case Expr::Mul: intrinsic = llvm::Intrinsic::smul_with_overflow; break;
+        default:
+            llvm_unreachable("Unknown integer arithmetic kind!");
+    }
+
+    auto result = mIR.CreateBinaryIntrinsic(intrinsic, left, right);
+    addUndefinedIf(mIR.CreateExtractValue(result, 1));
+
+    return mIR.CreateExtractValue(result, 0);
+}
+
+llvm::Value* ExprCodeGen::createDivision(Expr::ExprKind kind, llvm::Value* left, llvm::Value* right)
+{
+    auto zero = llvm::ConstantInt::get(right->getType(), 0);
+    auto one = llvm::ConstantInt::get(right->getType(), 1);
+    auto allOnes = llvm::ConstantInt::getAllOnesValue(right->getType());
+
+    auto isZero = mIR.CreateICmpEQ(right, zero);
+
+    if (kind == Expr::BvUDiv || kind == Expr::BvURem) {
+        auto safeRight = mIR.CreateSelect(isZero, one, right);
+        if (kind == Expr::BvUDiv) {
+            return mIR.CreateSelect(isZero, allOnes, mIR.CreateUDiv(left, safeRight));
+        }
+
+        return mIR.CreateSelect(isZero, left, mIR.CreateURem(left, safeRight));
+    }
+
+    // Signed division overflows for MIN / -1, the division is done with a
+    // safe divisor and the result is fixed up afterwards.
+    unsigned width = right->getType()->getIntegerBitWidth();
+    auto signedMin = llvm::ConstantInt::get(mContext, llvm::APInt::getSignedMinValue(width));
+    auto isOverflow = mIR.CreateAnd(
+        mIR.CreateICmpEQ(left, signedMin),
+        mIR.CreateICmpEQ(right, allOnes)
+    );
+    auto safeRight = mIR.CreateSelect(mIR.CreateOr(isZero, isOverflow), one, right);
+    auto quotient = mIR.CreateSDiv(left, safeRight);
+    auto remainder = mIR.CreateSRem(left, safeRight);
+
+    switch (kind) {
+        case Expr::BvSDiv:
+            // SMT-LIB: s / 0 is -1 for non-negative s and 1 otherwise,
+            // MIN / -1 wraps around to MIN.
+            return mIR.CreateSelect(
+                isZero,
+                mIR.CreateSelect(mIR.CreateICmpSLT(left, zero), one, allOnes),
+                mIR.CreateSelect(isOverflow, signedMin, quotient)
+            );
+        case Expr::BvSRem:
+            return mIR.CreateSelect(isZero, left, mIR.CreateSelect(isOverflow, zero, remainder));
+        case Expr::Div:
+            addUndefinedIf(mIR.CreateOr(isZero, isOverflow));
+            return quotient;
+        case Expr::Mod: {
+            addUndefinedIf(mIR.CreateOr(isZero, isOverflow));
+            auto absRight = mIR.CreateSelect(mIR.CreateICmpSLT(right, zero), mIR.CreateNeg(right), right);
+            return mIR.CreateSelect(
+                mIR.CreateICmpSLT(remainder, zero),
+                mIR.CreateAdd(remainder, absRight),
+                remainder
+            );
+        }
+        case Expr::Rem:
+            addUndefinedIf(mIR.CreateOr(isZero, isOverflow));
+            return remainder;
+        default:
+            llvm_unreachable("Unknown division kind!");
+    }
+}
+
+llvm::Value* ExprCodeGen::createShift(Expr::ExprKind kind, llvm::Value* left, llvm::Value* right)
+{
+    // Shifting by at least the bit width is poison in LLVM, but it is
+    // well-defined in SMT-LIB.
+    unsigned width = right->getType()->getIntegerBitWidth();
+    auto maxShift = llvm::ConstantInt::get(right->getType(), width - 1);
+    auto isOutOfRange = mIR.CreateICmpUGT(right, maxShift);
+    auto safeRight = mIR.CreateSelect(isOutOfRange, maxShift, right);
+
+    switch (kind) {
+        case Expr::Shl:
+            return mIR.CreateSelect(
+                isOutOfRange, llvm::ConstantInt::get(left->getType(), 0), mIR.CreateShl(left, safeRight)
+            );
+        case Expr::LShr:
+            return mIR.CreateSelect(
+                isOutOfRange, llvm::ConstantInt::get(left->getType(), 0), mIR.CreateLShr(left, safeRight)
+            );
+        case Expr::AShr:
+            return mIR.CreateAShr(left, safeRight);
+        default:
+            llvm_unreachable("Unknown shift kind!");
+    }
+}
+
+llvm::Value* ExprCodeGen::visitArithmetic(const ExprPtr& expr, llvm::Value* left, llvm::Value* right)
+{
+    if (expr->getType().isIntType()) {
+        switch (expr->getKind()) {
+            case Expr::Add:
+            case Expr::Sub:
+            case Expr::Mul:
+                return this->createIntArithmetic(expr->getKind(), left, right);
+            default:
+                break;
+        }
+    }
+
+    switch (expr->getKind()) {
+        case Expr::Add: return mIR.CreateAdd(left, right);
+        case Expr::Sub: return mIR.CreateSub(left, right);
+        case Expr::Mul: return mIR.CreateMul(left, right);
+        case Expr::BvAnd: return mIR.CreateAnd(left, right);
+        case Expr::BvOr: return mIR.CreateOr(left, right);
+        case Expr::BvXor: return mIR.CreateXor(left, right);
+        case Expr::Div:
+        case Expr::Mod:
+        case Expr::Rem:
+        case Expr::BvSDiv:
+        case Expr::BvUDiv:
+        case Expr::BvSRem:
+        case Expr::BvURem:
+            return this->createDivision(expr->getKind(), left, right);
+        case Expr::Shl:
+        case Expr::LShr:
+        case Expr::AShr:
+            return this->createShift(expr->getKind(), left, right);
+        case Expr::BvConcat: {
+            unsigned rightWidth = right->getType()->getIntegerBitWidth();
+            auto resultTy = this->getValueType(expr->getType());
+            return mIR.CreateOr(
+                mIR.CreateShl(mIR.CreateZExt(left, resultTy), rightWidth),
+                mIR.CreateZExt(right, resultTy)
+            );
+        }
+        default:
+            llvm_unreachable("Unknown binary arithmetic kind!");
+    }
+}
+
+llvm::Value* ExprCodeGen::visitCompare(const ExprPtr& expr, llvm::Value* left, llvm::Value* right)
+{
+    Type& opTy = cast<NonNullaryExpr>(expr)->getOperand(0)->getType();
+
+    switch (expr->getKind()) {
+        case Expr::Eq:
+        case Expr::NotEq: {
+            if (opTy.isArrayType()) {
+                // Array literals are not unique, their addresses cannot be compared.
+                return nullptr;
+            }
+
+            if (opTy.isFloatType()) {
+                // Equality is structural on floats: compare their bit patterns.
+                left = this->toSlot(left, opTy);
+                right = this->toSlot(right, opTy);
+            }
+
+            return expr->getKind() == Expr::Eq
+                ? mIR.CreateICmpEQ(left, right)
+                : mIR.CreateICmpNE(left, right);
+        }
+        case Expr::Lt: case Expr::BvSLt: return mIR.CreateICmpSLT(left, right);
+        case Expr::LtEq: case Expr::BvSLtEq: return mIR.CreateICmpSLE(left, right);
+        case Expr::Gt: case Expr::BvSGt: return mIR.CreateICmpSGT(left, right);
+        case Expr::GtEq: case Expr::BvSGtEq: return mIR.CreateICmpSGE(left, right);
+        case Expr::BvULt: return mIR.CreateICmpULT(left, right);
+        case Expr::BvULtEq: return mIR.CreateICmpULE(left, right);
+        case Expr::BvUGt: return mIR.CreateICmpUGT(left, right);
+        case Expr::BvUGtEq: return mIR.CreateICmpUGE(left, right);
+        default:
+            llvm_unreachable("Unknown compare kind!");
+    }
+}
+
+template<class ExprTy>
+static bool hasDefaultRoundingMode(const ExprPtr& expr)
+{
+    return cast<ExprTy>(expr)->getRoundingMode() == llvm::APFloat::rmNearestTiesToEven;
+}
+
+llvm::Value* ExprCodeGen::visitFloat(const ExprPtr& expr)
+{
+    llvm::Value* op = getOperand(0);
+    llvm::Type* resultTy = this->getValueType(expr->getType());
+
+    switch (expr->getKind()) {
+        case Expr::FIsNan:
+            return mIR.CreateFCmpUNO(op, op);
+        case Expr::FIsInf: {
+            auto inf = llvm::ConstantFP::getInfinity(op->getType());
+            auto negInf = llvm::ConstantFP::getInfinity(op->getType(), true);
+            return mIR.CreateOr(mIR.CreateFCmpOEQ(op, inf), mIR.CreateFCmpOEQ(op, negInf));
+        }
+        case Expr::FpToBv:
+        case Expr::BvToFp:
+            if (resultTy->getPrimitiveSizeInBits() != op->getType()->getPrimitiveSizeInBits()) {
+                return nullptr;
+            }
+            return mIR.CreateBitCast(op, resultTy);
+        case Expr::FEq: return mIR.CreateFCmpOEQ(op, getOperand(1));
+        case Expr::FGt: return mIR.CreateFCmpOGT(op, getOperand(1));
+        case Expr::FGtEq: return mIR.CreateFCmpOGE(op, getOperand(1));
+        case Expr::FLt: return mIR.CreateFCmpOLT(op, getOperand(1));
+        case Expr::FLtEq: return mIR.CreateFCmpOLE(op, getOperand(1));
+        default:
+            break;
+    }
+
+    // The remaining operations are rounded. LLVM's default floating-point
+    // environment rounds to nearest, ties to even.
+    switch (expr->getKind()) {
+        case Expr::FAdd:
+            return hasDefaultRoundingMode<FAddExpr>(expr) ? mIR.CreateFAdd(op, getOperand(1)) : nullptr;
+        case Expr::FSub:
+            return hasDefaultRoundingMode<FSubExpr>(expr) ? mIR.CreateFSub(op, getOperand(1)) : nullptr;
+        case Expr::FMul:
+            return hasDefaultRoundingMode<FMulExpr>(expr) ? mIR.CreateFMul(op, getOperand(1)) : nullptr;
+        case Expr::FDiv:
+            return hasDefaultRoundingMode<FDivExpr>(expr) ? mIR.CreateFDiv(op, getOperand(1)) : nullptr;
+        case Expr::FCast:
+            if (!hasDefaultRoundingMode<FCastExpr>(expr)) {
+                return nullptr;
+            }
+            return mIR.CreateFPCast(op, resultTy);
+        case Expr::SignedToFp:
+            return hasDefaultRoundingMode<SignedToFpExpr>(expr) ? mIR.CreateSIToFP(op, resultTy) : nullptr;
+        case Expr::UnsignedToFp:
+            return hasDefaultRoundingMode<UnsignedToFpExpr>(expr) ? mIR.CreateUIToFP(op, resultTy) : nullptr;
+        default:
+            // Float to integer conversions produce poison on overflow.
+            return nullptr;
+    }
+}
+
+llvm::Value* ExprCodeGen::visitExpr(ExprView<> expr)
+{
+    if (this->getValueType(expr->getType()) == nullptr) {
+        return nullptr;
+    }
+
+    if (auto lit = dyn_cast<LiteralExpr>(expr)) {
+        return this->emitLiteral(make_expr_ref(lit));
+    }
+
+    if (auto varRef = dyn_cast<VarRefExpr>(expr)) {
+        return this->emitVarRef(make_expr_ref(varRef));
+    }
+
+    if (expr->isNullary()) {
+        // Undef values cannot be represented.
+        return nullptr;
+    }
+
+    auto nn = cast<NonNullaryExpr>(expr);
+    for (size_t i = 0; i < nn->getNumOperands(); ++i) {
+        if (getOperand(i) == nullptr) {
+            return nullptr;
+        }
+    }
+
+    if (expr->isArithmetic()) {
+        return this->visitArithmetic(expr, getOperand(0), getOperand(1));
+    }
+
+    if (expr->isCompare()) {
+        return this->visitCompare(expr, getOperand(0), getOperand(1));
+    }
+
+    if (expr->isFloatingPoint()) {
+        return this->visitFloat(expr);
+    }
+
+    switch (expr->getKind()) {
+        case Expr::Not:
+            return mIR.CreateNot(getOperand(0));
+        case Expr::ZExt:
+            return mIR.CreateZExt(getOperand(0), this->getValueType(expr->getType()));
+        case Expr::SExt:
+            return mIR.CreateSExt(getOperand(0), this->getValueType(expr->getType()));
+        case Expr::Extract: {
+            auto extract = cast<ExtractExpr>(expr);
+            return mIR.CreateTrunc(
+                mIR.CreateLShr(getOperand(0), extract->getOffset()),
+                this->getValueType(expr->getType())
+            );
+        }
+        case Expr::And:
+        case Expr::Or: {
+            llvm::Value* result = getOperand(0);
+            for (size_t i = 1; i < nn->getNumOperands(); ++i) {
+                result = expr->getKind() == Expr::And
+                    ? mIR.CreateAnd(result, getOperand(i))
+                    : mIR.CreateOr(result, getOperand(i));
+            }
+            return result;
+        }
+        case Expr::Imply:
+            return mIR.CreateOr(mIR.CreateNot(getOperand(0)), getOperand(1));
+        case Expr::Select:
+            return mIR.CreateSelect(getOperand(0), getOperand(1), getOperand(2));
+        case Expr::ArrayRead: {
+            auto& arrayTy = cast<ArrayType>(nn->getOperand(0)->getType());
+            if (mArrayResult == nullptr) {
+                mArrayResult = mIR.CreateAlloca(mIR.getInt64Ty());
+            }
+
+            auto index = this->toSlot(getOperand(1), arrayTy.getIndexType());
+            auto success = mIR.CreateCall(mReadArrayTy, mReadArray, {getOperand(0), index, mArrayResult});
+            addUndefinedIf(mIR.CreateNot(success));
+
+            return this->fromSlot(mIR.CreateLoad(mIR.getInt64Ty(), mArrayResult), expr->getType());
+        }
+        default:
+            return nullptr;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// ExprCompiler
+//===----------------------------------------------------------------------===//
+
+ExprCompiler::ExprCompiler(std::unique_ptr<llvm::orc::LLJIT> jit)
+    : mJit(std::move(jit)),
+    mContext(std::make_unique<llvm::orc::ThreadSafeContext>(std::make_unique<llvm::LLVMContext>()))
+{}
+
+ExprCompiler::~ExprCompiler() = default;
+
+std::unique_ptr<ExprCompiler> ExprCompiler::Create()
+{
+    if (llvm::InitializeNativeTarget() || llvm::InitializeNativeTargetAsmPrinter()) {
+        return nullptr;
+    }
+
+    auto jit = llvm::orc::LLJITBuilder().create();
+    if (!jit) {
+        llvm::consumeError(jit.takeError());
+        return nullptr;
+    }
+
+    return std::unique_ptr<ExprCompiler>(new ExprCompiler(std::move(*jit)));
+}
+
+unsigned ExprCompiler::getSlot(Variable* variable)
+{
+    auto result = mSlots.try_emplace(variable, mSlots.size());
+    return result.first->second;
+}
+
+bool ExprCompiler::isSupportedType(Type& type)
+{
+    switch (type.getTypeID()) {
+        case Type::BoolTypeID:
+        case Type::IntTypeID:
+            return true;
+        case Type::BvTypeID:
+            return cast<BvType>(type).getWidth() <= 64;
+        case Type::FloatTypeID: {
+            auto precision = cast<FloatType>(type).getPrecision();
+            return precision == FloatType::Single || precision == FloatType::Double;
+        }
+        case Type::ArrayTypeID: {
+            auto& arrayTy = cast<ArrayType>(type);
+            return !arrayTy.getIndexType().isArrayType()
+                && !arrayTy.getElementType().isArrayType()
+                && isSupportedType(arrayTy.getIndexType())
+                && isSupportedType(arrayTy.getElementType());
+        }
+        default:
+            return false;
+    }
+}
+
+uint64_t ExprCompiler::encodeValue(const ExprRef<LiteralExpr>& literal)
+{
+    assert(isSupportedType(literal->getType()) && "Cannot encode unsupported literals!");
+
+    if (auto boolLit = dyn_cast<BoolLiteralExpr>(literal)) {
+        return boolLit->getValue() ? 1 : 0;
+    }
+
+    if (auto intLit = dyn_cast<IntLiteralExpr>(literal)) {
+        return static_cast<uint64_t>(intLit->getValue());
+    }
+
+    if (auto bvLit = dyn_cast<BvLiteralExpr>(literal)) {
+        return bvLit->getValue().getZExtValue();
+    }
+
+    if (auto fltLit = dyn_cast<FloatLiteralExpr>(literal)) {
+        return fltLit->getValue().bitcastToAPInt().getZExtValue();
+    }
+
+    if (auto arrayLit = dyn_cast<ArrayLiteralExpr>(literal)) {
+        return reinterpret_cast<uint64_t>(arrayLit);
+    }
+
+    llvm_unreachable("Unknown literal kind!");
+}
+
+ExprRef<LiteralExpr> ExprCompiler::decodeValue(Type& type, uint64_t value)
+{
+    switch (type.getTypeID()) {
+        case Type::BoolTypeID:
+            return BoolLiteralExpr::Get(cast<BoolType>(type), value != 0);
+        case Type::IntTypeID:
+            return IntLiteralExpr::Get(cast<IntType>(type), static_cast<int64_t>(value));
+        case Type::BvTypeID: {
+            auto& bvTy = cast<BvType>(type);
+            return BvLiteralExpr::Get(bvTy, llvm::APInt(bvTy.getWidth(), value));
+        }
+        case Type::FloatTypeID: {
+            auto& fltTy = cast<FloatType>(type);
+            return FloatLiteralExpr::Get(
+                fltTy, llvm::APFloat(fltTy.getLLVMSemantics(), llvm::APInt(fltTy.getWidth(), value))
+            );
+        }
+        case Type::ArrayTypeID:
+            return make_expr_ref(reinterpret_cast<ArrayLiteralExpr*>(value));
+        default:
+            llvm_unreachable("Cannot decode values of unsupported types!");
+    }
+}
+
+bool ExprCompiler::CompiledExpr::ReadArrayElement(uint64_t array, uint64_t index, uint64_t* result)
+{
+    auto arrayLit = reinterpret_cast<ArrayLiteralExpr*>(array);
+    auto element = arrayLit->getValue(decodeValue(arrayLit->getType().getIndexType(), index));
+
+    auto elementLit = dyn_cast<LiteralExpr>(element);
+    if (elementLit == nullptr) {
+        return false;
+    }
+
+    *result = encodeValue(make_expr_ref(elementLit));
+    return true;
+}
+
+auto ExprCompiler::compile(const ExprPtr& expr) -> const CompiledExpr*
+{
+    return this->compile(llvm::makeArrayRef(expr)).front();
+}
+
+auto ExprCompiler::compile(llvm::ArrayRef<ExprPtr> exprs) -> std::vector<const CompiledExpr*>
+{
+    llvm::LLVMContext& llvmContext = *mContext->getContext();
+
+    auto module = std::make_unique<llvm::Module>("gazer.exprs", llvmContext);
+    module->setDataLayout(mJit->getDataLayout());
+
+    llvm::IRBuilder<> ir(llvmContext);
+    auto i64PtrTy = llvm::PointerType::getUnqual(ir.getInt64Ty());
+    auto readArrayTy = llvm::FunctionType::get(
+        ir.getInt1Ty(), {ir.getInt64Ty(), ir.getInt64Ty(), i64PtrTy}, false
+    );
+    auto functionTy = llvm::FunctionType::get(
+        ir.getInt1Ty(), {i64PtrTy, i64PtrTy, llvm::PointerType::getUnqual(readArrayTy)}, false
+    );
+
+    // All new expressions are put into the same module, so the fixed costs
+    // of code generation are only paid once.
+    struct PendingExpr
+    {
+        std::string name;
+        std::vector<Variable*> variables;
+        std::vector<unsigned> slots;
+    };
+    llvm::DenseMap<Expr*, PendingExpr> pending;
+
+    for (const ExprPtr& expr : exprs) {
+        auto& entry = mCache[expr.get()];
+        if (entry != nullptr) {
+            continue;
+        }
+
+        // Unsupported expressions are also cached, with an empty function.
+        entry = std::make_unique<CompiledExpr>(expr, nullptr, std::vector<Variable*>{}, std::vector<unsigned>{});
+        if (!isSupportedType(expr->getType()) || expr->getType().isArrayType()) {
+            continue;
+        }
+
+        std::string name = "gazer.expr." + std::to_string(mNumFunctions++);
+        auto function = llvm::Function::Create(
+            functionTy, llvm::GlobalValue::ExternalLinkage, name, module.get()
+        );
+        function->addFnAttr(llvm::Attribute::NoUnwind);
+
+        auto args = function->arg_begin();
+        llvm::Value* values = &*args++;
+        llvm::Value* result = &*args++;
+        llvm::Value* readArray = &*args++;
+
+        ir.SetInsertPoint(llvm::BasicBlock::Create(llvmContext, "entry", function));
+
+        ExprCodeGen codegen(*this, ir, values, readArray, readArrayTy);
+        llvm::Value* value = codegen.walk(expr);
+        if (value == nullptr) {
+            function->eraseFromParent();
+            continue;
+        }
+
+        ir.CreateStore(codegen.toSlot(value, expr->getType()), result);
+        ir.CreateRet(codegen.getDefined());
+
+        assert(!llvm::verifyFunction(*function, &llvm::errs()) && "Generated function must be valid!");
+
+        pending[expr.get()] = { name, std::move(codegen.getVariables()), std::move(codegen.getSlots()) };
+    }
+
+    if (!pending.empty()) {
+        auto error = mJit->addIRModule(llvm::orc::ThreadSafeModule(std::move(module), *mContext));
+        if (error) {
+            llvm::consumeError(std::move(error));
+            pending.clear();
+        }
+    }
+
+    for (auto& [expr, info] : pending) {
+        auto symbol = mJit->lookup(info.name);
+        if (!symbol) {
+            llvm::consumeError(symbol.takeError());
+            continue;
+        }
+
+        auto& entry = mCache[expr];
+        entry->mFunction = reinterpret_cast<FunctionTy>(symbol->getAddress());
+        entry->mVariables = std::move(info.variables);
+        entry->mSlots = std::move(info.slots);
+    }
+
+    std::vector<const CompiledExpr*> result;
+    result.reserve(exprs.size());
+    for (const ExprPtr& expr : exprs) {
+        auto& entry = mCache[expr.get()];
+        result.push_back(entry->mFunction != nullptr ? entry.get() : nullptr);
+    }
+
+    return result;
+}
+
+//===----------------------------------------------------------------------===//
+// CompiledExprEvaluator
+//===----------------------------------------------------------------------===//
+
+ExprRef<AtomicExpr> CompiledExprEvaluator::evaluate(const ExprPtr& expr)
+{
+    auto compiled = mCompiler.compile(expr);
+    if (compiled == nullptr) {
+        return ValuationExprEvaluator(mValuation).evaluate(expr);
+    }
+
+    mValues.resize(mCompiler.getNumSlots());
+
+    auto variables = compiled->getVariables();
+    auto slots = compiled->getSlots();
+    for (size_t i = 0; i < variables.size(); ++i) {
+        auto it = mValuation.find(variables[i]);
+        if (it == mValuation.end()) {
+            return ValuationExprEvaluator(mValuation).evaluate(expr);
+        }
+
+        mValues[slots[i]] = ExprCompiler::encodeValue(it->second);
+    }
+
+    uint64_t result;
+    if (!compiled->run(mValues.data(), &result)) {
+        return ValuationExprEvaluator(mValuation).evaluate(expr);
+    }
+
+    return ExprCompiler::decodeValue(expr->getType(), result);
+}
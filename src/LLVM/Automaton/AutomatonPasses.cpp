@@ -189,4 +189,18 @@ Variable* CfaToLLVMTrace::getVariableForValue(const Cfa* parent, const llvm::Val
     }
 
     return nullptr;
+}
+
+void CfaToLLVMTrace::getValueVariables(const Cfa* parent, llvm::DenseSet<Variable*>& variables)
+{
+    auto it = mValueMaps.find(parent);
+    if (it == mValueMaps.end()) {
+        return;
+    }
+
+    for (auto& [value, expr] : it->second.values) {
+        if (auto varRef = llvm::dyn_cast_or_null<VarRefExpr>(expr)) {
+            variables.insert(&varRef->getVariable());
+        }
+    }
 }
\ No newline at end of file
@@ -695,7 +695,15 @@ bool BlocksToCfa::tryToEliminate(ValueOrMemoryObject val, Variable* variable, co
         return false;
     }
 
-    if (val.isValue() && llvm::isa<llvm::Instruction>(val.asValue())) {
+    if (mGenCtx.getSettings().isElimVarsBudget()) {
+        // Inline any value as long as the resulting term stays small: inlining a
+        // value with multiple uses duplicates its expression, but the shared DAG
+        // of the expression does not grow beyond the budget.
+        const LLVMFrontendSettings& settings = mGenCtx.getSettings();
+        if (!ExprFitsInBudget(expr, settings.elimVarsMaxNodes, settings.elimVarsMaxDepth)) {
+            return false;
+        }
+    } else if (val.isValue() && llvm::isa<llvm::Instruction>(val.asValue())) {
         auto inst = llvm::cast<llvm::Instruction>(val.asValue());
         // On 'Normal' level, we do not want to inline expressions which have multiple uses
         // and have already inlined operands.
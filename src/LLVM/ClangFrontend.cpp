@@ -16,6 +16,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include "gazer/LLVM/ClangFrontend.h"
+#include "gazer/Config/gazer-config.h"
 
 #include <llvm/Support/Path.h>
 #include <llvm/Support/Program.h>
@@ -26,6 +27,27 @@
 #include <llvm/Support/CommandLine.h>
 #include <llvm/IRReader/IRReader.h>
 
+#ifdef GAZER_HAS_CLANG_LIBRARIES
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Basic/DiagnosticOptions.h>
+#include <clang/CodeGen/CodeGenAction.h>
+#include <clang/Driver/Compilation.h>
+#include <clang/Driver/Driver.h>
+#include <clang/Driver/Tool.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/CompilerInvocation.h>
+#include <clang/Frontend/TextDiagnosticPrinter.h>
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
+
+#include <algorithm>
+#endif
+
 using namespace llvm;
 
 namespace gazer
@@ -50,43 +72,74 @@ namespace
         cl::desc("Enable the specified warning"),
         cl::cat(gazer::ClangFrontendCategory)
     );
+
+    cl::opt<bool> ExternalClang("external-clang",
+        cl::desc("Compile and link using the clang and llvm-link executables instead of the clang libraries"),
+        cl::cat(gazer::ClangFrontendCategory)
+    );
+    cl::opt<unsigned> ClangJobs("clang-jobs",
+        cl::desc("Number of threads compiling the input files (0 uses all cores)"),
+        cl::init(0),
+        cl::cat(gazer::ClangFrontendCategory)
+    );
 } // end anonymous namespace
 
-static bool executeClang(
-    llvm::StringRef clang, llvm::StringRef input,
-    llvm::StringRef output, llvm::ArrayRef<std::string> flags)
+/// Returns the flags passed to clang for each source file.
+static std::vector<std::string> createClangFlags(gazer::ClangOptions& settings)
 {
-    // Build our clang configuration
-    std::vector<llvm::StringRef> clangArgs = {
-        clang,
+    std::vector<std::string> flags = {
         "-g",
         // In the newer (>=5.0) versions of clang, -O0 marks functions
         // with a 'not optimizable' flag, which can break the functionality
         // of gazer. Here we request optimizations with -O1 and turn them off
         // immediately by disabling all LLVM passes.
         "-O1", "-Xclang", "-disable-llvm-passes",
-        "-c", "-emit-llvm",
     };
 
     // Add -I and -D options correctly
-    std::vector<std::string> prefixedStrings;
     for (auto& include : Includes) {
-        prefixedStrings.push_back("-I" + include);
+        flags.push_back("-I" + include);
     }
     for (auto& define : Defines) {
-        prefixedStrings.push_back("-D" + define);
+        flags.push_back("-D" + define);
     }
     for (auto& warning : Warnings) {
-        prefixedStrings.push_back("-W" + warning);
+        flags.push_back("-W" + warning);
     }
 
-    clangArgs.insert(clangArgs.end(), prefixedStrings.begin(), prefixedStrings.end());
-
     // Add other custom args
-    clangArgs.insert(clangArgs.end(), flags.begin(), flags.end());
+    settings.createArgumentList(flags);
+
+    return flags;
+}
+
+static bool isBitcodeFile(llvm::StringRef file)
+{
+    return file.endswith_lower(".bc") || file.endswith_lower(".ll");
+}
+
+static bool checkInputFiles(llvm::ArrayRef<std::string> files)
+{
+    for (llvm::StringRef inputFile : files) {
+        if (!isBitcodeFile(inputFile) && !inputFile.endswith_lower(".c") && !inputFile.endswith_lower(".i")) {
+            llvm::errs() << "Cannot compile source file " << inputFile << ".\n"
+            << "Supported extensions are: .c, .i, .bc, .ll\n";
+            return false;
+        }
+    }
 
+    return true;
+}
+
+static bool executeClang(
+    llvm::StringRef clang, llvm::StringRef input,
+    llvm::StringRef output, llvm::ArrayRef<std::string> flags)
+{
+    // Build our clang configuration
+    std::vector<llvm::StringRef> clangArgs = { clang };
+    clangArgs.insert(clangArgs.end(), flags.begin(), flags.end());
     clangArgs.insert(clangArgs.end(), {
-        input, "-o", output
+        "-c", "-emit-llvm", input, "-o", output
     });
 
     std::string clangErrors;
@@ -148,11 +201,10 @@ static bool executeLinker(llvm::StringRef linker, const std::vector<std::string>
     return true;
 }
 
-auto gazer::ClangCompileAndLink(
+static std::unique_ptr<llvm::Module> compileAndLinkExternal(
     llvm::ArrayRef<std::string> files,
     llvm::LLVMContext& llvmContext,
-    ClangOptions& settings)
--> std::unique_ptr<llvm::Module>
+    gazer::ClangOptions& settings)
 {
 #define CHECK_ERROR(ERRORCODE, MSG) if (ERRORCODE) {                            \
     llvm::errs() << (MSG) << "\n";                                              \
@@ -177,18 +229,13 @@ auto gazer::ClangCompileAndLink(
     CHECK_ERROR(errorCode, "Could not create temporary working directory.");
 
     std::vector<std::string> bitcodeFiles;
+    std::vector<std::string> flags = createClangFlags(settings);
 
     for (llvm::StringRef inputFile : files) {
-        if (inputFile.endswith_lower(".bc") || inputFile.endswith_lower(".ll")) {
+        if (isBitcodeFile(inputFile)) {
             bitcodeFiles.push_back(inputFile);
             continue;
         }
-        
-        if (!inputFile.endswith_lower(".c") && !inputFile.endswith_lower(".i")) {
-            llvm::errs() << "Cannot compile source file " << inputFile << ".\n"
-            << "Supported extensions are: .c, .i, .bc, .ll\n";
-            return nullptr;
-        }
 
         llvm::SmallString<128> inputPath = inputFile;
         llvm::sys::fs::make_absolute(inputPath);
@@ -198,10 +245,6 @@ auto gazer::ClangCompileAndLink(
         llvm::sys::path::append(outputPath, llvm::sys::path::filename(inputPath));
         llvm::sys::path::replace_extension(outputPath, "bc");
 
-        // Add extra flags
-        std::vector<std::string> flags;
-        settings.createArgumentList(flags);
-
         // Call clang
         bool clangSuccess = executeClang(*clang, inputPath, outputPath, flags);
         if (!clangSuccess) {
@@ -230,6 +273,180 @@ auto gazer::ClangCompileAndLink(
     }
 
     return module;
+#undef CHECK_ERROR
+}
+
+#ifdef GAZER_HAS_CLANG_LIBRARIES
+
+/// Compiles the C source file \p input into a module of \p llvmContext
+/// using the clang libraries. Diagnostics are written into \p diagOs.
+static std::unique_ptr<llvm::Module> compileInProcess(
+    const std::string& input, llvm::ArrayRef<std::string> flags,
+    llvm::LLVMContext& llvmContext, llvm::raw_ostream& diagOs)
+{
+    llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> diagOpts = new clang::DiagnosticOptions();
+    llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs> diagIds(new clang::DiagnosticIDs());
+    clang::DiagnosticsEngine diags(diagIds, &*diagOpts, new clang::TextDiagnosticPrinter(diagOs, &*diagOpts));
+
+    // Let the driver build the frontend invocation, so the flags are
+    // interpreted the same way as by the clang executable. The builtin
+    // headers are taken from the resource directory of the linked clang
+    // libraries, not from whichever clang executable comes first in PATH.
+    clang::driver::Driver driver("clang", llvm::sys::getDefaultTargetTriple(), diags);
+    driver.setCheckInputsExist(false);
+
+    std::vector<const char*> args = { "clang" };
+    for (const std::string& flag : flags) {
+        args.push_back(flag.c_str());
+    }
+#ifdef GAZER_CLANG_RESOURCE_DIR
+    args.push_back("-resource-dir");
+    args.push_back(GAZER_CLANG_RESOURCE_DIR);
+#endif
+    args.push_back("-fsyntax-only");
+    args.push_back(input.c_str());
+
+    std::unique_ptr<clang::driver::Compilation> compilation(driver.BuildCompilation(args));
+    if (compilation == nullptr || diags.hasErrorOccurred()) {
+        return nullptr;
+    }
+
+    // We expect exactly one frontend job for a single source file.
+    const clang::driver::JobList& jobs = compilation->getJobs();
+    if (jobs.size() != 1) {
+        diagOs << "ERROR: unexpected clang driver jobs for '" << input << "'.\n";
+        return nullptr;
+    }
+
+    const llvm::opt::ArgStringList& ccArgs = jobs.begin()->getArguments();
+
+    auto invocation = std::make_shared<clang::CompilerInvocation>();
+    if (!clang::CompilerInvocation::CreateFromArgs(
+        *invocation, ccArgs.data(), ccArgs.data() + ccArgs.size(), diags)
+    ) {
+        return nullptr;
+    }
+
+    clang::CompilerInstance compiler;
+    compiler.setInvocation(std::move(invocation));
+    compiler.createDiagnostics(new clang::TextDiagnosticPrinter(diagOs, &compiler.getDiagnosticOpts()));
+
+    clang::EmitLLVMOnlyAction action(&llvmContext);
+    if (!compiler.ExecuteAction(action)) {
+        return nullptr;
+    }
+
+    return action.takeModule();
+}
+
+static std::unique_ptr<llvm::Module> compileAndLinkInProcess(
+    llvm::ArrayRef<std::string> files,
+    llvm::LLVMContext& llvmContext,
+    gazer::ClangOptions& settings)
+{
+    std::vector<std::string> flags = createClangFlags(settings);
+    std::vector<std::unique_ptr<llvm::Module>> modules(files.size());
+
+    std::vector<size_t> sources;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!isBitcodeFile(files[i])) {
+            sources.push_back(i);
+        }
+    }
+
+    if (sources.size() == 1) {
+        // Compile a single source directly into the target context.
+        size_t idx = sources[0];
+        modules[idx] = compileInProcess(files[idx], flags, llvmContext, llvm::errs());
+        if (modules[idx] == nullptr) {
+            llvm::errs() << "Failed to compile input file '" << files[idx] << "'.\n";
+            return nullptr;
+        }
+    } else if (!sources.empty()) {
+        // An LLVMContext may only be used by one thread, thus each worker compiles
+        // into its own context and passes the module back as in-memory bitcode.
+        std::vector<llvm::SmallVector<char, 0>> bitcodes(sources.size());
+        std::vector<std::string> diagnostics(sources.size());
+
+        unsigned numThreads = ClangJobs != 0 ? ClangJobs : llvm::hardware_concurrency();
+        llvm::ThreadPool pool(std::min<unsigned>(std::max(numThreads, 1U), sources.size()));
+
+        for (size_t i = 0; i < sources.size(); ++i) {
+            pool.async([&, i] {
+                llvm::LLVMContext workerContext;
+                llvm::raw_string_ostream diagOs(diagnostics[i]);
+
+                auto module = compileInProcess(files[sources[i]], flags, workerContext, diagOs);
+                if (module != nullptr) {
+                    llvm::raw_svector_ostream os(bitcodes[i]);
+                    llvm::WriteBitcodeToFile(*module, os);
+                }
+            });
+        }
+        pool.wait();
+
+        for (size_t i = 0; i < sources.size(); ++i) {
+            llvm::StringRef file = files[sources[i]];
+            llvm::errs() << diagnostics[i];
+
+            if (bitcodes[i].empty()) {
+                llvm::errs() << "Failed to compile input file '" << file << "'.\n";
+                return nullptr;
+            }
+
+            llvm::MemoryBufferRef buffer(llvm::StringRef(bitcodes[i].data(), bitcodes[i].size()), file);
+            auto module = llvm::parseBitcodeFile(buffer, llvmContext);
+            if (!module) {
+                llvm::logAllUnhandledErrors(module.takeError(), llvm::errs(), "ERROR: ");
+                return nullptr;
+            }
+
+            modules[sources[i]] = std::move(*module);
+        }
+    }
+
+    // Link the modules in their input order.
+    std::unique_ptr<llvm::Module> result;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (modules[i] == nullptr) {
+            llvm::SMDiagnostic err;
+            modules[i] = llvm::parseIRFile(files[i], err, llvmContext);
+            if (modules[i] == nullptr) {
+                err.print(nullptr, llvm::errs());
+                return nullptr;
+            }
+        }
+
+        if (result == nullptr) {
+            result = std::move(modules[i]);
+        } else if (llvm::Linker::linkModules(*result, std::move(modules[i]))) {
+            llvm::errs() << "ERROR: failed to link input file '" << files[i] << "'.\n";
+            return nullptr;
+        }
+    }
+
+    return result;
+}
+
+#endif
+
+auto gazer::ClangCompileAndLink(
+    llvm::ArrayRef<std::string> files,
+    llvm::LLVMContext& llvmContext,
+    ClangOptions& settings)
+-> std::unique_ptr<llvm::Module>
+{
+    if (!checkInputFiles(files)) {
+        return nullptr;
+    }
+
+#ifdef GAZER_HAS_CLANG_LIBRARIES
+    if (!ExternalClang) {
+        return compileAndLinkInProcess(files, llvmContext, settings);
+    }
+#endif
+
+    return compileAndLinkExternal(files, llvmContext, settings);
 }
 
 using namespace gazer;
@@ -175,6 +175,37 @@ void CheckRegistry::registerPasses(llvm::legacy::PassManager& pm)
     mRegisterPassesCalled = true;
 }
 
+namespace
+{
+
+class RunChecksPass : public llvm::PassInfoMixin<RunChecksPass>
+{
+public:
+    explicit RunChecksPass(llvm::ArrayRef<Check*> checks)
+        : mChecks(checks.begin(), checks.end())
+    {}
+
+    llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager&)
+    {
+        bool changed = false;
+        for (Check* check : mChecks) {
+            changed |= check->runOnModule(module);
+        }
+
+        return changed ? llvm::PreservedAnalyses::none() : llvm::PreservedAnalyses::all();
+    }
+
+private:
+    std::vector<Check*> mChecks;
+};
+
+} // end anonymous namespace
+
+void CheckRegistry::registerPasses(llvm::ModulePassManager& pm)
+{
+    pm.addPass(RunChecksPass(mChecks));
+}
+
 std::string CheckRegistry::messageForCode(unsigned ec) const
 {
     assert(ec != VerificationResult::SuccessErrorCode && "Error code must be non-zero for failures!");
@@ -206,6 +237,25 @@ std::string CheckRegistry::messageForCode(unsigned ec) const
     return rso.str();
 }
 
+Check* CheckRegistry::getCheckForCode(unsigned ec) const
+{
+    auto result = mCheckMap.find(ec);
+    assert(result != mCheckMap.end() && "Error code should be present in the check map!");
+
+    return result->second.getCheck();
+}
+
+std::vector<unsigned> CheckRegistry::getErrorCodes() const
+{
+    std::vector<unsigned> codes;
+    for (auto& [ec, violation] : mCheckMap) {
+        codes.push_back(ec);
+    }
+
+    llvm::sort(codes);
+    return codes;
+}
+
 CheckRegistry::~CheckRegistry()
 {
     // If registerPasses() was not called, this object still owns all added checks.
@@ -0,0 +1,404 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file implements a pass which removes the error edges of
+/// instrumented checks whose conditions are provably never violated.
+///
+/// The conditions guarding error blocks are evaluated over integer intervals.
+/// The interval of a value is the intersection of the ranges computed by
+/// LazyValueInfo and ScalarEvolution at the branch, the intervals of overflow
+/// checks are computed by interval arithmetic on a doubled bit width.
+///
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/InstrumentationPasses.h"
+#include "gazer/LLVM/Instrumentation/Check.h"
+#include "gazer/LLVM/Instrumentation/Intrinsics.h"
+
+#include <llvm/Analysis/LazyValueInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/ConstantRange.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/PatternMatch.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/Local.h>
+
+#include <functional>
+#include <optional>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Evaluates branch conditions over the intervals of their operands.
+class IntervalEvaluator
+{
+public:
+    IntervalEvaluator(llvm::LazyValueInfo& lvi, llvm::ScalarEvolution& se)
+        : mLazyValueInfo(lvi), mScalarEvolution(se)
+    {}
+
+    /// Returns the value of \p condition at \p cxt if it is the same
+    /// for all possible values of its operands.
+    std::optional<bool> evaluate(llvm::Value* condition, llvm::Instruction* cxt);
+
+    /// Removes the cached information of a block before it is deleted.
+    void eraseBlock(llvm::BasicBlock* bb) { mLazyValueInfo.eraseBlock(bb); }
+
+private:
+    llvm::ConstantRange getRange(llvm::Value* value, llvm::Instruction* cxt, bool isSigned);
+    std::optional<bool> evaluateICmp(llvm::ICmpInst* icmp, llvm::Instruction* cxt);
+    std::optional<bool> evaluateNoOverflow(llvm::CallInst* call, llvm::Instruction* cxt);
+
+private:
+    llvm::LazyValueInfo& mLazyValueInfo;
+    llvm::ScalarEvolution& mScalarEvolution;
+};
+
+struct SafeCheck
+{
+    llvm::BranchInst* branch;
+    llvm::BasicBlock* errorBlock;
+    llvm::BasicBlock* successor;
+};
+
+class DischargeSafeChecks
+{
+public:
+    using AnalysisGetter = std::function<IntervalEvaluator(llvm::Function&)>;
+
+    explicit DischargeSafeChecks(AnalysisGetter getEvaluator)
+        : mGetEvaluator(std::move(getEvaluator))
+    {}
+
+    bool run(llvm::Module& module);
+
+private:
+    void findSafeChecks(
+        llvm::Function& function, IntervalEvaluator& evaluator, llvm::SmallVectorImpl<SafeCheck>& safeChecks);
+    void discharge(const SafeCheck& check, IntervalEvaluator& evaluator);
+
+private:
+    AnalysisGetter mGetEvaluator;
+};
+
+class DischargeSafeChecksLegacyPass : public llvm::ModulePass
+{
+public:
+    static char ID;
+
+    DischargeSafeChecksLegacyPass()
+        : ModulePass(ID)
+    {}
+
+    void getAnalysisUsage(llvm::AnalysisUsage& au) const override
+    {
+        au.addRequired<llvm::LazyValueInfoWrapperPass>();
+        au.addRequired<llvm::ScalarEvolutionWrapperPass>();
+    }
+
+    bool runOnModule(llvm::Module& module) override
+    {
+        DischargeSafeChecks impl([this](llvm::Function& function) {
+            return IntervalEvaluator(
+                getAnalysis<llvm::LazyValueInfoWrapperPass>(function).getLVI(),
+                getAnalysis<llvm::ScalarEvolutionWrapperPass>(function).getSE()
+            );
+        });
+
+        return impl.run(module);
+    }
+
+    llvm::StringRef getPassName() const override {
+        return "Discharge safe checks";
+    }
+};
+
+} // end anonymous namespace
+
+char DischargeSafeChecksLegacyPass::ID;
+
+static bool isErrorBlock(const llvm::BasicBlock& bb)
+{
+    if (!llvm::isa<llvm::UnreachableInst>(bb.getTerminator())) {
+        return false;
+    }
+
+    for (const llvm::Instruction& inst : bb) {
+        if (auto call = llvm::dyn_cast<llvm::CallInst>(&inst)) {
+            auto callee = call->getCalledFunction();
+            if (callee != nullptr && callee->getName() == CheckRegistry::ErrorFunctionName) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static bool isNoOverflowCall(const llvm::Value* value)
+{
+    if (auto call = llvm::dyn_cast<llvm::CallInst>(value)) {
+        auto callee = call->getCalledFunction();
+        return callee != nullptr && callee->getName().startswith(GazerIntrinsic::NoOverflowPrefix);
+    }
+
+    return false;
+}
+
+llvm::ConstantRange IntervalEvaluator::getRange(llvm::Value* value, llvm::Instruction* cxt, bool isSigned)
+{
+    if (auto ci = llvm::dyn_cast<llvm::ConstantInt>(value)) {
+        return llvm::ConstantRange(ci->getValue());
+    }
+
+    llvm::ConstantRange range = mLazyValueInfo.getConstantRange(value, cxt->getParent(), cxt);
+
+    if (mScalarEvolution.isSCEVable(value->getType())) {
+        const llvm::SCEV* scev = mScalarEvolution.getSCEV(value);
+        range = range.intersectWith(isSigned
+            ? mScalarEvolution.getSignedRange(scev)
+            : mScalarEvolution.getUnsignedRange(scev)
+        );
+    }
+
+    return range;
+}
+
+std::optional<bool> IntervalEvaluator::evaluate(llvm::Value* condition, llvm::Instruction* cxt)
+{
+    using namespace llvm::PatternMatch;
+
+    if (auto ci = llvm::dyn_cast<llvm::ConstantInt>(condition)) {
+        return ci->isOne();
+    }
+
+    llvm::Value* operand;
+    if (match(condition, m_Not(m_Value(operand)))) {
+        if (auto result = this->evaluate(operand, cxt)) {
+            return !*result;
+        }
+        return std::nullopt;
+    }
+
+    if (auto icmp = llvm::dyn_cast<llvm::ICmpInst>(condition)) {
+        return this->evaluateICmp(icmp, cxt);
+    }
+
+    if (isNoOverflowCall(condition)) {
+        return this->evaluateNoOverflow(llvm::cast<llvm::CallInst>(condition), cxt);
+    }
+
+    return std::nullopt;
+}
+
+std::optional<bool> IntervalEvaluator::evaluateICmp(llvm::ICmpInst* icmp, llvm::Instruction* cxt)
+{
+    if (!icmp->getOperand(0)->getType()->isIntegerTy()) {
+        return std::nullopt;
+    }
+
+    auto pred = icmp->getPredicate();
+    bool isSigned = icmp->isSigned();
+
+    llvm::ConstantRange lhs = this->getRange(icmp->getOperand(0), cxt, isSigned);
+    llvm::ConstantRange rhs = this->getRange(icmp->getOperand(1), cxt, isSigned);
+
+    if (llvm::ConstantRange::makeSatisfyingICmpRegion(pred, rhs).contains(lhs)) {
+        return true;
+    }
+
+    auto inverse = llvm::CmpInst::getInversePredicate(pred);
+    if (llvm::ConstantRange::makeSatisfyingICmpRegion(inverse, rhs).contains(lhs)) {
+        return false;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<bool> IntervalEvaluator::evaluateNoOverflow(llvm::CallInst* call, llvm::Instruction* cxt)
+{
+    llvm::StringRef name = call->getCalledFunction()->getName();
+
+    bool isSigned;
+    llvm::Instruction::BinaryOps opcode;
+    if (name.startswith(GazerIntrinsic::SAddNoOverflowPrefix)) {
+        isSigned = true; opcode = llvm::Instruction::Add;
+    } else if (name.startswith(GazerIntrinsic::SSubNoOverflowPrefix)) {
+        isSigned = true; opcode = llvm::Instruction::Sub;
+    } else if (name.startswith(GazerIntrinsic::SMulNoOverflowPrefix)) {
+        isSigned = true; opcode = llvm::Instruction::Mul;
+    } else if (name.startswith(GazerIntrinsic::UAddNoOverflowPrefix)) {
+        isSigned = false; opcode = llvm::Instruction::Add;
+    } else if (name.startswith(GazerIntrinsic::USubNoOverflowPrefix)) {
+        isSigned = false; opcode = llvm::Instruction::Sub;
+    } else if (name.startswith(GazerIntrinsic::UMulNoOverflowPrefix)) {
+        isSigned = false; opcode = llvm::Instruction::Mul;
+    } else {
+        return std::nullopt;
+    }
+
+    llvm::Value* left = call->getArgOperand(0);
+    unsigned width = left->getType()->getIntegerBitWidth();
+    unsigned wideWidth = 2 * width;
+
+    auto extend = [&](llvm::Value* value) {
+        llvm::ConstantRange range = this->getRange(value, cxt, isSigned);
+        return isSigned ? range.signExtend(wideWidth) : range.zeroExtend(wideWidth);
+    };
+
+    // On the doubled width none of the operations can wrap, thus the result
+    // is an overflow if and only if it does not fit into the original width.
+    llvm::ConstantRange lhs = extend(left);
+    llvm::ConstantRange rhs = extend(call->getArgOperand(1));
+    llvm::ConstantRange result = lhs.binaryOp(opcode, rhs);
+
+    llvm::ConstantRange valid = isSigned
+        ? llvm::ConstantRange(
+            llvm::APInt::getSignedMinValue(width).sext(wideWidth),
+            llvm::APInt::getSignedMaxValue(width).sext(wideWidth) + 1)
+        : llvm::ConstantRange(
+            llvm::APInt::getNullValue(wideWidth),
+            llvm::APInt::getOneBitSet(wideWidth, width));
+
+    if (valid.contains(result)) {
+        return true;
+    }
+
+    return std::nullopt;
+}
+
+void DischargeSafeChecks::findSafeChecks(
+    llvm::Function& function, IntervalEvaluator& evaluator, llvm::SmallVectorImpl<SafeCheck>& safeChecks)
+{
+    for (llvm::BasicBlock& bb : function) {
+        auto br = llvm::dyn_cast<llvm::BranchInst>(bb.getTerminator());
+        if (br == nullptr || br->isUnconditional()) {
+            continue;
+        }
+
+        for (unsigned i = 0; i < 2; ++i) {
+            llvm::BasicBlock* errorBB = br->getSuccessor(i);
+            llvm::BasicBlock* otherBB = br->getSuccessor(1 - i);
+            if (errorBB == otherBB || !isErrorBlock(*errorBB)) {
+                continue;
+            }
+
+            // The error edge is taken if the condition is true for the
+            // first successor, or false for the second one.
+            std::optional<bool> result = evaluator.evaluate(br->getCondition(), br);
+            if (result.has_value() && *result == (i == 1)) {
+                safeChecks.push_back({br, errorBB, otherBB});
+            }
+            break;
+        }
+    }
+}
+
+static void eraseDeadCondition(llvm::Value* condition)
+{
+    auto inst = llvm::dyn_cast<llvm::Instruction>(condition);
+    if (inst == nullptr || !inst->use_empty()) {
+        return;
+    }
+
+    // The overflow check intrinsics have no attributes, thus they are not
+    // trivially dead. They do not have side effects either.
+    if (!isNoOverflowCall(inst) && !llvm::isInstructionTriviallyDead(inst)) {
+        return;
+    }
+
+    llvm::SmallVector<llvm::Value*, 2> operands(inst->op_begin(), inst->op_end());
+    inst->eraseFromParent();
+
+    for (llvm::Value* operand : operands) {
+        eraseDeadCondition(operand);
+    }
+}
+
+void DischargeSafeChecks::discharge(const SafeCheck& check, IntervalEvaluator& evaluator)
+{
+    llvm::BranchInst* br = check.branch;
+    llvm::Value* condition = br->getCondition();
+
+    check.errorBlock->removePredecessor(br->getParent());
+    llvm::ReplaceInstWithInst(br, llvm::BranchInst::Create(check.successor));
+    eraseDeadCondition(condition);
+
+    if (llvm::pred_empty(check.errorBlock)) {
+        evaluator.eraseBlock(check.errorBlock);
+        llvm::DeleteDeadBlock(check.errorBlock);
+    }
+}
+
+bool DischargeSafeChecks::run(llvm::Module& module)
+{
+    unsigned numDischarged = 0;
+
+    for (llvm::Function& function : module) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+
+        // Query all conditions first: the analyses are not updated
+        // while the CFG is being modified.
+        IntervalEvaluator evaluator = mGetEvaluator(function);
+        llvm::SmallVector<SafeCheck, 8> safeChecks;
+        this->findSafeChecks(function, evaluator, safeChecks);
+
+        for (const SafeCheck& check : safeChecks) {
+            this->discharge(check, evaluator);
+        }
+
+        numDischarged += safeChecks.size();
+    }
+
+    if (numDischarged != 0) {
+        llvm::outs() << "Number of discharged checks: " << numDischarged << "\n";
+    }
+
+    return numDischarged != 0;
+}
+
+namespace gazer
+{
+
+llvm::Pass* createDischargeSafeChecksPass() {
+    return new DischargeSafeChecksLegacyPass();
+}
+
+llvm::PreservedAnalyses DischargeSafeChecksPass::run(llvm::Module& module, llvm::ModuleAnalysisManager& mam)
+{
+    auto& fam = mam.getResult<llvm::FunctionAnalysisManagerModuleProxy>(module).getManager();
+
+    DischargeSafeChecks impl([&fam](llvm::Function& function) {
+        return IntervalEvaluator(
+            fam.getResult<llvm::LazyValueAnalysis>(function),
+            fam.getResult<llvm::ScalarEvolutionAnalysis>(function)
+        );
+    });
+
+    if (!impl.run(module)) {
+        return llvm::PreservedAnalyses::all();
+    }
+
+    return llvm::PreservedAnalyses::none();
+}
+
+} // end namespace gazer
@@ -30,12 +30,12 @@ using namespace llvm;
 namespace
 {
 
-class MarkFunctionEntriesPass : public ModulePass
+class MarkFunctionEntriesLegacyPass : public ModulePass
 {
 public:
     static char ID;
 
-    MarkFunctionEntriesPass()
+    MarkFunctionEntriesLegacyPass()
         : ModulePass(ID)
     {}
 
@@ -44,6 +44,11 @@ public:
     }
 
     bool runOnModule(Module& module) override
+    {
+        return markFunctionEntries(module);
+    }
+
+    static bool markFunctionEntries(Module& module)
     {
         LLVMContext& context = module.getContext();
         llvm::DenseMap<llvm::Type*, llvm::Value*> returnValueMarks;
@@ -145,10 +150,16 @@ public:
 
 } // end anonymous namespace
 
-char MarkFunctionEntriesPass::ID = 0;
+char MarkFunctionEntriesLegacyPass::ID = 0;
 
 namespace gazer {
     llvm::Pass* createMarkFunctionEntriesPass() {
-        return new MarkFunctionEntriesPass();
+        return new MarkFunctionEntriesLegacyPass();
+    }
+
+    llvm::PreservedAnalyses MarkFunctionEntriesPass::run(llvm::Module& module, llvm::ModuleAnalysisManager&)
+    {
+        MarkFunctionEntriesLegacyPass::markFunctionEntries(module);
+        return llvm::PreservedAnalyses::none();
     }
 } // end namespace gazer
\ No newline at end of file
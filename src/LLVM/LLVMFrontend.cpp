@@ -26,6 +26,9 @@
 #include "gazer/LLVM/Trace/TestHarnessGenerator.h"
 #include "gazer/Trace/WitnessWriter.h"
 #include "gazer/LLVM/Transform/BackwardSlicer.h"
+#include "gazer/Automaton/CfaTransforms.h"
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Support/Runtime.h"
 #include "gazer/Support/Warnings.h"
 
 #include <llvm/Analysis/ScopedNoAliasAA.h>
@@ -39,6 +42,23 @@
 #include <llvm/Transforms/InstCombine/InstCombine.h>
 #include <llvm/Transforms/AggressiveInstCombine/AggressiveInstCombine.h>
 #include <llvm/Transforms/Utils/UnifyFunctionExitNodes.h>
+#include <llvm/Transforms/Utils/Mem2Reg.h>
+#include <llvm/Transforms/Utils/LoopSimplify.h>
+#include <llvm/Transforms/Scalar/CallSiteSplitting.h>
+#include <llvm/Transforms/Scalar/DCE.h>
+#include <llvm/Transforms/Scalar/IndVarSimplify.h>
+#include <llvm/Transforms/Scalar/LICM.h>
+#include <llvm/Transforms/Scalar/LoopDeletion.h>
+#include <llvm/Transforms/Scalar/LoopPassManager.h>
+#include <llvm/Transforms/Scalar/SimplifyCFG.h>
+#include <llvm/Transforms/Scalar/SROA.h>
+#include <llvm/Transforms/IPO/DeadArgumentElimination.h>
+#include <llvm/Transforms/IPO/GlobalDCE.h>
+#include <llvm/Transforms/IPO/GlobalOpt.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+#include <llvm/Transforms/IPO/SCCP.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Passes/StandardInstrumentations.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/InitializePasses.h>
 
@@ -49,6 +69,15 @@
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Program.h>
+#include <llvm/ADT/StringExtras.h>
+
+#include <chrono>
+#include <thread>
+
+#include <signal.h>
 
 using namespace gazer;
 using namespace llvm;
@@ -71,6 +100,29 @@ namespace
     cl::opt<bool> SkipPipeline(
         "skip-pipeline", cl::desc("Do not execute the verification pipeline; translate and verify the input LLVM module directly")
     );
+    cl::opt<bool> UseLegacyPassManager(
+        "legacy-pm", cl::desc("Run the preprocessing pipeline on the legacy pass manager"), cl::cat(LLVMFrontendCategory)
+    );
+
+    /// Runs a legacy pass without a new pass manager version within the
+    /// new pass manager pipeline.
+    template<auto CreatePass>
+    class LegacyPassWrapper : public llvm::PassInfoMixin<LegacyPassWrapper<CreatePass>>
+    {
+    public:
+        llvm::PreservedAnalyses run(llvm::Module& module, llvm::ModuleAnalysisManager&)
+        {
+            llvm::legacy::PassManager pm;
+            pm.add(CreatePass());
+            if (!pm.run(module)) {
+                return llvm::PreservedAnalyses::all();
+            }
+
+            return llvm::PreservedAnalyses::none();
+        }
+    };
+
+    llvm::Pass* createStructurizeCFGLegacyPass() { return llvm::createStructurizeCFGPass(); }
 
     class RunVerificationBackendPass : public llvm::ModulePass
     {
@@ -80,8 +132,9 @@ namespace
         RunVerificationBackendPass(
             const CheckRegistry& checks,
             VerificationAlgorithm& algorithm,
-            const LLVMFrontendSettings& settings
-        ) : ModulePass(ID), mChecks(checks), mAlgorithm(algorithm), mSettings(settings)
+            const LLVMFrontendSettings& settings,
+            std::unique_ptr<VerificationResult>& result
+        ) : ModulePass(ID), mChecks(checks), mAlgorithm(algorithm), mSettings(settings), mResult(result)
         {}
 
         void getAnalysisUsage(llvm::AnalysisUsage& au) const override
@@ -96,13 +149,60 @@ namespace
             return "Verification backend pass";
         }
 
+    private:
+        /// A group of error codes which are verified together.
+        struct Property
+        {
+            std::string name;
+            std::vector<unsigned> errorCodes;
+        };
+
+        void printResult(
+            const VerificationResult& result, llvm::Module& module, llvm::StringRef title, bool writeArtifacts);
+
+        /// Runs the CFA-level simplifications requested in the settings on a translated system.
+        void prepareSystem(AutomataSystem& system, CfaToLLVMTrace& cfaToLlvmTrace, bool printStats);
+
+        std::vector<Property> createProperties(AutomataSystem& system) const;
+
+        void checkProperties(llvm::ArrayRef<Property> properties);
+
     private:
         const CheckRegistry& mChecks;
         VerificationAlgorithm& mAlgorithm;
         const LLVMFrontendSettings& mSettings;
-        std::unique_ptr<VerificationResult> mResult;
+        std::unique_ptr<VerificationResult>& mResult;
     };
 
+    llvm::StringRef getStatusName(VerificationResult::Status status)
+    {
+        switch (status) {
+            case VerificationResult::Success: return "SUCCESSFUL";
+            case VerificationResult::Fail: return "FAILED";
+            case VerificationResult::Timeout: return "TIMEOUT";
+            case VerificationResult::Unknown: return "UNKNOWN";
+            case VerificationResult::BoundReached: return "BOUND REACHED";
+            case VerificationResult::InternalError: return "INTERNAL ERROR";
+        }
+
+        llvm_unreachable("Unknown verification result status!");
+    }
+
+    std::unique_ptr<VerificationResult> createResult(VerificationResult::Status status)
+    {
+        switch (status) {
+            case VerificationResult::Success: return VerificationResult::CreateSuccess();
+            case VerificationResult::Fail: return VerificationResult::CreateFail(VerificationResult::GeneralFailureCode);
+            case VerificationResult::Timeout: return VerificationResult::CreateTimeout();
+            case VerificationResult::Unknown: return VerificationResult::CreateUnknown();
+            case VerificationResult::BoundReached: return VerificationResult::CreateBoundReached();
+            case VerificationResult::InternalError:
+                return VerificationResult::CreateInternalError("A property could not be verified.");
+        }
+
+        llvm_unreachable("Unknown verification result status!");
+    }
+
 } // end anonymous namespace
 
 char RunVerificationBackendPass::ID;
@@ -118,13 +218,18 @@ LLVMFrontend::LLVMFrontend(
 {
     llvm::initializeAnalysis(*llvm::PassRegistry::getPassRegistry());
 
+    if (mSettings.canonicalizeExpr) {
+        mContext.setExprCanonicalization(true);
+    }
+
     // Force settings to be consistent
     if (mSettings.ints == IntRepresentation::Integers) {
         emit_warning("-math-int mode forces havoc memory model, analysis may be unsound\n");
         mSettings.memoryModel = MemoryModelSetting::Havoc;
     }
 
-    if (!PrintFinalModule.empty()) {
+    // Property workers repeat the pipeline of the main process, do not overwrite its output.
+    if (!PrintFinalModule.empty() && mSettings.propertyCodes.empty()) {
         std::error_code ec;
         mModuleOutput = std::make_unique<llvm::ToolOutputFile>(PrintFinalModule, ec, llvm::sys::fs::F_None);
 
@@ -143,6 +248,80 @@ void LLVMFrontend::registerVerificationPipeline()
         return;
     }
 
+    if (UseLegacyPassManager) {
+        this->registerLegacyPreprocessing();
+    } else {
+        this->registerPreprocessing();
+    }
+
+    // Display the final LLVM CFG now.
+    if (ShowFinalCFG && mSettings.propertyCodes.empty()) {
+        mPassManager.add(llvm::createCFGPrinterLegacyPassPass());
+    }
+
+    if (mModuleOutput != nullptr) {
+        mPassManager.add(llvm::createPrintModulePass(mModuleOutput->os()));
+        mModuleOutput->keep();
+    }
+
+    this->registerVerificationStep();
+}
+
+void LLVMFrontend::registerPreprocessing()
+{
+    mHasPreprocessing = true;
+
+    // Do basic preprocessing: get rid of alloca's and turn undef's
+    //  into nondet function calls.
+    llvm::FunctionPassManager basicFpm;
+    basicFpm.addPass(llvm::PromotePass());
+    basicFpm.addPass(gazer::PromoteUndefsPass());
+    mPreprocessing.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(basicFpm)));
+
+    // Perform check instrumentation.
+    mPreprocessing.addPass(gazer::NormalizeVerifierCallsPass());
+    mChecks.registerPasses(mPreprocessing);
+
+    // Execute early optimization passes.
+    registerEarlyOptimizations();
+
+    // Inline functions and global variables if requested.
+    mPreprocessing.addPass(gazer::MarkFunctionEntriesPass());
+    registerInlining();
+
+    // Remove the checks which are safe in their inlined context.
+    if (mSettings.dischargeChecks) {
+        mPreprocessing.addPass(gazer::DischargeSafeChecksPass());
+    }
+
+    // Unify function exit nodes
+    mPreprocessing.addPass(LegacyPassWrapper<&llvm::createUnifyFunctionExitNodesPass>());
+
+    // Run assertion lifting.
+    if (mSettings.liftAsserts) {
+        mPreprocessing.addPass(gazer::LiftErrorCallsPass(*mSettings.getEntryFunction(*mModule)));
+
+        // Assertion lifting creates a lot of dead code. Run a lightweight DCE pass
+        // and a subsequent CFG simplification to clean up.
+        llvm::FunctionPassManager cleanupFpm;
+        cleanupFpm.addPass(llvm::DCEPass());
+        cleanupFpm.addPass(llvm::SimplifyCFGPass());
+        mPreprocessing.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(cleanupFpm)));
+    }
+
+    // Execute late optimization passes.
+    registerLateOptimizations();
+
+    // Do an instruction namer pass.
+    mPreprocessing.addPass(LegacyPassWrapper<&llvm::createInstructionNamerPass>());
+
+    // Unify exit nodes again
+    mPreprocessing.addPass(LegacyPassWrapper<&llvm::createUnifyFunctionExitNodesPass>());
+    mPreprocessing.addPass(llvm::createModuleToFunctionPassAdaptor(llvm::InstCombinePass(false)));
+}
+
+void LLVMFrontend::registerLegacyPreprocessing()
+{
     // Do basic preprocessing: get rid of alloca's and turn undef's
     //  into nondet function calls.
     mPassManager.add(llvm::createPromoteMemoryToRegisterPass());
@@ -150,14 +329,19 @@ void LLVMFrontend::registerVerificationPipeline()
 
     // Perform check instrumentation.
     mPassManager.add(gazer::createNormalizeVerifierCallsPass());
-    registerEnabledChecks();
+    mChecks.registerPasses(mPassManager);
 
     // Execute early optimization passes.
-    registerEarlyOptimizations();
+    registerLegacyEarlyOptimizations();
 
     // Inline functions and global variables if requested.
     mPassManager.add(gazer::createMarkFunctionEntriesPass());
-    registerInlining();
+    registerLegacyInlining();
+
+    // Remove the checks which are safe in their inlined context.
+    if (mSettings.dischargeChecks) {
+        mPassManager.add(gazer::createDischargeSafeChecksPass());
+    }
 
     // Unify function exit nodes
     mPassManager.add(llvm::createUnifyFunctionExitNodesPass());
@@ -176,7 +360,7 @@ void LLVMFrontend::registerVerificationPipeline()
     }
 
     // Execute late optimization passes.
-    registerLateOptimizations();
+    registerLegacyLateOptimizations();
 
     // Do an instruction namer pass.
     mPassManager.add(llvm::createInstructionNamerPass());
@@ -184,29 +368,27 @@ void LLVMFrontend::registerVerificationPipeline()
     // Unify exit nodes again
     mPassManager.add(llvm::createUnifyFunctionExitNodesPass());
     mPassManager.add(llvm::createInstructionCombiningPass(false));
-    
-    // Display the final LLVM CFG now.
-    if (ShowFinalCFG) {
-        mPassManager.add(llvm::createCFGPrinterLegacyPassPass());
-    }
-
-    if (mModuleOutput != nullptr) {
-        mPassManager.add(llvm::createPrintModulePass(mModuleOutput->os()));
-        mModuleOutput->keep();
-    }
-
-    this->registerVerificationStep();
 }
 
 void LLVMFrontend::registerVerificationStep()
 {
+    // Narrow integer operations, so that their translation uses smaller bit-vectors.
+    // Run it as the last step of the new pass manager pipeline if there is one.
+    if (mSettings.narrowInts && mSettings.ints == IntRepresentation::BitVectors) {
+        if (mHasPreprocessing) {
+            mPreprocessing.addPass(gazer::NarrowIntegerWidthPass());
+        } else {
+            mPassManager.add(gazer::createNarrowIntegerWidthPass());
+        }
+    }
+
     // Perform module-to-automata translation.
     mPassManager.add(new gazer::MemoryModelWrapperPass(mContext, mSettings));
     mPassManager.add(new gazer::ModuleToAutomataPass(mContext, mSettings));
 
     // Execute the verifier backend if there is one.
     if (mBackendAlgorithm != nullptr) {
-        mPassManager.add(new RunVerificationBackendPass(mChecks, *mBackendAlgorithm, mSettings));
+        mPassManager.add(new RunVerificationBackendPass(mChecks, *mBackendAlgorithm, mSettings, mResult));
     }
 }
 
@@ -218,27 +400,114 @@ bool RunVerificationBackendPass::runOnModule(llvm::Module& module)
     CfaToLLVMTrace cfaToLlvmTrace = moduleToCfa.getTraceInfo();
     LLVMTraceBuilder traceBuilder{system.getContext(), cfaToLlvmTrace};
 
+    // A property worker only checks the error codes it was given.
+    if (!mSettings.propertyCodes.empty()) {
+        this->prepareSystem(system, cfaToLlvmTrace, false);
+        SliceErrorLocations(system, mSettings.propertyCodes);
+
+        mResult = mAlgorithm.check(system, traceBuilder);
+        this->printResult(*mResult, module, "Property", false);
+        return false;
+    }
+
+    this->prepareSystem(system, cfaToLlvmTrace, true);
+
+    if (mSettings.decomposition != PropertyDecomposition::Off) {
+        auto properties = this->createProperties(system);
+        if (!properties.empty() && mSettings.commandLine.empty()) {
+            emit_warning("property workers cannot be started without the command line, "
+                "verifying all checks at once");
+        } else if (!properties.empty()) {
+            if (!mSettings.witness.empty() || !mSettings.testHarnessFile.empty()) {
+                emit_warning("witnesses and test harnesses are not generated for decomposed properties");
+            }
+
+            this->checkProperties(properties);
+            return false;
+        }
+    }
+
     mResult = mAlgorithm.check(system, traceBuilder);
-    switch (mResult->getStatus()) {
+    this->printResult(*mResult, module, "Verification", true);
+
+    return false;
+}
+
+void RunVerificationBackendPass::prepareSystem(
+    AutomataSystem& system, CfaToLLVMTrace& cfaToLlvmTrace, bool printStats)
+{
+    if (printStats) {
+        size_t numLocals = 0;
+        for (Cfa& cfa : system) {
+            numLocals += cfa.getNumLocals();
+        }
+        llvm::outs() << "Number of CFA locals: " << numLocals << "\n";
+    }
+
+    if (mSettings.deadLocalElimination) {
+        unsigned numEliminated = 0;
+        for (Cfa& cfa : system) {
+            // Values shown in the traces must remain available in the model.
+            llvm::DenseSet<Variable*> traceVariables;
+            if (mSettings.trace) {
+                cfaToLlvmTrace.getValueVariables(&cfa, traceVariables);
+            }
+
+            numEliminated += EliminateDeadLocals(&cfa, [&traceVariables](Variable* variable) {
+                return traceVariables.count(variable) != 0;
+            });
+        }
+        if (printStats) {
+            llvm::outs() << "Number of eliminated CFA locals: " << numEliminated << "\n";
+        }
+    }
+
+    if (mSettings.largeBlockEncoding) {
+        // Traces are built from the entry locations of basic blocks, keep them if needed.
+        auto isTraceLocation = [this, &cfaToLlvmTrace](Location* loc) {
+            return mSettings.trace
+                && cfaToLlvmTrace.getBlockFromLocation(loc).kind == CfaToLLVMTrace::Location_Entry;
+        };
+
+        unsigned numMerged = 0;
+        for (Cfa& cfa : system) {
+            numMerged += LargeBlockEncoding(&cfa, isTraceLocation);
+        }
+        if (printStats) {
+            llvm::outs() << "Number of merged locations: " << numMerged << "\n";
+        }
+    }
+}
+
+void RunVerificationBackendPass::printResult(
+    const VerificationResult& result, llvm::Module& module, llvm::StringRef title, bool writeArtifacts)
+{
+    switch (result.getStatus()) {
         case VerificationResult::Fail: {
-            auto fail = llvm::cast<FailResult>(mResult.get());
-            unsigned ec = fail->getErrorID();
-            std::string msg = mChecks.messageForCode(ec);
+            auto fail = llvm::cast<FailResult>(&result);
 
-            llvm::outs() << "Verification FAILED.\n";
-            llvm::outs() << "  " << msg << "\n";
+            llvm::outs() << title << " FAILED.\n";
+            for (const FailResult::Violation& violation : fail->violations()) {
+                llvm::outs() << "  " << mChecks.messageForCode(violation.errorCode) << "\n";
+            }
 
             if (mSettings.trace) {
                 auto writer = trace::CreateTextWriter(llvm::outs(), true);
-                llvm::outs() << "Error trace:\n";
-                llvm::outs() << "------------\n";
-                if (fail->hasTrace()) {
-                    writer->write(fail->getTrace());
-                } else {
-                    llvm::outs() << "Error trace is unavailable.\n";
+                for (const FailResult::Violation& violation : fail->violations()) {
+                    llvm::outs() << "Error trace:\n";
+                    llvm::outs() << "------------\n";
+                    if (violation.trace != nullptr) {
+                        writer->write(*violation.trace);
+                    } else {
+                        llvm::outs() << "Error trace is unavailable.\n";
+                    }
                 }
             }
             
+            if (!writeArtifacts) {
+                break;
+            }
+
             if (!mSettings.witness.empty() && fail->hasTrace() && !mSettings.hash.empty()) {
                 if (fail->hasTrace()) {
                     std::error_code EC{};
@@ -277,7 +546,11 @@ bool RunVerificationBackendPass::runOnModule(llvm::Module& module)
             break;
         }
         case VerificationResult::Success:
-            llvm::outs() << "Verification SUCCESSFUL.\n";
+            llvm::outs() << title << " SUCCESSFUL.\n";
+            if (!writeArtifacts) {
+                break;
+            }
+
             if (!mSettings.witness.empty() && !mSettings.hash.empty()) {
                 // puts the witness file in the working directory of gazer
                 std::error_code EC{};
@@ -290,29 +563,251 @@ bool RunVerificationBackendPass::runOnModule(llvm::Module& module)
             }
             break;
         case VerificationResult::Timeout:
-            llvm::outs() << "Verification TIMEOUT.\n";
+            llvm::outs() << title << " TIMEOUT.\n";
             break;
         case VerificationResult::BoundReached:
-            llvm::outs() << "Verification BOUND REACHED.\n";
+            llvm::outs() << title << " BOUND REACHED.\n";
             break;
         case VerificationResult::InternalError:
-            llvm::outs() << "Verification INTERNAL ERROR.\n";
-            llvm::outs() << "  " << mResult->getMessage() << "\n";
+            llvm::outs() << title << " INTERNAL ERROR.\n";
+            llvm::outs() << "  " << result.getMessage() << "\n";
             break;
         case VerificationResult::Unknown:
-            llvm::outs() << "Verification UNKNOWN.\n";
+            llvm::outs() << title << " UNKNOWN.\n";
             break;
     }
 
-    return false;
 }
 
-void LLVMFrontend::registerEnabledChecks()
+auto RunVerificationBackendPass::createProperties(AutomataSystem& system) const -> std::vector<Property>
 {
-    mChecks.registerPasses(mPassManager);
+    // Only create properties for the error codes which are still present in the system.
+    // If an error code is not a literal, e.g. when error calls were lifted into the entry
+    // procedure, any of the registered codes may be reachable.
+    std::vector<unsigned> errorCodes;
+    bool allCodes = false;
+    for (Cfa& cfa : system) {
+        for (auto& [location, errorCode] : cfa.errors()) {
+            if (auto bvLit = llvm::dyn_cast<BvLiteralExpr>(errorCode)) {
+                errorCodes.push_back(bvLit->getValue().getLimitedValue());
+            } else if (auto intLit = llvm::dyn_cast<IntLiteralExpr>(errorCode)) {
+                errorCodes.push_back(intLit->getValue());
+            } else {
+                allCodes = true;
+            }
+        }
+    }
+
+    if (allCodes) {
+        errorCodes = mChecks.getErrorCodes();
+    } else {
+        llvm::sort(errorCodes);
+        errorCodes.erase(std::unique(errorCodes.begin(), errorCodes.end()), errorCodes.end());
+    }
+
+    std::vector<Property> properties;
+    llvm::DenseMap<Check*, size_t> checkToProperty;
+    for (unsigned ec : errorCodes) {
+        if (mSettings.decomposition == PropertyDecomposition::Violation) {
+            properties.push_back({llvm::StringRef(mChecks.messageForCode(ec)).rtrim('.').str(), {ec}});
+            continue;
+        }
+
+        Check* check = mChecks.getCheckForCode(ec);
+        auto [it, inserted] = checkToProperty.try_emplace(check, properties.size());
+        if (inserted) {
+            properties.push_back({check->getErrorDescription().str(), {}});
+        }
+        properties[it->second].errorCodes.push_back(ec);
+    }
+
+    return properties;
+}
+
+void RunVerificationBackendPass::checkProperties(llvm::ArrayRef<Property> properties)
+{
+    // Slicing modifies the system and the expressions of a GazerContext may not be shared
+    // between threads, thus each property is verified by a new process of this tool, started
+    // with the same arguments and the error codes of the property. A worker reports the status
+    // of its result in its exit code, its output is collected into a log file and printed when
+    // the property is done.
+    struct Worker
+    {
+        size_t property;
+        llvm::sys::ProcessInfo process;
+        llvm::SmallString<128> logFile;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    auto program = findProgramLocation(mSettings.commandLine.front());
+    if (!program) {
+        emit_error("could not find the path to this process: %s", program.getError().message().c_str());
+        mResult = VerificationResult::CreateInternalError("Could not start the property workers.");
+        return;
+    }
+
+    unsigned numJobs = mSettings.propertyJobs;
+    if (numJobs == 0) {
+        numJobs = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    std::vector<VerificationResult::Status> results(properties.size(), VerificationResult::InternalError);
+
+    auto finish = [&](size_t property, llvm::StringRef logFile, llvm::StringRef error) {
+        llvm::outs() << "Checking property: " << properties[property].name << "\n";
+        if (auto log = llvm::MemoryBuffer::getFile(logFile)) {
+            llvm::StringRef output = (*log)->getBuffer();
+            llvm::outs() << output;
+            if (!output.empty() && !output.endswith("\n")) {
+                llvm::outs() << "\n";
+            }
+        }
+        llvm::sys::fs::remove(logFile);
+
+        // Workers which were stopped or crashed could not print their result.
+        if (results[property] == VerificationResult::Timeout) {
+            llvm::outs() << "Property TIMEOUT.\n";
+        } else if (!error.empty()) {
+            llvm::outs() << "Property INTERNAL ERROR.\n";
+            llvm::outs() << "  " << error << "\n";
+        }
+        llvm::outs().flush();
+    };
+
+    std::vector<Worker> workers;
+    size_t next = 0;
+
+    while (next < properties.size() || !workers.empty()) {
+        while (next < properties.size() && workers.size() < numJobs) {
+            size_t property = next++;
+
+            llvm::SmallString<128> logFile;
+            if (auto ec = llvm::sys::fs::createTemporaryFile("gazer-property", "log", logFile)) {
+                finish(property, logFile, "Could not create a log file: " + ec.message());
+                continue;
+            }
+
+            std::vector<std::string> codes;
+            for (unsigned ec : properties[property].errorCodes) {
+                codes.push_back(std::to_string(ec));
+            }
+            std::string codesArg = "-property-codes=" + llvm::join(codes, ",");
+
+            std::vector<llvm::StringRef> args(mSettings.commandLine.begin(), mSettings.commandLine.end());
+            args.push_back(codesArg);
+
+            llvm::Optional<llvm::StringRef> redirects[] = {
+                llvm::StringRef(""), llvm::StringRef(logFile), llvm::StringRef(logFile)
+            };
+
+            std::string errorMessage;
+            bool executionFailed = false;
+            llvm::sys::ProcessInfo process = llvm::sys::ExecuteNoWait(
+                *program, args, llvm::None, redirects, 0, &errorMessage, &executionFailed);
+
+            if (executionFailed) {
+                finish(property, logFile, "Could not start a worker process: " + errorMessage);
+                continue;
+            }
+
+            workers.push_back({property, process, logFile, std::chrono::steady_clock::now()});
+        }
+
+        // Collect the finished workers and stop the ones which ran out of time.
+        bool anyFinished = false;
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = workers.begin(); it != workers.end();) {
+            auto& result = results[it->property];
+            std::string error;
+
+            llvm::sys::ProcessInfo waitResult = llvm::sys::Wait(it->process, 0, false, &error);
+            if (waitResult.Pid == 0) {
+                if (mSettings.propertyTimeout == 0
+                    || now - it->start < std::chrono::seconds(mSettings.propertyTimeout)
+                ) {
+                    ++it;
+                    continue;
+                }
+
+                ::kill(it->process.Pid, SIGKILL);
+                llvm::sys::Wait(it->process, 0, true);
+                result = VerificationResult::Timeout;
+            } else if (waitResult.ReturnCode >= LLVMFrontend::PropertyExitCodeBase
+                && waitResult.ReturnCode <= LLVMFrontend::PropertyExitCodeBase + VerificationResult::InternalError
+            ) {
+                result = static_cast<VerificationResult::Status>(
+                    waitResult.ReturnCode - LLVMFrontend::PropertyExitCodeBase);
+            } else if (error.empty()) {
+                error = "The worker process terminated abnormally.";
+            }
+
+            finish(it->property, it->logFile, error);
+            it = workers.erase(it);
+            anyFinished = true;
+        }
+
+        if (!anyFinished && !workers.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    // A single failing property makes the whole program unsafe and the combined result contains
+    // a violation for each failing property. The program is only safe if all properties were
+    // proven, otherwise the first inconclusive result is reported. The traces of the workers
+    // are not available in this process.
+    mResult = nullptr;
+    llvm::outs() << "Property results:\n";
+    for (size_t i = 0; i < properties.size(); ++i) {
+        llvm::outs() << "  " << properties[i].name << ": " << getStatusName(results[i]) << "\n";
+
+        if (results[i] == VerificationResult::Fail) {
+            // The violated error code is only known if the property has a single one.
+            unsigned errorCode = properties[i].errorCodes.size() == 1
+                ? properties[i].errorCodes.front()
+                : VerificationResult::GeneralFailureCode;
+
+            auto fail = VerificationResult::CreateFail(errorCode);
+            if (mResult != nullptr && mResult->isFail()) {
+                llvm::cast<FailResult>(mResult.get())->append(std::move(*llvm::cast<FailResult>(fail.get())));
+            } else {
+                mResult = std::move(fail);
+            }
+        } else if (mResult == nullptr || (mResult->isSuccess() && results[i] != VerificationResult::Success)) {
+            mResult = createResult(results[i]);
+        }
+    }
+
+    llvm::outs() << "Verification " << getStatusName(mResult->getStatus()) << ".\n";
 }
 
 void LLVMFrontend::registerInlining()
+{
+    if (mSettings.inlineLevel != InlineLevel::Off) {
+        mPreprocessing.addPass(llvm::InternalizePass([this](const llvm::GlobalValue& gv) {
+            if (auto fun = llvm::dyn_cast<llvm::Function>(&gv)) {
+                return mSettings.getEntryFunction(*gv.getParent()) == fun;
+            }
+            return false;
+        }));
+        mPreprocessing.addPass(gazer::SimpleInlinerPass(*mSettings.getEntryFunction(*mModule), mSettings.inlineLevel));
+
+        // Remove dead functions
+        mPreprocessing.addPass(llvm::GlobalDCEPass());
+
+        // Inline eligible global variables
+        if (mSettings.inlineGlobals) {
+            mPreprocessing.addPass(gazer::InlineGlobalVariablesPass());
+        }
+
+        // Remove dead globals
+        mPreprocessing.addPass(llvm::GlobalDCEPass());
+
+        // Transform the generated alloca instructions into registers
+        mPreprocessing.addPass(llvm::createModuleToFunctionPassAdaptor(llvm::PromotePass()));
+    }
+}
+
+void LLVMFrontend::registerLegacyInlining()
 {
     if (mSettings.inlineLevel != InlineLevel::Off) {
         mPassManager.add(llvm::createInternalizePass([this](auto& gv) {
@@ -346,15 +841,106 @@ void LLVMFrontend::registerPass(llvm::Pass* pass)
 
 void LLVMFrontend::run()
 {
+    if (mHasPreprocessing) {
+        this->runPreprocessing();
+    }
+
     mPassManager.run(*mModule);
 }
 
+void LLVMFrontend::runPreprocessing()
+{
+    // The standard instrumentations provide -time-passes and -print-after
+    // for the new pass manager as well.
+    llvm::PassInstrumentationCallbacks pic;
+    llvm::StandardInstrumentations instrumentations;
+    instrumentations.registerCallbacks(pic);
+
+    llvm::PassBuilder pb(nullptr, llvm::PipelineTuningOptions(), llvm::None, &pic);
+
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    mPreprocessing.run(*mModule, mam);
+}
+
 void LLVMFrontend::registerEarlyOptimizations()
 {
     if (!mSettings.optimize) {
         return;
     }
 
+    // Split call sites under conditionals
+    mPreprocessing.addPass(llvm::createModuleToFunctionPassAdaptor(llvm::CallSiteSplittingPass()));
+
+    // Do some inter-procedural reductions
+    mPreprocessing.addPass(llvm::IPSCCPPass());
+    mPreprocessing.addPass(llvm::GlobalOptPass());
+    mPreprocessing.addPass(llvm::DeadArgumentEliminationPass());
+
+    llvm::FunctionPassManager fpm;
+
+    // Clean up
+    fpm.addPass(llvm::InstCombinePass());
+    fpm.addPass(llvm::SimplifyCFGPass());
+
+    // SROA may introduce new undef values, so we run another promote undef pass after it
+    fpm.addPass(llvm::SROA());
+    fpm.addPass(gazer::PromoteUndefsPass());
+
+    fpm.addPass(llvm::SimplifyCFGPass());
+    fpm.addPass(llvm::AggressiveInstCombinePass());
+    fpm.addPass(llvm::InstCombinePass());
+    mPreprocessing.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(fpm)));
+
+    // Try to remove irreducible control flow
+    if (StructurizeCFG) {
+        mPreprocessing.addPass(LegacyPassWrapper<&createStructurizeCFGLegacyPass>());
+    }
+
+    // Optimize loops
+    llvm::LoopPassManager lpm;
+    lpm.addPass(llvm::IndVarSimplifyPass());
+    lpm.addPass(llvm::LoopDeletionPass());
+    mPreprocessing.addPass(llvm::createModuleToFunctionPassAdaptor(
+        llvm::createFunctionToLoopPassAdaptor(std::move(lpm))
+    ));
+}
+
+void LLVMFrontend::registerLateOptimizations()
+{
+    if (mSettings.optimize) {
+        mPreprocessing.addPass(llvm::createModuleToFunctionPassAdaptor(
+            llvm::createFunctionToLoopPassAdaptor(llvm::LICMPass())
+        ));
+    }
+
+    mPreprocessing.addPass(llvm::GlobalOptPass());
+    mPreprocessing.addPass(llvm::GlobalDCEPass());
+
+    // Currently loop simplify must be applied for ModuleToAutomata
+    // to work properly as it relies on loop preheaders being available.
+    llvm::FunctionPassManager fpm;
+    fpm.addPass(llvm::SimplifyCFGPass());
+    fpm.addPass(llvm::LoopSimplifyPass());
+    fpm.addPass(gazer::CanonizeLoopExitsPass());
+    mPreprocessing.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(fpm)));
+}
+
+void LLVMFrontend::registerLegacyEarlyOptimizations()
+{
+    if (!mSettings.optimize) {
+        return;
+    }
+
     // Start with some metadata-based typed AA
     mPassManager.add(llvm::createTypeBasedAAWrapperPass());
     mPassManager.add(llvm::createScopedNoAliasAAWrapperPass());
@@ -399,7 +985,7 @@ void LLVMFrontend::registerEarlyOptimizations()
     //mPassManager.add(llvm::createNewGVNPass());
 }
 
-void LLVMFrontend::registerLateOptimizations()
+void LLVMFrontend::registerLegacyLateOptimizations()
 {
     if (mSettings.optimize) {
         mPassManager.add(llvm::createBasicAAWrapperPass());
@@ -20,6 +20,7 @@
 
 #include <llvm/IR/Module.h>
 #include <llvm/Support/CommandLine.h>
+#include <llvm/Support/MathExtras.h>
 
 using namespace gazer;
 using namespace llvm;
@@ -35,6 +36,25 @@ namespace gazer
 namespace
 {
     cl::opt<std::string> EnabledChecks("checks", cl::desc("List of enabled checks"), cl::cat(ChecksCategory));
+    cl::opt<PropertyDecomposition> DecomposeOpt("decompose",
+        cl::desc("Verify the enabled checks as separate properties:"),
+        cl::values(
+            clEnumValN(PropertyDecomposition::Off, "off", "Verify all checks at once"),
+            clEnumValN(PropertyDecomposition::Check, "check", "One property for each check"),
+            clEnumValN(PropertyDecomposition::Violation, "violation", "One property for each check violation")
+        ),
+        cl::init(PropertyDecomposition::Off),
+        cl::cat(ChecksCategory)
+    );
+    cl::opt<unsigned> PropertyJobs("property-jobs",
+        cl::desc("Number of properties verified concurrently (0 uses all hardware threads)"),
+        cl::init(0), cl::cat(ChecksCategory));
+    cl::opt<unsigned> PropertyTimeout("property-timeout",
+        cl::desc("Time limit for verifying a single property in seconds (0 means no limit)"),
+        cl::init(0), cl::cat(ChecksCategory));
+    cl::list<unsigned> PropertyCodes("property-codes",
+        cl::desc("Verify the given error codes only (used by the property workers)"),
+        cl::CommaSeparated, cl::Hidden);
 
     // LLVM frontend and transformation options
     // LLVM IR to CFA translation options
@@ -57,17 +77,32 @@ namespace
     cl::opt<bool> NoSlice(
         "no-slicing", cl::desc("Do not run program slicing pass"), cl::cat(LLVMFrontendCategory)
     );
+    cl::opt<bool> NoDischargeChecks(
+        "no-discharge-checks", cl::desc("Do not remove checks which are statically proven to be safe"),
+        cl::cat(LLVMFrontendCategory)
+    );
 
     // LLVM IR to CFA translation options
     cl::opt<ElimVarsLevel> ElimVarsLevelOpt("elim-vars", cl::desc("Level for variable elimination:"),
         cl::values(
             clEnumValN(ElimVarsLevel::Off, "off", "Do not eliminate variables"),
             clEnumValN(ElimVarsLevel::Normal, "normal", "Eliminate variables having only one use"),
+            clEnumValN(ElimVarsLevel::Budget, "budget", "Eliminate variables whose expressions fit into a size budget"),
             clEnumValN(ElimVarsLevel::Aggressive, "aggressive", "Eliminate all eligible variables")
         ),
         cl::init(ElimVarsLevel::Normal),
         cl::cat(IrToCfaCategory)
     );
+    cl::opt<unsigned> ElimVarsMaxNodes(
+        "elim-vars-max-nodes",
+        cl::desc("Maximum number of distinct expression nodes of an eliminated variable (-elim-vars=budget)"),
+        cl::init(64), cl::cat(IrToCfaCategory)
+    );
+    cl::opt<unsigned> ElimVarsMaxDepth(
+        "elim-vars-max-depth",
+        cl::desc("Maximum expression depth of an eliminated variable (-elim-vars=budget)"),
+        cl::init(16), cl::cat(IrToCfaCategory)
+    );
     cl::opt<bool> ArithInts(
         "math-int", cl::desc("Use mathematical unbounded integers instead of bitvectors"),
         cl::cat(IrToCfaCategory));
@@ -75,6 +110,22 @@ namespace
         "no-simplify-expr", cl::desc("Do not simplify expressions"),
         cl::cat(IrToCfaCategory)
     );
+    cl::opt<bool> CanonicalizeExpr(
+        "canonical-expr", cl::desc("Flatten and sort the operands of commutative and associative expressions"),
+        cl::cat(IrToCfaCategory)
+    );
+    cl::opt<bool> NoNarrowInts(
+        "no-narrow-ints", cl::desc("Do not narrow integer operations to their demanded bit width"),
+        cl::cat(IrToCfaCategory)
+    );
+    cl::opt<bool> NoDeadLocalElimination(
+        "no-dead-locals", cl::desc("Do not remove CFA locals which are never read before verification"),
+        cl::cat(IrToCfaCategory)
+    );
+    cl::opt<bool> NoLargeBlockEncoding(
+        "no-lbe", cl::desc("Do not merge CFA transitions into large blocks before verification"),
+        cl::cat(IrToCfaCategory)
+    );
     cl::opt<std::string> EntryFunctionName(
         "function", cl::desc("Main function name"), cl::cat(IrToCfaCategory), cl::init("main"));
     cl::opt<bool> Strict(
@@ -94,6 +145,19 @@ namespace
         cl::init(MemoryModelSetting::Flat),
         cl::cat(IrToCfaCategory)
     );
+    cl::opt<bool> CompactPointers(
+        "compact-pointers",
+        cl::desc("Use 32-bit pointers in the flat memory model if the memory of the program fits"),
+        cl::cat(IrToCfaCategory)
+    );
+    cl::opt<unsigned long long> GlobalBase(
+        "global-base", cl::desc("Start address of the global variables in the flat memory model"),
+        cl::init(0x00000001), cl::cat(IrToCfaCategory)
+    );
+    cl::opt<unsigned long long> StackBase(
+        "stack-base", cl::desc("Start address of the stack in the flat memory model"),
+        cl::init(0x40000000), cl::cat(IrToCfaCategory)
+    );
 
     // Traceability options
     cl::opt<bool> PrintTrace(
@@ -132,6 +196,17 @@ bool LLVMFrontendSettings::validate(const llvm::Module& module, llvm::raw_ostrea
         return false;
     }
 
+    if (!(this->globalBase < this->stackBase)) {
+        os << "The global variables must be placed below the stack!\n";
+        return false;
+    }
+
+    unsigned ptrWidth = module.getDataLayout().getPointerSizeInBits();
+    if (!llvm::isUIntN(ptrWidth, this->globalBase) || !llvm::isUIntN(ptrWidth, this->stackBase)) {
+        os << "The memory region base addresses must fit into " << ptrWidth << "-bit pointers!\n";
+        return false;
+    }
+
     return true;
 }
 
@@ -152,15 +227,29 @@ LLVMFrontendSettings LLVMFrontendSettings::initFromCommandLine()
     settings.optimize = !NoOptimize;
     settings.liftAsserts = !NoAssertLift;
     settings.slicing =!NoSlice;
+    settings.dischargeChecks = !NoDischargeChecks;
     settings.simplifyExpr = !NoSimplifyExpr;
 
+    settings.canonicalizeExpr = CanonicalizeExpr;
+    settings.narrowInts = !NoNarrowInts;
+    settings.deadLocalElimination = !NoDeadLocalElimination;
+    settings.largeBlockEncoding = !NoLargeBlockEncoding;
     settings.strict = Strict;
 
     settings.inlineLevel = InlineLevelOpt;
     settings.elimVars = ElimVarsLevelOpt;
+    settings.elimVarsMaxNodes = ElimVarsMaxNodes;
+    settings.elimVarsMaxDepth = ElimVarsMaxDepth;
     settings.memoryModel = MemoryModelOpt;
+    settings.compactPointers = CompactPointers;
+    settings.globalBase = GlobalBase;
+    settings.stackBase = StackBase;
 
     settings.checks = EnabledChecks;
+    settings.decomposition = DecomposeOpt;
+    settings.propertyJobs = PropertyJobs;
+    settings.propertyTimeout = PropertyTimeout;
+    settings.propertyCodes.assign(PropertyCodes.begin(), PropertyCodes.end());
 
 
     settings.function = EntryFunctionName;
@@ -189,6 +278,7 @@ std::string LLVMFrontendSettings::toString() const
     switch (elimVars) {
         case ElimVarsLevel::Off:         str += "off"; break;
         case ElimVarsLevel::Normal:      str += "normal"; break;
+        case ElimVarsLevel::Budget:      str += "budget"; break;
         case ElimVarsLevel::Aggressive:  str += "aggressive"; break;
     }
     str += R"(", "loop_representation": ")";
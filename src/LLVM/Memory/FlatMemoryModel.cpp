@@ -23,6 +23,8 @@
 #include "gazer/Core/Expr/ExprBuilder.h"
 #include "gazer/Support/Warnings.h"
 
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/Analysis/CallGraph.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/GetElementPtrTypeIterator.h>
 #include <llvm/Transforms/Utils/UnifyFunctionExitNodes.h>
@@ -70,10 +72,6 @@ struct FlatMemoryFunctionInfo
 class FlatMemoryModel : public MemoryModel, public MemoryTypeTranslator
 {
 public:
-    static constexpr unsigned GlobalBegin32 = 0x00000001;
-    static constexpr unsigned StackBegin32  = 0x40000000;
-    static constexpr unsigned HeapBegin32   = 0xF0000000;
-
     using DominatorTreeFuncTy = std::function<llvm::DominatorTree&(llvm::Function&)>;
 
 public:
@@ -100,19 +98,12 @@ public:
     }
 
 public:
-    gazer::BvType& ptrType() {
-        return BvType::Get(mContext, mDataLayout.getPointerSizeInBits());
-    }
+    gazer::BvType& ptrType() { return mPtrType; }
+    gazer::BvType& cellType() { return mCellType; }
+    gazer::ArrayType& memoryArrayType() { return mMemoryArrayType; }
 
-    gazer::BvType& cellType() {
-        return BvType::Get(mContext, 8);
-    }
-
-    gazer::ArrayType& memoryArrayType() {
-        return ArrayType::Get(ptrType(), cellType());
-    }
-
-    ExprRef<BvLiteralExpr> ptrConstant(unsigned addr) {
+    ExprRef<BvLiteralExpr> ptrConstant(uint64_t addr) {
+        assert(llvm::isUIntN(ptrType().getWidth(), addr) && "The address does not fit into a pointer!");
         return BvLiteralExpr::Get(ptrType(), addr);
     }
 
@@ -128,6 +119,12 @@ public:
 private:
     const LLVMFrontendSettings& mSettings;
     const llvm::DataLayout& mDataLayout;
+
+    // These types are needed for each memory access, so look them up once.
+    gazer::BvType& mPtrType;
+    gazer::BvType& mCellType;
+    gazer::ArrayType& mMemoryArrayType;
+
     std::unordered_map<const llvm::Function*, FlatMemoryFunctionInfo> mFunctions;
     std::unordered_map<
         const llvm::Function*, std::unique_ptr<MemoryInstructionHandler>> mTranslators;
@@ -137,6 +134,64 @@ private:
 
 } // namespace
 
+/// Returns the number of bytes the stack frames of the program may occupy at
+/// once, or None if this cannot be bounded statically.
+static llvm::Optional<uint64_t> getStackFootprint(llvm::Module& module, const llvm::DataLayout& dl)
+{
+    // Without recursion, each function has at most one frame on the stack.
+    llvm::CallGraph callGraph(module);
+    for (auto it = llvm::scc_begin(&callGraph); !it.isAtEnd(); ++it) {
+        if (it.hasLoop()) {
+            return llvm::None;
+        }
+    }
+
+    uint64_t footprint = 0;
+    for (llvm::Function& function : module) {
+        for (llvm::Instruction& inst : llvm::instructions(function)) {
+            if (auto alloca = llvm::dyn_cast<llvm::AllocaInst>(&inst)) {
+                if (!alloca->isStaticAlloca()) {
+                    return llvm::None;
+                }
+
+                footprint += dl.getTypeAllocSize(alloca->getAllocatedType())
+                    * llvm::cast<llvm::ConstantInt>(alloca->getArraySize())->getZExtValue();
+            }
+        }
+    }
+
+    return footprint;
+}
+
+/// Returns the bit width of pointers in the flat memory model. In compact mode,
+/// 32-bit pointers are used if no address of the program can overflow them.
+static unsigned getPointerWidth(
+    const LLVMFrontendSettings& settings, llvm::Module& module, const llvm::DataLayout& dl)
+{
+    unsigned targetWidth = dl.getPointerSizeInBits();
+    if (!settings.compactPointers || targetWidth <= 32) {
+        return targetWidth;
+    }
+
+    uint64_t globalsSize = 0;
+    for (llvm::GlobalVariable& gv : module.globals()) {
+        globalsSize += dl.getTypeAllocSize(gv.getType()->getPointerElementType());
+    }
+
+    auto stackSize = getStackFootprint(module, dl);
+
+    // Heap allocations are not placed by the model, their addresses are nondeterministic.
+    if (settings.globalBase + globalsSize <= settings.stackBase
+        && settings.stackBase <= llvm::maxUIntN(32)
+        && stackSize.hasValue() && *stackSize <= llvm::maxUIntN(32) - settings.stackBase
+    ) {
+        return 32;
+    }
+
+    emit_warning("The memory of the program may not fit into 32-bit pointers, using %u-bit pointers.", targetWidth);
+    return targetWidth;
+}
+
 FlatMemoryModel::FlatMemoryModel(
     GazerContext& context,
     const LLVMFrontendSettings& settings,
@@ -145,6 +200,9 @@ FlatMemoryModel::FlatMemoryModel(
 ) : MemoryTypeTranslator(context),
     mSettings(settings),
     mDataLayout(module.getDataLayout()),
+    mPtrType(BvType::Get(context, getPointerWidth(settings, module, mDataLayout))),
+    mCellType(BvType::Get(context, 8)),
+    mMemoryArrayType(ArrayType::Get(mPtrType, mCellType)),
     mTypes(*this, mSettings)
 {
     // Initialize the expression builder
@@ -179,11 +237,11 @@ FlatMemoryModel::FlatMemoryModel(
         info.memory->setTypeHint(memoryArrayType());
 
         info.stackPointer = builder.createMemoryObject(
-            1, MemoryObjectType::Unknown, mDataLayout.getPointerSize(), nullptr, "StackPtr");
+            1, MemoryObjectType::Unknown, mPtrType.getWidth() / 8, nullptr, "StackPtr");
         info.stackPointer->setTypeHint(ptrType());
 
         info.framePointer = builder.createMemoryObject(
-            2, MemoryObjectType::Unknown, mDataLayout.getPointerSize(), nullptr, "FramePtr");
+            2, MemoryObjectType::Unknown, mPtrType.getWidth() / 8, nullptr, "FramePtr");
         info.framePointer->setTypeHint(ptrType());
 
         builder.createLiveOnEntryDef(info.memory);
@@ -209,7 +267,7 @@ FlatMemoryModel::FlatMemoryModel(
             }
         }
 
-        unsigned globalAddr = GlobalBegin32;
+        uint64_t globalAddr = mSettings.globalBase;
         info.globalPointers.reserve(otherGlobals.size());
 
         for (llvm::GlobalVariable* gv : otherGlobals) {
@@ -363,7 +421,7 @@ private:
 
     BvType& bv8ty()
     {
-        return BvType::Get(mMemoryModel.getContext(), 8);
+        return mMemoryModel.cellType();
     }
 
     memory::MemorySSA& getMemorySSA() const { return *mInfo.memorySSA; }
@@ -500,7 +558,7 @@ ExprPtr FlatMemoryModelInstTranslator::handleConstantDataArray(
 {
     assert(elements.size() == cda->getNumElements());
 
-    ArrayLiteralExpr::Builder builder(ArrayType::Get(mMemoryModel.ptrType(), bv8ty()), BvLiteralExpr::Get(bv8ty(), 0));
+    ArrayLiteralExpr::Builder builder(mMemoryModel.memoryArrayType(), BvLiteralExpr::Get(bv8ty(), 0));
 
     llvm::Type* elemTy = cda->getType()->getArrayElementType();
     unsigned size = mDataLayout.getTypeAllocSize(elemTy);
@@ -552,7 +610,7 @@ ExprPtr FlatMemoryModelInstTranslator::handleConstantDataArray(
 
 ExprPtr FlatMemoryModelInstTranslator::handleZeroInitializedAggregate(const llvm::ConstantAggregateZero *caz)
 {
-    return ArrayLiteralExpr::GetEmpty(ArrayType::Get(mMemoryModel.ptrType(), bv8ty()), mExprBuilder.BvLit8(0));
+    return ArrayLiteralExpr::GetEmpty(mMemoryModel.memoryArrayType(), mExprBuilder.BvLit8(0));
 }
 
 void FlatMemoryModelInstTranslator::handleBlock(const llvm::BasicBlock& bb, llvm2cfa::GenerationStepExtensionPoint& ep)
@@ -577,8 +635,7 @@ void FlatMemoryModelInstTranslator::handleBlock(const llvm::BasicBlock& bb, llvm
         } else if (auto liveOnEntry = llvm::dyn_cast<memory::LiveOnEntryDef>(&def)) {
             ExprPtr initVal;
             if (def.getObject() == mInfo.stackPointer || def.getObject() == mInfo.framePointer) {
-                // TODO: 64 bit
-                initVal = mMemoryModel.ptrConstant(FlatMemoryModel::StackBegin32);
+                initVal = mMemoryModel.ptrConstant(mMemoryModel.getSettings().stackBase);
             } else {
                 initVal = mExprBuilder.Undef(defVariable->getType());
             }
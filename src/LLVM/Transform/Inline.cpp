@@ -38,41 +38,57 @@ using namespace gazer;
 namespace
 {
 
-class InlinePass : public llvm::ModulePass
+class SimpleInliner
 {
 public:
-    static char ID;
-
-public:
-    InlinePass(llvm::Function* entry, InlineLevel level)
-        : ModulePass(ID), mEntryFunction(entry), mLevel(level)
+    SimpleInliner(llvm::Function* entry, InlineLevel level)
+        : mEntryFunction(entry), mLevel(level)
     {
         assert(mEntryFunction != nullptr);
     }
 
+    bool run(llvm::CallGraph& cg);
+
+private:
+    bool shouldInlineFunction(llvm::CallGraphNode* target, unsigned allowedRefs);
+
+    llvm::Function* mEntryFunction;
+    InlineLevel mLevel;
+};
+
+class InlineLegacyPass : public llvm::ModulePass
+{
+public:
+    static char ID;
+
+public:
+    InlineLegacyPass(llvm::Function* entry, InlineLevel level)
+        : ModulePass(ID), mInliner(entry, level)
+    {}
+
     void getAnalysisUsage(llvm::AnalysisUsage& au) const override
     {
         au.addRequired<llvm::CallGraphWrapperPass>();
     }
 
-    bool runOnModule(llvm::Module& module) override;
+    bool runOnModule(llvm::Module& module) override
+    {
+        return mInliner.run(getAnalysis<llvm::CallGraphWrapperPass>().getCallGraph());
+    }
 
     llvm::StringRef getPassName() const override {
         return "Simplified inling";
     }
 
 private:
-    bool shouldInlineFunction(llvm::CallGraphNode* target, unsigned allowedRefs);
-
-    llvm::Function* mEntryFunction;
-    InlineLevel mLevel;
+    SimpleInliner mInliner;
 };
 
 } // end anonymous namespace
 
-char InlinePass::ID;
+char InlineLegacyPass::ID;
 
-bool InlinePass::shouldInlineFunction(llvm::CallGraphNode* target, unsigned allowedRefs)
+bool SimpleInliner::shouldInlineFunction(llvm::CallGraphNode* target, unsigned allowedRefs)
 {
     bool viable = llvm::isInlineViable(*target->getFunction());
     viable |= !isRecursive(target);
@@ -102,14 +118,13 @@ bool InlinePass::shouldInlineFunction(llvm::CallGraphNode* target, unsigned allo
     return false;
 }
 
-bool InlinePass::runOnModule(llvm::Module& module)
+bool SimpleInliner::run(llvm::CallGraph& cg)
 {
     if (mLevel == InlineLevel::Off) {
         return false;
     }
 
     bool changed = false;
-    llvm::CallGraph& cg = getAnalysis<llvm::CallGraphWrapperPass>().getCallGraph();
 
     llvm::InlineFunctionInfo ifi(&cg);
     llvm::SmallVector<llvm::CallSite, 16> wl;
@@ -147,5 +162,15 @@ bool InlinePass::runOnModule(llvm::Module& module)
 
 llvm::Pass* gazer::createSimpleInlinerPass(llvm::Function& entry, InlineLevel level)
 {
-    return new InlinePass(&entry, level);
+    return new InlineLegacyPass(&entry, level);
+}
+
+llvm::PreservedAnalyses gazer::SimpleInlinerPass::run(llvm::Module& module, llvm::ModuleAnalysisManager& mam)
+{
+    SimpleInliner inliner(mEntryFunction, mLevel);
+    if (!inliner.run(mam.getResult<llvm::CallGraphAnalysis>(module))) {
+        return llvm::PreservedAnalyses::all();
+    }
+
+    return llvm::PreservedAnalyses::none();
 }
@@ -36,11 +36,11 @@ using namespace gazer;
 namespace
 {
 
-struct InlineGlobalVariablesPass final : public ModulePass
+struct InlineGlobalVariablesLegacyPass final : public ModulePass
 {
     static char ID;
 
-    InlineGlobalVariablesPass()
+    InlineGlobalVariablesLegacyPass()
         : ModulePass(ID)
     {}
 
@@ -51,10 +51,11 @@ struct InlineGlobalVariablesPass final : public ModulePass
 
     bool runOnModule(Module& module) override;
 
+    static bool inlineGlobals(Module& module, llvm::CallGraph& cg);
     static llvm::Function* shouldInlineGlobal(llvm::CallGraph& cg, llvm::GlobalVariable& gv);
 };
 
-llvm::Function* InlineGlobalVariablesPass::shouldInlineGlobal(llvm::CallGraph& cg, llvm::GlobalVariable& gv)
+llvm::Function* InlineGlobalVariablesLegacyPass::shouldInlineGlobal(llvm::CallGraph& cg, llvm::GlobalVariable& gv)
 {
     llvm::GlobalStatus status;
 
@@ -99,7 +100,7 @@ llvm::Function* InlineGlobalVariablesPass::shouldInlineGlobal(llvm::CallGraph& c
     return const_cast<llvm::Function*>(status.AccessingFunction);
 }
 
-char InlineGlobalVariablesPass::ID = 0;
+char InlineGlobalVariablesLegacyPass::ID = 0;
 
 void transformConstantUsersToInstructions(llvm::Constant& constant)
 {
@@ -127,15 +128,18 @@ void transformConstantUsersToInstructions(llvm::Constant& constant)
     }
 }
 
-bool InlineGlobalVariablesPass::runOnModule(Module& module)
+bool InlineGlobalVariablesLegacyPass::runOnModule(Module& module)
 {
     if (module.global_begin() == module.global_end()) {
         // No globals to inline
         return false;
     }
 
-    llvm::CallGraph& cg = getAnalysis<llvm::CallGraphWrapperPass>().getCallGraph();
+    return inlineGlobals(module, getAnalysis<llvm::CallGraphWrapperPass>().getCallGraph());
+}
 
+bool InlineGlobalVariablesLegacyPass::inlineGlobals(Module& module, llvm::CallGraph& cg)
+{
     // Create a dbg declaration if it does not exist yet.
     Intrinsic::getDeclaration(&module, Intrinsic::dbg_declare);
 
@@ -152,7 +156,7 @@ bool InlineGlobalVariablesPass::runOnModule(Module& module)
             continue;
         }
 
-        llvm::Function* target = this->shouldInlineGlobal(cg, gv);
+        llvm::Function* target = shouldInlineGlobal(cg, gv);
         if (target == nullptr) {
             continue;
         }
@@ -213,7 +217,21 @@ namespace gazer
 {
 
 llvm::Pass* createInlineGlobalVariablesPass() {
-    return new InlineGlobalVariablesPass();
+    return new InlineGlobalVariablesLegacyPass();
+}
+
+llvm::PreservedAnalyses InlineGlobalVariablesPass::run(llvm::Module& module, llvm::ModuleAnalysisManager& mam)
+{
+    if (module.global_begin() == module.global_end()) {
+        return llvm::PreservedAnalyses::all();
+    }
+
+    auto& cg = mam.getResult<llvm::CallGraphAnalysis>(module);
+    if (!InlineGlobalVariablesLegacyPass::inlineGlobals(module, cg)) {
+        return llvm::PreservedAnalyses::all();
+    }
+
+    return llvm::PreservedAnalyses::none();
 }
 
 } // end namespace gazer
\ No newline at end of file
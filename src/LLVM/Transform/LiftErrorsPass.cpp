@@ -99,13 +99,13 @@ private:
     llvm::DenseMap<llvm::Function*, FunctionInfo> mInfos;
 };
 
-class LiftErrorCallsPass : public llvm::ModulePass
+class LiftErrorCallsLegacyPass : public llvm::ModulePass
 {
 public:
     static char ID;
 
 public:
-    LiftErrorCallsPass(llvm::Function* function)
+    LiftErrorCallsLegacyPass(llvm::Function* function)
         : ModulePass(ID), mEntryFunction(function)
     {}
 
@@ -131,7 +131,7 @@ private:
 
 } // end anonymous namespace
 
-char LiftErrorCallsPass::ID;
+char LiftErrorCallsLegacyPass::ID;
 
 void LiftErrorCalls::combineErrorsInFunction(llvm::Function* function, FunctionInfo& info)
 {
@@ -320,5 +320,17 @@ bool LiftErrorCalls::run()
 
 llvm::Pass* gazer::createLiftErrorCallsPass(llvm::Function& entry)
 {
-    return new LiftErrorCallsPass(&entry);
+    return new LiftErrorCallsLegacyPass(&entry);
+}
+
+llvm::PreservedAnalyses gazer::LiftErrorCallsPass::run(llvm::Module& module, llvm::ModuleAnalysisManager& mam)
+{
+    auto& cg = mam.getResult<llvm::CallGraphAnalysis>(module);
+
+    LiftErrorCalls impl(module, cg, *mEntryFunction);
+    if (!impl.run()) {
+        return llvm::PreservedAnalyses::all();
+    }
+
+    return llvm::PreservedAnalyses::none();
 }
@@ -24,12 +24,12 @@
 namespace
 {
 
-class LoopExitCanonizationPass : public llvm::FunctionPass
+class LoopExitCanonizationLegacyPass : public llvm::FunctionPass
 {
 public:
     static char ID;
 
-    LoopExitCanonizationPass()
+    LoopExitCanonizationLegacyPass()
         : FunctionPass(ID)
     {}
 
@@ -43,7 +43,7 @@ public:
 
 } // namespace
 
-char LoopExitCanonizationPass::ID;
+char LoopExitCanonizationLegacyPass::ID;
 
 static void adjustPhiNodes(llvm::BasicBlock* succ, llvm::BasicBlock* oldBB, llvm::BasicBlock* newBB)
 {
@@ -95,10 +95,8 @@ static bool transformExitsInLoop(llvm::LoopInfo& loopInfo, llvm::Loop* loop)
     return true;
 }
 
-bool LoopExitCanonizationPass::runOnFunction(llvm::Function& function)
+static bool canonizeLoopExits(llvm::LoopInfo& loopInfo)
 {
-    llvm::LoopInfo& loopInfo = getAnalysis<llvm::LoopInfoWrapperPass>().getLoopInfo();
-
     auto loopsInPostorder = loopInfo.getLoopsInPreorder();
     llvm::reverse(loopsInPostorder);
 
@@ -110,6 +108,20 @@ bool LoopExitCanonizationPass::runOnFunction(llvm::Function& function)
     return changed;
 }
 
+bool LoopExitCanonizationLegacyPass::runOnFunction(llvm::Function& function)
+{
+    return canonizeLoopExits(getAnalysis<llvm::LoopInfoWrapperPass>().getLoopInfo());
+}
+
 llvm::Pass* gazer::createCanonizeLoopExitsPass() {
-    return new LoopExitCanonizationPass();
-}
\ No newline at end of file
+    return new LoopExitCanonizationLegacyPass();
+}
+
+llvm::PreservedAnalyses gazer::CanonizeLoopExitsPass::run(llvm::Function& function, llvm::FunctionAnalysisManager& fam)
+{
+    if (!canonizeLoopExits(fam.getResult<llvm::LoopAnalysis>(function))) {
+        return llvm::PreservedAnalyses::all();
+    }
+
+    return llvm::PreservedAnalyses::none();
+}
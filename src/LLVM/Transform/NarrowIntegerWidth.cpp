@@ -0,0 +1,337 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file implements a pass which narrows integer operations to
+/// the bit width they actually need, so that the CFA translation emits
+/// narrower bit-vector expressions.
+///
+/// An operation is narrowed if the upper bits of its result are never used
+/// (according to DemandedBits), or if the value range of its result fits into
+/// a narrower width (according to LazyValueInfo and ScalarEvolution). The
+/// narrowed operation works on truncated operands and its result is extended
+/// back to the original width, thus the users of the value are unchanged.
+/// Note that the value ranges rely on the no-wrap flags of the IR, similarly
+/// to the optimizations of the frontend pipeline.
+///
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Transform/Passes.h"
+
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/Analysis/DemandedBits.h>
+#include <llvm/Analysis/LazyValueInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/IR/ConstantRange.h>
+#include <llvm/IR/DebugInfo.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Transforms/Utils/Local.h>
+
+#include <functional>
+#include <optional>
+
+using namespace gazer;
+
+namespace
+{
+
+/// The narrowest width an operation is narrowed to. Narrowed widths are
+/// rounded up to a power of two, so that chains of narrowed operations
+/// are likely to share the same width.
+constexpr unsigned MinNarrowWidth = 8;
+
+struct Narrowing
+{
+    llvm::BinaryOperator* inst;
+    unsigned width;
+    bool isSigned;  ///< Sign-extend the narrow result instead of zero-extending it.
+};
+
+struct NarrowingAnalyses
+{
+    llvm::DemandedBits& demandedBits;
+    llvm::LazyValueInfo& lazyValueInfo;
+    llvm::ScalarEvolution& scalarEvolution;
+};
+
+class NarrowIntegerWidth
+{
+public:
+    using AnalysisGetter = std::function<NarrowingAnalyses(llvm::Function&)>;
+
+    explicit NarrowIntegerWidth(AnalysisGetter getAnalyses)
+        : mGetAnalyses(std::move(getAnalyses))
+    {}
+
+    bool run(llvm::Module& module);
+
+private:
+    std::optional<Narrowing> findNarrowing(llvm::BinaryOperator& inst, NarrowingAnalyses& analyses);
+    void narrow(const Narrowing& narrowing);
+
+private:
+    AnalysisGetter mGetAnalyses;
+};
+
+class NarrowIntegerWidthLegacyPass : public llvm::ModulePass
+{
+public:
+    static char ID;
+
+    NarrowIntegerWidthLegacyPass()
+        : ModulePass(ID)
+    {}
+
+    void getAnalysisUsage(llvm::AnalysisUsage& au) const override
+    {
+        au.addRequired<llvm::DemandedBitsWrapperPass>();
+        au.addRequired<llvm::LazyValueInfoWrapperPass>();
+        au.addRequired<llvm::ScalarEvolutionWrapperPass>();
+        au.setPreservesCFG();
+    }
+
+    bool runOnModule(llvm::Module& module) override
+    {
+        NarrowIntegerWidth impl([this](llvm::Function& function) {
+            return NarrowingAnalyses{
+                getAnalysis<llvm::DemandedBitsWrapperPass>(function).getDemandedBits(),
+                getAnalysis<llvm::LazyValueInfoWrapperPass>(function).getLVI(),
+                getAnalysis<llvm::ScalarEvolutionWrapperPass>(function).getSE()
+            };
+        });
+
+        return impl.run(module);
+    }
+
+    llvm::StringRef getPassName() const override {
+        return "Narrow integer width";
+    }
+};
+
+} // end anonymous namespace
+
+char NarrowIntegerWidthLegacyPass::ID;
+
+static bool isModularOperation(unsigned opcode)
+{
+    switch (opcode) {
+        case llvm::Instruction::Add:
+        case llvm::Instruction::Sub:
+        case llvm::Instruction::Mul:
+        case llvm::Instruction::And:
+        case llvm::Instruction::Or:
+        case llvm::Instruction::Xor:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool hasDebugUsers(llvm::Instruction& inst)
+{
+    llvm::SmallVector<llvm::DbgValueInst*, 1> dbgValues;
+    llvm::findDbgValues(dbgValues, &inst);
+
+    return !dbgValues.empty();
+}
+
+static unsigned getSignedBits(const llvm::ConstantRange& range)
+{
+    return std::max(range.getSignedMin().getMinSignedBits(), range.getSignedMax().getMinSignedBits());
+}
+
+static llvm::ConstantRange getRange(
+    llvm::Value* value, llvm::Instruction* cxt, bool isSigned, NarrowingAnalyses& analyses)
+{
+    if (auto ci = llvm::dyn_cast<llvm::ConstantInt>(value)) {
+        return llvm::ConstantRange(ci->getValue());
+    }
+
+    llvm::ConstantRange range = analyses.lazyValueInfo.getConstantRange(value, cxt->getParent(), cxt);
+
+    auto& se = analyses.scalarEvolution;
+    if (se.isSCEVable(value->getType())) {
+        const llvm::SCEV* scev = se.getSCEV(value);
+        range = range.intersectWith(isSigned ? se.getSignedRange(scev) : se.getUnsignedRange(scev));
+    }
+
+    return range;
+}
+
+std::optional<Narrowing> NarrowIntegerWidth::findNarrowing(
+    llvm::BinaryOperator& inst, NarrowingAnalyses& analyses)
+{
+    if (!inst.getType()->isIntegerTy()) {
+        return std::nullopt;
+    }
+
+    unsigned width = inst.getType()->getIntegerBitWidth();
+    llvm::Value* lhs = inst.getOperand(0);
+    llvm::Value* rhs = inst.getOperand(1);
+    if (width <= MinNarrowWidth || (llvm::isa<llvm::Constant>(lhs) && llvm::isa<llvm::Constant>(rhs))) {
+        return std::nullopt;
+    }
+
+    std::optional<Narrowing> best;
+    auto consider = [&](unsigned bits, bool isSigned) {
+        unsigned narrowWidth = std::max<unsigned>(MinNarrowWidth, llvm::PowerOf2Ceil(bits));
+        if (narrowWidth < width && (!best.has_value() || narrowWidth < best->width)) {
+            best = Narrowing{&inst, narrowWidth, isSigned};
+        }
+    };
+
+    unsigned opcode = inst.getOpcode();
+    if (isModularOperation(opcode)) {
+        // The low bits of a modular operation only depend on the low bits of its
+        // operands, thus it may be computed on the demanded bits only. As the rest
+        // of the bits will be zero, skip values the traces could show.
+        if (!hasDebugUsers(inst)) {
+            consider(analyses.demandedBits.getDemandedBits(&inst).getActiveBits(), false);
+        }
+
+        // If the result fits into the narrow width, extending the truncated
+        // result gives back the original one.
+        consider(getRange(&inst, &inst, false, analyses).getUnsignedMax().getActiveBits(), false);
+        consider(getSignedBits(getRange(&inst, &inst, true, analyses)), true);
+    } else if (opcode == llvm::Instruction::UDiv || opcode == llvm::Instruction::URem) {
+        // Division is exact on the narrow width if both operands fit.
+        consider(std::max(
+            getRange(lhs, &inst, false, analyses).getUnsignedMax().getActiveBits(),
+            getRange(rhs, &inst, false, analyses).getUnsignedMax().getActiveBits()
+        ), false);
+    } else if (opcode == llvm::Instruction::SDiv || opcode == llvm::Instruction::SRem) {
+        // An additional bit makes sure that the narrow division cannot overflow.
+        consider(std::max(
+            getSignedBits(getRange(lhs, &inst, true, analyses)),
+            getSignedBits(getRange(rhs, &inst, true, analyses))
+        ) + 1, true);
+    }
+
+    return best;
+}
+
+static llvm::Value* truncate(llvm::IRBuilder<>& builder, llvm::Value* value, llvm::IntegerType* type)
+{
+    // Operands which were narrowed before may be used directly.
+    if (llvm::isa<llvm::ZExtInst>(value) || llvm::isa<llvm::SExtInst>(value)) {
+        llvm::Value* source = llvm::cast<llvm::CastInst>(value)->getOperand(0);
+        if (source->getType() == type) {
+            return source;
+        }
+    }
+
+    return builder.CreateTrunc(value, type, value->hasName() ? value->getName() + ".trunc" : "");
+}
+
+void NarrowIntegerWidth::narrow(const Narrowing& narrowing)
+{
+    llvm::BinaryOperator* inst = narrowing.inst;
+    auto narrowTy = llvm::IntegerType::get(inst->getContext(), narrowing.width);
+
+    // The no-wrap and exact flags are not necessarily valid on the narrow width.
+    llvm::IRBuilder<> builder(inst);
+    llvm::Value* lhs = truncate(builder, inst->getOperand(0), narrowTy);
+    llvm::Value* rhs = truncate(builder, inst->getOperand(1), narrowTy);
+    llvm::Value* result = builder.CreateBinOp(inst->getOpcode(), lhs, rhs, inst->getName() + ".narrow");
+    llvm::Value* extended = narrowing.isSigned
+        ? builder.CreateSExt(result, inst->getType())
+        : builder.CreateZExt(result, inst->getType());
+
+    extended->takeName(inst);
+    inst->replaceAllUsesWith(extended);
+    inst->eraseFromParent();
+
+    // Truncations to the narrow width may use the narrow result directly.
+    for (llvm::User* user : llvm::make_early_inc_range(extended->users())) {
+        auto trunc = llvm::dyn_cast<llvm::TruncInst>(user);
+        if (trunc != nullptr && trunc->getType() == narrowTy) {
+            trunc->replaceAllUsesWith(result);
+            trunc->eraseFromParent();
+        }
+    }
+}
+
+bool NarrowIntegerWidth::run(llvm::Module& module)
+{
+    unsigned numNarrowed = 0;
+
+    for (llvm::Function& function : module) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+
+        // Query all instructions first: the analyses are not updated while the
+        // function is being modified. Operands are visited before their users,
+        // so narrowed chains do not need to be extended between each step.
+        NarrowingAnalyses analyses = mGetAnalyses(function);
+        llvm::SmallVector<Narrowing, 16> narrowings;
+
+        llvm::ReversePostOrderTraversal<llvm::Function*> rpot(&function);
+        for (llvm::BasicBlock* bb : rpot) {
+            for (llvm::Instruction& inst : *bb) {
+                if (auto binOp = llvm::dyn_cast<llvm::BinaryOperator>(&inst)) {
+                    if (auto narrowing = this->findNarrowing(*binOp, analyses)) {
+                        narrowings.push_back(*narrowing);
+                    }
+                }
+            }
+        }
+
+        for (const Narrowing& narrowing : narrowings) {
+            this->narrow(narrowing);
+        }
+
+        numNarrowed += narrowings.size();
+    }
+
+    if (numNarrowed != 0) {
+        llvm::outs() << "Number of narrowed instructions: " << numNarrowed << "\n";
+    }
+
+    return numNarrowed != 0;
+}
+
+namespace gazer
+{
+
+llvm::Pass* createNarrowIntegerWidthPass() {
+    return new NarrowIntegerWidthLegacyPass();
+}
+
+llvm::PreservedAnalyses NarrowIntegerWidthPass::run(llvm::Module& module, llvm::ModuleAnalysisManager& mam)
+{
+    auto& fam = mam.getResult<llvm::FunctionAnalysisManagerModuleProxy>(module).getManager();
+
+    NarrowIntegerWidth impl([&fam](llvm::Function& function) {
+        return NarrowingAnalyses{
+            fam.getResult<llvm::DemandedBitsAnalysis>(function),
+            fam.getResult<llvm::LazyValueAnalysis>(function),
+            fam.getResult<llvm::ScalarEvolutionAnalysis>(function)
+        };
+    });
+
+    if (!impl.run(module)) {
+        return llvm::PreservedAnalyses::all();
+    }
+
+    llvm::PreservedAnalyses pa;
+    pa.preserveSet<llvm::CFGAnalyses>();
+    return pa;
+}
+
+} // end namespace gazer
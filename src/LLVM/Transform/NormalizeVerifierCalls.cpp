@@ -35,16 +35,10 @@ namespace
 // The implementation of this class is partly based on the PromoteVerifierCalls
 // pass found in SeaHorn.
 // FIXME: We should update the call graph information as we go.
-class NormalizeVerifierCallsPass : public llvm::ModulePass
+class NormalizeVerifierCalls
 {
 public:
-    static char ID;
-
-    NormalizeVerifierCallsPass()
-        : ModulePass(ID)
-    {}
-
-    bool runOnModule(llvm::Module& module) override;
+    bool run(llvm::Module& module);
     void runOnFunction(llvm::Function& function);
 
 private:
@@ -52,9 +46,24 @@ private:
     llvm::FunctionCallee mError;
 };
 
+class NormalizeVerifierCallsLegacyPass : public llvm::ModulePass
+{
+public:
+    static char ID;
+
+    NormalizeVerifierCallsLegacyPass()
+        : ModulePass(ID)
+    {}
+
+    bool runOnModule(llvm::Module& module) override
+    {
+        return NormalizeVerifierCalls().run(module);
+    }
+};
+
 } // end anonymous namespace
 
-bool NormalizeVerifierCallsPass::runOnModule(llvm::Module& module)
+bool NormalizeVerifierCalls::run(llvm::Module& module)
 {
     // Insert our uniform functions.
     mAssume = module.getOrInsertFunction(
@@ -81,9 +90,9 @@ bool NormalizeVerifierCallsPass::runOnModule(llvm::Module& module)
     return true;
 }
 
-char NormalizeVerifierCallsPass::ID;
+char NormalizeVerifierCallsLegacyPass::ID;
 
-void NormalizeVerifierCallsPass::runOnFunction(llvm::Function& function)
+void NormalizeVerifierCalls::runOnFunction(llvm::Function& function)
 {
     llvm::SmallVector<llvm::Instruction*, 16> toKill;
     for (llvm::Instruction& inst : llvm::instructions(function)) {
@@ -134,5 +143,11 @@ void NormalizeVerifierCallsPass::runOnFunction(llvm::Function& function)
 
 llvm::Pass* gazer::createNormalizeVerifierCallsPass()
 {
-    return new NormalizeVerifierCallsPass();
+    return new NormalizeVerifierCallsLegacyPass();
+}
+
+llvm::PreservedAnalyses gazer::NormalizeVerifierCallsPass::run(llvm::Module& module, llvm::ModuleAnalysisManager&)
+{
+    NormalizeVerifierCalls().run(module);
+    return llvm::PreservedAnalyses::none();
 }
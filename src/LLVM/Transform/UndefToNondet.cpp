@@ -87,4 +87,15 @@ bool UndefToNondetCallPass::runOnModule(llvm::Module& module)
 }
 
 
-llvm::Pass* gazer::createPromoteUndefsPass() { return new UndefToNondetCallPass(); }
\ No newline at end of file
+llvm::Pass* gazer::createPromoteUndefsPass() { return new UndefToNondetCallPass(); }
+
+llvm::PreservedAnalyses PromoteUndefsPass::run(llvm::Function& function, llvm::FunctionAnalysisManager&)
+{
+    if (!replaceUndefsWithCalls(function)) {
+        return llvm::PreservedAnalyses::all();
+    }
+
+    llvm::PreservedAnalyses pa;
+    pa.preserveSet<llvm::CFGAnalyses>();
+    return pa;
+}
\ No newline at end of file
@@ -25,6 +25,20 @@ using namespace gazer;
 gazer::Type& LLVMTypeTranslator::get(const llvm::Type* type)
 {
     assert(type != nullptr && "Cannot translate NULL types!");
+
+    auto it = mCache.find(type);
+    if (it != mCache.end()) {
+        return *it->second;
+    }
+
+    gazer::Type& result = this->translate(type);
+    mCache[type] = &result;
+
+    return result;
+}
+
+gazer::Type& LLVMTypeTranslator::translate(const llvm::Type* type)
+{
     assert(type->isFirstClassType() && "Can only translate first class types!");
 
     auto& ctx = mMemoryTypes.getContext();
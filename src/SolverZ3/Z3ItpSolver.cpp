@@ -0,0 +1,471 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "Z3SolverImpl.h"
+
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Solver/Model.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/Debug.h>
+
+#include <array>
+
+#define DEBUG_TYPE "Z3ItpSolver"
+
+using namespace gazer;
+
+namespace
+{
+    llvm::cl::opt<bool> Z3ItpWeakest("z3-itp-weakest",
+        llvm::cl::desc("Compute the weakest instead of the strongest interpolant"));
+
+/// Translates quantifier-free Z3 formulas back into gazer expressions.
+/// Only the boolean, integer and bit-vector fragments are supported.
+class Z3ToExprTranslator
+{
+public:
+    Z3ToExprTranslator(Z3_context context, GazerContext& gazerContext, Z3DeclMapTy& decls)
+        : mZ3Context(context), mContext(gazerContext),
+        mExprBuilder(CreateFoldingExprBuilder(gazerContext))
+    {
+        // Fresh variables are not registered by name in the context, thus the
+        // constants are mapped back through the declarations of the solver.
+        for (auto& scope : decls.scopes()) {
+            for (auto& [variable, decl] : scope) {
+                mVariables[Z3_get_ast_id(mZ3Context, Z3_func_decl_to_ast(mZ3Context, decl))] = variable;
+            }
+        }
+    }
+
+    /// Returns the translated expression or nullptr, if the formula contains
+    /// unsupported constructs.
+    ExprPtr translate(Z3_ast ast);
+
+    ExprBuilder& getBuilder() { return *mExprBuilder; }
+
+private:
+    ExprPtr translateApp(Z3_app app);
+    ExprPtr translateNumeral(Z3_ast ast);
+
+    /// Left-folds \p ops using \p fn.
+    template<class Fn>
+    ExprPtr fold(const ExprVector& ops, Fn fn)
+    {
+        ExprPtr result = ops[0];
+        for (size_t i = 1; i < ops.size(); ++i) {
+            result = fn(result, ops[i]);
+        }
+        return result;
+    }
+
+private:
+    Z3_context mZ3Context;
+    GazerContext& mContext;
+    std::unique_ptr<ExprBuilder> mExprBuilder;
+    std::unordered_map<unsigned, ExprPtr> mCache;
+    std::unordered_map<unsigned, Variable*> mVariables;
+};
+
+} // end anonymous namespace
+
+ExprPtr Z3ToExprTranslator::translate(Z3_ast ast)
+{
+    unsigned id = Z3_get_ast_id(mZ3Context, ast);
+    auto it = mCache.find(id);
+    if (it != mCache.end()) {
+        return it->second;
+    }
+
+    ExprPtr result;
+    switch (Z3_get_ast_kind(mZ3Context, ast)) {
+        case Z3_NUMERAL_AST:
+            result = this->translateNumeral(ast);
+            break;
+        case Z3_APP_AST:
+            result = this->translateApp(Z3_to_app(mZ3Context, ast));
+            break;
+        default:
+            // Quantifiers and bound variables are not supported.
+            result = nullptr;
+    }
+
+    mCache[id] = result;
+    return result;
+}
+
+ExprPtr Z3ToExprTranslator::translateNumeral(Z3_ast ast)
+{
+    Z3_sort sort = Z3_get_sort(mZ3Context, ast);
+    switch (Z3_get_sort_kind(mZ3Context, sort)) {
+        case Z3_INT_SORT: {
+            int64_t value;
+            if (!Z3_get_numeral_int64(mZ3Context, ast, &value)) {
+                return nullptr;
+            }
+            return mExprBuilder->IntLit(value);
+        }
+        case Z3_BV_SORT: {
+            unsigned width = Z3_get_bv_sort_size(mZ3Context, sort);
+            llvm::APInt value(width, Z3_get_numeral_string(mZ3Context, ast), 10);
+            return mExprBuilder->BvLit(value);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+ExprPtr Z3ToExprTranslator::translateApp(Z3_app app)
+{
+    Z3_func_decl decl = Z3_get_app_decl(mZ3Context, app);
+    Z3_decl_kind kind = Z3_get_decl_kind(mZ3Context, decl);
+
+    if (kind == Z3_OP_UNINTERPRETED) {
+        if (Z3_get_app_num_args(mZ3Context, app) != 0) {
+            return nullptr;
+        }
+
+        auto it = mVariables.find(Z3_get_ast_id(mZ3Context, Z3_func_decl_to_ast(mZ3Context, decl)));
+        if (it == mVariables.end()) {
+            return nullptr;
+        }
+
+        return it->second->getRefExpr();
+    }
+
+    ExprVector ops;
+    for (unsigned i = 0, e = Z3_get_app_num_args(mZ3Context, app); i < e; ++i) {
+        ExprPtr op = this->translate(Z3_get_app_arg(mZ3Context, app, i));
+        if (op == nullptr) {
+            return nullptr;
+        }
+        ops.push_back(op);
+    }
+
+    auto& eb = *mExprBuilder;
+    auto binary = [&ops](auto fn) -> ExprPtr {
+        return ops.size() == 2 ? fn(ops[0], ops[1]) : nullptr;
+    };
+
+    #define FOLD(METHOD) \
+        (ops.empty() ? nullptr : fold(ops, [&eb](auto& l, auto& r) { return eb.METHOD(l, r); }))
+    #define BINARY(METHOD) \
+        binary([&eb](auto& l, auto& r) { return eb.METHOD(l, r); })
+
+    switch (kind) {
+        // Logic
+        case Z3_OP_TRUE:    return eb.True();
+        case Z3_OP_FALSE:   return eb.False();
+        case Z3_OP_AND:     return eb.And(ops);
+        case Z3_OP_OR:      return eb.Or(ops);
+        case Z3_OP_NOT:     return ops.size() == 1 ? eb.Not(ops[0]) : nullptr;
+        case Z3_OP_IMPLIES: return BINARY(Imply);
+        case Z3_OP_XOR:     return BINARY(NotEq);
+        case Z3_OP_ITE:     return ops.size() == 3 ? eb.Select(ops[0], ops[1], ops[2]) : nullptr;
+        case Z3_OP_EQ:      return BINARY(Eq);
+        case Z3_OP_DISTINCT: {
+            ExprVector pairs;
+            for (size_t i = 0; i < ops.size(); ++i) {
+                for (size_t j = i + 1; j < ops.size(); ++j) {
+                    pairs.push_back(eb.NotEq(ops[i], ops[j]));
+                }
+            }
+            return eb.And(pairs);
+        }
+
+        // Integer arithmetic
+        case Z3_OP_LE:      return BINARY(LtEq);
+        case Z3_OP_GE:      return BINARY(GtEq);
+        case Z3_OP_LT:      return BINARY(Lt);
+        case Z3_OP_GT:      return BINARY(Gt);
+        case Z3_OP_ADD:     return FOLD(Add);
+        case Z3_OP_SUB:     return FOLD(Sub);
+        case Z3_OP_MUL:     return FOLD(Mul);
+        case Z3_OP_IDIV:    return BINARY(Div);
+        case Z3_OP_MOD:     return BINARY(Mod);
+        case Z3_OP_REM:     return BINARY(Rem);
+        case Z3_OP_UMINUS:
+            if (ops.size() != 1 || !ops[0]->getType().isIntType()) {
+                return nullptr;
+            }
+            return eb.Sub(eb.IntLit(0), ops[0]);
+
+        // Bit-vectors
+        case Z3_OP_BADD:    return FOLD(Add);
+        case Z3_OP_BSUB:    return FOLD(Sub);
+        case Z3_OP_BMUL:    return FOLD(Mul);
+        case Z3_OP_BSDIV:
+        case Z3_OP_BSDIV_I: return BINARY(BvSDiv);
+        case Z3_OP_BUDIV:
+        case Z3_OP_BUDIV_I: return BINARY(BvUDiv);
+        case Z3_OP_BSREM:
+        case Z3_OP_BSREM_I: return BINARY(BvSRem);
+        case Z3_OP_BUREM:
+        case Z3_OP_BUREM_I: return BINARY(BvURem);
+        case Z3_OP_BAND:    return FOLD(BvAnd);
+        case Z3_OP_BOR:     return FOLD(BvOr);
+        case Z3_OP_BXOR:    return FOLD(BvXor);
+        case Z3_OP_BSHL:    return BINARY(Shl);
+        case Z3_OP_BLSHR:   return BINARY(LShr);
+        case Z3_OP_BASHR:   return BINARY(AShr);
+        case Z3_OP_CONCAT:  return FOLD(BvConcat);
+        case Z3_OP_BNEG:
+        case Z3_OP_BNOT: {
+            if (ops.size() != 1 || !ops[0]->getType().isBvType()) {
+                return nullptr;
+            }
+            unsigned width = llvm::cast<BvType>(ops[0]->getType()).getWidth();
+            if (kind == Z3_OP_BNEG) {
+                return eb.Sub(eb.BvLit(0, width), ops[0]);
+            }
+            return eb.BvXor(ops[0], eb.BvLit(llvm::APInt::getAllOnesValue(width)));
+        }
+        case Z3_OP_EXTRACT: {
+            if (ops.size() != 1) {
+                return nullptr;
+            }
+            unsigned hi = Z3_get_decl_int_parameter(mZ3Context, decl, 0);
+            unsigned lo = Z3_get_decl_int_parameter(mZ3Context, decl, 1);
+            return eb.Extract(ops[0], lo, hi - lo + 1);
+        }
+        case Z3_OP_ZERO_EXT:
+        case Z3_OP_SIGN_EXT: {
+            if (ops.size() != 1 || !ops[0]->getType().isBvType()) {
+                return nullptr;
+            }
+            unsigned width = llvm::cast<BvType>(ops[0]->getType()).getWidth()
+                + Z3_get_decl_int_parameter(mZ3Context, decl, 0);
+            auto& type = BvType::Get(mContext, width);
+            return kind == Z3_OP_ZERO_EXT ? eb.ZExt(ops[0], type) : eb.SExt(ops[0], type);
+        }
+        case Z3_OP_ULEQ:    return BINARY(BvULtEq);
+        case Z3_OP_SLEQ:    return BINARY(BvSLtEq);
+        case Z3_OP_UGEQ:    return BINARY(BvUGtEq);
+        case Z3_OP_SGEQ:    return BINARY(BvSGtEq);
+        case Z3_OP_ULT:     return BINARY(BvULt);
+        case Z3_OP_SLT:     return BINARY(BvSLt);
+        case Z3_OP_UGT:     return BINARY(BvUGt);
+        case Z3_OP_SGT:     return BINARY(BvSGt);
+        default:
+            LLVM_DEBUG(llvm::dbgs() << "Unsupported Z3 operator: "
+                << Z3_func_decl_to_string(mZ3Context, decl) << "\n");
+            return nullptr;
+    }
+
+    #undef FOLD
+    #undef BINARY
+}
+
+/// Collects the free constants of \p ast into \p consts.
+static void collectConstants(
+    Z3_context ctx, Z3_ast ast, llvm::DenseSet<Z3_ast>& visited, std::vector<Z3_app>& consts)
+{
+    if (Z3_get_ast_kind(ctx, ast) != Z3_APP_AST || !visited.insert(ast).second) {
+        return;
+    }
+
+    Z3_app app = Z3_to_app(ctx, ast);
+    unsigned numArgs = Z3_get_app_num_args(ctx, app);
+    if (numArgs == 0) {
+        if (Z3_get_decl_kind(ctx, Z3_get_app_decl(ctx, app)) == Z3_OP_UNINTERPRETED) {
+            consts.push_back(app);
+        }
+        return;
+    }
+
+    for (unsigned i = 0; i < numArgs; ++i) {
+        collectConstants(ctx, Z3_get_app_arg(ctx, app, i), visited, consts);
+    }
+}
+
+// Z3ItpSolver implementation
+//===----------------------------------------------------------------------===//
+void Z3ItpSolver::addConstraint(ExprPtr expr)
+{
+    this->addConstraint(NoGroup, std::move(expr));
+}
+
+void Z3ItpSolver::addConstraint(ItpGroup group, ExprPtr expr)
+{
+    mSolver.add(expr);
+    mFormulae.emplace_back(group, std::move(expr));
+}
+
+auto Z3ItpSolver::getModel() -> std::unique_ptr<Model>
+{
+    return mSolver.getModel();
+}
+
+void Z3ItpSolver::reset()
+{
+    mSolver.reset();
+    mFormulae.clear();
+    mScopes.clear();
+}
+
+void Z3ItpSolver::push()
+{
+    mSolver.push();
+    mScopes.push_back(mFormulae.size());
+}
+
+void Z3ItpSolver::pop()
+{
+    assert(!mScopes.empty() && "Attempting to pop an empty scope stack!");
+    mSolver.pop();
+    mFormulae.resize(mScopes.back());
+    mScopes.pop_back();
+}
+
+ExprPtr Z3ItpSolver::getInterpolant(ItpGroup group)
+{
+    Z3_context ctx = mSolver.mZ3Context;
+
+    std::vector<Z3_ast> aFormulae;
+    std::vector<Z3_ast> bFormulae;
+    std::vector<Z3AstHandle> handles;
+    for (auto& [formulaGroup, expr] : mFormulae) {
+        handles.push_back(mSolver.mTransformer.walk(expr));
+        if (formulaGroup == group) {
+            aFormulae.push_back(handles.back());
+        } else {
+            bFormulae.push_back(handles.back());
+        }
+    }
+
+    auto conjunction = [ctx](std::vector<Z3_ast>& formulae) {
+        return Z3AstHandle(ctx, Z3_mk_and(ctx, formulae.size(), formulae.data()));
+    };
+
+    Z3AstHandle a = conjunction(aFormulae);
+    Z3AstHandle b = conjunction(bFormulae);
+
+    llvm::DenseSet<Z3_ast> visited;
+    std::vector<Z3_app> aConsts;
+    std::vector<Z3_app> bConsts;
+    collectConstants(ctx, a, visited, aConsts);
+    visited.clear();
+    collectConstants(ctx, b, visited, bConsts);
+
+    // Eliminate the constants which are private to the projected side.
+    auto privateConsts = [ctx](std::vector<Z3_app>& own, std::vector<Z3_app>& other) {
+        llvm::DenseSet<Z3_ast> otherSet;
+        for (Z3_app app : other) {
+            otherSet.insert(Z3_app_to_ast(ctx, app));
+        }
+
+        std::vector<Z3_app> result;
+        std::copy_if(own.begin(), own.end(), std::back_inserter(result), [&](Z3_app app) {
+            return otherSet.count(Z3_app_to_ast(ctx, app)) == 0;
+        });
+        return result;
+    };
+
+    if (Z3ItpWeakest) {
+        ExprPtr projection = this->project(b, privateConsts(bConsts, aConsts));
+        return projection == nullptr ? nullptr : NotExpr::Create(projection);
+    }
+
+    return this->project(a, privateConsts(aConsts, bConsts));
+}
+
+ExprPtr Z3ItpSolver::project(Z3AstHandle body, const std::vector<Z3_app>& bound)
+{
+    Z3_context ctx = mSolver.mZ3Context;
+
+    Z3AstHandle formula = body;
+    if (!bound.empty()) {
+        formula = Z3AstHandle(ctx, Z3_mk_exists_const(
+            ctx, 0, bound.size(), bound.data(), 0, nullptr, body
+        ));
+    }
+
+    LLVM_DEBUG(llvm::dbgs() << "Projecting formula: " << Z3_ast_to_string(ctx, formula) << "\n");
+
+    Z3_goal goal = Z3_mk_goal(ctx, false, false, false);
+    Z3_goal_inc_ref(ctx, goal);
+    Z3_goal_assert(ctx, goal, formula);
+
+    // Cheaply eliminate the variables defined by equalities first, then run
+    // the complete, QSAT-based quantifier elimination procedure on the rest.
+    // Results of the API are only kept alive until the next call, so each
+    // tactic must be referenced before the next one is created.
+    std::array<const char*, 3> names = { "qe-light", "qe2", "simplify" };
+    std::array<Z3_tactic, 3> steps;
+    for (size_t i = 0; i < names.size(); ++i) {
+        steps[i] = Z3_mk_tactic(ctx, names[i]);
+        Z3_tactic_inc_ref(ctx, steps[i]);
+    }
+
+    Z3_tactic tactic = steps[0];
+    Z3_tactic_inc_ref(ctx, tactic);
+    for (size_t i = 1; i < steps.size(); ++i) {
+        Z3_tactic next = Z3_tactic_and_then(ctx, tactic, steps[i]);
+        Z3_tactic_inc_ref(ctx, next);
+        Z3_tactic_dec_ref(ctx, tactic);
+        tactic = next;
+    }
+
+    Z3_apply_result applyResult = Z3_tactic_apply(ctx, tactic, goal);
+    Z3_apply_result_inc_ref(ctx, applyResult);
+
+    // The result is the disjunction of the resulting subgoals.
+    Z3ToExprTranslator translator(ctx, mContext, mSolver.mDecls);
+    ExprVector disjuncts;
+    for (unsigned i = 0, e = Z3_apply_result_get_num_subgoals(ctx, applyResult); i < e; ++i) {
+        Z3_goal subgoal = Z3_apply_result_get_subgoal(ctx, applyResult, i);
+        ExprVector conjuncts;
+        for (unsigned j = 0, je = Z3_goal_size(ctx, subgoal); j < je; ++j) {
+            ExprPtr expr = translator.translate(Z3_goal_formula(ctx, subgoal, j));
+            if (expr == nullptr) {
+                disjuncts.clear();
+                break;
+            }
+            conjuncts.push_back(expr);
+        }
+
+        if (conjuncts.size() != Z3_goal_size(ctx, subgoal)) {
+            disjuncts.clear();
+            break;
+        }
+
+        disjuncts.push_back(translator.getBuilder().And(conjuncts));
+    }
+
+    bool failed = disjuncts.empty() && Z3_apply_result_get_num_subgoals(ctx, applyResult) != 0;
+
+    Z3_apply_result_dec_ref(ctx, applyResult);
+    Z3_tactic_dec_ref(ctx, tactic);
+    for (Z3_tactic step : steps) {
+        Z3_tactic_dec_ref(ctx, step);
+    }
+    Z3_goal_dec_ref(ctx, goal);
+
+    if (failed) {
+        LLVM_DEBUG(llvm::dbgs() << "Could not eliminate quantifiers from the interpolant.\n");
+        return nullptr;
+    }
+
+    return translator.getBuilder().Or(disjuncts);
+}
+
+std::unique_ptr<ItpSolver> Z3SolverFactory::createItpSolver(GazerContext& context)
+{
+    return std::make_unique<Z3ItpSolver>(context);
+}
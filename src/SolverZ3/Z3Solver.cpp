@@ -19,6 +19,7 @@
 
 #include "gazer/Support/Float.h"
 
+#include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/SmallString.h>
 
 #include <llvm/Support/raw_os_ostream.h>
@@ -60,6 +61,7 @@ Z3Solver::Z3Solver(GazerContext& context)
 
 Z3Solver::~Z3Solver()
 {
+    mAssumptions.clear();
     mCache.clear();
     mDecls.clear();
     mTransformer.clear();
@@ -68,23 +70,69 @@ Z3Solver::~Z3Solver()
     Z3_del_config(mConfig);
 }
 
-Solver::SolverStatus Z3Solver::run()
+static Solver::SolverStatus toSolverStatus(Z3_context ctx, Z3_solver solver, Z3_lbool result)
 {
-    Z3_lbool result =  Z3_solver_check(mZ3Context, mSolver);
-
     switch (result) {
-        case Z3_L_FALSE: return SolverStatus::UNSAT;
+        case Z3_L_FALSE: return Solver::UNSAT;
         case Z3_L_TRUE:
             if (Z3DumpModel) {
-                llvm::errs() << Z3_model_to_string(mZ3Context, Z3_solver_get_model(mZ3Context, mSolver)) << "\n";
+                llvm::errs() << Z3_model_to_string(ctx, Z3_solver_get_model(ctx, solver)) << "\n";
             }
-            return SolverStatus::SAT;
-        case Z3_L_UNDEF: return SolverStatus::UNKNOWN;
+            return Solver::SAT;
+        case Z3_L_UNDEF: return Solver::UNKNOWN;
     }
 
     llvm_unreachable("Unknown solver status encountered.");
 }
 
+Solver::SolverStatus Z3Solver::run()
+{
+    return toSolverStatus(mZ3Context, mSolver, Z3_solver_check(mZ3Context, mSolver));
+}
+
+Solver::SolverStatus Z3Solver::run(llvm::ArrayRef<ExprPtr> assumptions)
+{
+    mAssumptions.clear();
+
+    std::vector<Z3_ast> asts;
+    for (const ExprPtr& assumption : assumptions) {
+        assert(assumption->getType().isBoolType() && "Assumptions must be boolean expressions!");
+        Z3AstHandle ast = mTransformer.walk(assumption);
+        asts.push_back(ast);
+        mAssumptions.emplace_back(ast, assumption);
+    }
+
+    Z3_lbool result = Z3_solver_check_assumptions(mZ3Context, mSolver, asts.size(), asts.data());
+    return toSolverStatus(mZ3Context, mSolver, result);
+}
+
+std::vector<ExprPtr> Z3Solver::getUnsatCore()
+{
+    Z3_ast_vector core = Z3_solver_get_unsat_core(mZ3Context, mSolver);
+    Z3_ast_vector_inc_ref(mZ3Context, core);
+
+    llvm::DenseSet<Z3_ast> coreAsts;
+    for (unsigned i = 0, e = Z3_ast_vector_size(mZ3Context, core); i < e; ++i) {
+        coreAsts.insert(Z3_ast_vector_get(mZ3Context, core, i));
+    }
+
+    Z3_ast_vector_dec_ref(mZ3Context, core);
+
+    std::vector<ExprPtr> result;
+    for (auto& [ast, expr] : mAssumptions) {
+        if (coreAsts.count(ast) != 0) {
+            result.push_back(expr);
+        }
+    }
+
+    return result;
+}
+
+void Z3Solver::interrupt()
+{
+    Z3_interrupt(mZ3Context);
+}
+
 void Z3Solver::addConstraint(ExprPtr expr)
 {
     auto z3Expr = mTransformer.walk(expr);
@@ -146,24 +194,23 @@ auto Z3ExprTransformer::createHandle(Z3_ast ast) -> Z3AstHandle
     return Z3AstHandle{mZ3Context, ast};
 }
 
-auto Z3ExprTransformer::shouldSkip(const ExprPtr& expr, Z3AstHandle* ret) -> bool
+auto Z3ExprTransformer::shouldSkip(ExprView<> expr, Z3AstHandle* ret) -> bool
 {
     if (expr->isNullary() || expr->isUnary()) {
         return false;
     }
 
-    auto result = mCache.get(expr);
-    if (result) {
-        *ret = *result;
+    if (const Z3CacheEntry* entry = mCache.lookup(expr)) {
+        *ret = entry->ast;
         return true;
     }
 
     return false;
 }
 
-void Z3ExprTransformer::handleResult(const ExprPtr& expr, Z3AstHandle& ret)
+void Z3ExprTransformer::handleResult(ExprView<> expr, Z3AstHandle& ret)
 {
-    mCache.insert(expr, ret);
+    mCache.insert(expr, { expr.ref(), ret });
 }
 
 auto Z3ExprTransformer::translateDecl(Variable* variable) -> Z3Handle<Z3_func_decl>
@@ -183,13 +230,13 @@ auto Z3ExprTransformer::translateDecl(Variable* variable) -> Z3Handle<Z3_func_de
     return handle;
 }
 
-auto Z3ExprTransformer::visitVarRef(const ExprRef<VarRefExpr>& expr) -> Z3AstHandle
+auto Z3ExprTransformer::visitVarRef(ExprView<VarRefExpr> expr) -> Z3AstHandle
 {
     auto decl = this->translateDecl(&expr->getVariable());
     return createHandle(Z3_mk_app(mZ3Context, decl, 0, nullptr));
 }
 
-auto Z3ExprTransformer::visitAdd(const ExprRef<AddExpr>& expr) -> Z3AstHandle
+auto Z3ExprTransformer::visitAdd(ExprView<AddExpr> expr) -> Z3AstHandle
 {
     if (expr->getType().isBvType()) {
         return createHandle(Z3_mk_bvadd(mZ3Context, getOperand(0), getOperand(1)));
@@ -199,7 +246,7 @@ auto Z3ExprTransformer::visitAdd(const ExprRef<AddExpr>& expr) -> Z3AstHandle
     return createHandle(Z3_mk_add(mZ3Context, 2, ops.data()));
 }
 
-auto Z3ExprTransformer::visitSub(const ExprRef<SubExpr>& expr) -> Z3AstHandle
+auto Z3ExprTransformer::visitSub(ExprView<SubExpr> expr) -> Z3AstHandle
 {
     if (expr->getType().isBvType()) {
         return createHandle(Z3_mk_bvsub(mZ3Context, getOperand(0), getOperand(1)));
@@ -209,7 +256,7 @@ auto Z3ExprTransformer::visitSub(const ExprRef<SubExpr>& expr) -> Z3AstHandle
     return createHandle(Z3_mk_sub(mZ3Context, 2, ops.data()));
 }
 
-auto Z3ExprTransformer::visitMul(const ExprRef<MulExpr>& expr) -> Z3AstHandle
+auto Z3ExprTransformer::visitMul(ExprView<MulExpr> expr) -> Z3AstHandle
 {
     if (expr->getType().isBvType()) {
         return createHandle(Z3_mk_bvmul(mZ3Context, getOperand(0), getOperand(1)));
@@ -219,7 +266,7 @@ auto Z3ExprTransformer::visitMul(const ExprRef<MulExpr>& expr) -> Z3AstHandle
     return createHandle(Z3_mk_mul(mZ3Context, 2, ops.data()));
 }
 
-auto Z3ExprTransformer::visitAnd(const ExprRef<AndExpr>& expr) -> Z3AstHandle
+auto Z3ExprTransformer::visitAnd(ExprView<AndExpr> expr) -> Z3AstHandle
 {
     z3::array<Z3_ast> ops(expr->getNumOperands());
     for (size_t i = 0; i < ops.size(); ++i) {
@@ -229,7 +276,7 @@ auto Z3ExprTransformer::visitAnd(const ExprRef<AndExpr>& expr) -> Z3AstHandle
     return createHandle(Z3_mk_and(mZ3Context, expr->getNumOperands(), ops.ptr()));
 }
 
-auto Z3ExprTransformer::visitOr(const ExprRef<OrExpr>& expr) -> Z3AstHandle
+auto Z3ExprTransformer::visitOr(ExprView<OrExpr> expr) -> Z3AstHandle
 {
     z3::array<Z3_ast> ops(expr->getNumOperands());
     for (size_t i = 0; i < ops.size(); ++i) {
@@ -239,13 +286,13 @@ auto Z3ExprTransformer::visitOr(const ExprRef<OrExpr>& expr) -> Z3AstHandle
     return createHandle(Z3_mk_or(mZ3Context, expr->getNumOperands(), ops.ptr()));
 }
 
-auto Z3ExprTransformer::visitNotEq(const ExprRef<NotEqExpr>& expr) -> Z3AstHandle
+auto Z3ExprTransformer::visitNotEq(ExprView<NotEqExpr> expr) -> Z3AstHandle
 {
     std::array<Z3_ast, 2> ops = { getOperand(0), getOperand(1) };
     return createHandle(Z3_mk_distinct(mZ3Context, 2, ops.data()));
 }
 
-auto Z3ExprTransformer::visitTupleSelect(const ExprRef<TupleSelectExpr>& expr) -> Z3AstHandle
+auto Z3ExprTransformer::visitTupleSelect(ExprView<TupleSelectExpr> expr) -> Z3AstHandle
 {
     auto& tupTy = llvm::cast<TupleType>(expr->getOperand(0)->getType());
 
@@ -258,7 +305,7 @@ auto Z3ExprTransformer::visitTupleSelect(const ExprRef<TupleSelectExpr>& expr) -
     return createHandle(Z3_mk_app(mZ3Context, proj, 1, args.data()));
 }
 
-auto Z3ExprTransformer::visitTupleConstruct(const ExprRef<TupleConstructExpr>& expr) -> Z3AstHandle
+auto Z3ExprTransformer::visitTupleConstruct(ExprView<TupleConstructExpr> expr) -> Z3AstHandle
 {
     auto& tupTy = llvm::cast<TupleType>(expr->getOperand(0)->getType());
 
@@ -380,7 +427,7 @@ Z3Handle<Z3_sort> Z3ExprTransformer::handleTupleType(TupleType& tupTy)
     return info.sort;
 }
 
-Z3AstHandle Z3ExprTransformer::translateLiteral(const ExprRef<LiteralExpr>& expr)
+Z3AstHandle Z3ExprTransformer::translateLiteral(ExprView<LiteralExpr> expr)
 {
     if (auto bvLit = llvm::dyn_cast<BvLiteralExpr>(expr)) {
         llvm::SmallString<20> buffer;
@@ -411,10 +458,11 @@ Z3AstHandle Z3ExprTransformer::translateLiteral(const ExprRef<LiteralExpr>& expr
     }
 
     if (auto arrayLit = llvm::dyn_cast<ArrayLiteralExpr>(expr)) {
+        ExprRef<LiteralExpr> defaultLit = arrayLit->getDefault();
         Z3AstHandle ast = createHandle(Z3_mk_const_array(
             mZ3Context,
             typeToSort(arrayLit->getType().getIndexType()),
-            this->translateLiteral(arrayLit->getDefault())
+            this->translateLiteral(defaultLit)
         ));
 
         Z3AstHandle result = ast;
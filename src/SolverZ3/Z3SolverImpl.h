@@ -106,7 +106,7 @@ public:
         return !operator==(rhs);
     }
 
-    /*implicit*/ operator T()
+    /*implicit*/ operator T() const
     {
         assert(mContext != nullptr);
         assert(mNode != nullptr);
@@ -165,7 +165,18 @@ namespace gazer
 {
 
 using Z3AstHandle = Z3Handle<Z3_ast>;
-using Z3CacheMapTy = ScopedCache<ExprPtr, Z3AstHandle, std::unordered_map<ExprPtr, Z3AstHandle>>;
+
+/// Cached translation of an expression. The cache is keyed by borrowed views,
+/// so looking up an expression does not touch its reference counter. Each
+/// entry owns its expression instead: were it freed, its address could be
+/// reused by an unrelated expression, resulting in a false cache hit.
+struct Z3CacheEntry
+{
+    ExprPtr expr;
+    Z3AstHandle ast;
+};
+
+using Z3CacheMapTy = ScopedCache<ExprView<>, Z3CacheEntry>;
 using Z3DeclMapTy = ScopedCache<
     Variable*, Z3Handle<Z3_func_decl>, std::unordered_map<Variable*, Z3Handle<Z3_func_decl>>
 >;
@@ -203,13 +214,13 @@ protected:
 
     Z3Handle<Z3_func_decl> translateDecl(Variable* variable);
 
-    Z3AstHandle translateLiteral(const ExprRef<LiteralExpr>& expr);
+    Z3AstHandle translateLiteral(ExprView<LiteralExpr> expr);
 
 private:
-    bool shouldSkip(const ExprPtr& expr, Z3AstHandle* ret);  
-    void handleResult(const ExprPtr& expr, Z3AstHandle& ret);
+    bool shouldSkip(ExprView<> expr, Z3AstHandle* ret);  
+    void handleResult(ExprView<> expr, Z3AstHandle& ret);
 
-    Z3AstHandle visitExpr(const ExprPtr& expr) // NOLINT(readability-convert-member-functions-to-static)
+    Z3AstHandle visitExpr(ExprView<> expr) // NOLINT(readability-convert-member-functions-to-static)
     {
         llvm::errs() << *expr << "\n";
         llvm_unreachable("Unhandled expression type in Z3ExprTransformer.");
@@ -218,23 +229,23 @@ private:
 
     // Use some helper macros to translate trivial cases
     #define TRANSLATE_UNARY_OP(NAME, Z3_METHOD)                                     \
-    Z3AstHandle visit##NAME(const ExprRef<NAME##Expr>& expr) {                      \
+    Z3AstHandle visit##NAME(ExprView<NAME##Expr> expr) {                            \
         return createHandle(Z3_METHOD(mZ3Context, getOperand(0)));                  \
     }                                                                               \
 
     #define TRANSLATE_BINARY_OP(NAME, Z3_METHOD)                                    \
-    Z3AstHandle visit##NAME(const ExprRef<NAME##Expr>& expr) {                      \
+    Z3AstHandle visit##NAME(ExprView<NAME##Expr> expr) {                            \
         return createHandle(Z3_METHOD(mZ3Context, getOperand(0), getOperand(1)));   \
     }                                                                               \
 
     #define TRANSLATE_TERNARY_OP(NAME, Z3_METHOD)                                   \
-    Z3AstHandle visit##NAME(const ExprRef<NAME##Expr>& expr) {                      \
+    Z3AstHandle visit##NAME(ExprView<NAME##Expr> expr) {                            \
         return createHandle(Z3_METHOD(                                              \
             mZ3Context, getOperand(0), getOperand(1), getOperand(2)));              \
     }                                                                               \
 
     #define TRANSLATE_BINARY_FPA_RM(NAME, Z3_METHOD)                                \
-    Z3AstHandle visit##NAME(const ExprRef<NAME##Expr>& expr) {                      \
+    Z3AstHandle visit##NAME(ExprView<NAME##Expr> expr) {                            \
         return createHandle(Z3_METHOD(mZ3Context,                                   \
             transformRoundingMode(expr->getRoundingMode()),                         \
             getOperand(0), getOperand(1)                                            \
@@ -242,13 +253,13 @@ private:
     }                                                                               \
 
     // Nullary
-    Z3AstHandle visitVarRef(const ExprRef<VarRefExpr>& expr);
+    Z3AstHandle visitVarRef(ExprView<VarRefExpr> expr);
 
-    Z3AstHandle visitUndef(const ExprRef<UndefExpr>& expr) {
+    Z3AstHandle visitUndef(ExprView<UndefExpr> expr) {
         return createHandle(Z3_mk_fresh_const(mZ3Context, "", typeToSort(expr->getType())));
     }
 
-    Z3AstHandle visitLiteral(const ExprRef<LiteralExpr>& expr) {
+    Z3AstHandle visitLiteral(ExprView<LiteralExpr> expr) {
         return this->translateLiteral(expr);
     }
 
@@ -256,9 +267,9 @@ private:
     TRANSLATE_UNARY_OP(Not,         Z3_mk_not)
 
     // Arithmetic operators
-    Z3AstHandle visitAdd(const ExprRef<AddExpr>& expr);
-    Z3AstHandle visitSub(const ExprRef<SubExpr>& expr);
-    Z3AstHandle visitMul(const ExprRef<MulExpr>& expr);
+    Z3AstHandle visitAdd(ExprView<AddExpr> expr);
+    Z3AstHandle visitSub(ExprView<SubExpr> expr);
+    Z3AstHandle visitMul(ExprView<MulExpr> expr);
 
     TRANSLATE_BINARY_OP(Div,        Z3_mk_div)
     TRANSLATE_BINARY_OP(Mod,        Z3_mk_mod)
@@ -268,8 +279,8 @@ private:
     TRANSLATE_BINARY_OP(Imply,      Z3_mk_implies)
 
     // Multiary logic
-    Z3AstHandle visitAnd(const ExprRef<AndExpr>& expr);
-    Z3AstHandle visitOr(const ExprRef<OrExpr>& expr);
+    Z3AstHandle visitAnd(ExprView<AndExpr> expr);
+    Z3AstHandle visitOr(ExprView<OrExpr> expr);
 
     // Bit-vectors
     TRANSLATE_BINARY_OP(BvSDiv,     Z3_mk_bvsdiv)
@@ -291,7 +302,7 @@ private:
     TRANSLATE_BINARY_OP(Gt,         Z3_mk_gt)
     TRANSLATE_BINARY_OP(GtEq,       Z3_mk_ge)
 
-    Z3AstHandle visitNotEq(const ExprRef<NotEqExpr>& expr);
+    Z3AstHandle visitNotEq(ExprView<NotEqExpr> expr);
 
     // Bit-vector comparisons
     TRANSLATE_BINARY_OP(BvSLt,      Z3_mk_bvslt)
@@ -333,15 +344,15 @@ private:
     #undef TRANSLATE_BINARY_FPA_RM
 
     // Bit-vector casts
-    Z3AstHandle visitZExt(const ExprRef<ZExtExpr>& expr) {
+    Z3AstHandle visitZExt(ExprView<ZExtExpr> expr) {
         return createHandle(Z3_mk_zero_ext(mZ3Context, expr->getWidthDiff(), getOperand(0)));
     }
 
-    Z3AstHandle visitSExt(const ExprRef<SExtExpr>& expr) {
+    Z3AstHandle visitSExt(ExprView<SExtExpr> expr) {
         return createHandle(Z3_mk_sign_ext(mZ3Context, expr->getWidthDiff(), getOperand(0)));
     }
 
-    Z3AstHandle visitExtract(const ExprRef<ExtractExpr>& expr)
+    Z3AstHandle visitExtract(ExprView<ExtractExpr> expr)
     {
         unsigned hi = expr->getOffset() + expr->getWidth() - 1;
         unsigned lo = expr->getOffset();
@@ -350,7 +361,7 @@ private:
     }
 
     // Floating-point casts
-    Z3AstHandle visitFCast(const ExprRef<FCastExpr>& expr)
+    Z3AstHandle visitFCast(ExprView<FCastExpr> expr)
     {
         return createHandle(Z3_mk_fpa_to_fp_float(mZ3Context,
             transformRoundingMode(expr->getRoundingMode()),
@@ -359,7 +370,7 @@ private:
         ));
     }
 
-    Z3AstHandle visitSignedToFp(const ExprRef<SignedToFpExpr>& expr)
+    Z3AstHandle visitSignedToFp(ExprView<SignedToFpExpr> expr)
     {
         return createHandle(Z3_mk_fpa_to_fp_signed(mZ3Context,
             transformRoundingMode(expr->getRoundingMode()),
@@ -368,7 +379,7 @@ private:
         ));
     }
 
-    Z3AstHandle visitUnsignedToFp(const ExprRef<UnsignedToFpExpr>& expr)
+    Z3AstHandle visitUnsignedToFp(ExprView<UnsignedToFpExpr> expr)
     {
         return createHandle(Z3_mk_fpa_to_fp_unsigned(mZ3Context,
             transformRoundingMode(expr->getRoundingMode()),
@@ -377,7 +388,7 @@ private:
         ));
     }
 
-    Z3AstHandle visitFpToSigned(const ExprRef<FpToSignedExpr>& expr)
+    Z3AstHandle visitFpToSigned(ExprView<FpToSignedExpr> expr)
     {
         return createHandle(Z3_mk_fpa_to_sbv(mZ3Context,
             transformRoundingMode(expr->getRoundingMode()),
@@ -386,7 +397,7 @@ private:
         ));
     }
 
-    Z3AstHandle visitFpToUnsigned(const ExprRef<FpToUnsignedExpr>& expr)
+    Z3AstHandle visitFpToUnsigned(ExprView<FpToUnsignedExpr> expr)
     {
         return createHandle(Z3_mk_fpa_to_ubv(mZ3Context,
             transformRoundingMode(expr->getRoundingMode()),
@@ -395,7 +406,7 @@ private:
         ));
     }
 
-    Z3AstHandle visitFpToBv(const ExprRef<FpToBvExpr>& expr)
+    Z3AstHandle visitFpToBv(ExprView<FpToBvExpr> expr)
     {
         return createHandle(Z3_mk_fpa_to_ieee_bv(
             mZ3Context,
@@ -403,7 +414,7 @@ private:
         ));
     }
 
-    Z3AstHandle visitBvToFp(const ExprRef<BvToFpExpr>& expr)
+    Z3AstHandle visitBvToFp(ExprView<BvToFpExpr> expr)
     {
         return createHandle(Z3_mk_fpa_to_fp_bv(
             mZ3Context,
@@ -412,8 +423,8 @@ private:
         ));
     }
 
-    Z3AstHandle visitTupleSelect(const ExprRef<TupleSelectExpr>& expr);
-    Z3AstHandle visitTupleConstruct(const ExprRef<TupleConstructExpr>& expr);
+    Z3AstHandle visitTupleSelect(ExprView<TupleSelectExpr> expr);
+    Z3AstHandle visitTupleConstruct(ExprView<TupleConstructExpr> expr);
 
 protected:
     Z3AstHandle transformRoundingMode(llvm::APFloat::roundingMode rm);
@@ -429,14 +440,19 @@ protected:
 /// Z3 solver implementation
 class Z3Solver : public Solver
 {
+    friend class Z3ItpSolver;
 public:
     explicit Z3Solver(GazerContext& context);
 
     void printStats(llvm::raw_ostream& os) override;
     void dump(llvm::raw_ostream& os) override;
     SolverStatus run() override;
-    
+    SolverStatus run(llvm::ArrayRef<ExprPtr> assumptions) override;
+
     std::unique_ptr<Model> getModel() override;
+    std::vector<ExprPtr> getUnsatCore() override;
+
+    void interrupt() override;
 
     void reset() override;
 
@@ -456,6 +472,58 @@ protected:
     Z3CacheMapTy mCache;
     Z3DeclMapTy mDecls;
     Z3ExprTransformer mTransformer;
+
+    /// The assumptions of the last run(assumptions) call.
+    std::vector<std::pair<Z3AstHandle, ExprPtr>> mAssumptions;
+};
+
+/// Interpolating solver on top of Z3.
+///
+/// As recent Z3 releases do not provide an interpolation API, interpolants are
+/// computed by quantifier elimination: the strongest interpolant of (A, B) is
+/// the projection of A onto the variables shared with B, the weakest one is the
+/// negated projection of B onto the variables shared with A.
+class Z3ItpSolver : public ItpSolver
+{
+    /// The group of constraints added without an interpolation group.
+    static constexpr ItpGroup NoGroup = 0;
+public:
+    explicit Z3ItpSolver(GazerContext& context)
+        : ItpSolver(context), mSolver(context)
+    {}
+
+    void printStats(llvm::raw_ostream& os) override { mSolver.printStats(os); }
+    void dump(llvm::raw_ostream& os) override { mSolver.dump(os); }
+    SolverStatus run() override { return mSolver.run(); }
+    SolverStatus run(llvm::ArrayRef<ExprPtr> assumptions) override {
+        return mSolver.run(assumptions);
+    }
+
+    std::unique_ptr<Model> getModel() override;
+    std::vector<ExprPtr> getUnsatCore() override { return mSolver.getUnsatCore(); }
+
+    void interrupt() override { mSolver.interrupt(); }
+
+    void reset() override;
+
+    void push() override;
+    void pop() override;
+
+    ExprPtr getInterpolant(ItpGroup group) override;
+
+protected:
+    void addConstraint(ExprPtr expr) override;
+    void addConstraint(ItpGroup group, ExprPtr expr) override;
+
+private:
+    /// Eliminates \p bound from the formula \p body, and translates the
+    /// result back into a gazer expression.
+    ExprPtr project(Z3AstHandle body, const std::vector<Z3_app>& bound);
+
+private:
+    Z3Solver mSolver;
+    std::vector<std::pair<ItpGroup, ExprPtr>> mFormulae;
+    std::vector<size_t> mScopes;
 };
 
 } // end namespace gazer
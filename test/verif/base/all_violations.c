@@ -0,0 +1,29 @@
+// RUN: %bmc -bound 1 -checks=assertion-fail,div-by-zero -bmc-all-violations "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -checks=assertion-fail,div-by-zero -bmc-all-violations -sim-time=1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -checks=assertion-fail,div-by-zero "%s" | FileCheck "%s" --check-prefix=FIRST
+
+// CHECK: Number of violations: 2
+// CHECK: Verification FAILED.
+
+// FIRST-NOT: Number of violations
+// FIRST: Verification FAILED.
+// FIRST-COUNT-1: {{(Division by zero|Assertion failure)}} in
+
+void __VERIFIER_error(void);
+int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int x = __VERIFIER_nondet_int();
+    int y = __VERIFIER_nondet_int();
+
+    // CHECK-DAG: Division by zero in {{.*}}all_violations.c at line [[# @LINE + 1]]
+    int z = x / y;
+
+    if (z == 3) {
+        // CHECK-DAG: Assertion failure in {{.*}}all_violations.c at line [[# @LINE + 1]]
+        __VERIFIER_error();
+    }
+
+    return 0;
+}
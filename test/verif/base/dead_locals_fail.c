@@ -0,0 +1,33 @@
+// RUN: %bmc -bound 10 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -trace "%s" | FileCheck "%s" --check-prefix=TRACE
+// RUN: %bmc -bound 10 -no-dead-locals "%s" | FileCheck "%s" --check-prefix=NODEAD
+
+// CHECK: Number of eliminated CFA locals: {{[0-9]+}}
+// CHECK: Verification FAILED
+
+// TRACE: Verification FAILED
+// TRACE: Error trace:
+
+// NODEAD-NOT: Number of eliminated CFA locals
+// NODEAD: Verification FAILED
+
+int __VERIFIER_nondet_int(void);
+void __VERIFIER_error(void) __attribute__((__noreturn__));
+
+int main(void)
+{
+    int sum = 0;
+    int last = 0;
+    int n = __VERIFIER_nondet_int();
+
+    for (int i = 0; i < 5; ++i) {
+        last = __VERIFIER_nondet_int();
+        sum += i;
+    }
+
+    if (sum == 10 && n == 3) {
+        __VERIFIER_error();
+    }
+
+    return 0;
+}
@@ -0,0 +1,33 @@
+// RUN: %bmc -bound 1 -checks=assertion-fail,div-by-zero -no-discharge-checks -decompose=check -property-jobs=1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -checks=assertion-fail,div-by-zero -no-discharge-checks -decompose=violation "%s" | FileCheck "%s" --check-prefix=VIOLATION
+
+// CHECK: Property results:
+// CHECK-DAG: Assertion failure: FAILED
+// CHECK-DAG: Division by zero: SUCCESSFUL
+// CHECK: Verification FAILED.
+
+// VIOLATION: Property results:
+// VIOLATION: Verification FAILED.
+
+void __VERIFIER_error(void);
+int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int x = __VERIFIER_nondet_int();
+    int y = __VERIFIER_nondet_int();
+
+    if (y == 0) {
+        y = 1;
+    }
+
+    // VIOLATION-DAG: Division by zero in {{.*}}decompose_checks.c at line [[# @LINE + 1]] column {{[0-9]+}}: SUCCESSFUL
+    int z = x / y;
+
+    if (z == 5) {
+        // VIOLATION-DAG: Assertion failure in {{.*}}decompose_checks.c at line [[# @LINE + 1]] column {{[0-9]+}}: FAILED
+        __VERIFIER_error();
+    }
+
+    return 0;
+}
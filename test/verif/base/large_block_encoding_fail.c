@@ -0,0 +1,35 @@
+// RUN: %bmc -bound 1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -trace "%s" | FileCheck "%s" --check-prefix=TRACE
+// RUN: %bmc -bound 1 -no-lbe "%s" | FileCheck "%s" --check-prefix=NOLBE
+
+// CHECK: Number of merged locations: {{[1-9][0-9]*}}
+// CHECK: Verification FAILED
+
+// TRACE: Number of merged locations: {{[0-9]+}}
+// TRACE: Verification FAILED
+// TRACE: Error trace:
+
+// NOLBE-NOT: Number of merged locations
+// NOLBE: Verification FAILED
+
+int __VERIFIER_nondet_int(void);
+void __VERIFIER_error(void) __attribute__((__noreturn__));
+
+int main(void)
+{
+    int a = __VERIFIER_nondet_int();
+    int b = __VERIFIER_nondet_int();
+    int c;
+
+    if (a > b) {
+        c = a - b;
+    } else {
+        c = b - a;
+    }
+
+    if (c == 5 && a == 10) {
+        __VERIFIER_error();
+    }
+
+    return 0;
+}
@@ -0,0 +1,25 @@
+// RUN: %bmc -bound 1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -no-narrow-ints "%s" | FileCheck "%s" --check-prefix=NONARROW
+
+// CHECK: Number of narrowed instructions: {{[0-9]+}}
+// CHECK: Verification FAILED
+
+// NONARROW-NOT: Number of narrowed instructions
+// NONARROW: Verification FAILED
+
+unsigned char __VERIFIER_nondet_uchar();
+void __VERIFIER_error(void) __attribute__((noreturn));
+
+int main(void)
+{
+    unsigned char a = __VERIFIER_nondet_uchar();
+    unsigned char b = __VERIFIER_nondet_uchar();
+
+    // The product fits into 16 bits.
+    unsigned x = a * b;
+    if (x / (b + 1) == 200 && x == 1000) {
+        __VERIFIER_error();
+    }
+
+    return 0;
+}
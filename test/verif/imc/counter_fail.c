@@ -0,0 +1,16 @@
+// RUN: %bmc -engine=imc -inline=all -no-optimize "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+#include <assert.h>
+
+int main(void)
+{
+    int i = 0;
+    while (i < 5) {
+        ++i;
+    }
+
+    assert(i == 4);
+
+    return 0;
+}
@@ -0,0 +1,25 @@
+// RUN: %bmc -engine=kind -inline=all -no-optimize "%s" | FileCheck "%s"
+// RUN: %bmc -engine=kind -kind-invariants=false -inline=all -bound 5 -no-optimize "%s" | FileCheck "%s" --check-prefix=NOINV
+
+// CHECK: Verification SUCCESSFUL
+// NOINV: Verification BOUND REACHED
+#include <assert.h>
+
+extern int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int n = __VERIFIER_nondet_int();
+    if (n < 0) {
+        return 0;
+    }
+
+    int i = 0;
+    while (i < n) {
+        ++i;
+    }
+
+    assert(i == n);
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+// RUN: %bmc -engine=kind -inline=all -no-optimize "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+#include <assert.h>
+
+extern int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int n = __VERIFIER_nondet_int();
+    int i = 0;
+    while (i < n) {
+        ++i;
+    }
+
+    assert(i != 3);
+
+    return 0;
+}
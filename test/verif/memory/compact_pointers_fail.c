@@ -0,0 +1,29 @@
+// RUN: %bmc -bound 10 -compact-pointers "%s" 2>&1 | FileCheck "%s"
+// RUN: %bmc -bound 10 -compact-pointers -stack-base=0x100000000 "%s" 2>&1 | FileCheck "%s" --check-prefix=WIDE
+
+// CHECK-NOT: warning: The memory of the program may not fit into 32-bit pointers
+// CHECK: Verification FAILED
+
+// WIDE: warning: The memory of the program may not fit into 32-bit pointers, using 64-bit pointers.
+// WIDE: Verification FAILED
+int __VERIFIER_nondet_int(void);
+void __VERIFIER_error(void) __attribute__((__noreturn__));
+
+int g[4];
+
+int main(void)
+{
+    int x[5];
+    int* p = &g[2];
+
+    for (int i = 0; i < 5; ++i) {
+        x[i] = i;
+    }
+
+    *p = x[3];
+    if (g[2] == 3) {
+        __VERIFIER_error();
+    }
+
+    return 0;
+}
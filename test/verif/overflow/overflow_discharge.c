@@ -0,0 +1,28 @@
+// RUN: %bmc -bound 1 -checks=signed-overflow,div-by-zero "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -checks=signed-overflow,div-by-zero -no-discharge-checks "%s" | FileCheck "%s" --check-prefix=NODISCHARGE
+
+// CHECK: Number of discharged checks: {{[0-9]+}}
+// CHECK: Verification FAILED
+
+// NODISCHARGE-NOT: Number of discharged checks
+// NODISCHARGE: Verification FAILED
+
+int __VERIFIER_nondet_int();
+
+int main(void)
+{
+    int x = __VERIFIER_nondet_int();
+
+    // CHECK: Signed integer overflow in {{.*}}overflow_discharge.c at line [[# @LINE + 2]]
+    // NODISCHARGE: Signed integer overflow in {{.*}}overflow_discharge.c at line [[# @LINE + 1]]
+    int y = x + 1;
+
+    // Every check in the loop is safe: the counter stays below 100, the divisor
+    // is never zero and the sum stays below 600. The verifier discharges these.
+    int sum = 0;
+    for (int i = 0; i < 100; ++i) {
+        sum += 100 / (i + 1);
+    }
+
+    return y + sum;
+}
@@ -0,0 +1,25 @@
+// RUN: %bmc -sim-time=1 -engine=pdr -inline=all -no-optimize "%s" | FileCheck "%s"
+
+// CHECK: Running random simulation.
+// CHECK: No error was found by simulation.
+// CHECK: Verification SUCCESSFUL
+#include <assert.h>
+
+extern int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int n = __VERIFIER_nondet_int();
+    if (n < 0) {
+        return 0;
+    }
+
+    int i = 0;
+    while (i < n) {
+        ++i;
+    }
+
+    assert(i == n);
+
+    return 0;
+}
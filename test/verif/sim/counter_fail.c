@@ -0,0 +1,21 @@
+// RUN: %bmc -sim-time=5 -inline=all -no-optimize "%s" | FileCheck "%s"
+
+// CHECK: Running random simulation.
+// CHECK: Found a counterexample
+// CHECK: Verification FAILED
+#include <assert.h>
+
+extern int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int n = __VERIFIER_nondet_int();
+    int i = 0;
+    while (i < n) {
+        ++i;
+    }
+
+    assert(i != 3);
+
+    return 0;
+}
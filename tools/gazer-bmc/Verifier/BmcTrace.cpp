@@ -56,9 +56,9 @@ void bmc::cex_iterator::advance()
 }
 
 // FIXME: Move this to BoundedModelChecker.cpp?
-std::unique_ptr<VerificationResult> BoundedModelCheckerImpl::createFailResult()
+std::unique_ptr<VerificationResult> BoundedModelCheckerImpl::createFailResult(Solver& solver)
 {
-    auto model = mSolver->getModel();
+    auto model = solver.getModel();
 
     if (mSettings.dumpSolverModel) {
         model->dump(llvm::errs());
@@ -16,6 +16,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include "BoundedModelCheckerImpl.h"
+#include "ConcurrentSolverRun.h"
 
 #include "gazer/Core/Expr/ExprRewrite.h"
 #include "gazer/Core/Expr/ExprUtils.h"
@@ -73,6 +74,11 @@ BoundedModelCheckerImpl::BoundedModelCheckerImpl(
     mTraceBuilder(traceBuilder),
     mSettings(settings)
 {
+    if (mSettings.parallelApprox) {
+        mUnderSolver = solverFactory.createSolver(system.getContext());
+        mConsistencySolver = solverFactory.createSolver(system.getContext());
+    }
+
     // TODO: Clone the main automaton instead of modifying the original.
     mRoot = mSystem.getMainAutomaton();
     assert(mRoot != nullptr && "The main automaton must exist!");
@@ -85,12 +91,7 @@ void BoundedModelCheckerImpl::createTopologicalSorts()
         createTopologicalSort(cfa, topoVec);
     }
 
-    auto& mainTopo = mTopoSortMap[mRoot];
-    mTopo.insert(mTopo.end(), mainTopo.begin(), mainTopo.end());
-
-    for (size_t i = 0; i < mTopo.size(); ++i) {
-        mLocNumbers[mTopo[i]] = i;
-    }
+    mTopo.append(mTopoSortMap[mRoot]);
 }
 
 auto BoundedModelCheckerImpl::initializeErrorField() -> bool
@@ -185,6 +186,14 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
     // Create the topological sorts
     this->createTopologicalSorts();
 
+    // Build the dominator trees of the main automaton. These are kept
+    // up-to-date during inlining, so the common call ancestors may be
+    // queried without recalculating dominators in each iteration.
+    mDomTree = std::make_unique<DagDominatorTree>(this->createLocNumberFunc());
+    mDomTree->recalculate(mRoot->getEntry(), mTopoSortMap[mRoot]);
+    mPostDomTree = std::make_unique<DagPostDominatorTree>(this->createLocNumberFunc());
+    mPostDomTree->recalculate(mError, mTopoSortMap[mRoot]);
+
     // Insert initial call approximations.
     for (Transition* edge : mRoot->edges()) {
         if (auto call = llvm::dyn_cast<CallTransition>(edge)) {
@@ -200,7 +209,6 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
     // Initialize the path condition calculator
     PathConditionCalculator pathConditions(
         mTopo, mExprBuilder,
-        this->createLocNumberFunc(),
         [this](CallTransition* call) -> ExprPtr {
             return mCalls[call].overApprox;
         },
@@ -215,7 +223,6 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
         return VerificationResult::CreateUnknown();
     }
 
-    unsigned tmp = 0;
     for (size_t bound = 1; bound <= mSettings.eagerUnroll; ++bound) {
         llvm::outs() << "Eager iteration " << bound << "\n";
         mOpenCalls.clear();
@@ -227,7 +234,7 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
 
         llvm::SmallVector<CallTransition*, 16> callsToInline;
         for (CallTransition* call : mOpenCalls) {
-            inlineCallIntoRoot(call, mInlinedVariables, "_call" + llvm::Twine(tmp++), callsToInline);
+            inlineCallIntoRoot(call, mInlinedVariables, callsToInline);
             mCalls.erase(call);
         }
     }
@@ -248,109 +255,114 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
             unsigned numUnhandledCallSites = 0;
             ExprPtr formula;
             Solver::SolverStatus status = Solver::UNKNOWN;
+            std::pair<Location*, Location*> lca;
+
+            if (mSettings.parallelApprox) {
+                auto result = this->solveApproximationsConcurrently(
+                    pathConditions, top, bottom, bound, skipUnderApprox, lca, numUnhandledCallSites, status
+                );
+                if (result != nullptr) {
+                    return result;
+                }
+                skipUnderApprox = false;
+            } else {
+                if (!skipUnderApprox) {
+                    llvm::outs() << "  Under-approximating.\n";
 
-            if (!skipUnderApprox) {
-                llvm::outs() << "  Under-approximating.\n";
+                    for (auto& entry : mCalls) {
+                        entry.second.overApprox = mExprBuilder.False();
+                    }
 
-                for (auto& entry : mCalls) {
-                    entry.second.overApprox = mExprBuilder.False();
-                }
+                    formula = pathConditions.encode(top, bottom);
 
-                formula = pathConditions.encode(top, bottom);
+                    this->push();
+                    llvm::outs() << "    Transforming formula...\n";
+                    if (mSettings.dumpFormula) {
+                        formula->print(llvm::errs());
+                    }
 
-                this->push();
-                llvm::outs() << "    Transforming formula...\n";
-                if (mSettings.dumpFormula) {
-                    formula->print(llvm::errs());
-                }
+                    mSolver->add(formula);
 
-                mSolver->add(formula);
+                    if (mSettings.dumpSolver) {
+                        mSolver->dump(llvm::errs());
+                    }
 
-                if (mSettings.dumpSolver) {
-                    mSolver->dump(llvm::errs());
-                }
+                    status = this->runSolver();
 
-                status = this->runSolver();
+                    if (status == Solver::SAT) {
+                        llvm::outs() << "  Under-approximated formula is SAT.\n";
+                        auto result = this->createFailResult(*mSolver);
+                        if (!mSettings.allViolations) {
+                            return result;
+                        }
 
-                if (status == Solver::SAT) {
-                    llvm::outs() << "  Under-approximated formula is SAT.\n";
-                    return this->createFailResult();
+                        // Keep the current unwinding and the solver state, but
+                        // look for a violation of a different check.
+                        this->pop();
+                        this->blockViolation(std::move(result));
+                        continue;
+                    }
+
+                    this->pop();
                 }
 
-                this->pop();
-            }
+                skipUnderApprox = false;
 
-            skipUnderApprox = false;
+                // If the under-approximated formula was UNSAT, there is no feasible path from start
+                // to the error location which does not involve a call. Find the lowest common dominator
+                // of all calls, and set is as the start location. Similarly, we can calculate the
+                // highest common post-dominator for the error location of all calls to update the
+                // target state. These nodes are the lowest common ancestors (LCA) of the calls in
+                // the (post-)dominator trees.
+                llvm::outs() << "  Attempting to set new starting and target points...\n";
+                lca = this->findCommonCallAncestor(top, bottom);
 
-            // If the under-approximated formula was UNSAT, there is no feasible path from start
-            // to the error location which does not involve a call. Find the lowest common dominator
-            // of all calls, and set is as the start location. Similarly, we can calculate the
-            // highest common post-dominator for the error location of all calls to update the
-            // target state. These nodes are the lowest common ancestors (LCA) of the calls in
-            // the (post-)dominator trees.
-            llvm::outs() << "  Attempting to set new starting and target points...\n";
-            auto lca = this->findCommonCallAncestor(top, bottom);
+                this->push();
+                if (lca.first != nullptr) {
+                    LLVM_DEBUG(llvm::dbgs() << "Found LCA, " << lca.first->getId() << ".\n");
+                    assert(lca.second != nullptr);
 
-            this->push();
-            if (lca.first != nullptr) {
-                LLVM_DEBUG(llvm::dbgs() << "Found LCA, " << lca.first->getId() << ".\n");
-                assert(lca.second != nullptr);
+                    mSolver->add(pathConditions.encode(top, lca.first));
+                    mSolver->add(pathConditions.encode(lca.second, bottom));
 
-                mSolver->add(pathConditions.encode(top, lca.first));
-                mSolver->add(pathConditions.encode(lca.second, bottom));
+                    // Run the solver and check whether top and bottom are consistent -- if not,
+                    // we can return that the program is safe as all possible error paths will
+                    // encode these program parts.
+                    status = this->runSolver();
 
-                // Run the solver and check whether top and bottom are consistent -- if not,
-                // we can return that the program is safe as all possible error paths will
-                // encode these program parts.
-                status = this->runSolver();
+                    if (status == Solver::UNSAT) {
+                        llvm::outs() << "    Start and target points are inconsitent, no errors are reachable.\n";
+                        return this->finish(VerificationResult::CreateSuccess());
+                    }
 
-                if (status == Solver::UNSAT) {
-                    llvm::outs() << "    Start and target points are inconsitent, no errors are reachable.\n";
-                    return VerificationResult::CreateSuccess();
+                } else {
+                    LLVM_DEBUG(llvm::dbgs() << "No calls present, LCA is " << top->getId() << ".\n");
+                    lca = { top, bottom };
                 }
 
-            } else {
-                LLVM_DEBUG(llvm::dbgs() << "No calls present, LCA is " << top->getId() << ".\n");
-                lca = { top, bottom };
-            }
+                // Now try to over-approximate.
+                llvm::outs() << "  Over-approximating.\n";
 
-            // Now try to over-approximate.
-            llvm::outs() << "  Over-approximating.\n";
-
-            mOpenCalls.clear();
-            for (auto& [call, info] : mCalls) {
-                if (info.getCost() > bound) {
-                    LLVM_DEBUG(
-                        llvm::dbgs() << "  Skipping " << *call
-                        << ": inline cost is greater than bound (" <<
-                        info.getCost() << " > " << bound << ").\n"
-                    );
-                    info.overApprox = mExprBuilder.False();
-                    ++numUnhandledCallSites;
-                    continue;
-                }
+                numUnhandledCallSites = this->openCallsWithinBound(bound);
 
-                info.overApprox = mExprBuilder.True();
-                mOpenCalls.insert(call);
-            }
+                this->push();
 
-            this->push();
+                llvm::outs() << "    Calculating verification condition...\n";
+                formula = pathConditions.encode(lca.first, lca.second);
+                if (mSettings.dumpFormula) {
+                    formula->print(llvm::errs());
+                }
 
-            llvm::outs() << "    Calculating verification condition...\n";
-            formula = pathConditions.encode(lca.first, lca.second);
-            if (mSettings.dumpFormula) {
-                formula->print(llvm::errs());
-            }
+                llvm::outs() << "    Transforming formula...\n";
+                mSolver->add(formula);
 
-            llvm::outs() << "    Transforming formula...\n";
-            mSolver->add(formula);
+                if (mSettings.dumpSolver) {
+                    mSolver->dump(llvm::errs());
+                }
 
-            if (mSettings.dumpSolver) {
-                mSolver->dump(llvm::errs());
+                status = this->runSolver();
             }
 
-            status = this->runSolver();
-
             if (status == Solver::SAT) {
                 llvm::outs() << "      Over-approximated formula is SAT.\n";
                 llvm::outs() << "      Checking counterexample...\n";
@@ -370,9 +382,7 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
                     mStats.NumInlined++;
 
                     llvm::SmallVector<CallTransition*, 4> newCalls;
-                    this->inlineCallIntoRoot(
-                        call, mInlinedVariables, "_call" + llvm::Twine(tmp++), newCalls
-                    );
+                    this->inlineCallIntoRoot(call, mInlinedVariables, newCalls);
                     mCalls.erase(call);
                     mOpenCalls.erase(call);
 
@@ -402,7 +412,7 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
                     mStats.NumEndLocs = mRoot->getNumLocations();
                     mStats.NumEndLocals = mRoot->getNumLocals();
 
-                    return VerificationResult::CreateSuccess();
+                    return this->finish(VerificationResult::CreateSuccess());
                 }
 
                 if (bound == mSettings.maxBound) {
@@ -412,7 +422,7 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
                     mStats.NumEndLocs = mRoot->getNumLocations();
                     mStats.NumEndLocals = mRoot->getNumLocals();
 
-                    return VerificationResult::CreateBoundReached();
+                    return this->finish(VerificationResult::CreateBoundReached());
                 }
 
                 // Try with an increased bound.
@@ -432,41 +442,266 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
         }
     }
 
-    return VerificationResult::CreateBoundReached();
+    return this->finish(VerificationResult::CreateBoundReached());
+}
+
+void BoundedModelCheckerImpl::blockViolation(std::unique_ptr<VerificationResult> result)
+{
+    auto fail = llvm::cast<FailResult>(result.get());
+    unsigned ec = fail->getErrorID();
+    llvm::outs() << "    Found a violation with error code " << ec << ", continuing with the other checks.\n";
+    mStats.NumViolations++;
+
+    ExprPtr code;
+    if (auto bvTy = llvm::dyn_cast<BvType>(&mErrorFieldVariable->getType())) {
+        code = mExprBuilder.BvLit(ec, bvTy->getWidth());
+    } else {
+        code = mExprBuilder.IntLit(ec);
+    }
+
+    // The blocking constraint is added below all scopes of the current iteration,
+    // thus it is kept for the rest of the analysis.
+    mSolver->add(mExprBuilder.NotEq(mErrorFieldVariable->getRefExpr(), code));
+
+    if (mViolations == nullptr) {
+        mViolations.reset(llvm::cast<FailResult>(result.release()));
+    } else {
+        mViolations->append(std::move(*fail));
+    }
+}
+
+auto BoundedModelCheckerImpl::finish(std::unique_ptr<VerificationResult> result)
+    -> std::unique_ptr<VerificationResult>
+{
+    if (mViolations != nullptr) {
+        return std::move(mViolations);
+    }
+
+    return result;
 }
 
 auto BoundedModelCheckerImpl::createLocNumberFunc()
     -> std::function<size_t(Location*)>
 {
-    return [this](Location* loc) {
-        auto predIt = mLocNumbers.find(loc);
-        assert(predIt != mLocNumbers.end()
-            && "All locations must be present in the location map!");
+    return mTopo.getIndexFunction();
+}
 
-        return predIt->second;
-    };
+unsigned BoundedModelCheckerImpl::openCallsWithinBound(size_t bound)
+{
+    unsigned numUnhandledCallSites = 0;
+
+    mOpenCalls.clear();
+    for (auto& [call, info] : mCalls) {
+        if (info.getCost() > bound) {
+            LLVM_DEBUG(
+                llvm::dbgs() << "  Skipping " << *call
+                << ": inline cost is greater than bound (" <<
+                info.getCost() << " > " << bound << ").\n"
+            );
+            info.overApprox = mExprBuilder.False();
+            ++numUnhandledCallSites;
+            continue;
+        }
+
+        info.overApprox = mExprBuilder.True();
+        mOpenCalls.insert(call);
+    }
+
+    return numUnhandledCallSites;
+}
+
+auto BoundedModelCheckerImpl::solveApproximationsConcurrently(
+    PathConditionCalculator& pathConditions,
+    Location* top,
+    Location* bottom,
+    size_t bound,
+    bool skipUnderApprox,
+    std::pair<Location*, Location*>& lca,
+    unsigned& numUnhandledCallSites,
+    Solver::SolverStatus& overApproxStatus
+) -> std::unique_ptr<VerificationResult>
+{
+    // The under-approximation, the consistency check of the new start and target
+    // points and the over-approximation are independent queries, they are solved
+    // concurrently on separate solver instances. The formulas are built and
+    // translated on this thread, only the solvers run on worker threads.
+    //
+    // Note that the start and target points are only relevant if the
+    // under-approximation is UNSAT: until then, only a SAT under-approximation
+    // is a decisive answer.
+    lca = this->findCommonCallAncestor(top, bottom);
+    bool hasLca = lca.first != nullptr;
+    if (!hasLca) {
+        LLVM_DEBUG(llvm::dbgs() << "No calls present, LCA is " << top->getId() << ".\n");
+        lca = { top, bottom };
+    }
+
+    ConcurrentSolverRun queries;
+    auto consistency = ConcurrentSolverRun::InvalidQuery;
+    auto under = ConcurrentSolverRun::InvalidQuery;
+
+    // The over-approximation uses the main solver with the same scopes as the
+    // sequential algorithm, so its model and predecessor information may be used
+    // for inlining afterwards.
+    llvm::outs() << "  Over-approximating.\n";
+    this->push();
+    ExprPtr prefix;
+    ExprPtr suffix;
+    if (hasLca) {
+        prefix = pathConditions.encode(top, lca.first);
+        suffix = pathConditions.encode(lca.second, bottom);
+        mSolver->add(prefix);
+        mSolver->add(suffix);
+    }
+
+    numUnhandledCallSites = this->openCallsWithinBound(bound);
+    this->push();
+
+    llvm::outs() << "    Calculating verification condition...\n";
+    ExprPtr formula = pathConditions.encode(lca.first, lca.second);
+    if (mSettings.dumpFormula) {
+        formula->print(llvm::errs());
+    }
+    mSolver->add(formula);
+    if (mSettings.dumpSolver) {
+        mSolver->dump(llvm::errs());
+    }
+    auto over = queries.launch(*mSolver);
+
+    // Similarly to the main solver, the start and target point constraints are
+    // kept in the consistency solver for the rest of the analysis.
+    if (hasLca) {
+        llvm::outs() << "  Checking start and target point consistency.\n";
+        mConsistencySolver->push();
+        mConsistencySolver->add(prefix);
+        mConsistencySolver->add(suffix);
+        consistency = queries.launch(*mConsistencySolver);
+    }
+
+    // The under-approximation is encoded last, in its own predecessor scope,
+    // so that its predecessor information is on top if it yields a counterexample.
+    if (!skipUnderApprox) {
+        llvm::outs() << "  Under-approximating.\n";
+        for (auto& entry : mCalls) {
+            entry.second.overApprox = mExprBuilder.False();
+        }
+
+        mPredecessors.push();
+        formula = pathConditions.encode(top, bottom);
+        if (mSettings.dumpFormula) {
+            formula->print(llvm::errs());
+        }
+        mUnderSolver->push();
+        mUnderSolver->add(formula);
+        under = queries.launch(*mUnderSolver);
+    }
+
+    llvm::outs() << "    Running solvers...\n";
+    mTimer.start();
+
+    auto underStatus = skipUnderApprox ? std::optional(Solver::UNSAT) : std::nullopt;
+    auto consistencyStatus = hasLca ? std::nullopt : std::optional(Solver::SAT);
+    std::optional<Solver::SolverStatus> overStatus;
+
+    std::unique_ptr<VerificationResult> result = nullptr;
+    while (true) {
+        if (underStatus == Solver::SAT) {
+            llvm::outs() << "  Under-approximated formula is SAT.\n";
+            queries.cancelAll();
+            result = this->createFailResult(*mUnderSolver);
+            break;
+        }
+
+        if (consistencyStatus == Solver::UNSAT) {
+            // All error paths must go through the start and target points, so
+            // the over-approximation cannot be satisfiable either.
+            queries.cancel(over);
+            if (underStatus.has_value()) {
+                llvm::outs() << "    Start and target points are inconsitent, no errors are reachable.\n";
+                queries.cancelAll();
+                result = VerificationResult::CreateSuccess();
+                break;
+            }
+        } else if (overStatus == Solver::SAT || (overStatus == Solver::UNSAT && numUnhandledCallSites == 0)) {
+            // The result of the consistency check cannot change the outcome of this iteration.
+            queries.cancel(consistency);
+            if (underStatus.has_value()) {
+                queries.cancelAll();
+                break;
+            }
+        } else if (overStatus.has_value() && consistencyStatus.has_value() && underStatus.has_value()) {
+            break;
+        }
+
+        auto next = queries.waitNext();
+        assert(next.has_value() && "There must be a running query if the outcome is undecided!");
+
+        auto [query, status] = *next;
+        if (query == under) {
+            underStatus = status;
+        } else if (query == consistency) {
+            consistencyStatus = status;
+        } else if (query == over) {
+            overStatus = status;
+        }
+    }
+
+    mTimer.stop();
+    llvm::outs() << "      Elapsed time: ";
+    mTimer.format(llvm::outs(), "s");
+    llvm::outs() << "\n";
+    mStats.SolverTime += mTimer.elapsed();
+
+    if (result != nullptr) {
+        return result;
+    }
+
+    if (!skipUnderApprox) {
+        mUnderSolver->pop();
+        mPredecessors.pop();
+    }
+
+    // The next under-approximation will start from the new start and target
+    // points, add their constraints to the under-approximating solver as well.
+    if (hasLca) {
+        mUnderSolver->push();
+        mUnderSolver->add(prefix);
+        mUnderSolver->add(suffix);
+    }
+
+    overApproxStatus = *overStatus;
+    return nullptr;
 }
 
 auto BoundedModelCheckerImpl::findCommonCallAncestor(Location* fwd, Location* bwd)
     -> std::pair<Location*, Location*>
 {
-    // Calculate the closest common dominator for all call nodes
-    std::vector<Transition*> targets;
-    std::transform(mCalls.begin(), mCalls.end(), std::back_inserter(targets), [](auto& pair) {
-        return pair.first;
-    });
+    // Calculate the closest common dominator for all call nodes. As `fwd`
+    // dominates and `bwd` post-dominates all calls, the nearest common
+    // ancestors in the whole trees are the same as the ones in the subtrees
+    // rooted at `fwd` and `bwd`.
+    llvm::SmallVector<Location*, 16> sources;
+    llvm::SmallVector<Location*, 16> targets;
+    for (auto& [call, info] : mCalls) {
+        sources.push_back(call->getSource());
+        targets.push_back(call->getTarget());
+    }
 
     Location* dom;
     Location* pdom;
 
     if (!NoDomPush) {
-        dom = findLowestCommonDominator(targets, mTopo, this->createLocNumberFunc(), fwd);
+        dom = mDomTree->findNearestCommonDominator(sources);
+        assert((sources.empty() || mDomTree->dominates(fwd, dom))
+            && "The starting location must dominate all calls!");
     } else {
         dom = fwd;
     }
 
     if (!NoPostDomPush) {
-        pdom = findHighestCommonPostDominator(targets, mTopo, this->createLocNumberFunc(), bwd);
+        pdom = mPostDomTree->findNearestCommonDominator(targets);
+        assert((targets.empty() || mPostDomTree->dominates(bwd, pdom))
+            && "The target location must post-dominate all calls!");
     } else {
         pdom = bwd;
     }
@@ -493,7 +728,6 @@ void BoundedModelCheckerImpl::findOpenCallsInCex(Model& model, llvm::SmallVector
 void BoundedModelCheckerImpl::inlineCallIntoRoot(
     CallTransition* call,
     llvm::DenseMap<Variable*, Variable*>& vmap,
-    const llvm::Twine& suffix,
     llvm::SmallVectorImpl<CallTransition*>& newCalls
 ) {
     LLVM_DEBUG(
@@ -517,8 +751,7 @@ void BoundedModelCheckerImpl::inlineCallIntoRoot(
     for (Variable& local : callee->locals()) {
         LLVM_DEBUG(llvm::dbgs() << "Callee local " << local.getName() << "\n");
         if (!callee->isOutput(&local)) {
-            auto varname = (local.getName() + suffix).str();
-            auto newLocal = mRoot->createLocal(varname, local.getType());
+            auto newLocal = mRoot->createFreshLocal(&local);
             oldVarToNew[&local] = newLocal;
             vmap[newLocal] = &local;
             rewrite[&local] = newLocal->getRefExpr();
@@ -528,8 +761,7 @@ void BoundedModelCheckerImpl::inlineCallIntoRoot(
     for (Variable& input : callee->inputs()) {
         LLVM_DEBUG(llvm::dbgs() << "Callee input " << input.getName() << "\n");
         if (!callee->isOutput(&input)) {
-            auto varname = (input.getName() + suffix).str();
-            auto newInput = mRoot->createLocal(varname, input.getType());
+            auto newInput = mRoot->createFreshLocal(&input);
             oldVarToNew[&input] = newInput;
             vmap[newInput] = &input;
 
@@ -650,26 +882,23 @@ void BoundedModelCheckerImpl::inlineCallIntoRoot(
 
     // Add the new locations to the topological sort.
     // As every inlined location should come between the source and target of the original call transition,
-    // we will insert them there in the topo sort.
+    // we will insert them there in the topo sort. This only relabels the locations around the call site.
     auto& oldTopo = mTopoSortMap[callee];
     auto getInlinedLocation = [&locToLocMap](Location* loc) {
         return locToLocMap[loc];
     };
 
-    size_t callIdx = mLocNumbers[call->getTarget()];
-    auto callPos = std::next(mTopo.begin(), callIdx);
-    auto insertPos = mTopo.insert(callPos,
+    std::vector<Location*> inlinedLocs(
         llvm::map_iterator(oldTopo.begin(), getInlinedLocation),
         llvm::map_iterator(oldTopo.end(), getInlinedLocation)
     );
-
-    // Update the location numbers
-    for (auto it = insertPos, ie = mTopo.end(); it != ie; ++it) {
-        size_t idx = std::distance(mTopo.begin(), it);
-        mLocNumbers[*it] = idx;
-    }
+    mTopo.insertBefore(call->getTarget(), inlinedLocs);
 
     mRoot->disconnectEdge(call);
+
+    // Update the dominator trees with the inlined locations.
+    mDomTree->insertLocations(inlinedLocs);
+    mPostDomTree->insertLocations(inlinedLocs);
 }
 
 auto BoundedModelCheckerImpl::runSolver() -> Solver::SolverStatus
@@ -698,6 +927,9 @@ void BoundedModelCheckerImpl::printStats(llvm::raw_ostream& os)
     os << "Number of locations on finish: " << mStats.NumEndLocs << "\n";
     os << "Number of variables on start: " << mStats.NumBeginLocals << "\n";
     os << "Number of variables on finish: " << mStats.NumEndLocals << "\n";
+    if (mSettings.allViolations) {
+        os << "Number of violations: " << mStats.NumViolations << "\n";
+    }
     os << "------------------------------\n";
     if (mSettings.printSolverStats) {
         mSolver->printStats(os);
@@ -24,6 +24,9 @@
 #include "gazer/Core/Solver/Solver.h"
 #include "gazer/Core/Solver/Model.h"
 #include "gazer/Automaton/Cfa.h"
+#include "gazer/Automaton/CfaDominators.h"
+#include "gazer/Automaton/CfaTopoOrder.h"
+#include "gazer/Automaton/CfaUtils.h"
 #include "gazer/Trace/Trace.h"
 
 #include "gazer/Support/Stopwatch.h"
@@ -132,6 +135,7 @@ public:
         unsigned NumEndLocs = 0;
         unsigned NumBeginLocals = 0;
         unsigned NumEndLocals = 0;
+        unsigned NumViolations = 0;
     };
 
     BoundedModelCheckerImpl(
@@ -154,7 +158,6 @@ private:
     void inlineCallIntoRoot(
         CallTransition* call,
         llvm::DenseMap<Variable*, Variable*>& vmap,
-        const llvm::Twine& suffix,
         llvm::SmallVectorImpl<CallTransition*>& newCalls
     );
     
@@ -164,9 +167,36 @@ private:
 
     std::function<size_t(Location*)> createLocNumberFunc();
 
+    /// Marks the calls whose inline cost is within \p bound as open and sets their
+    /// over-approximation. Returns the number of calls which exceed the bound.
+    unsigned openCallsWithinBound(size_t bound);
+
+    /// Solves the under-approximation, the start and target point consistency check
+    /// and the over-approximation of an iteration concurrently. Returns the final
+    /// verification result if one was found, otherwise the over-approximation is left
+    /// on the solver and its status is returned in \p overApproxStatus.
+    std::unique_ptr<VerificationResult> solveApproximationsConcurrently(
+        PathConditionCalculator& pathConditions,
+        Location* top,
+        Location* bottom,
+        size_t bound,
+        bool skipUnderApprox,
+        std::pair<Location*, Location*>& lca,
+        unsigned& numUnhandledCallSites,
+        Solver::SolverStatus& overApproxStatus
+    );
+
     void findOpenCallsInCex(Model& model, llvm::SmallVectorImpl<CallTransition*>& callsInCex);
 
-    std::unique_ptr<VerificationResult> createFailResult();
+    std::unique_ptr<VerificationResult> createFailResult(Solver& solver);
+
+    /// Records a violation found in all-violations mode and excludes its
+    /// error code from all further queries.
+    void blockViolation(std::unique_ptr<VerificationResult> result);
+
+    /// Returns the violations found so far in all-violations mode, or
+    /// \p result if there were none.
+    std::unique_ptr<VerificationResult> finish(std::unique_ptr<VerificationResult> result);
 
     void push() {
         mSolver->push();
@@ -184,15 +214,18 @@ private:
     AutomataSystem& mSystem;
     ExprBuilder& mExprBuilder;
     std::unique_ptr<Solver> mSolver;
+    std::unique_ptr<Solver> mUnderSolver;
+    std::unique_ptr<Solver> mConsistencySolver;
     TraceBuilder<Location*, std::vector<VariableAssignment>>& mTraceBuilder;
     BmcSettings mSettings;
 
     Cfa* mRoot;
-    std::vector<Location*> mTopo;
+    CfaTopoOrder mTopo;
 
     Location* mError = nullptr;
 
-    llvm::DenseMap<Location*, size_t> mLocNumbers;
+    std::unique_ptr<DagDominatorTree> mDomTree;
+    std::unique_ptr<DagPostDominatorTree> mPostDomTree;
     llvm::DenseSet<CallTransition*> mOpenCalls;
     std::unordered_map<CallTransition*, CallInfo> mCalls;
     std::unordered_map<Cfa*, std::vector<Location*>> mTopoSortMap;
@@ -207,6 +240,7 @@ private:
     Stats mStats;
     Stopwatch<> mTimer;
     Variable* mErrorFieldVariable = nullptr;
+    std::unique_ptr<FailResult> mViolations;
 };
 
 std::unique_ptr<Trace> buildBmcTrace(
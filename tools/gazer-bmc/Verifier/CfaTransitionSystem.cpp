@@ -0,0 +1,389 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "CfaTransitionSystem.h"
+
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Expr/ExprRewrite.h"
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+
+using namespace gazer;
+
+CfaTransitionSystem::CfaTransitionSystem(
+    Cfa& cfa, RecursiveToCyclicResult& cyclic, ExprBuilder& builder
+) : mCfa(cfa), mCyclic(cyclic), mExprBuilder(builder)
+{
+    GazerContext& ctx = mCfa.getParent().getContext();
+
+    mPc = ctx.createFreshVariable("__gazer_pc", IntType::Get(ctx));
+
+    mStateVariables.push_back(mPc);
+
+    llvm::DenseSet<Variable*> seen;
+    for (auto range : { mCfa.inputs(), mCfa.locals() }) {
+        for (Variable& variable : range) {
+            if (seen.insert(&variable).second) {
+                mStateVariables.push_back(&variable);
+            }
+        }
+    }
+
+    this->encodeTransitionRelation();
+}
+
+Variable* CfaTransitionSystem::getCopy(Variable* variable, unsigned step)
+{
+    auto& copy = mCopies[{variable, step}];
+    if (copy == nullptr) {
+        GazerContext& ctx = mCfa.getParent().getContext();
+        copy = ctx.createFreshVariable(variable, variable->getType());
+    }
+
+    return copy;
+}
+
+ExprPtr CfaTransitionSystem::atLocation(Location* loc, unsigned step)
+{
+    return mExprBuilder.Eq(getCopy(mPc, step)->getRefExpr(), mExprBuilder.IntLit(loc->getId()));
+}
+
+void CfaTransitionSystem::encodeTransitionRelation()
+{
+    GazerContext& ctx = mCfa.getParent().getContext();
+    ExprVector edges;
+
+    auto frame = [this](ExprVector& exprs, const llvm::DenseMap<Variable*, ExprPtr>& next) {
+        for (Variable* variable : mStateVariables) {
+            if (variable == mPc) {
+                continue;
+            }
+
+            ExprPtr value = next.lookup(variable);
+            if (value == nullptr) {
+                value = getCopy(variable, 0)->getRefExpr();
+            }
+
+            exprs.push_back(mExprBuilder.Eq(getCopy(variable, 1)->getRefExpr(), value));
+        }
+    };
+
+    for (Transition* edge : mCfa.edges()) {
+        auto assignEdge = llvm::cast<AssignTransition>(edge);
+
+        // Assignments are sequential: each assignment sees the values
+        // written by the previous ones on the same transition.
+        VariableExprRewrite current(mExprBuilder);
+        for (Variable* variable : mStateVariables) {
+            current[variable] = getCopy(variable, 0)->getRefExpr();
+        }
+
+        ExprVector exprs;
+        exprs.push_back(current.walk(edge->getGuard()));
+
+        llvm::DenseMap<Variable*, ExprPtr> next;
+        for (const VariableAssignment& assignment : *assignEdge) {
+            ExprPtr value;
+            if (assignment.getValue()->getKind() == Expr::Undef) {
+                Variable* havoc = ctx.createFreshVariable("__gazer_havoc", assignment.getVariable()->getType());
+                mHavocVariables.push_back(havoc);
+                value = getCopy(havoc, 0)->getRefExpr();
+            } else {
+                value = current.walk(assignment.getValue());
+            }
+
+            next[assignment.getVariable()] = value;
+            current[assignment.getVariable()] = value;
+        }
+
+        frame(exprs, next);
+
+        ExprPtr data = mExprBuilder.And(exprs);
+        mEdgeTransitions[edge] = data;
+
+        edges.push_back(mExprBuilder.And({
+            atLocation(edge->getSource(), 0), data, atLocation(edge->getTarget(), 1)
+        }));
+    }
+
+    // The error location has no outgoing transitions. Let it stutter, so
+    // error paths shorter than the current bound are not cut off.
+    ExprVector stutter;
+    stutter.push_back(atLocation(mCyclic.errorLocation, 0));
+    stutter.push_back(atLocation(mCyclic.errorLocation, 1));
+    frame(stutter, {});
+    edges.push_back(mExprBuilder.And(stutter));
+
+    mTransition = mExprBuilder.Or(edges);
+}
+
+ExprPtr CfaTransitionSystem::transition(unsigned step)
+{
+    if (step == 0) {
+        return mTransition;
+    }
+
+    VariableExprRewrite rewrite(mExprBuilder);
+    for (Variable* variable : mStateVariables) {
+        rewrite[getCopy(variable, 0)] = getCopy(variable, step)->getRefExpr();
+        rewrite[getCopy(variable, 1)] = getCopy(variable, step + 1)->getRefExpr();
+    }
+    for (Variable* variable : mHavocVariables) {
+        rewrite[getCopy(variable, 0)] = getCopy(variable, step)->getRefExpr();
+    }
+
+    return rewrite.walk(mTransition);
+}
+
+ExprVector CfaTransitionSystem::collectComparisons()
+{
+    ExprVector atoms;
+    llvm::DenseSet<Expr*> visited;
+    llvm::DenseSet<Expr*> seenAtoms;
+
+    std::vector<ExprPtr> worklist;
+    for (Transition* edge : mCfa.edges()) {
+        worklist.push_back(edge->getGuard());
+        for (const VariableAssignment& assignment : *llvm::cast<AssignTransition>(edge)) {
+            worklist.push_back(assignment.getValue());
+        }
+    }
+
+    auto addAtom = [&](const ExprPtr& atom) {
+        if (seenAtoms.insert(atom.get()).second) {
+            atoms.push_back(atom);
+        }
+    };
+
+    while (!worklist.empty()) {
+        ExprPtr expr = worklist.back();
+        worklist.pop_back();
+
+        if (!visited.insert(expr.get()).second) {
+            continue;
+        }
+
+        auto nn = llvm::dyn_cast<NonNullaryExpr>(expr);
+        if (nn == nullptr) {
+            continue;
+        }
+
+        for (const ExprPtr& op : nn->operands()) {
+            worklist.push_back(op);
+        }
+
+        if (!expr->isCompare()) {
+            continue;
+        }
+
+        Type& opTy = nn->getOperand(0)->getType();
+        if (!opTy.isIntType() && !opTy.isBvType()) {
+            continue;
+        }
+
+        ExprPtr left = nn->getOperand(0);
+        ExprPtr right = nn->getOperand(1);
+
+        addAtom(expr);
+        addAtom(mExprBuilder.Not(expr));
+
+        switch (expr->getKind()) {
+            case Expr::Lt: addAtom(mExprBuilder.LtEq(left, right)); break;
+            case Expr::Gt: addAtom(mExprBuilder.GtEq(left, right)); break;
+            case Expr::BvSLt: addAtom(mExprBuilder.BvSLtEq(left, right)); break;
+            case Expr::BvSGt: addAtom(mExprBuilder.BvSGtEq(left, right)); break;
+            case Expr::BvULt: addAtom(mExprBuilder.BvULtEq(left, right)); break;
+            case Expr::BvUGt: addAtom(mExprBuilder.BvUGtEq(left, right)); break;
+            default:
+                break;
+        }
+    }
+
+    return atoms;
+}
+
+ExprPtr CfaTransitionSystem::atStep(const ExprPtr& expr, unsigned step)
+{
+    VariableExprRewrite rewrite(mExprBuilder);
+    for (Variable* variable : mStateVariables) {
+        rewrite[variable] = getCopy(variable, step)->getRefExpr();
+    }
+
+    return rewrite.walk(expr);
+}
+
+ExprPtr CfaTransitionSystem::renameStep(const ExprPtr& expr, unsigned from, unsigned to)
+{
+    VariableExprRewrite rewrite(mExprBuilder);
+    for (Variable* variable : mStateVariables) {
+        rewrite[getCopy(variable, from)] = getCopy(variable, to)->getRefExpr();
+    }
+
+    return rewrite.walk(expr);
+}
+
+auto CfaTransitionSystem::createFailResult(Model& model, unsigned bound, CfaTraceBuilder* traceBuilder)
+    -> std::unique_ptr<VerificationResult>
+{
+    auto evalInt = [&model](Variable* variable) -> int64_t {
+        auto lit = llvm::dyn_cast<IntLiteralExpr>(model.evaluate(variable->getRefExpr()));
+        assert(lit != nullptr && "The program counter must be present in the model!");
+        return lit->getValue();
+    };
+
+    // Find the first step in which the error location was reached.
+    std::vector<Location*> path;
+    for (unsigned i = 0; i <= bound; ++i) {
+        Location* loc = mCfa.findLocationById(evalInt(getCopy(mPc, i)));
+        assert(loc != nullptr && "Locations should be findable by their id!");
+
+        path.push_back(loc);
+        if (loc == mCyclic.errorLocation) {
+            break;
+        }
+    }
+
+    assert(path.back() == mCyclic.errorLocation && "A counterexample must end in the error location!");
+    unsigned errorStep = path.size() - 1;
+
+    std::unique_ptr<Trace> trace;
+    if (traceBuilder != nullptr) {
+        std::vector<Location*> states;
+        std::vector<std::vector<VariableAssignment>> actions;
+
+        for (unsigned i = 0; i < path.size(); ++i) {
+            Location* origLoc = mCyclic.inlinedLocations.lookup(path[i]);
+            states.push_back(origLoc != nullptr ? origLoc : path[i]);
+
+            if (i == errorStep) {
+                break;
+            }
+
+            // Find the transition taken in this step.
+            VariableExprRewrite current(mExprBuilder);
+            for (Variable* variable : mStateVariables) {
+                current[variable] = getCopy(variable, i)->getRefExpr();
+            }
+
+            auto edge = std::find_if(path[i]->outgoing_begin(), path[i]->outgoing_end(),
+                [&](Transition* e) {
+                    if (e->getTarget() != path[i + 1]) {
+                        return false;
+                    }
+                    auto guard = model.evaluate(current.walk(e->getGuard()));
+                    return guard != nullptr && llvm::isa<BoolLiteralExpr>(guard)
+                        && llvm::cast<BoolLiteralExpr>(guard)->isTrue();
+                }
+            );
+
+            assert(edge != path[i]->outgoing_end() && "There must be a transition between consecutive locations!");
+
+            std::vector<VariableAssignment> traceAction;
+            for (const VariableAssignment& assignment : *llvm::cast<AssignTransition>(*edge)) {
+                Variable* variable = assignment.getVariable();
+                Variable* origVariable = mCyclic.inlinedVariables.lookup(variable);
+                if (origVariable == nullptr) {
+                    origVariable = variable;
+                }
+
+                ExprRef<AtomicExpr> value = model.evaluate(getCopy(variable, i + 1)->getRefExpr());
+                if (value == nullptr) {
+                    value = UndefExpr::Get(variable->getType());
+                }
+
+                traceAction.emplace_back(origVariable, value);
+            }
+
+            actions.push_back(traceAction);
+        }
+
+        trace = traceBuilder->build(states, actions);
+    } else {
+        trace = std::make_unique<Trace>(std::vector<std::unique_ptr<TraceEvent>>());
+    }
+
+    ExprRef<AtomicExpr> errorExpr = model.evaluate(
+        getCopy(mCyclic.errorFieldVariable, errorStep)->getRefExpr()
+    );
+    assert(!errorExpr->isUndef() && "The error field must be present in the model as a literal expression!");
+
+    switch (errorExpr->getType().getTypeID()) {
+        case Type::BvTypeID:
+            return VerificationResult::CreateFail(llvm::cast<BvLiteralExpr>(errorExpr)->getValue().getLimitedValue(), std::move(trace));
+        case Type::IntTypeID:
+            return VerificationResult::CreateFail(llvm::cast<IntLiteralExpr>(errorExpr)->getValue(), std::move(trace));
+        default:
+            llvm_unreachable("Invalid error field type!");
+    }
+}
+
+std::unique_ptr<VerificationResult> gazer::CheckCyclicMainAutomaton(
+    AutomataSystem& system,
+    llvm::StringRef engineName,
+    llvm::function_ref<
+        std::unique_ptr<VerificationResult>(Cfa&, RecursiveToCyclicResult&, ExprBuilder&)
+    > check
+) {
+    Cfa* main = system.getMainAutomaton();
+    assert(main != nullptr && "The main automaton must exist!");
+
+    bool hasErrors = std::any_of(system.begin(), system.end(), [](Cfa& cfa) {
+        return cfa.getNumErrors() != 0;
+    });
+
+    if (!hasErrors) {
+        // There are no error calls in the system, it is safe by definition.
+        llvm::outs() << "No error location is present or it was discarded by the frontend.\n";
+        return VerificationResult::CreateSuccess();
+    }
+
+    CloneOrigins origins;
+    Cfa* cyclicMain = CloneAutomaton(main, main->getName().str() + "_cyclic", &origins);
+    auto cyclic = TransformRecursiveToCyclic(cyclicMain);
+
+    // Inlined elements already point into the called automata, map the
+    // elements of the clone to the original main automaton as well.
+    for (auto& [cloned, original] : origins.locations) {
+        cyclic.inlinedLocations.try_emplace(cloned, original);
+    }
+    for (auto& [cloned, original] : origins.variables) {
+        cyclic.inlinedVariables.try_emplace(cloned, original);
+    }
+
+    std::unique_ptr<VerificationResult> result;
+
+    bool hasCalls = llvm::any_of(cyclicMain->edges(), [](Transition* edge) {
+        return llvm::isa<CallTransition>(edge);
+    });
+
+    if (hasCalls) {
+        result = VerificationResult::CreateInternalError(
+            llvm::Twine(engineName) + " does not support non-inlined procedure calls. "
+            "Use '-inline=all' to inline all procedures into the main automaton."
+        );
+    } else {
+        auto builder = CreateFoldingExprBuilder(system.getContext());
+        result = check(*cyclicMain, cyclic, *builder);
+    }
+
+    system.removeCfa(cyclicMain);
+
+    return result;
+}
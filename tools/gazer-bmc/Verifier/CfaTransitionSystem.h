@@ -0,0 +1,131 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_SRC_VERIFIER_CFATRANSITIONSYSTEM_H
+#define GAZER_SRC_VERIFIER_CFATRANSITIONSYSTEM_H
+
+#include "gazer/Automaton/Cfa.h"
+#include "gazer/Automaton/CfaTransforms.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+#include "gazer/Core/Solver/Model.h"
+#include "gazer/Verifier/VerificationAlgorithm.h"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/STLExtras.h>
+
+namespace gazer
+{
+
+/// Encodes a cyclic, call-free CFA as a symbolic transition system.
+///
+/// The state of the system is the value of a program counter, holding the
+/// identifier of the current location, and the values of the inputs and
+/// locals of the automaton. Each state variable has a copy for each step,
+/// named 'name#step'. Non-deterministic assignments use fresh havoc
+/// variables, which also get a copy in each step.
+///
+/// The error location stutters, so an error reached in fewer steps than a
+/// given bound is still visible at the bound.
+class CfaTransitionSystem
+{
+public:
+    CfaTransitionSystem(Cfa& cfa, RecursiveToCyclicResult& cyclic, ExprBuilder& builder);
+
+    CfaTransitionSystem(const CfaTransitionSystem&) = delete;
+    CfaTransitionSystem& operator=(const CfaTransitionSystem&) = delete;
+
+    Cfa& getAutomaton() const { return mCfa; }
+    Location* getErrorLocation() const { return mCyclic.errorLocation; }
+    Variable* getProgramCounter() const { return mPc; }
+    llvm::ArrayRef<Variable*> getStateVariables() const { return mStateVariables; }
+
+    /// Returns the copy of \p variable representing its value after \p step steps.
+    Variable* getCopy(Variable* variable, unsigned step);
+
+    /// Returns a formula which holds if the program counter is at \p loc after \p step steps.
+    ExprPtr atLocation(Location* loc, unsigned step);
+
+    /// Returns the initial condition over the copies of step \p step.
+    ExprPtr init(unsigned step) { return atLocation(mCfa.getEntry(), step); }
+
+    /// Returns a formula which holds if the error location is reached after \p step steps.
+    ExprPtr error(unsigned step) { return atLocation(mCyclic.errorLocation, step); }
+
+    /// Returns the transition relation T(V#step, V#step+1).
+    ExprPtr transition(unsigned step);
+
+    /// Returns the formula of \p edge over the copies of steps 0 and 1,
+    /// without constraining the program counter.
+    ExprPtr edgeTransition(Transition* edge) const { return mEdgeTransitions.lookup(edge); }
+
+    /// Returns the comparisons over integer and bit-vector values found in
+    /// the guards and assignments of the automaton, their negations, and the
+    /// non-strict versions of strict inequalities.
+    ExprVector collectComparisons();
+
+    /// Rewrites \p expr, given over the state variables of the automaton,
+    /// to their copies of step \p step.
+    ExprPtr atStep(const ExprPtr& expr, unsigned step);
+
+    /// Renames all state variable copies of step \p from in \p expr to step \p to.
+    ExprPtr renameStep(const ExprPtr& expr, unsigned from, unsigned to);
+
+    /// Builds a failure result from a model which reaches the error location
+    /// within \p bound steps. A trace is only built if \p traceBuilder is non-null.
+    std::unique_ptr<VerificationResult> createFailResult(
+        Model& model, unsigned bound, CfaTraceBuilder* traceBuilder);
+
+private:
+    void encodeTransitionRelation();
+
+private:
+    Cfa& mCfa;
+    RecursiveToCyclicResult& mCyclic;
+    ExprBuilder& mExprBuilder;
+
+    Variable* mPc = nullptr;
+    std::vector<Variable*> mStateVariables;
+    std::vector<Variable*> mHavocVariables;
+
+    llvm::DenseMap<std::pair<Variable*, unsigned>, Variable*> mCopies;
+    llvm::DenseMap<Transition*, ExprPtr> mEdgeTransitions;
+
+    /// The transition relation T(V#0, V#1).
+    ExprPtr mTransition;
+};
+
+/// Checks the main automaton of \p system with \p check, an engine working
+/// on its transition system.
+///
+/// The engine runs on a clone of the main automaton in which tail-recursive
+/// calls are turned into loops, the clone is deleted afterwards, so \p system
+/// is left unchanged. The inlined location and variable maps of the cyclic
+/// result point into the original automata, thus traces refer to them.
+/// Systems without error locations are safe, and an internal error naming
+/// \p engineName is returned if calls remain after the transformation.
+std::unique_ptr<VerificationResult> CheckCyclicMainAutomaton(
+    AutomataSystem& system,
+    llvm::StringRef engineName,
+    llvm::function_ref<
+        std::unique_ptr<VerificationResult>(Cfa&, RecursiveToCyclicResult&, ExprBuilder&)
+    > check
+);
+
+} // end namespace gazer
+
+#endif
@@ -0,0 +1,101 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "ConcurrentSolverRun.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace gazer;
+
+auto ConcurrentSolverRun::launch(Solver& solver) -> QueryId
+{
+    QueryId id = mQueries.size();
+    auto& query = mQueries.emplace_back(std::make_unique<Query>(&solver));
+
+    query->thread = std::thread([this, id, q = query.get()] {
+        auto status = q->solver->run();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        q->status = status;
+        q->done = true;
+        mFinished.push_back(id);
+        mCondition.notify_all();
+    });
+
+    return id;
+}
+
+auto ConcurrentSolverRun::waitNext() -> std::optional<std::pair<QueryId, Solver::SolverStatus>>
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (true) {
+        while (!mFinished.empty()) {
+            QueryId id = mFinished.front();
+            mFinished.pop_front();
+
+            if (!mQueries[id]->cancelled) {
+                return std::make_pair(id, mQueries[id]->status);
+            }
+        }
+
+        bool hasRunning = std::any_of(mQueries.begin(), mQueries.end(), [](auto& query) {
+            return !query->done && !query->cancelled;
+        });
+
+        if (!hasRunning) {
+            return std::nullopt;
+        }
+
+        mCondition.wait(lock);
+    }
+}
+
+void ConcurrentSolverRun::cancel(QueryId id)
+{
+    if (id == InvalidQuery) {
+        return;
+    }
+
+    Query& query = *mQueries[id];
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    query.cancelled = true;
+
+    // An interrupt is lost if it arrives before the solver started its
+    // search, so it is repeated until the worker finishes.
+    while (!query.done) {
+        query.solver->interrupt();
+        mCondition.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+void ConcurrentSolverRun::cancelAll()
+{
+    for (QueryId id = 0; id < mQueries.size(); ++id) {
+        this->cancel(id);
+    }
+}
+
+ConcurrentSolverRun::~ConcurrentSolverRun()
+{
+    this->cancelAll();
+    for (auto& query : mQueries) {
+        query->thread.join();
+    }
+}
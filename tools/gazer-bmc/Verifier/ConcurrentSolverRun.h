@@ -0,0 +1,93 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_SRC_VERIFIER_CONCURRENTSOLVERRUN_H
+#define GAZER_SRC_VERIFIER_CONCURRENTSOLVERRUN_H
+
+#include "gazer/Core/Solver/Solver.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace gazer
+{
+
+/// Runs solver queries on worker threads and reports their results in the
+/// order they finish.
+///
+/// Only Solver::run() is executed on the worker threads. As expressions are
+/// not thread-safe, constraints must be added on the calling thread, before
+/// the query is launched. Solvers must not be shared between running queries.
+class ConcurrentSolverRun
+{
+public:
+    using QueryId = unsigned;
+    static constexpr QueryId InvalidQuery = ~0u;
+
+private:
+    struct Query
+    {
+        Solver* solver;
+        std::thread thread;
+        Solver::SolverStatus status = Solver::UNKNOWN;
+        bool done = false;
+        bool cancelled = false;
+
+        explicit Query(Solver* solver)
+            : solver(solver)
+        {}
+    };
+
+public:
+    ConcurrentSolverRun() = default;
+
+    ConcurrentSolverRun(const ConcurrentSolverRun&) = delete;
+    ConcurrentSolverRun& operator=(const ConcurrentSolverRun&) = delete;
+
+    /// Starts running \p solver on a new thread.
+    QueryId launch(Solver& solver);
+
+    /// Waits until the next non-cancelled query finishes and returns its
+    /// identifier and result. Returns an empty optional if there are no
+    /// more queries to wait for.
+    std::optional<std::pair<QueryId, Solver::SolverStatus>> waitNext();
+
+    /// Interrupts the given query and waits for it to stop. The result of a
+    /// cancelled query is never reported. Cancelling an already finished or
+    /// an invalid query has no effect.
+    void cancel(QueryId id);
+
+    /// Cancels all queries which are still running.
+    void cancelAll();
+
+    ~ConcurrentSolverRun();
+
+private:
+    std::vector<std::unique_ptr<Query>> mQueries;
+    std::deque<QueryId> mFinished;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+};
+
+} // end namespace gazer
+
+#endif
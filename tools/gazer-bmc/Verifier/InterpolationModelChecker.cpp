@@ -0,0 +1,238 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Verifier/InterpolationModelChecker.h"
+#include "CfaTransitionSystem.h"
+
+#include "gazer/Core/Solver/Solver.h"
+#include "gazer/Support/Stopwatch.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+using namespace gazer;
+
+namespace
+{
+
+class InterpolationModelCheckerImpl
+{
+    struct Stats
+    {
+        std::chrono::milliseconds SolverTime{0};
+        unsigned NumInterpolants = 0;
+        unsigned NumStateVariables = 0;
+        unsigned NumTransitions = 0;
+    };
+public:
+    InterpolationModelCheckerImpl(
+        Cfa& cfa,
+        RecursiveToCyclicResult& cyclic,
+        ExprBuilder& builder,
+        std::unique_ptr<ItpSolver> itpSolver,
+        std::unique_ptr<Solver> solver,
+        CfaTraceBuilder& traceBuilder,
+        ImcSettings settings
+    );
+
+    std::unique_ptr<VerificationResult> check();
+
+    void printStats(llvm::raw_ostream& os);
+
+private:
+    Solver::SolverStatus runSolver(Solver& solver);
+
+private:
+    Cfa& mCfa;
+    CfaTransitionSystem mSystem;
+    ExprBuilder& mExprBuilder;
+    std::unique_ptr<ItpSolver> mItpSolver;
+    std::unique_ptr<Solver> mSolver;
+    CfaTraceBuilder& mTraceBuilder;
+    ImcSettings mSettings;
+
+    Stats mStats;
+    Stopwatch<> mTimer;
+};
+
+} // end anonymous namespace
+
+auto InterpolationModelChecker::check(AutomataSystem& system, CfaTraceBuilder& traceBuilder)
+    -> std::unique_ptr<VerificationResult>
+{
+    return CheckCyclicMainAutomaton(system, "Interpolation-based model checking",
+        [this, &system, &traceBuilder](Cfa& main, RecursiveToCyclicResult& cyclic, ExprBuilder& builder)
+            -> std::unique_ptr<VerificationResult>
+    {
+        auto itpSolver = mSolverFactory.createItpSolver(system.getContext());
+        if (itpSolver == nullptr) {
+            return VerificationResult::CreateInternalError(
+                "Interpolation-based model checking requires an interpolating solver."
+            );
+        }
+
+        InterpolationModelCheckerImpl impl{
+            main, cyclic, builder, std::move(itpSolver),
+            mSolverFactory.createSolver(system.getContext()), traceBuilder, mSettings
+        };
+
+        auto result = impl.check();
+
+        impl.printStats(llvm::outs());
+
+        return result;
+    });
+}
+
+InterpolationModelCheckerImpl::InterpolationModelCheckerImpl(
+    Cfa& cfa,
+    RecursiveToCyclicResult& cyclic,
+    ExprBuilder& builder,
+    std::unique_ptr<ItpSolver> itpSolver,
+    std::unique_ptr<Solver> solver,
+    CfaTraceBuilder& traceBuilder,
+    ImcSettings settings
+) : mCfa(cfa),
+    mSystem(cfa, cyclic, builder),
+    mExprBuilder(builder),
+    mItpSolver(std::move(itpSolver)),
+    mSolver(std::move(solver)),
+    mTraceBuilder(traceBuilder),
+    mSettings(settings)
+{
+    mStats.NumStateVariables = mSystem.getStateVariables().size();
+    mStats.NumTransitions = mCfa.getNumTransitions();
+}
+
+auto InterpolationModelCheckerImpl::runSolver(Solver& solver) -> Solver::SolverStatus
+{
+    mTimer.start();
+    auto status = solver.run();
+    mTimer.stop();
+
+    mStats.SolverTime += mTimer.elapsed();
+
+    return status;
+}
+
+auto InterpolationModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
+{
+    ExprPtr init = mSystem.init(0);
+
+    for (unsigned bound = 1; bound <= mSettings.maxBound; ++bound) {
+        llvm::outs() << "Bound " << bound << "\n";
+
+        // The suffix of the bounded check: an error is reachable from the
+        // post-image of the current states within 'bound - 1' steps.
+        ExprVector suffix;
+        ExprVector errors;
+        for (unsigned i = 1; i < bound; ++i) {
+            suffix.push_back(mSystem.transition(i));
+        }
+        for (unsigned i = 1; i <= bound; ++i) {
+            errors.push_back(mSystem.error(i));
+        }
+        suffix.push_back(mExprBuilder.Or(errors));
+
+        mItpSolver->reset();
+        mItpSolver->add(mExprBuilder.And(suffix));
+
+        ExprPtr reached = init;
+        for (unsigned iteration = 0; ; ++iteration) {
+            llvm::outs() << "  Iteration " << iteration << "\n";
+
+            mItpSolver->push();
+            ItpGroup prefix = mItpSolver->createItpGroup();
+            mItpSolver->add(prefix, reached);
+            mItpSolver->add(prefix, mSystem.transition(0));
+
+            auto status = this->runSolver(*mItpSolver);
+
+            if (status == Solver::SAT) {
+                if (iteration == 0) {
+                    // The states were not over-approximated yet, this is a real counterexample.
+                    llvm::outs() << "    Bounded formula is SAT.\n";
+                    auto model = mItpSolver->getModel();
+                    if (mSettings.dumpSolverModel) {
+                        model->dump(llvm::errs());
+                    }
+
+                    return mSystem.createFailResult(
+                        *model, bound, mSettings.trace ? &mTraceBuilder : nullptr
+                    );
+                }
+
+                llvm::outs() << "    Counterexample is spurious, increasing bound.\n";
+                mItpSolver->pop();
+                break;
+            }
+
+            if (status == Solver::UNKNOWN) {
+                llvm::outs() << "    Solver returned UNKNOWN.\n";
+                return VerificationResult::CreateUnknown();
+            }
+
+            ExprPtr itp = mItpSolver->getInterpolant(prefix);
+            mItpSolver->pop();
+
+            if (itp == nullptr) {
+                llvm::outs() << "    Could not compute an interpolant.\n";
+                return VerificationResult::CreateUnknown();
+            }
+            mStats.NumInterpolants++;
+
+            // The interpolant over-approximates the image of the reached
+            // states. If it adds no new states, we found an inductive invariant.
+            ExprPtr image = mSystem.renameStep(itp, 1, 0);
+
+            mSolver->reset();
+            mSolver->add(image);
+            mSolver->add(mExprBuilder.Not(reached));
+
+            status = this->runSolver(*mSolver);
+            if (status == Solver::UNSAT) {
+                llvm::outs() << "    Fixpoint reached, no errors are reachable.\n";
+                return VerificationResult::CreateSuccess();
+            }
+
+            if (status == Solver::UNKNOWN) {
+                llvm::outs() << "    Solver returned UNKNOWN.\n";
+                return VerificationResult::CreateUnknown();
+            }
+
+            reached = mExprBuilder.Or(reached, image);
+        }
+    }
+
+    llvm::outs() << "Maximum bound is reached.\n";
+    return VerificationResult::CreateBoundReached();
+}
+
+void InterpolationModelCheckerImpl::printStats(llvm::raw_ostream& os)
+{
+    os << "--------- Statistics ---------\n";
+    os << "Total solver time: ";
+    llvm::format_provider<std::chrono::milliseconds>::format(mStats.SolverTime, os, "s");
+    os << "\n";
+    os << "Number of state variables: " << mStats.NumStateVariables << "\n";
+    os << "Number of transitions: " << mStats.NumTransitions << "\n";
+    os << "Number of interpolants: " << mStats.NumInterpolants << "\n";
+    os << "------------------------------\n";
+    if (mSettings.printSolverStats) {
+        mItpSolver->printStats(os);
+    }
+    os << "\n";
+}
@@ -0,0 +1,320 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Verifier/KInductionModelChecker.h"
+#include "CfaTransitionSystem.h"
+#include "ConcurrentSolverRun.h"
+
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Solver/Solver.h"
+#include "gazer/Support/Stopwatch.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+using namespace gazer;
+
+namespace
+{
+
+class KInductionModelCheckerImpl
+{
+    struct Stats
+    {
+        std::chrono::milliseconds SolverTime{0};
+        unsigned NumStateVariables = 0;
+        unsigned NumTransitions = 0;
+        unsigned NumCandidateInvariants = 0;
+        unsigned NumInvariants = 0;
+    };
+public:
+    KInductionModelCheckerImpl(
+        Cfa& cfa,
+        RecursiveToCyclicResult& cyclic,
+        ExprBuilder& builder,
+        SolverFactory& solverFactory,
+        CfaTraceBuilder& traceBuilder,
+        KInductionSettings settings
+    );
+
+    std::unique_ptr<VerificationResult> check();
+
+    void printStats(llvm::raw_ostream& os);
+
+private:
+    /// Builds candidate invariants of the form 'pc = L -> atom' for each
+    /// location L, where atom is a comparison found in the automaton, its
+    /// negation, or the non-strict version of a strict inequality.
+    ExprVector collectCandidates();
+
+    /// Filters the candidates with the Houdini algorithm, returning the
+    /// largest subset of them which is inductive.
+    ExprVector mineInvariants();
+
+    Solver::SolverStatus runSolver(Solver& solver);
+
+private:
+    Cfa& mCfa;
+    CfaTransitionSystem mSystem;
+    ExprBuilder& mExprBuilder;
+    SolverFactory& mSolverFactory;
+    CfaTraceBuilder& mTraceBuilder;
+    KInductionSettings mSettings;
+
+    std::unique_ptr<Solver> mBaseSolver;
+    std::unique_ptr<Solver> mStepSolver;
+
+    Stats mStats;
+    Stopwatch<> mTimer;
+};
+
+} // end anonymous namespace
+
+auto KInductionModelChecker::check(AutomataSystem& system, CfaTraceBuilder& traceBuilder)
+    -> std::unique_ptr<VerificationResult>
+{
+    return CheckCyclicMainAutomaton(system, "K-induction",
+        [this, &traceBuilder](Cfa& main, RecursiveToCyclicResult& cyclic, ExprBuilder& builder)
+            -> std::unique_ptr<VerificationResult>
+    {
+        KInductionModelCheckerImpl impl{
+            main, cyclic, builder, mSolverFactory, traceBuilder, mSettings
+        };
+
+        auto result = impl.check();
+
+        impl.printStats(llvm::outs());
+
+        return result;
+    });
+}
+
+KInductionModelCheckerImpl::KInductionModelCheckerImpl(
+    Cfa& cfa,
+    RecursiveToCyclicResult& cyclic,
+    ExprBuilder& builder,
+    SolverFactory& solverFactory,
+    CfaTraceBuilder& traceBuilder,
+    KInductionSettings settings
+) : mCfa(cfa),
+    mSystem(cfa, cyclic, builder),
+    mExprBuilder(builder),
+    mSolverFactory(solverFactory),
+    mTraceBuilder(traceBuilder),
+    mSettings(settings)
+{
+    GazerContext& ctx = mCfa.getParent().getContext();
+    mBaseSolver = mSolverFactory.createSolver(ctx);
+    mStepSolver = mSolverFactory.createSolver(ctx);
+
+    mStats.NumStateVariables = mSystem.getStateVariables().size();
+    mStats.NumTransitions = mCfa.getNumTransitions();
+}
+
+auto KInductionModelCheckerImpl::runSolver(Solver& solver) -> Solver::SolverStatus
+{
+    mTimer.start();
+    auto status = solver.run();
+    mTimer.stop();
+
+    mStats.SolverTime += mTimer.elapsed();
+
+    return status;
+}
+
+ExprVector KInductionModelCheckerImpl::collectCandidates()
+{
+    ExprVector atoms = mSystem.collectComparisons();
+
+    // The candidates are trivially satisfied in the initial states, as long
+    // as they are not guarded by the entry location. As the program counter
+    // is part of the state, a loop invariant is only inductive if the
+    // locations of the loop body are constrained as well, so each location
+    // gets its own candidates.
+    ExprVector candidates;
+    ExprPtr pc = mSystem.getProgramCounter()->getRefExpr();
+    for (Location* loc : mCfa.nodes()) {
+        if (loc == mCfa.getEntry()) {
+            continue;
+        }
+
+        ExprPtr atLoc = mExprBuilder.Eq(pc, mExprBuilder.IntLit(loc->getId()));
+        for (const ExprPtr& atom : atoms) {
+            candidates.push_back(mExprBuilder.Imply(atLoc, atom));
+        }
+    }
+
+    return candidates;
+}
+
+ExprVector KInductionModelCheckerImpl::mineInvariants()
+{
+    ExprVector candidates = this->collectCandidates();
+    mStats.NumCandidateInvariants = candidates.size();
+
+    auto solver = mSolverFactory.createSolver(mCfa.getParent().getContext());
+
+    while (!candidates.empty()) {
+        ExprVector pre;
+        ExprVector post;
+        for (const ExprPtr& candidate : candidates) {
+            pre.push_back(mSystem.atStep(candidate, 0));
+            post.push_back(mSystem.atStep(candidate, 1));
+        }
+
+        solver->reset();
+        solver->add(mExprBuilder.And(pre));
+        solver->add(mSystem.transition(0));
+        solver->add(mExprBuilder.Not(mExprBuilder.And(post)));
+
+        auto status = this->runSolver(*solver);
+        if (status == Solver::UNSAT) {
+            break;
+        }
+
+        if (status == Solver::UNKNOWN) {
+            candidates.clear();
+            break;
+        }
+
+        // Drop the candidates which are violated by the model. At least one
+        // of them is, so the loop terminates.
+        auto model = solver->getModel();
+        ExprVector remaining;
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            auto value = model->evaluate(post[i]);
+            if (value != nullptr && llvm::isa<BoolLiteralExpr>(value)
+                && llvm::cast<BoolLiteralExpr>(value)->isTrue()) {
+                remaining.push_back(candidates[i]);
+            }
+        }
+
+        candidates = std::move(remaining);
+    }
+
+    mStats.NumInvariants = candidates.size();
+    return candidates;
+}
+
+auto KInductionModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
+{
+    ExprPtr invariant;
+    if (mSettings.mineInvariants) {
+        llvm::outs() << "Mining invariants.\n";
+        ExprVector invariants = this->mineInvariants();
+        if (!invariants.empty()) {
+            invariant = mExprBuilder.And(invariants);
+        }
+    }
+
+    mBaseSolver->add(mSystem.init(0));
+    if (invariant != nullptr) {
+        mStepSolver->add(mSystem.atStep(invariant, 0));
+    }
+
+    for (unsigned bound = 0; bound <= mSettings.maxBound; ++bound) {
+        llvm::outs() << "Bound " << bound << "\n";
+
+        // Base case: the error location is reachable from the initial
+        // states in 'bound' steps. As the error location stutters, this
+        // also covers shorter error paths.
+        if (bound != 0) {
+            mBaseSolver->add(mSystem.transition(bound - 1));
+        }
+        mBaseSolver->push();
+        mBaseSolver->add(mSystem.error(bound));
+
+        // Step case: an error follows 'bound + 1' consecutive non-error states.
+        mStepSolver->add(mExprBuilder.Not(mSystem.error(bound)));
+        mStepSolver->add(mSystem.transition(bound));
+        if (invariant != nullptr) {
+            mStepSolver->add(mSystem.atStep(invariant, bound + 1));
+        }
+        mStepSolver->push();
+        mStepSolver->add(mSystem.error(bound + 1));
+
+        auto baseStatus = Solver::UNKNOWN;
+        auto stepStatus = Solver::UNKNOWN;
+
+        mTimer.start();
+        {
+            ConcurrentSolverRun run;
+            auto baseQuery = run.launch(*mBaseSolver);
+            auto stepQuery = run.launch(*mStepSolver);
+
+            while (auto next = run.waitNext()) {
+                if (next->first == baseQuery) {
+                    baseStatus = next->second;
+                    if (baseStatus == Solver::SAT) {
+                        // The step case does not matter anymore.
+                        run.cancel(stepQuery);
+                    }
+                } else {
+                    stepStatus = next->second;
+                }
+            }
+        }
+        mTimer.stop();
+        mStats.SolverTime += mTimer.elapsed();
+
+        if (baseStatus == Solver::SAT) {
+            llvm::outs() << "  Base case is SAT, the error location is reachable.\n";
+            auto model = mBaseSolver->getModel();
+            if (mSettings.dumpSolverModel) {
+                model->dump(llvm::errs());
+            }
+
+            return mSystem.createFailResult(
+                *model, bound, mSettings.trace ? &mTraceBuilder : nullptr
+            );
+        }
+
+        if (baseStatus == Solver::UNKNOWN) {
+            llvm::outs() << "  Solver returned UNKNOWN for the base case.\n";
+            return VerificationResult::CreateUnknown();
+        }
+
+        if (stepStatus == Solver::UNSAT) {
+            llvm::outs() << "  Step case is UNSAT, the program is " << bound + 1 << "-inductive.\n";
+            return VerificationResult::CreateSuccess();
+        }
+
+        mBaseSolver->pop();
+        mStepSolver->pop();
+    }
+
+    llvm::outs() << "Maximum bound is reached.\n";
+    return VerificationResult::CreateBoundReached();
+}
+
+void KInductionModelCheckerImpl::printStats(llvm::raw_ostream& os)
+{
+    os << "--------- Statistics ---------\n";
+    os << "Total solver time: ";
+    llvm::format_provider<std::chrono::milliseconds>::format(mStats.SolverTime, os, "s");
+    os << "\n";
+    os << "Number of state variables: " << mStats.NumStateVariables << "\n";
+    os << "Number of transitions: " << mStats.NumTransitions << "\n";
+    os << "Number of candidate invariants: " << mStats.NumCandidateInvariants << "\n";
+    os << "Number of invariants: " << mStats.NumInvariants << "\n";
+    os << "------------------------------\n";
+    if (mSettings.printSolverStats) {
+        mBaseSolver->printStats(os);
+        mStepSolver->printStats(os);
+    }
+    os << "\n";
+}
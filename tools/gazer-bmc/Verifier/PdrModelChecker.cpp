@@ -0,0 +1,623 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Verifier/PdrModelChecker.h"
+#include "CfaTransitionSystem.h"
+
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Solver/Solver.h"
+#include "gazer/Support/Stopwatch.h"
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <iterator>
+#include <queue>
+
+using namespace gazer;
+
+namespace
+{
+
+class PdrModelCheckerImpl
+{
+    struct Stats
+    {
+        std::chrono::milliseconds SolverTime{0};
+        unsigned NumStateVariables = 0;
+        unsigned NumTransitions = 0;
+        unsigned NumFrames = 0;
+        unsigned NumLemmas = 0;
+        unsigned NumObligations = 0;
+        unsigned NumQueries = 0;
+    };
+
+    /// A lemma excluding the states of a cube at a location. Cubes are given
+    /// over the variable copies of step 0. The lemma is stored in the highest
+    /// frame in which it is known to hold, and it also holds in all previous
+    /// frames.
+    struct Lemma
+    {
+        Location* loc;
+        ExprVector cube;
+    };
+
+    /// A proof obligation: the states of the cube at the location must be
+    /// shown unreachable within 'level' steps.
+    struct Obligation
+    {
+        Location* loc;
+        ExprVector cube;
+        unsigned level;
+
+        /// The index of the obligation this one is a predecessor of, or -1
+        /// for the error location.
+        int successor;
+    };
+
+    enum class BlockResult { Blocked, Counterexample, Unknown };
+public:
+    PdrModelCheckerImpl(
+        Cfa& cfa,
+        RecursiveToCyclicResult& cyclic,
+        ExprBuilder& builder,
+        SolverFactory& solverFactory,
+        CfaTraceBuilder& traceBuilder,
+        PdrSettings settings
+    );
+
+    std::unique_ptr<VerificationResult> check();
+
+    void printStats(llvm::raw_ostream& os);
+
+private:
+    /// Blocks the error location in frame \p bound, recursively blocking
+    /// the predecessors of the obligations in earlier frames.
+    BlockResult blockError(unsigned bound);
+
+    /// Pushes the lemmas of frames 1..bound forward where possible.
+    /// Returns true if two consecutive frames became equal.
+    bool propagate(unsigned bound);
+
+    /// Checks whether a state in \p cube at the target of \p edge has a
+    /// predecessor along \p edge in frame \p level. If the query is SAT and
+    /// \p predecessor is non-null, the predecessor cube is stored in it. If
+    /// the query is UNSAT and \p core is non-null, the indices of the cube
+    /// literals in the unsat core are inserted into it.
+    Solver::SolverStatus query(
+        Transition* edge, unsigned level, const ExprVector& cube,
+        ExprVector* predecessor, llvm::DenseSet<unsigned>* core
+    );
+
+    /// Returns true if no state of \p cube at \p loc is in frame \p level,
+    /// that is, it has no predecessor in frame \p level - 1. The indices of
+    /// the literals needed for this are inserted into \p core if it is non-null.
+    bool isBlocked(Location* loc, const ExprVector& cube, unsigned level, llvm::DenseSet<unsigned>* core);
+
+    /// Generalizes \p cube, which is blocked at \p loc in frame \p level
+    /// using the literals in \p core. The comparisons of the program are
+    /// preferred over variable bounds, then the literals are dropped one by
+    /// one as long as the remaining cube is still blocked.
+    ExprVector generalize(
+        Location* loc, const ExprVector& cube, const llvm::DenseSet<unsigned>& core, unsigned level);
+
+    /// Builds a cube describing the step 0 state of \p model.
+    ExprVector extractCube(Model& model);
+
+    void addLemma(Location* loc, ExprVector cube, unsigned level);
+
+    ExprPtr getClause(const ExprVector& cube);
+
+    Variable* getFrameActivation(Location* loc, unsigned level);
+    Variable* createBoolVariable(llvm::StringRef prefix);
+
+    std::unique_ptr<VerificationResult> createFailResult(llvm::ArrayRef<Location*> path);
+
+private:
+    Cfa& mCfa;
+    CfaTransitionSystem mSystem;
+    ExprBuilder& mExprBuilder;
+    SolverFactory& mSolverFactory;
+    CfaTraceBuilder& mTraceBuilder;
+    PdrSettings mSettings;
+
+    std::unique_ptr<Solver> mSolver;
+
+    /// The lemmas of each frame. Frame 0 is the set of initial states, it
+    /// is not stored explicitly.
+    std::vector<std::vector<Lemma>> mFrames;
+
+    llvm::DenseMap<Transition*, Variable*> mEdgeActivations;
+    llvm::DenseMap<std::pair<Location*, unsigned>, Variable*> mFrameActivations;
+    std::vector<Variable*> mIndicators;
+
+    /// Program comparisons and their negations, over the variables of step 0.
+    ExprVector mAtoms;
+    ExprVector mNegatedAtoms;
+    llvm::DenseSet<Expr*> mAtomLiterals;
+
+    /// The locations of the counterexample found by the last blockError() call.
+    std::vector<Location*> mCounterexample;
+
+    Stats mStats;
+    Stopwatch<> mTimer;
+};
+
+} // end anonymous namespace
+
+auto PdrModelChecker::check(AutomataSystem& system, CfaTraceBuilder& traceBuilder)
+    -> std::unique_ptr<VerificationResult>
+{
+    return CheckCyclicMainAutomaton(system, "PDR",
+        [this, &traceBuilder](Cfa& main, RecursiveToCyclicResult& cyclic, ExprBuilder& builder)
+            -> std::unique_ptr<VerificationResult>
+    {
+        PdrModelCheckerImpl impl{
+            main, cyclic, builder, mSolverFactory, traceBuilder, mSettings
+        };
+
+        auto result = impl.check();
+
+        impl.printStats(llvm::outs());
+
+        return result;
+    });
+}
+
+PdrModelCheckerImpl::PdrModelCheckerImpl(
+    Cfa& cfa,
+    RecursiveToCyclicResult& cyclic,
+    ExprBuilder& builder,
+    SolverFactory& solverFactory,
+    CfaTraceBuilder& traceBuilder,
+    PdrSettings settings
+) : mCfa(cfa),
+    mSystem(cfa, cyclic, builder),
+    mExprBuilder(builder),
+    mSolverFactory(solverFactory),
+    mTraceBuilder(traceBuilder),
+    mSettings(settings)
+{
+    mSolver = mSolverFactory.createSolver(mCfa.getParent().getContext());
+
+    // Each edge is only enabled in the queries which assume its activation
+    // variable.
+    for (Transition* edge : mCfa.edges()) {
+        Variable* act = createBoolVariable("__gazer_pdr_edge");
+        mEdgeActivations[edge] = act;
+        mSolver->add(mExprBuilder.Imply(act->getRefExpr(), mSystem.edgeTransition(edge)));
+    }
+
+    for (const ExprPtr& atom : mSystem.collectComparisons()) {
+        ExprPtr atomAtZero = mSystem.atStep(atom, 0);
+        mAtoms.push_back(atomAtZero);
+        mNegatedAtoms.push_back(mExprBuilder.Not(atomAtZero));
+        mAtomLiterals.insert(mAtoms.back().get());
+        mAtomLiterals.insert(mNegatedAtoms.back().get());
+    }
+
+    mStats.NumStateVariables = mSystem.getStateVariables().size();
+    mStats.NumTransitions = mCfa.getNumTransitions();
+}
+
+Variable* PdrModelCheckerImpl::createBoolVariable(llvm::StringRef prefix)
+{
+    // Fresh variables cannot clash with program variables or with the
+    // literals of another PDR run in the same context.
+    GazerContext& ctx = mCfa.getParent().getContext();
+    return ctx.createFreshVariable(prefix, BoolType::Get(ctx));
+}
+
+Variable* PdrModelCheckerImpl::getFrameActivation(Location* loc, unsigned level)
+{
+    auto& act = mFrameActivations[{loc, level}];
+    if (act == nullptr) {
+        act = createBoolVariable("__gazer_pdr_frame");
+    }
+
+    return act;
+}
+
+ExprPtr PdrModelCheckerImpl::getClause(const ExprVector& cube)
+{
+    if (cube.empty()) {
+        return mExprBuilder.False();
+    }
+
+    return mExprBuilder.Not(mExprBuilder.And(cube));
+}
+
+void PdrModelCheckerImpl::addLemma(Location* loc, ExprVector cube, unsigned level)
+{
+    mSolver->add(mExprBuilder.Imply(
+        getFrameActivation(loc, level)->getRefExpr(),
+        getClause(cube)
+    ));
+
+    mFrames[level].push_back({loc, std::move(cube)});
+    mStats.NumLemmas++;
+}
+
+auto PdrModelCheckerImpl::query(
+    Transition* edge, unsigned level, const ExprVector& cube,
+    ExprVector* predecessor, llvm::DenseSet<unsigned>* core
+) -> Solver::SolverStatus
+{
+    Location* source = edge->getSource();
+    assert((level != 0 || source == mCfa.getEntry())
+        && "Only the entry location is present in the initial frame!");
+
+    ExprVector assumptions;
+    assumptions.push_back(mEdgeActivations[edge]->getRefExpr());
+
+    // The entry location is unconstrained in every frame, as all of its
+    // states are initial.
+    if (source != mCfa.getEntry()) {
+        for (unsigned j = level; j < mFrames.size(); ++j) {
+            assumptions.push_back(getFrameActivation(source, j)->getRefExpr());
+        }
+    }
+
+    mSolver->push();
+
+    // Each literal of the cube is guarded by an indicator variable, so the
+    // unsat core tells which literals were needed to block the cube.
+    llvm::DenseMap<Expr*, unsigned> indicatorIdx;
+    for (unsigned i = 0; i < cube.size(); ++i) {
+        if (i == mIndicators.size()) {
+            mIndicators.push_back(createBoolVariable("__gazer_pdr_lit"));
+        }
+
+        ExprPtr indicator = mIndicators[i]->getRefExpr();
+        mSolver->add(mExprBuilder.Imply(indicator, mSystem.renameStep(cube[i], 0, 1)));
+        assumptions.push_back(indicator);
+        indicatorIdx[indicator.get()] = i;
+    }
+
+    // Self loops are checked relative to the cube itself: the first state
+    // of the cube reached at this location must come from outside of it.
+    if (source == edge->getTarget() && !cube.empty()) {
+        mSolver->add(getClause(cube));
+    }
+
+    mTimer.start();
+    auto status = mSolver->run(assumptions);
+    mTimer.stop();
+
+    mStats.SolverTime += mTimer.elapsed();
+    mStats.NumQueries++;
+
+    if (status == Solver::SAT && predecessor != nullptr) {
+        auto model = mSolver->getModel();
+        *predecessor = this->extractCube(*model);
+    } else if (status == Solver::UNSAT && core != nullptr) {
+        for (const ExprPtr& expr : mSolver->getUnsatCore()) {
+            auto it = indicatorIdx.find(expr.get());
+            if (it != indicatorIdx.end()) {
+                core->insert(it->second);
+            }
+        }
+    }
+
+    mSolver->pop();
+
+    return status;
+}
+
+ExprVector PdrModelCheckerImpl::extractCube(Model& model)
+{
+    ExprVector cube;
+
+    // Bound each variable from both sides, so the generalization may keep
+    // only one of the bounds.
+    for (Variable* variable : mSystem.getStateVariables()) {
+        if (variable == mSystem.getProgramCounter()) {
+            continue;
+        }
+
+        ExprPtr copy = mSystem.getCopy(variable, 0)->getRefExpr();
+        ExprRef<AtomicExpr> value = model.evaluate(copy);
+        if (value == nullptr || value->isUndef()) {
+            // The value of the variable does not matter.
+            continue;
+        }
+
+        switch (variable->getType().getTypeID()) {
+            case Type::BoolTypeID:
+                cube.push_back(llvm::cast<BoolLiteralExpr>(value)->isTrue() ? copy : mExprBuilder.Not(copy));
+                break;
+            case Type::IntTypeID:
+                cube.push_back(mExprBuilder.GtEq(copy, value));
+                cube.push_back(mExprBuilder.LtEq(copy, value));
+                break;
+            case Type::BvTypeID:
+                cube.push_back(mExprBuilder.BvSGtEq(copy, value));
+                cube.push_back(mExprBuilder.BvSLtEq(copy, value));
+                break;
+            default:
+                cube.push_back(mExprBuilder.Eq(copy, value));
+                break;
+        }
+    }
+
+    // The comparisons of the program (or their negations) which hold in
+    // this state are implied by the bounds above, but they generalize much
+    // better.
+    llvm::DenseSet<Expr*> seen;
+    for (unsigned i = 0; i < mAtoms.size(); ++i) {
+        auto value = model.evaluate(mAtoms[i]);
+        if (value == nullptr || !llvm::isa<BoolLiteralExpr>(value)) {
+            continue;
+        }
+
+        const ExprPtr& literal = llvm::cast<BoolLiteralExpr>(value)->isTrue() ? mAtoms[i] : mNegatedAtoms[i];
+        if (seen.insert(literal.get()).second) {
+            cube.push_back(literal);
+        }
+    }
+
+    return cube;
+}
+
+auto PdrModelCheckerImpl::blockError(unsigned bound) -> BlockResult
+{
+    std::vector<Obligation> obligations;
+
+    // Obligations of lower levels are processed first.
+    using QueueEntry = std::pair<unsigned, unsigned>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+    obligations.push_back({mSystem.getErrorLocation(), {}, bound, -1});
+    queue.push({bound, 0});
+
+    while (!queue.empty()) {
+        auto [level, idx] = queue.top();
+        Location* loc = obligations[idx].loc;
+        mStats.NumObligations++;
+
+        llvm::DenseSet<unsigned> core;
+        bool hasPredecessor = false;
+
+        for (Transition* edge : loc->incoming()) {
+            Location* source = edge->getSource();
+            if (level == 1 && source != mCfa.getEntry()) {
+                continue;
+            }
+
+            ExprVector predecessor;
+            auto status = this->query(edge, level - 1, obligations[idx].cube, &predecessor, &core);
+
+            if (status == Solver::UNKNOWN) {
+                return BlockResult::Unknown;
+            }
+
+            if (status == Solver::SAT) {
+                if (source == mCfa.getEntry()) {
+                    // Every state of the entry location is initial.
+                    mCounterexample.clear();
+                    mCounterexample.push_back(source);
+                    for (int i = idx; i != -1; i = obligations[i].successor) {
+                        mCounterexample.push_back(obligations[i].loc);
+                    }
+
+                    return BlockResult::Counterexample;
+                }
+
+                obligations.push_back({source, std::move(predecessor), level - 1, static_cast<int>(idx)});
+                queue.push({level - 1, obligations.size() - 1});
+                hasPredecessor = true;
+                break;
+            }
+        }
+
+        if (hasPredecessor) {
+            continue;
+        }
+
+        // The cube is blocked on all incoming edges.
+        queue.pop();
+        this->addLemma(loc, this->generalize(loc, obligations[idx].cube, core, level), level);
+
+        // Try to block the same states in the next frames as well.
+        if (level < bound) {
+            obligations[idx].level = level + 1;
+            queue.push({level + 1, idx});
+        }
+    }
+
+    return BlockResult::Blocked;
+}
+
+bool PdrModelCheckerImpl::isBlocked(
+    Location* loc, const ExprVector& cube, unsigned level, llvm::DenseSet<unsigned>* core)
+{
+    for (Transition* edge : loc->incoming()) {
+        if (level == 1 && edge->getSource() != mCfa.getEntry()) {
+            continue;
+        }
+
+        if (this->query(edge, level - 1, cube, nullptr, core) != Solver::UNSAT) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static ExprVector filterCube(const ExprVector& cube, const llvm::DenseSet<unsigned>& core)
+{
+    ExprVector result;
+    for (unsigned i = 0; i < cube.size(); ++i) {
+        if (core.count(i) != 0) {
+            result.push_back(cube[i]);
+        }
+    }
+
+    return result;
+}
+
+ExprVector PdrModelCheckerImpl::generalize(
+    Location* loc, const ExprVector& cube, const llvm::DenseSet<unsigned>& core, unsigned level)
+{
+    // The unsat core of the blocking query may keep the variable bounds
+    // instead of the comparisons which imply them. The comparisons are
+    // relational, so they describe whole sets of states, try them alone first.
+    ExprVector atoms;
+    std::copy_if(cube.begin(), cube.end(), std::back_inserter(atoms), [this](const ExprPtr& literal) {
+        return mAtomLiterals.count(literal.get()) != 0;
+    });
+
+    ExprVector result;
+    llvm::DenseSet<unsigned> atomCore;
+    if (atoms.size() < cube.size() && this->isBlocked(loc, atoms, level, &atomCore)) {
+        result = filterCube(atoms, atomCore);
+    } else {
+        result = filterCube(cube, core);
+    }
+
+    unsigned i = 0;
+    while (i < result.size()) {
+        ExprVector candidate;
+        candidate.reserve(result.size() - 1);
+        for (unsigned j = 0; j < result.size(); ++j) {
+            if (j != i) {
+                candidate.push_back(result[j]);
+            }
+        }
+
+        llvm::DenseSet<unsigned> candidateCore;
+        if (!this->isBlocked(loc, candidate, level, &candidateCore)) {
+            ++i;
+            continue;
+        }
+
+        result = filterCube(candidate, candidateCore);
+        i = std::min<unsigned>(i, result.size());
+    }
+
+    return result;
+}
+
+bool PdrModelCheckerImpl::propagate(unsigned bound)
+{
+    for (unsigned k = 1; k <= bound; ++k) {
+        std::vector<Lemma> remaining;
+        for (Lemma& lemma : mFrames[k]) {
+            if (this->isBlocked(lemma.loc, lemma.cube, k + 1, nullptr)) {
+                mSolver->add(mExprBuilder.Imply(
+                    getFrameActivation(lemma.loc, k + 1)->getRefExpr(),
+                    getClause(lemma.cube)
+                ));
+                mFrames[k + 1].push_back(std::move(lemma));
+            } else {
+                remaining.push_back(std::move(lemma));
+            }
+        }
+
+        mFrames[k] = std::move(remaining);
+
+        if (mFrames[k].empty()) {
+            llvm::outs() << "  Frames " << k << " and " << k + 1 << " are equal.\n";
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto PdrModelCheckerImpl::createFailResult(llvm::ArrayRef<Location*> path)
+    -> std::unique_ptr<VerificationResult>
+{
+    // Find concrete values for the location path found by the algorithm.
+    auto solver = mSolverFactory.createSolver(mCfa.getParent().getContext());
+    unsigned bound = path.size() - 1;
+
+    for (unsigned i = 0; i <= bound; ++i) {
+        solver->add(mSystem.atLocation(path[i], i));
+        if (i != bound) {
+            solver->add(mSystem.transition(i));
+        }
+    }
+
+    mTimer.start();
+    auto status = solver->run();
+    mTimer.stop();
+    mStats.SolverTime += mTimer.elapsed();
+
+    if (status != Solver::SAT) {
+        llvm::outs() << "  Could not reproduce the counterexample.\n";
+        return VerificationResult::CreateUnknown();
+    }
+
+    auto model = solver->getModel();
+    if (mSettings.dumpSolverModel) {
+        model->dump(llvm::errs());
+    }
+
+    return mSystem.createFailResult(*model, bound, mSettings.trace ? &mTraceBuilder : nullptr);
+}
+
+auto PdrModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
+{
+    mFrames.resize(2);
+
+    for (unsigned bound = 1; bound <= mSettings.maxBound; ++bound) {
+        llvm::outs() << "Frame " << bound << "\n";
+        mStats.NumFrames = bound;
+        mFrames.resize(bound + 2);
+
+        auto result = this->blockError(bound);
+        if (result == BlockResult::Counterexample) {
+            llvm::outs() << "  Found a counterexample of length " << mCounterexample.size() - 1 << ".\n";
+            return this->createFailResult(mCounterexample);
+        }
+
+        if (result == BlockResult::Unknown) {
+            llvm::outs() << "  Solver returned UNKNOWN.\n";
+            return VerificationResult::CreateUnknown();
+        }
+
+        if (this->propagate(bound)) {
+            return VerificationResult::CreateSuccess();
+        }
+    }
+
+    llvm::outs() << "Maximum bound is reached.\n";
+    return VerificationResult::CreateBoundReached();
+}
+
+void PdrModelCheckerImpl::printStats(llvm::raw_ostream& os)
+{
+    os << "--------- Statistics ---------\n";
+    os << "Total solver time: ";
+    llvm::format_provider<std::chrono::milliseconds>::format(mStats.SolverTime, os, "s");
+    os << "\n";
+    os << "Number of state variables: " << mStats.NumStateVariables << "\n";
+    os << "Number of transitions: " << mStats.NumTransitions << "\n";
+    os << "Number of frames: " << mStats.NumFrames << "\n";
+    os << "Number of lemmas: " << mStats.NumLemmas << "\n";
+    os << "Number of proof obligations: " << mStats.NumObligations << "\n";
+    os << "Number of solver queries: " << mStats.NumQueries << "\n";
+    os << "------------------------------\n";
+    if (mSettings.printSolverStats) {
+        mSolver->printStats(os);
+    }
+    os << "\n";
+}
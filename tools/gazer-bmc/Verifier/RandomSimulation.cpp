@@ -0,0 +1,587 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Verifier/RandomSimulation.h"
+#include "gazer/Automaton/Cfa.h"
+#include "gazer/JIT/ExprCompiler.h"
+#include "gazer/Support/Stopwatch.h"
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace gazer;
+
+namespace
+{
+
+using CompiledExpr = ExprCompiler::CompiledExpr;
+
+/// A small and fast seedable random number generator (SplitMix64).
+/// Each run is driven by its own seed, so runs can be replayed exactly.
+class SimulationRng
+{
+public:
+    explicit SimulationRng(uint64_t seed)
+        : mState(seed)
+    {}
+
+    uint64_t next()
+    {
+        uint64_t z = (mState += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31U);
+    }
+
+    uint64_t below(uint64_t bound) { return next() % bound; }
+
+private:
+    uint64_t mState;
+};
+
+struct SimAssignment
+{
+    Variable* variable;
+    Type* type;
+    unsigned slot;
+
+    /// The assigned value, or nullptr for nondeterministic values.
+    const CompiledExpr* value;
+};
+
+struct SimEdge
+{
+    Transition* edge;
+    const CompiledExpr* guard;
+
+    /// The assignments of an assign transition, or the input assignments
+    /// of a call, which are evaluated in the caller and assign the callee.
+    std::vector<SimAssignment> assignments;
+
+    /// The output assignments of a call, which are evaluated in the callee
+    /// and assign the caller.
+    std::vector<SimAssignment> outputs;
+
+    Cfa* callee = nullptr;
+};
+
+struct SimLocation
+{
+    std::vector<const SimEdge*> outgoing;
+
+    /// The error code expression of error locations.
+    const CompiledExpr* errorCode = nullptr;
+};
+
+/// The compiled form of an automata system. Worker threads only access this
+/// read-only representation: they never touch expressions, as reference
+/// counting and the creation of literals are not thread-safe.
+class SimulationProgram
+{
+public:
+    explicit SimulationProgram(ExprCompiler& compiler)
+        : mCompiler(compiler)
+    {}
+
+    /// Compiles the system. Returns false if the system contains expressions
+    /// or values which cannot be compiled.
+    bool build(AutomataSystem& system);
+
+    const SimLocation& getLocation(Location* loc) const
+    {
+        auto it = mLocations.find(loc);
+        assert(it != mLocations.end() && "Every location must be compiled!");
+        return it->second;
+    }
+
+    /// Returns the slots (and types) of the variables of \p cfa.
+    llvm::ArrayRef<std::pair<unsigned, Type*>> getVariables(Cfa* cfa) const
+    {
+        auto it = mVariables.find(cfa);
+        assert(it != mVariables.end() && "Every automaton must be compiled!");
+        return it->second;
+    }
+
+    unsigned getNumSlots() const { return mCompiler.getNumSlots(); }
+
+private:
+    ExprCompiler& mCompiler;
+    llvm::DenseMap<Location*, SimLocation> mLocations;
+    llvm::DenseMap<Cfa*, std::vector<std::pair<unsigned, Type*>>> mVariables;
+    std::vector<std::unique_ptr<SimEdge>> mEdges;
+};
+
+struct SimulationTrace
+{
+    std::vector<Location*> states;
+    std::vector<std::vector<std::pair<Variable*, uint64_t>>> actions;
+};
+
+/// Executes runs of a compiled system. Each thread has its own instance.
+class SimulationRun
+{
+    struct Frame
+    {
+        Cfa* cfa;
+        const SimEdge* call;
+        std::vector<uint64_t> values;
+    };
+
+public:
+    SimulationRun(const SimulationProgram& program, Cfa* main, unsigned maxSteps)
+        : mProgram(program), mMain(main), mMaxSteps(maxSteps)
+    {}
+
+    /// Executes a single run, driven by \p seed. Returns true if an error
+    /// location was reached. If \p trace is not null, the states and
+    /// actions of the run are recorded into it.
+    bool run(uint64_t seed, SimulationTrace* trace);
+
+    uint64_t getErrorCode() const { return mErrorCode; }
+    uint64_t getNumSteps() const { return mNumSteps; }
+
+private:
+    Frame& pushFrame(Cfa* cfa, const SimEdge* call, SimulationRng& rng);
+
+    static uint64_t randomValue(Type& type, SimulationRng& rng);
+
+private:
+    const SimulationProgram& mProgram;
+    Cfa* mMain;
+    unsigned mMaxSteps;
+
+    // Frames are reused between runs to avoid reallocating their buffers.
+    std::vector<Frame> mFrames;
+    size_t mDepth = 0;
+
+    std::vector<const SimEdge*> mEnabled;
+    std::vector<uint64_t> mInputs;
+
+    uint64_t mErrorCode = 0;
+    uint64_t mNumSteps = 0;
+};
+
+} // end anonymous namespace
+
+bool SimulationProgram::build(AutomataSystem& system)
+{
+    for (Cfa& cfa : system) {
+        auto& variables = mVariables[&cfa];
+        auto addVariables = [&](auto range) {
+            for (Variable& variable : range) {
+                variables.emplace_back(mCompiler.getSlot(&variable), &variable.getType());
+            }
+        };
+
+        addVariables(cfa.inputs());
+        addVariables(cfa.locals());
+        addVariables(cfa.outputs());
+
+        for (auto& [slot, type] : variables) {
+            // Arrays are read through callbacks which create literals,
+            // they cannot be used concurrently.
+            if (!ExprCompiler::isSupportedType(*type) || type->isArrayType()) {
+                return false;
+            }
+        }
+    }
+
+    // Collect all expressions of the system, to compile them in one batch.
+    std::vector<ExprPtr> exprs;
+    auto addAssignments = [&exprs](const auto& range) {
+        for (const VariableAssignment& assign : range) {
+            if (assign.getValue()->getKind() != Expr::Undef) {
+                exprs.push_back(assign.getValue());
+            }
+        }
+    };
+
+    for (Cfa& cfa : system) {
+        for (Transition* edge : cfa.edges()) {
+            exprs.push_back(edge->getGuard());
+            if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+                addAssignments(*assign);
+            } else if (auto call = llvm::dyn_cast<CallTransition>(edge)) {
+                addAssignments(call->inputs());
+                addAssignments(call->outputs());
+            }
+        }
+
+        for (auto& [loc, errorCode] : cfa.errors()) {
+            exprs.push_back(errorCode);
+        }
+    }
+
+    auto compiled = mCompiler.compile(exprs);
+    if (std::find(compiled.begin(), compiled.end(), nullptr) != compiled.end()) {
+        return false;
+    }
+
+    // The compiled expressions are cached, look them up in the same order.
+    auto getCompiled = [this](const ExprPtr& expr) -> const CompiledExpr* {
+        if (expr->getKind() == Expr::Undef) {
+            return nullptr;
+        }
+        return mCompiler.compile(expr);
+    };
+
+    auto toSimAssignments = [&](const auto& range, std::vector<SimAssignment>& result) {
+        for (const VariableAssignment& assign : range) {
+            Variable* variable = assign.getVariable();
+            result.push_back({
+                variable, &variable->getType(), mCompiler.getSlot(variable), getCompiled(assign.getValue())
+            });
+        }
+    };
+
+    for (Cfa& cfa : system) {
+        for (Location* loc : cfa.nodes()) {
+            mLocations[loc];
+        }
+
+        for (auto& [loc, errorCode] : cfa.errors()) {
+            auto& simLoc = mLocations[loc];
+            simLoc.errorCode = getCompiled(errorCode);
+        }
+
+        for (Transition* edge : cfa.edges()) {
+            auto simEdge = std::make_unique<SimEdge>();
+            simEdge->edge = edge;
+            simEdge->guard = getCompiled(edge->getGuard());
+
+            if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+                toSimAssignments(*assign, simEdge->assignments);
+            } else if (auto call = llvm::dyn_cast<CallTransition>(edge)) {
+                simEdge->callee = call->getCalledAutomaton();
+                toSimAssignments(call->inputs(), simEdge->assignments);
+                toSimAssignments(call->outputs(), simEdge->outputs);
+            }
+
+            mLocations[edge->getSource()].outgoing.push_back(simEdge.get());
+            mEdges.emplace_back(std::move(simEdge));
+        }
+    }
+
+    return true;
+}
+
+uint64_t SimulationRun::randomValue(Type& type, SimulationRng& rng)
+{
+    // Prefer boundary values, as these are the most likely to trigger bugs.
+    uint64_t choice = rng.below(8);
+
+    switch (type.getTypeID()) {
+        case Type::BoolTypeID:
+            return rng.next() & 1U;
+        case Type::BvTypeID: {
+            unsigned width = llvm::cast<BvType>(type).getWidth();
+            uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+            switch (choice) {
+                case 0: return 0;
+                case 1: return 1;
+                case 2: return mask;
+                case 3: return 1ULL << (width - 1);
+                case 4: return mask >> 1U;
+                case 5: return rng.below(16) & mask;
+                default: return rng.next() & mask;
+            }
+        }
+        case Type::IntTypeID: {
+            // Mathematical integers are evaluated in 64 bits, and results
+            // which overflow are undefined, so they never lead to an error.
+            // Stay far from the limits, so that few runs are cut short.
+            switch (choice) {
+                case 0: return 0;
+                case 1: return 1;
+                case 2: return static_cast<uint64_t>(-1);
+                case 3: return static_cast<uint64_t>(static_cast<int64_t>(rng.below(33)) - 16);
+                default: return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(rng.next())));
+            }
+        }
+        case Type::FloatTypeID: {
+            bool isSingle = llvm::cast<FloatType>(type).getPrecision() == FloatType::Single;
+            static constexpr uint64_t SingleValues[] = {
+                0x00000000, 0x3F800000, 0xBF800000, 0x7F800000, 0xFF800000, 0x7FC00000
+            };
+            static constexpr uint64_t DoubleValues[] = {
+                0x0000000000000000, 0x3FF0000000000000, 0xBFF0000000000000,
+                0x7FF0000000000000, 0xFFF0000000000000, 0x7FF8000000000000
+            };
+            if (choice < 6) {
+                return isSingle ? SingleValues[choice] : DoubleValues[choice];
+            }
+            return isSingle ? (rng.next() & 0xFFFFFFFFULL) : rng.next();
+        }
+        default:
+            llvm_unreachable("Unsupported types must be rejected before simulation!");
+    }
+}
+
+auto SimulationRun::pushFrame(Cfa* cfa, const SimEdge* call, SimulationRng& rng) -> Frame&
+{
+    if (mDepth == mFrames.size()) {
+        mFrames.emplace_back();
+        mFrames.back().values.resize(mProgram.getNumSlots());
+    }
+
+    Frame& frame = mFrames[mDepth++];
+    frame.cfa = cfa;
+    frame.call = call;
+
+    // Uninitialized variables may hold any value.
+    for (auto& [slot, type] : mProgram.getVariables(cfa)) {
+        frame.values[slot] = randomValue(*type, rng);
+    }
+
+    return frame;
+}
+
+bool SimulationRun::run(uint64_t seed, SimulationTrace* trace)
+{
+    SimulationRng rng(seed);
+    mDepth = 0;
+
+    auto record = [trace](Variable* variable, uint64_t value) {
+        if (trace != nullptr) {
+            trace->actions.back().emplace_back(variable, value);
+        }
+    };
+
+    this->pushFrame(mMain, nullptr, rng);
+    Location* loc = mMain->getEntry();
+
+    for (unsigned step = 0; step < mMaxSteps; ++step) {
+        Frame* frame = &mFrames[mDepth - 1];
+        const SimLocation& simLoc = mProgram.getLocation(loc);
+
+        if (trace != nullptr) {
+            trace->states.push_back(loc);
+        }
+
+        if (loc->isError()) {
+            return simLoc.errorCode->run(frame->values.data(), &mErrorCode);
+        }
+
+        ++mNumSteps;
+
+        if (trace != nullptr) {
+            trace->actions.emplace_back();
+        }
+
+        if (loc == frame->cfa->getExit()) {
+            if (mDepth == 1) {
+                // The main automaton has returned without reaching an error.
+                return false;
+            }
+
+            const SimEdge* call = frame->call;
+            Frame& caller = mFrames[mDepth - 2];
+            for (const SimAssignment& output : call->outputs) {
+                uint64_t value;
+                if (!output.value->run(frame->values.data(), &value)) {
+                    return false;
+                }
+                caller.values[output.slot] = value;
+                record(output.variable, value);
+            }
+
+            --mDepth;
+            loc = call->edge->getTarget();
+            continue;
+        }
+
+        mEnabled.clear();
+        for (const SimEdge* edge : simLoc.outgoing) {
+            uint64_t enabled;
+            if (edge->guard->run(frame->values.data(), &enabled) && enabled != 0) {
+                mEnabled.push_back(edge);
+            }
+        }
+
+        if (mEnabled.empty()) {
+            // The run is blocked by an assumption.
+            return false;
+        }
+
+        const SimEdge* edge = mEnabled.size() == 1 ? mEnabled[0] : mEnabled[rng.below(mEnabled.size())];
+
+        if (edge->callee == nullptr) {
+            // Assignments are sequential: each assignment sees the values
+            // written by the previous ones.
+            for (const SimAssignment& assign : edge->assignments) {
+                uint64_t value;
+                if (assign.value == nullptr) {
+                    value = randomValue(*assign.type, rng);
+                } else if (!assign.value->run(frame->values.data(), &value)) {
+                    return false;
+                }
+                frame->values[assign.slot] = value;
+                record(assign.variable, value);
+            }
+
+            loc = edge->edge->getTarget();
+            continue;
+        }
+
+        // Evaluate the inputs in the caller before entering the callee.
+        mInputs.clear();
+        for (const SimAssignment& input : edge->assignments) {
+            uint64_t value;
+            if (input.value == nullptr) {
+                value = randomValue(*input.type, rng);
+            } else if (!input.value->run(frame->values.data(), &value)) {
+                return false;
+            }
+            mInputs.push_back(value);
+        }
+
+        Frame& callee = this->pushFrame(edge->callee, edge, rng);
+        for (size_t i = 0; i < mInputs.size(); ++i) {
+            callee.values[edge->assignments[i].slot] = mInputs[i];
+            record(edge->assignments[i].variable, mInputs[i]);
+        }
+
+        loc = edge->callee->getEntry();
+    }
+
+    return false;
+}
+
+auto RandomSimulation::check(AutomataSystem& system, CfaTraceBuilder& traceBuilder)
+    -> std::unique_ptr<VerificationResult>
+{
+    auto runNext = [&]() -> std::unique_ptr<VerificationResult> {
+        if (mNext == nullptr) {
+            return VerificationResult::CreateUnknown();
+        }
+        return mNext->check(system, traceBuilder);
+    };
+
+    Cfa* main = system.getMainAutomaton();
+    assert(main != nullptr && "The main automaton must exist!");
+
+    bool hasErrors = std::any_of(system.begin(), system.end(), [](Cfa& cfa) {
+        return cfa.getNumErrors() != 0;
+    });
+
+    if (!hasErrors) {
+        return runNext();
+    }
+
+    llvm::outs() << "Running random simulation.\n";
+
+    Stopwatch<> timer;
+    timer.start();
+
+    auto compiler = ExprCompiler::Create();
+    if (compiler == nullptr) {
+        llvm::outs() << "  Native code generation is not available, skipping simulation.\n";
+        return runNext();
+    }
+
+    SimulationProgram program(*compiler);
+    if (!program.build(system)) {
+        llvm::outs() << "  The program contains unsupported expressions or types, skipping simulation.\n";
+        return runNext();
+    }
+
+    unsigned numThreads = mSettings.numThreads;
+    if (numThreads == 0) {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(mSettings.timeLimit);
+
+    std::atomic<bool> found = false;
+    std::atomic<uint64_t> numRuns = 0;
+    std::atomic<uint64_t> numSteps = 0;
+    std::mutex mutex;
+    uint64_t errorSeed = 0;
+
+    auto worker = [&](unsigned threadIdx) {
+        SimulationRun run(program, main, mSettings.maxSteps);
+        uint64_t localRuns = 0;
+
+        // Seeds are distinct between threads and runs.
+        SimulationRng seeds((static_cast<uint64_t>(mSettings.seed) << 32U) | threadIdx);
+
+        while (!found.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < deadline) {
+            uint64_t seed = seeds.next();
+            ++localRuns;
+
+            if (run.run(seed, nullptr)) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!found.exchange(true)) {
+                    errorSeed = seed;
+                }
+                break;
+            }
+        }
+
+        numRuns += localRuns;
+        numSteps += run.getNumSteps();
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < numThreads; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    timer.stop();
+    llvm::outs() << "  Executed " << numRuns << " runs (" << numSteps << " transitions) on "
+        << numThreads << " threads in ";
+    timer.format(llvm::outs(), "s");
+    llvm::outs() << ".\n";
+
+    if (!found) {
+        llvm::outs() << "  No error was found by simulation.\n";
+        return runNext();
+    }
+
+    // Replay the failing run to build the counterexample.
+    SimulationTrace simTrace;
+    SimulationRun replay(program, main, mSettings.maxSteps);
+    bool reproduced = replay.run(errorSeed, &simTrace);
+    assert(reproduced && "Simulation runs must be reproducible from their seed!");
+    (void) reproduced;
+
+    llvm::outs() << "  Found a counterexample of " << simTrace.actions.size() << " transitions.\n";
+
+    std::unique_ptr<Trace> trace;
+    if (mSettings.trace) {
+        std::vector<std::vector<VariableAssignment>> actions;
+        for (auto& simAction : simTrace.actions) {
+            auto& action = actions.emplace_back();
+            for (auto& [variable, value] : simAction) {
+                action.emplace_back(variable, ExprCompiler::decodeValue(variable->getType(), value));
+            }
+        }
+
+        trace = traceBuilder.build(simTrace.states, actions);
+    } else {
+        trace = std::make_unique<Trace>(std::vector<std::unique_ptr<TraceEvent>>());
+    }
+
+    return VerificationResult::CreateFail(replay.getErrorCode(), std::move(trace));
+}
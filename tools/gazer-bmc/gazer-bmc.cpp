@@ -22,6 +22,11 @@
 
 #include "gazer/Z3Solver/Z3Solver.h"
 #include "gazer/Verifier/BoundedModelChecker.h"
+#include "gazer/Verifier/InterpolationModelChecker.h"
+#include "gazer/Verifier/KInductionModelChecker.h"
+#include "gazer/Verifier/PdrModelChecker.h"
+#include "gazer/Verifier/RandomSimulation.h"
+#include "gazer/Support/Warnings.h"
 
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Verifier.h>
@@ -44,11 +49,57 @@ namespace
 
     cl::OptionCategory BmcAlgorithmCategory("Bounded model checker algorithm settings");
 
-    cl::opt<unsigned> MaxBound("bound", cl::desc("Maximum iterations for the bounded model checker"),
+    enum class EngineKind
+    {
+        Bmc,    ///< Bounded model checking with lazy inlining
+        Imc,    ///< Interpolation-based unbounded model checking
+        KInd,   ///< K-induction
+        Pdr     ///< IC3/PDR
+    };
+
+    cl::opt<EngineKind> Engine("engine", cl::desc("Verification engine"),
+        cl::values(
+            clEnumValN(EngineKind::Bmc, "bmc", "Bounded model checking"),
+            clEnumValN(EngineKind::Imc, "imc", "Interpolation-based model checking (requires -inline=all)"),
+            clEnumValN(EngineKind::KInd, "kind", "K-induction (requires -inline=all)"),
+            clEnumValN(EngineKind::Pdr, "pdr", "IC3/PDR (requires -inline=all)")
+        ),
+        cl::init(EngineKind::Bmc),
+        cl::cat(BmcAlgorithmCategory)
+    );
+
+    cl::opt<unsigned> MaxBound("bound", cl::desc("Maximum iterations for the bounded model checker, "
+        "the maximum interpolation bound for the interpolation-based engine, "
+        "the maximum induction depth for k-induction, or the maximum number of frames for PDR"),
         cl::init(100), cl::cat(BmcAlgorithmCategory));
     cl::opt<unsigned> EagerUnroll("eager-unroll", cl::desc("Eager unrolling bound"), cl::init(0),
         cl::cat(BmcAlgorithmCategory));
 
+    cl::opt<bool> ParallelApprox("bmc-parallel-approx",
+        cl::desc("Solve the under- and over-approximation queries of each iteration concurrently"),
+        cl::cat(BmcAlgorithmCategory));
+
+    cl::opt<bool> AllViolations("bmc-all-violations",
+        cl::desc("Report all violated checks instead of stopping at the first violation"),
+        cl::cat(BmcAlgorithmCategory));
+
+    cl::opt<bool> KIndInvariants("kind-invariants",
+        cl::desc("Strengthen the k-induction step case with invariants mined from the loops"),
+        cl::init(true), cl::cat(BmcAlgorithmCategory));
+
+    cl::opt<unsigned> SimulationTime("sim-time",
+        cl::desc("Run a random simulation for the given number of seconds before the verification engine "
+            "(0 disables the simulation)"),
+        cl::init(0), cl::cat(BmcAlgorithmCategory));
+    cl::opt<unsigned> SimulationThreads("sim-threads",
+        cl::desc("Number of random simulation threads (0 uses all hardware threads)"),
+        cl::init(0), cl::cat(BmcAlgorithmCategory));
+    cl::opt<unsigned> SimulationMaxSteps("sim-max-steps",
+        cl::desc("Maximum number of transitions in a single simulation run"),
+        cl::init(10000), cl::cat(BmcAlgorithmCategory));
+    cl::opt<unsigned> SimulationSeed("sim-seed", cl::desc("Seed of the random simulation"),
+        cl::init(0), cl::cat(BmcAlgorithmCategory));
+
     cl::opt<bool> DumpCfa("debug-dump-cfa", cl::desc("Dump the generated CFA after each inlining step"),
         cl::cat(BmcAlgorithmCategory));
     cl::opt<bool> DumpFormula("dump-formula", cl::desc("Dump the solver formula to stderr"),
@@ -74,6 +125,10 @@ namespace gazer
 } // end namespace gazer
 
 static BmcSettings initBmcSettingsFromCommandLine();
+static ImcSettings initImcSettingsFromCommandLine();
+static KInductionSettings initKInductionSettingsFromCommandLine();
+static PdrSettings initPdrSettingsFromCommandLine();
+static SimulationSettings initSimulationSettingsFromCommandLine();
 
 int main(int argc, char* argv[])
 {
@@ -99,16 +154,60 @@ int main(int argc, char* argv[])
     }
 
     Z3SolverFactory solverFactory;
+    std::unique_ptr<VerificationAlgorithm> algorithm;
+
+    // Only the BMC engine continues the search after the first violation.
+    bool simulate = SimulationTime != 0;
+    if (AllViolations && Engine != EngineKind::Bmc) {
+        emit_warning("-bmc-all-violations is only supported by the BMC engine, reporting the first violation only");
+    } else if (AllViolations && simulate) {
+        emit_warning("-bmc-all-violations is not supported with -sim-time, skipping the simulation");
+        simulate = false;
+    }
+
+    if (Engine == EngineKind::Imc) {
+        auto imcSettings = initImcSettingsFromCommandLine();
+        imcSettings.trace = frontend->getSettings().trace;
+
+        algorithm = std::make_unique<InterpolationModelChecker>(solverFactory, imcSettings);
+    } else if (Engine == EngineKind::KInd) {
+        auto kindSettings = initKInductionSettingsFromCommandLine();
+        kindSettings.trace = frontend->getSettings().trace;
+
+        algorithm = std::make_unique<KInductionModelChecker>(solverFactory, kindSettings);
+    } else if (Engine == EngineKind::Pdr) {
+        auto pdrSettings = initPdrSettingsFromCommandLine();
+        pdrSettings.trace = frontend->getSettings().trace;
 
-    auto bmcSettings = initBmcSettingsFromCommandLine();
-    bmcSettings.simplifyExpr = frontend->getSettings().simplifyExpr;
-    bmcSettings.trace = frontend->getSettings().trace;
+        algorithm = std::make_unique<PdrModelChecker>(solverFactory, pdrSettings);
+    } else {
+        auto bmcSettings = initBmcSettingsFromCommandLine();
+        bmcSettings.simplifyExpr = frontend->getSettings().simplifyExpr;
+        bmcSettings.trace = frontend->getSettings().trace;
 
-    frontend->setBackendAlgorithm(new BoundedModelChecker(solverFactory, bmcSettings));
+        algorithm = std::make_unique<BoundedModelChecker>(solverFactory, bmcSettings);
+    }
+
+    if (simulate) {
+        auto simSettings = initSimulationSettingsFromCommandLine();
+        simSettings.trace = frontend->getSettings().trace;
+
+        algorithm = std::make_unique<RandomSimulation>(simSettings, std::move(algorithm));
+    }
+
+    // Decomposed properties are verified by workers started with the same arguments.
+    frontend->getSettings().commandLine.assign(argv, argv + argc);
+
+    frontend->setBackendAlgorithm(algorithm.release());
     frontend->registerVerificationPipeline();
 
     frontend->run();
 
+    // A property worker reports the status of its result to the main process.
+    if (!frontend->getSettings().propertyCodes.empty() && frontend->getResult() != nullptr) {
+        return LLVMFrontend::PropertyExitCodeBase + frontend->getResult()->getStatus();
+    }
+
     return 0;
 }
 
@@ -123,6 +222,59 @@ BmcSettings initBmcSettingsFromCommandLine()
 
     settings.maxBound = MaxBound;
     settings.eagerUnroll = EagerUnroll;
+    settings.parallelApprox = ParallelApprox;
+    settings.allViolations = AllViolations;
+
+    if (settings.allViolations && settings.parallelApprox) {
+        emit_warning("-bmc-all-violations is not supported with -bmc-parallel-approx, "
+            "solving the approximations sequentially");
+        settings.parallelApprox = false;
+    }
+
+    return settings;
+}
+
+ImcSettings initImcSettingsFromCommandLine()
+{
+    ImcSettings settings;
+    settings.dumpSolverModel = DumpSolverModel;
+    settings.printSolverStats = PrintSolverStats;
+
+    settings.maxBound = MaxBound;
+
+    return settings;
+}
+
+KInductionSettings initKInductionSettingsFromCommandLine()
+{
+    KInductionSettings settings;
+    settings.dumpSolverModel = DumpSolverModel;
+    settings.printSolverStats = PrintSolverStats;
+
+    settings.maxBound = MaxBound;
+    settings.mineInvariants = KIndInvariants;
+
+    return settings;
+}
+
+PdrSettings initPdrSettingsFromCommandLine()
+{
+    PdrSettings settings;
+    settings.dumpSolverModel = DumpSolverModel;
+    settings.printSolverStats = PrintSolverStats;
+
+    settings.maxBound = MaxBound;
+
+    return settings;
+}
+
+SimulationSettings initSimulationSettingsFromCommandLine()
+{
+    SimulationSettings settings;
+    settings.timeLimit = SimulationTime;
+    settings.numThreads = SimulationThreads;
+    settings.maxSteps = SimulationMaxSteps;
+    settings.seed = SimulationSeed;
 
     return settings;
 }
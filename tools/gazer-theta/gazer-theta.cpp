@@ -129,9 +129,17 @@ int main(int argc, char* argv[])
     }
 
     if (!ModelOnly) {
+        // Decomposed properties are verified by workers started with the same arguments.
+        frontend->getSettings().commandLine.assign(argv, argv + argc);
+
         frontend->setBackendAlgorithm(new theta::ThetaVerifier(backendSettings));
         frontend->registerVerificationPipeline();
         frontend->run();
+
+        // A property worker reports the status of its result to the main process.
+        if (!frontend->getSettings().propertyCodes.empty() && frontend->getResult() != nullptr) {
+            return LLVMFrontend::PropertyExitCodeBase + frontend->getResult()->getStatus();
+        }
     } else {
         if (ModelPath.empty()) {
             emit_error("-model-only must be supplied together with -o <path>!");
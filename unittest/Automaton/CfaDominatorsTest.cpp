@@ -0,0 +1,298 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaDominators.h"
+#include "gazer/Automaton/CfaUtils.h"
+#include "gazer/Core/LiteralExpr.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace gazer;
+
+namespace
+{
+
+class CfaDominatorsTest : public ::testing::Test
+{
+protected:
+    CfaDominatorsTest()
+        : system(ctx)
+    {}
+
+    void SetUp() override
+    {
+        cfa = system.createCfa("main");
+    }
+
+    void sort()
+    {
+        topo.clear();
+        indexMap.clear();
+        createTopologicalSort(*cfa, topo, &indexMap);
+    }
+
+    std::function<size_t(Location*)> index()
+    {
+        return [this](Location* loc) { return indexMap[loc]; };
+    }
+
+    /// Calculates the immediate dominator of each location using
+    /// the set-based definition of dominators.
+    template<bool IsPostDom>
+    llvm::DenseMap<Location*, Location*> calculateExpectedIDoms(Location* root)
+    {
+        std::vector<Location*> order(topo);
+        if (IsPostDom) {
+            std::reverse(order.begin(), order.end());
+        }
+
+        llvm::DenseMap<Location*, std::set<Location*>> doms;
+        doms[root] = { root };
+
+        auto it = std::find(order.begin(), order.end(), root);
+        for (++it; it != order.end(); ++it) {
+            Location* loc = *it;
+            bool first = true;
+            std::set<Location*> current;
+
+            auto visit = [&](Location* pred) {
+                if (doms.count(pred) == 0) {
+                    return;
+                }
+                if (first) {
+                    current = doms[pred];
+                    first = false;
+                } else {
+                    std::set<Location*> result;
+                    std::set_intersection(
+                        current.begin(), current.end(), doms[pred].begin(), doms[pred].end(),
+                        std::inserter(result, result.begin())
+                    );
+                    current = std::move(result);
+                }
+            };
+
+            if (IsPostDom) {
+                for (Transition* edge : loc->outgoing()) { visit(edge->getTarget()); }
+            } else {
+                for (Transition* edge : loc->incoming()) { visit(edge->getSource()); }
+            }
+
+            if (!first) {
+                current.insert(loc);
+                doms[loc] = std::move(current);
+            }
+        }
+
+        // The immediate dominator is the strict dominator with the most dominators.
+        llvm::DenseMap<Location*, Location*> result;
+        for (auto& [loc, dominators] : doms) {
+            Location* idom = nullptr;
+            for (Location* dom : dominators) {
+                if (dom != loc && (idom == nullptr || doms[dom].size() > doms[idom].size())) {
+                    idom = dom;
+                }
+            }
+            result[loc] = idom;
+        }
+
+        return result;
+    }
+
+    /// Creates a random acyclic automaton where each location is reachable
+    /// from the entry and reaches the exit.
+    void createRandomDag(unsigned numLocs, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<Location*> locs = { cfa->getEntry() };
+        for (unsigned i = 0; i < numLocs; ++i) {
+            Location* loc = cfa->createLocation();
+            std::uniform_int_distribution<size_t> dist(0, locs.size() - 1);
+            cfa->createAssignTransition(locs[dist(rng)], loc);
+            if (rng() % 2 == 0) {
+                cfa->createAssignTransition(locs[dist(rng)], loc);
+            }
+            locs.push_back(loc);
+        }
+
+        for (Location* loc : locs) {
+            if (loc->getNumOutgoing() == 0 || rng() % 4 == 0) {
+                cfa->createAssignTransition(loc, cfa->getExit());
+            }
+        }
+    }
+
+    template<bool IsPostDom>
+    void checkTree(DagDominatorTreeBase<IsPostDom>& tree, Location* root)
+    {
+        auto expected = calculateExpectedIDoms<IsPostDom>(root);
+        ASSERT_EQ(expected.size(), tree.size());
+        for (auto& [loc, idom] : expected) {
+            ASSERT_TRUE(tree.contains(loc));
+            EXPECT_EQ(idom, tree.getIDom(loc)) << "Location " << loc->getId();
+        }
+    }
+
+protected:
+    GazerContext ctx;
+    AutomataSystem system;
+    Cfa* cfa;
+
+    std::vector<Location*> topo;
+    llvm::DenseMap<Location*, size_t> indexMap;
+};
+
+TEST_F(CfaDominatorsTest, DiamondDominators)
+{
+    // entry -> l2 -> { l3, l4 } -> l5 -> exit
+    Location* l2 = cfa->createLocation();
+    Location* l3 = cfa->createLocation();
+    Location* l4 = cfa->createLocation();
+    Location* l5 = cfa->createLocation();
+
+    cfa->createAssignTransition(cfa->getEntry(), l2);
+    cfa->createAssignTransition(l2, l3);
+    cfa->createAssignTransition(l2, l4);
+    cfa->createAssignTransition(l3, l5);
+    cfa->createAssignTransition(l4, l5);
+    cfa->createAssignTransition(l5, cfa->getExit());
+    sort();
+
+    DagDominatorTree domTree(index());
+    domTree.recalculate(cfa->getEntry(), topo);
+
+    EXPECT_EQ(nullptr, domTree.getIDom(cfa->getEntry()));
+    EXPECT_EQ(l2, domTree.getIDom(l3));
+    EXPECT_EQ(l2, domTree.getIDom(l4));
+    EXPECT_EQ(l2, domTree.getIDom(l5));
+    EXPECT_EQ(l2, domTree.findNearestCommonDominator(l3, l4));
+    EXPECT_EQ(l3, domTree.findNearestCommonDominator(l3, l3));
+    EXPECT_TRUE(domTree.dominates(l2, l5));
+    EXPECT_FALSE(domTree.dominates(l3, l5));
+
+    DagPostDominatorTree postDomTree(index());
+    postDomTree.recalculate(cfa->getExit(), topo);
+
+    EXPECT_EQ(nullptr, postDomTree.getIDom(cfa->getExit()));
+    EXPECT_EQ(l5, postDomTree.getIDom(l3));
+    EXPECT_EQ(l5, postDomTree.getIDom(l2));
+    EXPECT_EQ(l5, postDomTree.findNearestCommonDominator(l3, l4));
+    EXPECT_TRUE(postDomTree.dominates(l5, cfa->getEntry()));
+}
+
+TEST_F(CfaDominatorsTest, RandomDagMatchesDefinition)
+{
+    for (unsigned seed = 0; seed < 10; ++seed) {
+        cfa = system.createCfa("test" + std::to_string(seed));
+        createRandomDag(60, seed);
+        sort();
+
+        DagDominatorTree domTree(index());
+        domTree.recalculate(cfa->getEntry(), topo);
+        checkTree(domTree, cfa->getEntry());
+
+        DagPostDominatorTree postDomTree(index());
+        postDomTree.recalculate(cfa->getExit(), topo);
+        checkTree(postDomTree, cfa->getExit());
+    }
+}
+
+TEST_F(CfaDominatorsTest, IncrementalInsertion)
+{
+    std::mt19937 rng(42);
+    createRandomDag(40, 42);
+    sort();
+
+    DagDominatorTree domTree(index());
+    domTree.recalculate(cfa->getEntry(), topo);
+
+    DagPostDominatorTree postDomTree(index());
+    postDomTree.recalculate(cfa->getExit(), topo);
+
+    for (unsigned round = 0; round < 20; ++round) {
+        // Replace a random edge with a small diamond, similarly to the inlining
+        // of a call. Some of the new locations also jump to the exit.
+        std::vector<Transition*> edges;
+        for (Transition* edge : cfa->edges()) {
+            if (edge->getSource() != nullptr && edge->getTarget() != cfa->getExit()) {
+                edges.push_back(edge);
+            }
+        }
+        Transition* edge = edges[rng() % edges.size()];
+        Location* before = edge->getSource();
+        Location* after = edge->getTarget();
+
+        Location* entry = cfa->createLocation();
+        Location* left = cfa->createLocation();
+        Location* right = cfa->createLocation();
+        Location* exit = cfa->createLocation();
+        cfa->createAssignTransition(before, entry);
+        cfa->createAssignTransition(entry, left);
+        cfa->createAssignTransition(entry, right);
+        cfa->createAssignTransition(left, exit);
+        cfa->createAssignTransition(right, exit);
+        cfa->createAssignTransition(exit, after);
+        if (rng() % 2 == 0) {
+            cfa->createAssignTransition(left, cfa->getExit());
+        }
+        cfa->disconnectEdge(edge);
+
+        sort();
+        domTree.insertLocations({ entry, left, right, exit });
+        postDomTree.insertLocations({ entry, left, right, exit });
+
+        checkTree(domTree, cfa->getEntry());
+        checkTree(postDomTree, cfa->getExit());
+
+        // Check the index against the tree
+        for (Location* loc : { left, right, exit, after }) {
+            EXPECT_EQ(domTree.getIDom(loc), domTree.findNearestCommonDominator(loc, domTree.getIDom(loc)));
+        }
+    }
+}
+
+TEST_F(CfaDominatorsTest, FindLowestCommonDominator)
+{
+    // entry -> l2 -> { l3 -> l5 -> { l6, l7 }, l4 } -> exit
+    Location* l2 = cfa->createLocation();
+    Location* l3 = cfa->createLocation();
+    Location* l4 = cfa->createLocation();
+    Location* l5 = cfa->createLocation();
+    Location* l6 = cfa->createLocation();
+    Location* l7 = cfa->createLocation();
+
+    cfa->createAssignTransition(cfa->getEntry(), l2);
+    cfa->createAssignTransition(l2, l3);
+    cfa->createAssignTransition(l2, l4);
+    cfa->createAssignTransition(l3, l5);
+    auto t1 = cfa->createAssignTransition(l5, l6);
+    auto t2 = cfa->createAssignTransition(l5, l7);
+    auto t3 = cfa->createAssignTransition(l4, cfa->getExit());
+    cfa->createAssignTransition(l6, cfa->getExit());
+    cfa->createAssignTransition(l7, cfa->getExit());
+    sort();
+
+    EXPECT_EQ(l5, findLowestCommonDominator({ t1, t2 }, topo, index(), nullptr));
+    EXPECT_EQ(l2, findLowestCommonDominator({ t1, t3 }, topo, index(), nullptr));
+    EXPECT_EQ(l5, findLowestCommonDominator({ t1, t2 }, topo, index(), l3));
+    EXPECT_EQ(cfa->getExit(), findHighestCommonPostDominator({ t1, t2 }, topo, index(), nullptr));
+    EXPECT_EQ(l6, findHighestCommonPostDominator({ t1 }, topo, index(), nullptr));
+}
+
+} // end anonymous namespace
@@ -16,7 +16,9 @@
 //
 //===----------------------------------------------------------------------===//
 #include "gazer/Automaton/Cfa.h"
+#include "gazer/Automaton/CfaTransforms.h"
 #include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
 
 #include <llvm/ADT/Twine.h>
 
@@ -82,3 +84,336 @@ TEST(Cfa, CanCreateCfa)
     ASSERT_EQ(loc2, edge1->getTarget());
     ASSERT_EQ(loc3, edge2->getTarget());
 }
+
+TEST(Cfa, FreshLocalsAndLookup)
+{
+    GazerContext context;
+    AutomataSystem system(context);
+
+    auto cfa = system.createCfa("Test");
+    Variable* x = cfa->createInput("x", BvType::Get(context, 32));
+    Variable* y = cfa->createLocal("y", BvType::Get(context, 32));
+    Variable* y2 = cfa->createLocal("y", BvType::Get(context, 32));
+    Variable* fresh = cfa->createFreshLocal(x);
+
+    ASSERT_EQ("Test/y_0", y2->getName());
+    ASSERT_EQ(3, cfa->getNumLocals());
+    ASSERT_TRUE(fresh->isFresh());
+    ASSERT_EQ(x->getType(), fresh->getType());
+    ASSERT_EQ("Test/x#" + std::to_string(fresh->getId()), fresh->getName());
+    ASSERT_EQ(fresh->getName(), cfa->getSymbolName(fresh));
+
+    EXPECT_EQ(x, cfa->findInputByName("x"));
+    EXPECT_EQ(nullptr, cfa->findLocalByName("x"));
+    EXPECT_EQ(y, cfa->findLocalByName("y"));
+    EXPECT_EQ(nullptr, cfa->findLocalByName("z"));
+}
+
+TEST(Cfa, CloneAutomaton)
+{
+    GazerContext context;
+    AutomataSystem system(context);
+
+    auto cfa = system.createCfa("Test");
+    Variable* x = cfa->createInput("x", BvType::Get(context, 32));
+    Variable* y = cfa->createLocal("y", BvType::Get(context, 32));
+    cfa->addOutput(y);
+
+    Location* loc1 = cfa->createLocation();
+    Location* err = cfa->createErrorLocation();
+    cfa->addErrorCode(err, BvLiteralExpr::Get(BvType::Get(context, 16), llvm::APInt{16, 1}));
+
+    cfa->createAssignTransition(cfa->getEntry(), loc1, {
+        { y, AddExpr::Create(x->getRefExpr(), BvLiteralExpr::Get(BvType::Get(context, 32), llvm::APInt{32, 1})) }
+    });
+    cfa->createAssignTransition(loc1, cfa->getExit(), NotExpr::Create(EqExpr::Create(x->getRefExpr(), y->getRefExpr())));
+    cfa->createAssignTransition(loc1, err, EqExpr::Create(x->getRefExpr(), y->getRefExpr()));
+
+    Cfa* clone = CloneAutomaton(cfa, "Clone");
+
+    ASSERT_EQ("Clone", clone->getName());
+    ASSERT_EQ(cfa->getNumLocations(), clone->getNumLocations());
+    ASSERT_EQ(cfa->getNumTransitions(), clone->getNumTransitions());
+    ASSERT_EQ(1, clone->getNumInputs());
+    ASSERT_EQ(1, clone->getNumLocals());
+    ASSERT_EQ(1, clone->getNumOutputs());
+    ASSERT_EQ(1, clone->getNumErrors());
+
+    Variable* cx = clone->getInput(0);
+    Variable* cy = clone->getOutput(0);
+    ASSERT_EQ("Clone/x", cx->getName());
+    ASSERT_EQ("Clone/y", cy->getName());
+
+    // The cloned transitions must only reference the variables of the clone.
+    auto first = llvm::cast<AssignTransition>(*clone->getEntry()->outgoing_begin());
+    ASSERT_EQ(1, first->getNumAssignments());
+    ASSERT_EQ(cy, first->begin()->getVariable());
+    ASSERT_EQ(
+        AddExpr::Create(cx->getRefExpr(), BvLiteralExpr::Get(BvType::Get(context, 32), llvm::APInt{32, 1})),
+        first->begin()->getValue()
+    );
+
+    Location* cloneLoc = first->getTarget();
+    ASSERT_EQ(2, cloneLoc->getNumOutgoing());
+    for (Transition* edge : cloneLoc->outgoing()) {
+        ExprPtr cond = EqExpr::Create(cx->getRefExpr(), cy->getRefExpr());
+        if (edge->getTarget() == clone->getExit()) {
+            ASSERT_EQ(NotExpr::Create(cond), edge->getGuard());
+        } else {
+            ASSERT_TRUE(edge->getTarget()->isError());
+            ASSERT_EQ(cond, edge->getGuard());
+        }
+    }
+}
+
+TEST(Cfa, CloneAutomatonWithFreshLocals)
+{
+    GazerContext context;
+    AutomataSystem system(context);
+
+    auto& bv32 = BvType::Get(context, 32);
+    auto cfa = system.createCfa("Test");
+    Variable* x = cfa->createInput("x", bv32);
+    Variable* tmp = cfa->createFreshLocal(x);
+
+    Location* loc1 = cfa->createLocation();
+    cfa->createAssignTransition(cfa->getEntry(), loc1, { { tmp, x->getRefExpr() } });
+    cfa->createAssignTransition(loc1, cfa->getExit(), EqExpr::Create(tmp->getRefExpr(), x->getRefExpr()));
+
+    CloneOrigins origins;
+    Cfa* clone = CloneAutomaton(cfa, "Clone", &origins);
+
+    ASSERT_EQ(1, clone->getNumLocals());
+    Variable* ctmp = &*clone->locals().begin();
+    EXPECT_TRUE(ctmp->isFresh());
+    EXPECT_NE(tmp, ctmp);
+    EXPECT_EQ(tmp, origins.variables.lookup(ctmp));
+
+    auto first = llvm::cast<AssignTransition>(*clone->getEntry()->outgoing_begin());
+    EXPECT_EQ(ctmp, first->begin()->getVariable());
+    EXPECT_EQ(clone->getInput(0)->getRefExpr(), first->begin()->getValue());
+}
+
+TEST(Cfa, SliceErrorLocations)
+{
+    GazerContext context;
+    AutomataSystem system(context);
+
+    auto& errTy = BvType::Get(context, 16);
+    auto cfa = system.createCfa("Test");
+    Variable* x = cfa->createInput("x", BvType::Get(context, 32));
+    Variable* ec = cfa->createLocal("ec", errTy);
+
+    Location* loc1 = cfa->createLocation();
+    Location* err2 = cfa->createErrorLocation();
+    Location* err3 = cfa->createErrorLocation();
+    Location* errDyn = cfa->createErrorLocation();
+    cfa->addErrorCode(err2, BvLiteralExpr::Get(errTy, llvm::APInt{16, 2}));
+    cfa->addErrorCode(err3, BvLiteralExpr::Get(errTy, llvm::APInt{16, 3}));
+    cfa->addErrorCode(errDyn, ec->getRefExpr());
+
+    ExprPtr cond = EqExpr::Create(x->getRefExpr(), BvLiteralExpr::Get(BvType::Get(context, 32), llvm::APInt{32, 0}));
+    cfa->createAssignTransition(cfa->getEntry(), loc1);
+    cfa->createAssignTransition(loc1, cfa->getExit());
+    cfa->createAssignTransition(loc1, err2, cond);
+    cfa->createAssignTransition(loc1, err3, cond);
+    cfa->createAssignTransition(loc1, errDyn, cond, {
+        { ec, BvLiteralExpr::Get(errTy, llvm::APInt{16, 4}) }
+    });
+
+    SliceErrorLocations(system, {2, 4});
+
+    // The error location of code 3 is removed, the dynamic one is replaced by a guarded one.
+    ASSERT_EQ(2, cfa->getNumErrors());
+    ASSERT_EQ(err2, cfa->findLocationById(err2->getId()));
+    ASSERT_EQ(nullptr, cfa->findLocationById(4));
+    ASSERT_EQ(nullptr, cfa->findLocationById(5));
+    ASSERT_EQ(3, loc1->getNumOutgoing());
+
+    for (auto& [location, code] : cfa->errors()) {
+        if (location == err2) {
+            continue;
+        }
+
+        ASSERT_EQ(ec->getRefExpr(), code);
+        ASSERT_EQ(1, location->getNumIncoming());
+
+        Transition* guardEdge = *location->incoming_begin();
+        ASSERT_EQ(
+            OrExpr::Create(
+                EqExpr::Create(ec->getRefExpr(), BvLiteralExpr::Get(errTy, llvm::APInt{16, 2})),
+                EqExpr::Create(ec->getRefExpr(), BvLiteralExpr::Get(errTy, llvm::APInt{16, 4}))
+            ),
+            guardEdge->getGuard()
+        );
+
+        Location* guarded = guardEdge->getSource();
+        ASSERT_EQ(1, guarded->getNumIncoming());
+        auto redirected = llvm::cast<AssignTransition>(*guarded->incoming_begin());
+        ASSERT_EQ(loc1, redirected->getSource());
+        ASSERT_EQ(cond, redirected->getGuard());
+        ASSERT_EQ(1, redirected->getNumAssignments());
+    }
+}
+
+TEST(Cfa, LargeBlockEncoding)
+{
+    GazerContext context;
+    AutomataSystem system(context);
+
+    auto& bv32 = BvType::Get(context, 32);
+    auto cfa = system.createCfa("Test");
+    Variable* x = cfa->createInput("x", bv32);
+    Variable* a = cfa->createLocal("a", bv32);
+    Variable* b = cfa->createLocal("b", bv32);
+
+    // entry -> l1 -> (l2 | l3) -> l4 -> exit
+    Location* l1 = cfa->createLocation();
+    Location* l2 = cfa->createLocation();
+    Location* l3 = cfa->createLocation();
+    Location* l4 = cfa->createLocation();
+
+    auto lit = [&bv32](unsigned value) { return BvLiteralExpr::Get(bv32, llvm::APInt{32, value}); };
+    ExprPtr cond = EqExpr::Create(a->getRefExpr(), lit(0));
+
+    cfa->createAssignTransition(cfa->getEntry(), l1, { { a, AddExpr::Create(x->getRefExpr(), lit(1)) } });
+    cfa->createAssignTransition(l1, l2, cond);
+    cfa->createAssignTransition(l1, l3, NotExpr::Create(cond));
+    cfa->createAssignTransition(l2, l4, { { b, lit(1) } });
+    cfa->createAssignTransition(l3, l4, { { b, lit(2) } });
+    cfa->createAssignTransition(l4, cfa->getExit());
+
+    ASSERT_EQ(4, LargeBlockEncoding(cfa));
+
+    ASSERT_EQ(2, cfa->getNumLocations());
+    ASSERT_EQ(1, cfa->getNumTransitions());
+
+    auto edge = llvm::cast<AssignTransition>(*cfa->getEntry()->outgoing_begin());
+    ASSERT_EQ(cfa->getExit(), edge->getTarget());
+    ASSERT_EQ(2, edge->getNumAssignments());
+
+    auto it = edge->begin();
+    EXPECT_EQ(a, it->getVariable());
+    ++it;
+    EXPECT_EQ(b, it->getVariable());
+    EXPECT_TRUE(llvm::isa<SelectExpr>(it->getValue()));
+}
+
+TEST(Cfa, LargeBlockEncodingKeepsRequestedLocations)
+{
+    GazerContext context;
+    AutomataSystem system(context);
+
+    auto cfa = system.createCfa("Test");
+    Location* l1 = cfa->createLocation();
+    Location* l2 = cfa->createLocation();
+
+    cfa->createAssignTransition(cfa->getEntry(), l1);
+    cfa->createAssignTransition(l1, l2);
+    cfa->createAssignTransition(l2, cfa->getExit());
+
+    ASSERT_EQ(1, LargeBlockEncoding(cfa, [l2](Location* loc) { return loc == l2; }));
+    ASSERT_EQ(3, cfa->getNumLocations());
+    ASSERT_EQ(l2, (*cfa->getEntry()->outgoing_begin())->getTarget());
+}
+
+TEST(Cfa, EliminateDeadLocals)
+{
+    GazerContext context;
+    AutomataSystem system(context);
+
+    auto& bv32 = BvType::Get(context, 32);
+
+    auto callee = system.createCfa("Callee");
+    Variable* p = callee->createInput("p", bv32);
+    Variable* q = callee->createLocal("q", bv32);
+    callee->addOutput(q);
+    callee->createAssignTransition(callee->getEntry(), callee->getExit(), { { q, p->getRefExpr() } });
+
+    auto cfa = system.createCfa("Test");
+    Variable* x = cfa->createInput("x", bv32);
+    Variable* a = cfa->createLocal("a", bv32);
+    Variable* b = cfa->createLocal("b", bv32);
+    Variable* c = cfa->createLocal("c", bv32);
+    Variable* d = cfa->createLocal("d", bv32);
+    Variable* e = cfa->createLocal("e", bv32);
+    Variable* r = cfa->createLocal("r", bv32);
+    cfa->addOutput(r);
+
+    Location* l1 = cfa->createLocation();
+    Location* l2 = cfa->createLocation();
+
+    auto lit = [&bv32](unsigned value) { return BvLiteralExpr::Get(bv32, llvm::APInt{32, value}); };
+
+    // The assignments of b and c only feed each other, d is never read. The
+    // output of the call is never read either, but it must remain bound.
+    auto first = cfa->createAssignTransition(cfa->getEntry(), l1, {
+        { a, AddExpr::Create(x->getRefExpr(), lit(1)) },
+        { b, AddExpr::Create(a->getRefExpr(), lit(2)) },
+        { c, b->getRefExpr() }
+    });
+    cfa->createCallTransition(
+        l1, l2, EqExpr::Create(a->getRefExpr(), lit(0)), callee,
+        { { p, a->getRefExpr() } }, { { e, q->getRefExpr() } }
+    );
+    auto last = cfa->createAssignTransition(l2, cfa->getExit(), {
+        { r, a->getRefExpr() },
+        { d, lit(5) }
+    });
+
+    ASSERT_EQ(3, EliminateDeadLocals(cfa));
+    ASSERT_EQ(3, cfa->getNumLocals());
+    EXPECT_EQ(a, cfa->findLocalByName("a"));
+    EXPECT_EQ(e, cfa->findLocalByName("e"));
+    EXPECT_EQ(r, cfa->findLocalByName("r"));
+    EXPECT_EQ(nullptr, cfa->findLocalByName("b"));
+    EXPECT_EQ(nullptr, cfa->findLocalByName("c"));
+    EXPECT_EQ(nullptr, cfa->findLocalByName("d"));
+
+    ASSERT_EQ(1, first->getNumAssignments());
+    EXPECT_EQ(a, first->begin()->getVariable());
+    ASSERT_EQ(1, last->getNumAssignments());
+    EXPECT_EQ(r, last->begin()->getVariable());
+
+    // Nothing else to remove.
+    ASSERT_EQ(0, EliminateDeadLocals(cfa));
+}
+
+TEST(Cfa, EliminateDeadLocalsKeepsReadVariables)
+{
+    GazerContext context;
+    AutomataSystem system(context);
+
+    auto& bv16 = BvType::Get(context, 16);
+    auto cfa = system.createCfa("Test");
+    Variable* a = cfa->createLocal("a", bv16);
+    Variable* b = cfa->createLocal("b", bv16);
+    Variable* ec = cfa->createLocal("ec", bv16);
+
+    Location* loc = cfa->createLocation();
+    Location* err = cfa->createErrorLocation();
+    cfa->addErrorCode(err, ec->getRefExpr());
+
+    auto lit = [&bv16](unsigned value) { return BvLiteralExpr::Get(bv16, llvm::APInt{16, value}); };
+
+    // The first assignment of a is overwritten before it is read.
+    auto first = cfa->createAssignTransition(cfa->getEntry(), loc, {
+        { a, lit(1) },
+        { a, lit(2) },
+        { ec, a->getRefExpr() },
+        { b, lit(3) }
+    });
+    cfa->createAssignTransition(loc, err, EqExpr::Create(a->getRefExpr(), lit(2)));
+    cfa->createAssignTransition(loc, cfa->getExit(), NotExpr::Create(EqExpr::Create(a->getRefExpr(), lit(2))));
+
+    ASSERT_EQ(0, EliminateDeadLocals(cfa, [b](Variable* variable) { return variable == b; }));
+    ASSERT_EQ(3, cfa->getNumLocals());
+    ASSERT_EQ(3, first->getNumAssignments());
+
+    auto it = first->begin();
+    EXPECT_EQ(VariableAssignment(a, lit(2)), *it);
+    ++it;
+    EXPECT_EQ(ec, it->getVariable());
+    ++it;
+    EXPECT_EQ(b, it->getVariable());
+}
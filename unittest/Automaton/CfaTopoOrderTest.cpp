@@ -0,0 +1,125 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaTopoOrder.h"
+#include "gazer/Automaton/CfaUtils.h"
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <random>
+
+using namespace gazer;
+
+namespace
+{
+
+class CfaTopoOrderTest : public ::testing::Test
+{
+protected:
+    CfaTopoOrderTest()
+        : system(ctx)
+    {}
+
+    void SetUp() override
+    {
+        cfa = system.createCfa("main");
+    }
+
+    void checkOrder(const CfaTopoOrder& order, const std::list<Location*>& expected)
+    {
+        ASSERT_EQ(expected.size(), order.size());
+        ASSERT_TRUE(std::equal(order.begin(), order.end(), expected.begin(), expected.end()));
+
+        Location* prev = nullptr;
+        for (Location* loc : order) {
+            if (prev != nullptr) {
+                EXPECT_LT(order.getLabel(prev), order.getLabel(loc));
+                EXPECT_TRUE(order.comesBefore(prev, loc));
+                EXPECT_EQ(prev, order.getPrev(loc));
+                EXPECT_EQ(loc, order.getNext(prev));
+            }
+            prev = loc;
+        }
+    }
+
+protected:
+    GazerContext ctx;
+    AutomataSystem system;
+    Cfa* cfa;
+};
+
+TEST_F(CfaTopoOrderTest, CreateFromTopoSort)
+{
+    Location* l2 = cfa->createLocation();
+    Location* l3 = cfa->createLocation();
+    cfa->createAssignTransition(cfa->getEntry(), l2);
+    cfa->createAssignTransition(l2, l3);
+    cfa->createAssignTransition(cfa->getEntry(), l3);
+    cfa->createAssignTransition(l3, cfa->getExit());
+
+    std::vector<Location*> topo;
+    createTopologicalSort(*cfa, topo);
+    CfaTopoOrder order(topo);
+
+    checkOrder(order, { cfa->getEntry(), l2, l3, cfa->getExit() });
+    EXPECT_EQ(nullptr, order.getPrev(cfa->getEntry()));
+    EXPECT_EQ(nullptr, order.getNext(cfa->getExit()));
+    EXPECT_TRUE(order.contains(l2));
+}
+
+TEST_F(CfaTopoOrderTest, InsertRelabelsWhenGapIsExhausted)
+{
+    std::list<Location*> expected = { cfa->getEntry(), cfa->getExit() };
+    CfaTopoOrder order(std::vector<Location*>(expected.begin(), expected.end()));
+
+    // Always inserting before the previously inserted location halves the
+    // same gap in each step, which eventually forces a redistribution.
+    Location* pos = cfa->getExit();
+    for (unsigned i = 0; i < 200; ++i) {
+        Location* loc = cfa->createLocation();
+        order.insertBefore(pos, { loc });
+        expected.insert(std::find(expected.begin(), expected.end(), pos), loc);
+        pos = loc;
+    }
+
+    checkOrder(order, expected);
+    EXPECT_GT(order.getNumRelabeled(), 0u);
+}
+
+TEST_F(CfaTopoOrderTest, RandomInsertions)
+{
+    std::mt19937 rng(42);
+    std::list<Location*> expected = { cfa->getEntry(), cfa->getExit() };
+    CfaTopoOrder order(std::vector<Location*>(expected.begin(), expected.end()));
+
+    for (unsigned i = 0; i < 500; ++i) {
+        auto pos = std::next(expected.begin(), 1 + rng() % (expected.size() - 1));
+
+        std::vector<Location*> locs;
+        for (unsigned j = 0, e = 1 + rng() % 8; j < e; ++j) {
+            locs.push_back(cfa->createLocation());
+        }
+
+        order.insertBefore(*pos, locs);
+        expected.insert(pos, locs.begin(), locs.end());
+    }
+
+    checkOrder(order, expected);
+}
+
+} // end anonymous namespace
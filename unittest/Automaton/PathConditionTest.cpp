@@ -78,12 +78,11 @@ TEST(PathConditionTest, PredecessorTest)
     auto builder = CreateFoldingExprBuilder(ctx);
 
     std::vector<Location*> topo;
-    llvm::DenseMap<Location*, size_t> indexMap;
-    createTopologicalSort(*cfa, topo, &indexMap);
+    createTopologicalSort(*cfa, topo);
+    CfaTopoOrder order(topo);
 
     PathConditionCalculator pathCond(
-        topo, *builder,
-        [&indexMap](auto l) { return indexMap[l]; },
+        order, *builder,
         [&ctx](auto t) { return BoolLiteralExpr::True(ctx); },
         nullptr
     );
@@ -130,13 +129,12 @@ TEST(PathConditionTest, TestParallelEdges)
     cfa->createAssignTransition(le, cfa->getExit(), BoolLiteralExpr::False(ctx));
 
     std::vector<Location*> topo;
-    llvm::DenseMap<Location*, size_t> indexMap;
-    createTopologicalSort(*cfa, topo, &indexMap);
+    createTopologicalSort(*cfa, topo);
+    CfaTopoOrder order(topo);
     auto builder = CreateFoldingExprBuilder(ctx);
 
     PathConditionCalculator pathCond(
-        topo, *builder,
-        [&indexMap](auto l) { return indexMap[l]; },
+        order, *builder,
         [&ctx](auto t) { return BoolLiteralExpr::True(ctx); },
         nullptr
     );
@@ -0,0 +1,207 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Core/Expr/BatchExprEvaluator.h"
+#include "gazer/Core/Expr/ExprEvaluator.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace gazer;
+
+namespace
+{
+
+class BatchExprEvaluatorTest : public ::testing::Test
+{
+protected:
+    GazerContext context;
+    std::unique_ptr<ExprBuilder> builder;
+
+    Variable *a, *b;
+    Variable *x, *y, *z;
+    Variable *p;
+
+    std::vector<Variable*> variables;
+
+public:
+    BatchExprEvaluatorTest()
+        : builder(CreateExprBuilder(context))
+    {
+        a = context.createVariable("a", BoolType::Get(context));
+        b = context.createVariable("b", BoolType::Get(context));
+        x = context.createVariable("x", BvType::Get(context, 32));
+        y = context.createVariable("y", BvType::Get(context, 32));
+        z = context.createVariable("z", BvType::Get(context, 32));
+        p = context.createVariable("p", BvType::Get(context, 8));
+
+        variables = {a, b, x, y, z, p};
+    }
+
+    /// Builds a column-major buffer of \p numLanes random valuations. Small
+    /// and boundary values are preferred to hit the interesting cases.
+    std::vector<uint64_t> createColumns(size_t numLanes, unsigned seed)
+    {
+        std::mt19937_64 rng(seed);
+        std::vector<uint64_t> columns(variables.size() * numLanes);
+        for (size_t i = 0; i < variables.size(); ++i) {
+            auto& type = variables[i]->getType();
+            unsigned width = type.isBoolType() ? 1 : llvm::cast<BvType>(type).getWidth();
+            uint64_t mask = (uint64_t(1) << width) - 1;
+
+            for (size_t lane = 0; lane < numLanes; ++lane) {
+                uint64_t value;
+                switch (rng() % 4) {
+                    case 0: value = rng() % 4; break;
+                    case 1: value = mask - rng() % 4; break;
+                    case 2: value = (mask >> 1U) + rng() % 4; break;
+                    default: value = rng(); break;
+                }
+                columns[i * numLanes + lane] = value & mask;
+            }
+        }
+
+        return columns;
+    }
+
+    /// Evaluates \p expr in each lane with the interpreter.
+    std::vector<uint64_t> interpret(const ExprPtr& expr, llvm::ArrayRef<uint64_t> columns, size_t numLanes)
+    {
+        std::vector<uint64_t> result;
+        for (size_t lane = 0; lane < numLanes; ++lane) {
+            auto vb = Valuation::CreateBuilder();
+            for (size_t i = 0; i < variables.size(); ++i) {
+                uint64_t value = columns[i * numLanes + lane];
+                if (auto bvTy = llvm::dyn_cast<BvType>(&variables[i]->getType())) {
+                    vb.put(variables[i], builder->BvLit(value, bvTy->getWidth()));
+                } else {
+                    vb.put(variables[i], builder->BoolLit(value != 0));
+                }
+            }
+
+            auto valuation = vb.build();
+            ValuationExprEvaluator eval(valuation);
+            auto lit = eval.evaluate(expr);
+
+            if (auto bvLit = llvm::dyn_cast<BvLiteralExpr>(lit)) {
+                result.push_back(bvLit->getValue().getZExtValue());
+            } else {
+                result.push_back(llvm::cast<BoolLiteralExpr>(lit)->getValue() ? 1 : 0);
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<uint64_t> evaluate(const ExprPtr& expr, llvm::ArrayRef<uint64_t> columns, size_t numLanes)
+    {
+        auto eval = BatchExprEvaluator::Create(expr, variables);
+        EXPECT_NE(eval, nullptr);
+        if (eval == nullptr) {
+            return {};
+        }
+
+        std::vector<uint64_t> result(numLanes);
+        eval->evaluate(columns, numLanes, result);
+        return result;
+    }
+};
+
+TEST_F(BatchExprEvaluatorTest, AgreesWithInterpreter)
+{
+    ExprPtr X = x->getRefExpr(), Y = y->getRefExpr(), Z = z->getRefExpr();
+    ExprPtr A = a->getRefExpr(), B = b->getRefExpr(), P = p->getRefExpr();
+
+    std::vector<ExprPtr> exprs = {
+        builder->Add(builder->Mul(X, Y), builder->Sub(Z, builder->BvLit32(7))),
+        builder->BvXor(builder->BvAnd(X, Y), builder->BvOr(Y, Z)),
+        builder->Select(builder->BvSLt(X, Y), X, builder->Select(builder->BvUGtEq(Y, Z), Y, Z)),
+        builder->And({A, builder->Not(B), builder->BvULt(X, Y)}),
+        builder->Or({builder->Eq(A, B), builder->BvSGt(X, Z), builder->NotEq(Y, Z)}),
+        builder->Imply(A, builder->BvSLtEq(Y, Z)),
+        builder->ZExt(P, BvType::Get(context, 32)),
+        builder->Add(builder->SExt(P, BvType::Get(context, 32)), X),
+        builder->Extract(X, 4, 8),
+        builder->BvConcat(P, builder->Extract(Y, 0, 24)),
+        builder->Eq(builder->Extract(builder->BvConcat(X, Y), 16, 32), builder->BvLit32(0)),
+    };
+
+    // Include a partial block to check the tail handling.
+    size_t numLanes = 2 * BatchExprEvaluator::BlockSize + 13;
+    auto columns = this->createColumns(numLanes, 1);
+
+    for (size_t i = 0; i < exprs.size(); ++i) {
+        EXPECT_EQ(this->evaluate(exprs[i], columns, numLanes), this->interpret(exprs[i], columns, numLanes))
+            << "Mismatch for expression #" << i;
+    }
+}
+
+TEST_F(BatchExprEvaluatorTest, DivisionAndShifts)
+{
+    ExprPtr X = x->getRefExpr(), Y = y->getRefExpr();
+
+    struct Case { uint64_t x, y; uint64_t udiv, urem, sdiv, srem, shl, lshr, ashr; };
+    std::vector<Case> cases = {
+        {7, 2, 3, 1, 3, 1, 28, 1, 1},
+        {7, 0, 0xFFFFFFFF, 7, 0xFFFFFFFF, 7, 7, 7, 7},
+        {0xFFFFFFF9, 0, 0xFFFFFFFF, 0xFFFFFFF9, 1, 0xFFFFFFF9, 0xFFFFFFF9, 0xFFFFFFF9, 0xFFFFFFF9},
+        {0xFFFFFFF9, 2, 0x7FFFFFFC, 1, 0xFFFFFFFD, 0xFFFFFFFF, 0xFFFFFFE4, 0x3FFFFFFE, 0xFFFFFFFE},
+        {0x80000000, 0xFFFFFFFF, 0, 0x80000000, 0x80000000, 0, 0, 0, 0xFFFFFFFF},
+        {0x80000000, 40, 0x03333333, 8, 0xFCCCCCCD, 0xFFFFFFF8, 0, 0, 0xFFFFFFFF},
+    };
+
+    size_t numLanes = cases.size();
+    std::vector<uint64_t> columns(variables.size() * numLanes, 0);
+    for (size_t lane = 0; lane < numLanes; ++lane) {
+        columns[2 * numLanes + lane] = cases[lane].x;
+        columns[3 * numLanes + lane] = cases[lane].y;
+    }
+
+    auto check = [&](const char* name, const ExprPtr& expr, uint64_t Case::* field) {
+        auto result = this->evaluate(expr, columns, numLanes);
+        ASSERT_EQ(result.size(), numLanes);
+        for (size_t lane = 0; lane < numLanes; ++lane) {
+            EXPECT_EQ(result[lane], cases[lane].*field) << name << " in lane " << lane;
+        }
+    };
+
+    check("udiv", builder->BvUDiv(X, Y), &Case::udiv);
+    check("urem", builder->BvURem(X, Y), &Case::urem);
+    check("sdiv", builder->BvSDiv(X, Y), &Case::sdiv);
+    check("srem", builder->BvSRem(X, Y), &Case::srem);
+    check("shl", builder->Shl(X, Y), &Case::shl);
+    check("lshr", builder->LShr(X, Y), &Case::lshr);
+    check("ashr", builder->AShr(X, Y), &Case::ashr);
+}
+
+TEST_F(BatchExprEvaluatorTest, UnsupportedExpressions)
+{
+    auto i = context.createVariable("i", IntType::Get(context));
+    auto w = context.createVariable("w", BvType::Get(context, 128));
+
+    EXPECT_EQ(BatchExprEvaluator::Create(builder->Lt(i->getRefExpr(), builder->IntLit(0)), variables), nullptr);
+    EXPECT_EQ(BatchExprEvaluator::Create(
+        builder->Eq(builder->Extract(w->getRefExpr(), 0, 32), x->getRefExpr()), variables), nullptr);
+
+    // Variables must have a column.
+    EXPECT_EQ(BatchExprEvaluator::Create(builder->Not(a->getRefExpr()), {b}), nullptr);
+    EXPECT_NE(BatchExprEvaluator::Create(builder->Not(a->getRefExpr()), {a}), nullptr);
+}
+
+} // end anonymous namespace
@@ -19,6 +19,10 @@
 #include "gazer/Core/GazerContext.h"
 #include "gazer/Core/ExprTypes.h"
 #include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+#include "gazer/Core/Expr/ExprUtils.h"
+
+#include <llvm/ADT/DenseMap.h>
 
 #include <gtest/gtest.h>
 
@@ -203,3 +207,99 @@ TEST(Expr, CanCreateTupleExpressions)
     read = TupleSelectExpr::Create(construct, 1);
     EXPECT_EQ(read->getType(), bvTy);
 }
+
+TEST(Expr, ExprViewBorrowsExpressions)
+{
+    static_assert(std::is_constructible_v<ExprView<>, const ExprPtr&>);
+    static_assert(!std::is_constructible_v<ExprView<>, ExprPtr&&>,
+        "Views must not borrow temporaries!");
+    static_assert(std::is_constructible_v<ExprView<>, ExprView<EqExpr>>);
+    static_assert(!std::is_constructible_v<ExprView<EqExpr>, ExprView<>>);
+    static_assert(std::is_trivially_copyable_v<ExprView<>>);
+
+    GazerContext context;
+    auto x = context.createVariable("X", IntType::Get(context))->getRefExpr();
+    auto y = context.createVariable("Y", IntType::Get(context))->getRefExpr();
+
+    ExprRef<EqExpr> eq = EqExpr::Create(x, y);
+    ExprView<EqExpr> view = eq;
+    ExprView<> base = view;
+
+    EXPECT_EQ(view.get(), eq.get());
+    EXPECT_EQ(base, view);
+    EXPECT_TRUE(llvm::isa<EqExpr>(base));
+    EXPECT_EQ(expr_cast<EqExpr>(base), view);
+    EXPECT_EQ(dyn_expr_cast<NotEqExpr>(base), nullptr);
+
+    llvm::DenseMap<ExprView<>, int> map;
+    map[base] = 1;
+    map[x] = 2;
+    EXPECT_EQ(map.lookup(view), 1);
+    EXPECT_EQ(map.lookup(ExprView<>(y)), 0);
+
+    // Taking an owning reference keeps the expression alive.
+    ExprPtr owned = base.ref();
+    eq = nullptr;
+    EXPECT_EQ(owned.get(), base.get());
+    EXPECT_EQ(llvm::cast<EqExpr>(owned)->getLeft(), x);
+}
+
+TEST(Expr, CanonicalExpressionsShareNodes)
+{
+    GazerContext context;
+    auto x = context.createVariable("X", BvType::Get(context, 32))->getRefExpr();
+    auto y = context.createVariable("Y", BvType::Get(context, 32))->getRefExpr();
+    auto z = context.createVariable("Z", BvType::Get(context, 32))->getRefExpr();
+    auto a = context.createVariable("A", BoolType::Get(context))->getRefExpr();
+    auto b = context.createVariable("B", BoolType::Get(context))->getRefExpr();
+    auto c = context.createVariable("C", BoolType::Get(context))->getRefExpr();
+
+    // Operand order matters by default.
+    EXPECT_FALSE(context.isExprCanonicalizationEnabled());
+    EXPECT_NE(AddExpr::Create(x, y), AddExpr::Create(y, x));
+
+    context.setExprCanonicalization(true);
+
+    EXPECT_EQ(AddExpr::Create(x, y), AddExpr::Create(y, x));
+    EXPECT_EQ(EqExpr::Create(x, y), EqExpr::Create(y, x));
+    EXPECT_EQ(
+        BvXorExpr::Create(x, BvXorExpr::Create(y, z)),
+        BvXorExpr::Create(BvXorExpr::Create(z, x), y)
+    );
+
+    // Binary operators form a left-deep chain.
+    auto sum = AddExpr::Create(z, AddExpr::Create(y, x));
+    EXPECT_EQ(sum->getLeft(), AddExpr::Create(x, y));
+    EXPECT_EQ(sum->getRight(), z);
+
+    // Literals are placed on the right-hand side.
+    auto lit = BvLiteralExpr::Get(BvType::Get(context, 32), 1);
+    EXPECT_EQ(MulExpr::Create(lit, x)->getRight(), lit);
+
+    // Non-commutative operators are left intact.
+    EXPECT_NE(SubExpr::Create(x, y), SubExpr::Create(y, x));
+
+    // Conjunctions and disjunctions are flattened into a single node.
+    auto conj = AndExpr::Create(a, AndExpr::Create(c, b));
+    EXPECT_EQ(conj->getNumOperands(), 3);
+    EXPECT_EQ(conj, AndExpr::Create({b, c, a}));
+    EXPECT_EQ(OrExpr::Create(OrExpr::Create(a, b), c), OrExpr::Create(c, OrExpr::Create(b, a)));
+    EXPECT_NE(ExprPtr(AndExpr::Create(a, b)), ExprPtr(OrExpr::Create(a, b)));
+}
+
+TEST(Expr, ExprFitsInBudgetCountsSharedNodesOnce)
+{
+    GazerContext context;
+    auto builder = CreateExprBuilder(context);
+
+    // The tree of this expression has 2^11 - 1 nodes, but its DAG only has 11.
+    ExprPtr expr = context.createVariable("X", BvType::Get(context, 32))->getRefExpr();
+    for (unsigned i = 0; i < 10; ++i) {
+        expr = builder->Add(expr, expr);
+    }
+
+    EXPECT_EQ(ExprDepth(expr), 11);
+    EXPECT_TRUE(ExprFitsInBudget(expr, 11, 11));
+    EXPECT_FALSE(ExprFitsInBudget(expr, 10, 11));
+    EXPECT_FALSE(ExprFitsInBudget(expr, 11, 10));
+}
@@ -167,6 +167,15 @@ TEST(TypeTest, Bitvectors)
 
     EXPECT_EQ(bvTy32, BvType::Get(context, 32));
     EXPECT_EQ(bvTy57, BvType::Get(context, 57));
+    EXPECT_EQ(&bvTy1, &BvType::Get(context, 1));
+
+    // Widths beyond the directly indexed ones.
+    BvType& bvTy65 = BvType::Get(context, 65);
+    BvType& bvTy128 = BvType::Get(context, 128);
+    EXPECT_EQ(bvTy65.getWidth(), 65);
+    EXPECT_EQ(&bvTy65, &BvType::Get(context, 65));
+    EXPECT_EQ(&bvTy128, &BvType::Get(context, 128));
+    EXPECT_NE(bvTy65, bvTy128);
 }
 
 TEST(TypeTest, Arrays)
@@ -202,4 +211,14 @@ TEST(TypeTest, Tuples)
     EXPECT_EQ(intBoolRealTy.getName(), "(Int, Bool, Real)");
 
     EXPECT_FALSE(intBoolRealTy == intPairTy);
+
+    // Lookups may pass any contiguous list of subtypes.
+    std::vector<Type*> subtypes = { &intTy, &boolTy, &realTy };
+    EXPECT_EQ(&intBoolRealTy, &TupleType::Get(subtypes));
+    Type* pair[] = { &intTy, &intTy };
+    EXPECT_EQ(&intPairTy, &TupleType::Get(pair));
+
+    TupleType& intBoolTy = TupleType::Get(llvm::makeArrayRef(subtypes).take_front(2));
+    EXPECT_EQ(intBoolTy.getName(), "(Int, Bool)");
+    EXPECT_EQ(&intBoolTy, &TupleType::Get(intTy, boolTy));
 }
\ No newline at end of file
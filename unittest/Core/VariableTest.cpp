@@ -37,3 +37,32 @@ TEST(Variable, CanCreateVariables)
     context.removeVariable(x);
     EXPECT_EQ(nullptr, context.getVariable("x"));
 }
+
+TEST(Variable, FreshVariables)
+{
+    GazerContext context;
+    Variable* x = context.createVariable("x", BvType::Get(context, 32));
+    Variable* f1 = context.createFreshVariable("tmp", BoolType::Get(context));
+    Variable* f2 = context.createFreshVariable(x, x->getType());
+
+    // Identifiers are dense and index the variable table.
+    EXPECT_EQ(0u, x->getId());
+    EXPECT_EQ(1u, f1->getId());
+    EXPECT_EQ(2u, f2->getId());
+    EXPECT_EQ(3u, context.getNumVariableIds());
+    EXPECT_EQ(f1, context.getVariableById(1));
+
+    EXPECT_FALSE(x->isFresh());
+    EXPECT_TRUE(f1->isFresh());
+    EXPECT_EQ("tmp#1", f1->getName());
+    EXPECT_EQ("x#2", f2->getName());
+    EXPECT_EQ(x->getType(), f2->getType());
+    EXPECT_NE(*x, *f2);
+
+    // Fresh variables are not registered by name.
+    EXPECT_EQ(nullptr, context.getVariable("tmp#1"));
+
+    context.removeVariable(f1);
+    EXPECT_EQ(nullptr, context.getVariableById(1));
+    EXPECT_EQ(x, context.getVariable("x"));
+}
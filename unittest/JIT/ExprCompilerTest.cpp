@@ -0,0 +1,302 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/JIT/ExprCompiler.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+using namespace gazer;
+
+namespace
+{
+
+class ExprCompilerTest : public ::testing::Test
+{
+protected:
+    GazerContext context;
+    std::unique_ptr<ExprBuilder> builder;
+    std::unique_ptr<ExprCompiler> compiler;
+
+    ExprRef<VarRefExpr> a, b;
+    ExprRef<VarRefExpr> x, y, z;
+    ExprRef<VarRefExpr> i, j;
+
+public:
+    ExprCompilerTest()
+        : builder(CreateExprBuilder(context)), compiler(ExprCompiler::Create())
+    {
+        a = context.createVariable("a", BoolType::Get(context))->getRefExpr();
+        b = context.createVariable("b", BoolType::Get(context))->getRefExpr();
+
+        x = context.createVariable("x", BvType::Get(context, 32))->getRefExpr();
+        y = context.createVariable("y", BvType::Get(context, 32))->getRefExpr();
+        z = context.createVariable("z", BvType::Get(context, 8))->getRefExpr();
+
+        i = context.createVariable("i", IntType::Get(context))->getRefExpr();
+        j = context.createVariable("j", IntType::Get(context))->getRefExpr();
+    }
+
+    /// Checks that the compiled and the interpreted evaluation of \p expr agree.
+    void checkAgainstInterpreter(const Valuation& valuation, const ExprPtr& expr)
+    {
+        ASSERT_NE(compiler->compile(expr), nullptr);
+
+        ValuationExprEvaluator interpreter(valuation);
+        CompiledExprEvaluator compiled(*compiler, valuation);
+
+        EXPECT_EQ(compiled.evaluate(expr), interpreter.evaluate(expr));
+    }
+
+    /// Runs the compiled version of \p expr directly.
+    bool run(const ExprPtr& expr, const Valuation& valuation, ExprRef<LiteralExpr>* result)
+    {
+        auto compiled = compiler->compile(expr);
+        EXPECT_NE(compiled, nullptr);
+
+        std::vector<uint64_t> values(compiler->getNumSlots());
+        for (size_t k = 0; k < compiled->getVariables().size(); ++k) {
+            auto literal = valuation.find(compiled->getVariables()[k])->second;
+            values[compiled->getSlots()[k]] = ExprCompiler::encodeValue(literal);
+        }
+
+        uint64_t encoded;
+        if (!compiled->run(values.data(), &encoded)) {
+            return false;
+        }
+
+        *result = ExprCompiler::decodeValue(expr->getType(), encoded);
+        return true;
+    }
+};
+
+TEST_F(ExprCompilerTest, BoolAndBvAgreeWithInterpreter)
+{
+    ASSERT_NE(compiler, nullptr);
+
+    std::vector<ExprPtr> exprs = {
+        builder->And(ExprVector{a, builder->Not(b)}),
+        builder->Or(ExprVector{a, b, builder->Eq(x, y)}),
+        builder->Imply(a, b),
+        builder->Add(x, y),
+        builder->Sub(x, builder->Mul(y, builder->BvLit(3, 32))),
+        builder->BvSDiv(x, y),
+        builder->BvSLt(x, y),
+        builder->BvULtEq(x, y),
+        builder->Eq(builder->Extract(x, 8, 8), z),
+        builder->ZExt(z, BvType::Get(context, 32)),
+        builder->SExt(z, BvType::Get(context, 64)),
+        builder->BvConcat(z, y),
+        builder->Select(a, x, builder->Add(y, builder->ZExt(z, BvType::Get(context, 32))))
+    };
+
+    std::vector<std::tuple<bool, bool, uint64_t, uint64_t, uint64_t>> inputs = {
+        { false, false, 0, 1, 0 },
+        { true, false, 7, 11, 255 },
+        { true, true, 0xFFFFFFF0, 3, 0x80 },
+        { false, true, 0x1234, 0xFFFFFFFF, 0x12 },
+    };
+
+    for (auto& [va, vb, vx, vy, vz] : inputs) {
+        auto valuation = Valuation::CreateBuilder();
+        valuation.put(&a->getVariable(), builder->BoolLit(va));
+        valuation.put(&b->getVariable(), builder->BoolLit(vb));
+        valuation.put(&x->getVariable(), builder->BvLit(vx, 32));
+        valuation.put(&y->getVariable(), builder->BvLit(vy, 32));
+        valuation.put(&z->getVariable(), builder->BvLit(vz, 8));
+        auto v = valuation.build();
+
+        for (auto& expr : exprs) {
+            checkAgainstInterpreter(v, expr);
+        }
+    }
+}
+
+TEST_F(ExprCompilerTest, IntAgreesWithInterpreter)
+{
+    ASSERT_NE(compiler, nullptr);
+
+    std::vector<ExprPtr> exprs = {
+        builder->Add(i, j),
+        builder->Mul(i, builder->Sub(j, builder->IntLit(5))),
+        builder->Div(i, j),
+        builder->Mod(i, j),
+        builder->Rem(i, j),
+        builder->Lt(i, j),
+        builder->GtEq(i, builder->IntLit(-3)),
+    };
+
+    std::vector<std::pair<int64_t, int64_t>> inputs = {
+        { 5, 3 }, { 5, -3 }, { -5, 3 }, { -5, -3 }, { 0, 7 }
+    };
+
+    for (auto& [vi, vj] : inputs) {
+        auto valuation = Valuation::CreateBuilder();
+        valuation.put(&i->getVariable(), builder->IntLit(vi));
+        valuation.put(&j->getVariable(), builder->IntLit(vj));
+        auto v = valuation.build();
+
+        for (auto& expr : exprs) {
+            checkAgainstInterpreter(v, expr);
+        }
+    }
+}
+
+TEST_F(ExprCompilerTest, UndefinedResults)
+{
+    ASSERT_NE(compiler, nullptr);
+
+    auto vb = Valuation::CreateBuilder();
+    vb.put(&i->getVariable(), builder->IntLit(5));
+    vb.put(&j->getVariable(), builder->IntLit(0));
+    vb.put(&x->getVariable(), builder->BvLit(0xFFFFFFF0, 32));
+    vb.put(&y->getVariable(), builder->BvLit(0, 32));
+    auto v = vb.build();
+
+    ExprRef<LiteralExpr> result;
+    EXPECT_FALSE(run(builder->Div(i, j), v, &result));
+    EXPECT_FALSE(run(builder->Mod(i, j), v, &result));
+
+    // Integers do not wrap around.
+    auto max = builder->IntLit(std::numeric_limits<int64_t>::max());
+    auto min = builder->IntLit(std::numeric_limits<int64_t>::min());
+    EXPECT_FALSE(run(builder->Add(max, i), v, &result));
+    EXPECT_FALSE(run(builder->Sub(min, i), v, &result));
+    EXPECT_FALSE(run(builder->Mul(max, i), v, &result));
+    ASSERT_TRUE(run(builder->Sub(max, i), v, &result));
+    EXPECT_EQ(result, builder->IntLit(std::numeric_limits<int64_t>::max() - 5));
+
+    // Bit-vector division by zero and shifts follow SMT-LIB.
+    ASSERT_TRUE(run(builder->BvUDiv(x, y), v, &result));
+    EXPECT_EQ(result, builder->BvLit(0xFFFFFFFF, 32));
+    ASSERT_TRUE(run(builder->BvSDiv(x, y), v, &result));
+    EXPECT_EQ(result, builder->BvLit(1, 32));
+    ASSERT_TRUE(run(builder->BvURem(x, y), v, &result));
+    EXPECT_EQ(result, builder->BvLit(0xFFFFFFF0, 32));
+    ASSERT_TRUE(run(builder->Shl(x, builder->BvLit(32, 32)), v, &result));
+    EXPECT_EQ(result, builder->BvLit(0, 32));
+    ASSERT_TRUE(run(builder->AShr(x, builder->BvLit(40, 32)), v, &result));
+    EXPECT_EQ(result, builder->BvLit(0xFFFFFFFF, 32));
+    ASSERT_TRUE(run(builder->LShr(x, builder->BvLit(4, 32)), v, &result));
+    EXPECT_EQ(result, builder->BvLit(0x0FFFFFFF, 32));
+}
+
+TEST_F(ExprCompilerTest, ArrayRead)
+{
+    ASSERT_NE(compiler, nullptr);
+
+    auto& arrayTy = ArrayType::Get(IntType::Get(context), BvType::Get(context, 32));
+    auto arr = context.createVariable("arr", arrayTy)->getRefExpr();
+
+    ArrayLiteralExpr::Builder arrayBuilder(arrayTy, builder->BvLit(0, 32));
+    arrayBuilder.addValue(builder->IntLit(1), builder->BvLit(10, 32));
+    arrayBuilder.addValue(builder->IntLit(2), builder->BvLit(20, 32));
+
+    auto expr = builder->Add(builder->Read(arr, i), builder->Read(arr, builder->IntLit(2)));
+
+    for (int64_t index : { 0, 1, 2, 3 }) {
+        auto vb = Valuation::CreateBuilder();
+        vb.put(&arr->getVariable(), arrayBuilder.build());
+        vb.put(&i->getVariable(), builder->IntLit(index));
+
+        checkAgainstInterpreter(vb.build(), expr);
+    }
+}
+
+TEST_F(ExprCompilerTest, Float)
+{
+    ASSERT_NE(compiler, nullptr);
+
+    auto& doubleTy = FloatType::Get(context, FloatType::Double);
+    auto f = context.createVariable("f", doubleTy)->getRefExpr();
+    auto rm = llvm::APFloat::rmNearestTiesToEven;
+
+    auto vb = Valuation::CreateBuilder();
+    vb.put(&f->getVariable(), builder->FloatLit(llvm::APFloat(1.5)));
+    auto v = vb.build();
+
+    ExprRef<LiteralExpr> result;
+    ASSERT_TRUE(run(builder->FMul(f, builder->FloatLit(llvm::APFloat(2.0)), rm), v, &result));
+    EXPECT_EQ(result, builder->FloatLit(llvm::APFloat(3.0)));
+
+    ASSERT_TRUE(run(builder->FLt(f, builder->FloatLit(llvm::APFloat(2.0))), v, &result));
+    EXPECT_EQ(result, builder->True());
+
+    auto nan = builder->FDiv(builder->FSub(f, f, rm), builder->FSub(f, f, rm), rm);
+    ASSERT_TRUE(run(builder->FIsNan(nan), v, &result));
+    EXPECT_EQ(result, builder->True());
+
+    // Only the default rounding mode is supported.
+    EXPECT_EQ(compiler->compile(builder->FAdd(f, f, llvm::APFloat::rmTowardZero)), nullptr);
+}
+
+TEST_F(ExprCompilerTest, FallbackAndCaching)
+{
+    ASSERT_NE(compiler, nullptr);
+
+    auto vb = Valuation::CreateBuilder();
+    vb.put(&x->getVariable(), builder->BvLit(1, 32));
+    auto v = vb.build();
+
+    auto expr = builder->Add(x, builder->BvLit(2, 32));
+    auto compiled = compiler->compile(expr);
+    EXPECT_NE(compiled, nullptr);
+    EXPECT_EQ(compiler->compile(expr), compiled);
+
+    // Wide bit-vectors are not compiled, but evaluated by the interpreter.
+    auto wide = builder->ZExt(x, BvType::Get(context, 128));
+    EXPECT_EQ(compiler->compile(wide), nullptr);
+
+    CompiledExprEvaluator eval(*compiler, v);
+    EXPECT_EQ(eval.evaluate(expr), builder->BvLit(3, 32));
+    EXPECT_EQ(eval.evaluate(wide), builder->BvLit(llvm::APInt(128, 1)));
+
+    // Variables missing from the valuation evaluate to undef.
+    EXPECT_TRUE(eval.evaluate(builder->Add(y, x))->isUndef());
+}
+
+TEST_F(ExprCompilerTest, CompileMany)
+{
+    ASSERT_NE(compiler, nullptr);
+
+    auto first = builder->Add(x, y);
+    auto unsupported = builder->ZExt(x, BvType::Get(context, 128));
+    auto second = builder->BvSLt(x, builder->BvLit(0, 32));
+
+    auto compiled = compiler->compile({first, unsupported, second, first});
+    ASSERT_EQ(compiled.size(), 4u);
+    EXPECT_NE(compiled[0], nullptr);
+    EXPECT_EQ(compiled[1], nullptr);
+    EXPECT_NE(compiled[2], nullptr);
+    EXPECT_EQ(compiled[3], compiled[0]);
+    EXPECT_EQ(compiler->compile(second), compiled[2]);
+
+    auto vb = Valuation::CreateBuilder();
+    vb.put(&x->getVariable(), builder->BvLit(0xFFFFFFFF, 32));
+    vb.put(&y->getVariable(), builder->BvLit(3, 32));
+    auto v = vb.build();
+
+    ExprRef<LiteralExpr> result;
+    ASSERT_TRUE(run(first, v, &result));
+    EXPECT_EQ(result, builder->BvLit(2, 32));
+    ASSERT_TRUE(run(second, v, &result));
+    EXPECT_EQ(result, builder->True());
+}
+
+} // end anonymous namespace
@@ -0,0 +1,171 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Z3Solver/Z3Solver.h"
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+
+#include <gtest/gtest.h>
+
+using namespace gazer;
+
+/// Checks that \p itp is implied by \p a and is inconsistent with \p b.
+static void checkInterpolant(GazerContext& ctx, const ExprPtr& itp, const ExprPtr& a, const ExprPtr& b)
+{
+    Z3SolverFactory factory;
+    auto solver = factory.createSolver(ctx);
+
+    solver->push();
+    solver->add(a);
+    solver->add(NotExpr::Create(itp));
+    EXPECT_EQ(solver->run(), Solver::UNSAT);
+    solver->pop();
+
+    solver->add(itp);
+    solver->add(b);
+    EXPECT_EQ(solver->run(), Solver::UNSAT);
+}
+
+TEST(Z3ItpSolverTest, IntInterpolant)
+{
+    GazerContext ctx;
+    Z3SolverFactory factory;
+    auto solver = factory.createItpSolver(ctx);
+    ASSERT_NE(solver, nullptr);
+
+    auto& intTy = IntType::Get(ctx);
+    auto x = ctx.createVariable("x", intTy)->getRefExpr();
+    auto y = ctx.createVariable("y", intTy)->getRefExpr();
+    auto z = ctx.createVariable("z", intTy)->getRefExpr();
+
+    // A: x >= 0 & y = x + 1, B: y < z & z <= 0
+    auto a = AndExpr::Create(
+        GtEqExpr::Create(x, IntLiteralExpr::Get(intTy, 0)),
+        EqExpr::Create(y, AddExpr::Create(x, IntLiteralExpr::Get(intTy, 1)))
+    );
+    auto b = AndExpr::Create(
+        LtExpr::Create(y, z),
+        LtEqExpr::Create(z, IntLiteralExpr::Get(intTy, 0))
+    );
+
+    ItpGroup group = solver->createItpGroup();
+    solver->add(group, a);
+    solver->add(b);
+
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+
+    auto itp = solver->getInterpolant(group);
+    ASSERT_NE(itp, nullptr);
+
+    checkInterpolant(ctx, itp, a, b);
+}
+
+TEST(Z3ItpSolverTest, FreshVariableInterpolant)
+{
+    GazerContext ctx;
+    Z3SolverFactory factory;
+    auto solver = factory.createItpSolver(ctx);
+
+    // Fresh variables have no entry in the name table of the context.
+    auto& intTy = IntType::Get(ctx);
+    Variable* base = ctx.createVariable("x", intTy);
+    auto x0 = ctx.createFreshVariable(base, intTy)->getRefExpr();
+    auto x1 = ctx.createFreshVariable(base, intTy)->getRefExpr();
+
+    // A: x0 = 0 & x1 = x0 + 1, B: x1 < 0
+    auto a = AndExpr::Create(
+        EqExpr::Create(x0, IntLiteralExpr::Get(intTy, 0)),
+        EqExpr::Create(x1, AddExpr::Create(x0, IntLiteralExpr::Get(intTy, 1)))
+    );
+    auto b = LtExpr::Create(x1, IntLiteralExpr::Get(intTy, 0));
+
+    ItpGroup group = solver->createItpGroup();
+    solver->add(group, a);
+    solver->add(b);
+
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+
+    auto itp = solver->getInterpolant(group);
+    ASSERT_NE(itp, nullptr);
+
+    checkInterpolant(ctx, itp, a, b);
+}
+
+TEST(Z3ItpSolverTest, BvInterpolant)
+{
+    GazerContext ctx;
+    Z3SolverFactory factory;
+    auto solver = factory.createItpSolver(ctx);
+
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto x = ctx.createVariable("x", bv8)->getRefExpr();
+    auto y = ctx.createVariable("y", bv8)->getRefExpr();
+
+    // A: x = 5 & y = x + 1, B: y = 0
+    auto a = AndExpr::Create(
+        EqExpr::Create(x, BvLiteralExpr::Get(bv8, 5)),
+        EqExpr::Create(y, AddExpr::Create(x, BvLiteralExpr::Get(bv8, 1)))
+    );
+    auto b = EqExpr::Create(y, BvLiteralExpr::Get(bv8, 0));
+
+    ItpGroup group = solver->createItpGroup();
+    solver->add(group, a);
+    solver->add(b);
+
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+
+    auto itp = solver->getInterpolant(group);
+    ASSERT_NE(itp, nullptr);
+
+    checkInterpolant(ctx, itp, a, b);
+}
+
+TEST(Z3ItpSolverTest, ScopedGroups)
+{
+    GazerContext ctx;
+    Z3SolverFactory factory;
+    auto solver = factory.createItpSolver(ctx);
+
+    auto& intTy = IntType::Get(ctx);
+    auto x = ctx.createVariable("x", intTy)->getRefExpr();
+    auto y = ctx.createVariable("y", intTy)->getRefExpr();
+
+    auto b = LtExpr::Create(y, IntLiteralExpr::Get(intTy, 0));
+    solver->add(b);
+
+    // The constraints of a popped scope must not take part in the interpolant.
+    ItpGroup group = solver->createItpGroup();
+    solver->push();
+    solver->add(group, EqExpr::Create(y, IntLiteralExpr::Get(intTy, -1)));
+    EXPECT_EQ(solver->run(), Solver::SAT);
+    solver->pop();
+
+    auto a = AndExpr::Create(
+        EqExpr::Create(x, IntLiteralExpr::Get(intTy, 3)),
+        EqExpr::Create(y, MulExpr::Create(x, x))
+    );
+
+    solver->push();
+    solver->add(group, a);
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+
+    auto itp = solver->getInterpolant(group);
+    ASSERT_NE(itp, nullptr);
+
+    checkInterpolant(ctx, itp, a, b);
+    solver->pop();
+}
@@ -22,6 +22,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <future>
+
 using namespace gazer;
 
 TEST(SolverZ3Test, SmokeTest1)
@@ -158,4 +161,68 @@ TEST(SolverZ3Test, Tuples)
 
     status = solver->run();
     EXPECT_EQ(status, Solver::UNSAT);
-}
\ No newline at end of file
+}
+
+TEST(SolverZ3Test, Interrupt)
+{
+    GazerContext ctx;
+    Z3SolverFactory factory;
+    auto solver = factory.createSolver(ctx);
+
+    // Factoring a semiprime with two 31-bit factors is hard for bit-blasting,
+    // the solver will not finish before it is interrupted.
+    auto& bv64 = BvType::Get(ctx, 64);
+    auto x = ctx.createVariable("x", bv64)->getRefExpr();
+    auto y = ctx.createVariable("y", bv64)->getRefExpr();
+    auto limit = BvLiteralExpr::Get(bv64, 1ull << 32);
+
+    solver->push();
+    solver->add(EqExpr::Create(MulExpr::Create(x, y), BvLiteralExpr::Get(bv64, 4611685975477714963ull)));
+    solver->add(BvUGtExpr::Create(x, BvLiteralExpr::Get(bv64, 1)));
+    solver->add(BvUGtExpr::Create(y, BvLiteralExpr::Get(bv64, 1)));
+    solver->add(BvULtExpr::Create(x, limit));
+    solver->add(BvULtExpr::Create(y, limit));
+
+    auto result = std::async(std::launch::async, [&solver] { return solver->run(); });
+
+    // Interrupts arriving before the search starts are lost, repeat until the solver stops.
+    while (result.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
+        solver->interrupt();
+    }
+
+    EXPECT_EQ(result.get(), Solver::UNKNOWN);
+
+    // The solver must remain usable after an interrupt.
+    solver->pop();
+    solver->add(EqExpr::Create(x, BvLiteralExpr::Get(bv64, 2)));
+    EXPECT_EQ(solver->run(), Solver::SAT);
+}
+
+TEST(SolverZ3Test, AssumptionsAndUnsatCore)
+{
+    GazerContext ctx;
+    Z3SolverFactory factory;
+    auto solver = factory.createSolver(ctx);
+
+    auto x = ctx.createVariable("x", IntType::Get(ctx))->getRefExpr();
+    auto a = ctx.createVariable("a", BoolType::Get(ctx))->getRefExpr();
+    auto b = ctx.createVariable("b", BoolType::Get(ctx))->getRefExpr();
+    auto c = ctx.createVariable("c", BoolType::Get(ctx))->getRefExpr();
+
+    // a => x > 5, b => x < 3, c => x = 4
+    solver->add(ImplyExpr::Create(a, GtExpr::Create(x, IntLiteralExpr::Get(ctx, 5))));
+    solver->add(ImplyExpr::Create(b, LtExpr::Create(x, IntLiteralExpr::Get(ctx, 3))));
+    solver->add(ImplyExpr::Create(c, EqExpr::Create(x, IntLiteralExpr::Get(ctx, 4))));
+
+    EXPECT_EQ(solver->run({a, b, c}), Solver::UNSAT);
+    auto core = solver->getUnsatCore();
+    EXPECT_GE(core.size(), 2u);
+    EXPECT_LE(core.size(), 3u);
+    for (auto& expr : core) {
+        EXPECT_TRUE(expr == a || expr == b || expr == c);
+    }
+
+    // Assumptions only hold for a single call.
+    EXPECT_EQ(solver->run({a, NotExpr::Create(b)}), Solver::SAT);
+    EXPECT_EQ(solver->run(), Solver::SAT);
+}
@@ -0,0 +1,112 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Verifier/InterpolationModelChecker.h"
+#include "gazer/Automaton/Cfa.h"
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Z3Solver/Z3Solver.h"
+
+#include <gtest/gtest.h>
+
+using namespace gazer;
+
+namespace
+{
+
+class NullTraceBuilder : public CfaTraceBuilder
+{
+public:
+    std::unique_ptr<Trace> build(
+        std::vector<Location*>& states,
+        std::vector<std::vector<VariableAssignment>>& actions) override
+    {
+        return std::make_unique<Trace>(std::vector<std::unique_ptr<TraceEvent>>());
+    }
+};
+
+class InterpolationModelCheckerTest : public ::testing::Test
+{
+protected:
+    InterpolationModelCheckerTest()
+        : system(context)
+    {}
+
+    /// Builds a main automaton which counts x up to \p limit in a loop, then
+    /// fails if x differs from \p expected.
+    Cfa* createCounter(unsigned limit, unsigned expected)
+    {
+        Cfa* main = system.createCfa("main");
+        system.setMainAutomaton(main);
+
+        auto& intTy = IntType::Get(context);
+        Variable* x = main->createLocal("x", intTy);
+        ExprPtr X = x->getRefExpr();
+
+        auto lit = [&intTy](unsigned value) { return IntLiteralExpr::Get(intTy, value); };
+
+        Location* head = main->createLocation();
+        Location* body = main->createLocation();
+        Location* done = main->createLocation();
+        Location* err = main->createErrorLocation();
+        main->addErrorCode(err, lit(2));
+
+        main->createAssignTransition(main->getEntry(), head, { { x, lit(0) } });
+        main->createAssignTransition(head, body, LtExpr::Create(X, lit(limit)), { { x, AddExpr::Create(X, lit(1)) } });
+        main->createAssignTransition(body, head);
+        main->createAssignTransition(head, done, NotExpr::Create(LtExpr::Create(X, lit(limit))));
+        main->createAssignTransition(done, err, NotEqExpr::Create(X, lit(expected)));
+        main->createAssignTransition(done, main->getExit(), EqExpr::Create(X, lit(expected)));
+
+        return main;
+    }
+
+    std::unique_ptr<VerificationResult> check()
+    {
+        InterpolationModelChecker checker(solverFactory, ImcSettings{false, false, false, 30});
+        return checker.check(system, traceBuilder);
+    }
+
+    GazerContext context;
+    AutomataSystem system;
+    Z3SolverFactory solverFactory;
+    NullTraceBuilder traceBuilder;
+};
+
+TEST_F(InterpolationModelCheckerTest, ProvesSafeLoop)
+{
+    // The interpolants are over the fresh step copies of the transition
+    // system, they must be translated back from the solver to find a fixpoint.
+    Cfa* main = this->createCounter(10, 10);
+
+    auto result = this->check();
+    EXPECT_TRUE(result->isSuccess()) << result->getMessage().str();
+
+    EXPECT_EQ(1, system.getNumAutomata());
+    EXPECT_EQ(6, main->getNumLocations());
+}
+
+TEST_F(InterpolationModelCheckerTest, FindsCounterexample)
+{
+    this->createCounter(3, 4);
+
+    auto result = this->check();
+    ASSERT_TRUE(result->isFail());
+    EXPECT_EQ(2, llvm::cast<FailResult>(*result).getErrorID());
+}
+
+} // end anonymous namespace
@@ -0,0 +1,132 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Verifier/PdrModelChecker.h"
+#include "gazer/Automaton/Cfa.h"
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Z3Solver/Z3Solver.h"
+
+#include <gtest/gtest.h>
+
+using namespace gazer;
+
+namespace
+{
+
+/// Records the locations of the counterexamples instead of building a trace.
+class RecordingTraceBuilder : public CfaTraceBuilder
+{
+public:
+    std::unique_ptr<Trace> build(
+        std::vector<Location*>& states,
+        std::vector<std::vector<VariableAssignment>>& actions) override
+    {
+        this->states = states;
+        return std::make_unique<Trace>(std::vector<std::unique_ptr<TraceEvent>>());
+    }
+
+    std::vector<Location*> states;
+};
+
+class PdrModelCheckerTest : public ::testing::Test
+{
+protected:
+    PdrModelCheckerTest()
+        : system(context)
+    {}
+
+    /// Builds a main automaton which counts x up to \p limit in a loop, then
+    /// fails if x differs from \p expected.
+    Cfa* createCounter(unsigned limit, unsigned expected)
+    {
+        Cfa* main = system.createCfa("main");
+        system.setMainAutomaton(main);
+
+        auto& intTy = IntType::Get(context);
+        Variable* x = main->createLocal("x", intTy);
+        ExprPtr X = x->getRefExpr();
+
+        auto lit = [&intTy](unsigned value) { return IntLiteralExpr::Get(intTy, value); };
+
+        Location* head = main->createLocation();
+        Location* body = main->createLocation();
+        Location* done = main->createLocation();
+        Location* err = main->createErrorLocation();
+        main->addErrorCode(err, lit(2));
+
+        main->createAssignTransition(main->getEntry(), head, { { x, lit(0) } });
+        main->createAssignTransition(head, body, LtExpr::Create(X, lit(limit)), { { x, AddExpr::Create(X, lit(1)) } });
+        main->createAssignTransition(body, head);
+        main->createAssignTransition(head, done, NotExpr::Create(LtExpr::Create(X, lit(limit))));
+        main->createAssignTransition(done, err, NotEqExpr::Create(X, lit(expected)));
+        main->createAssignTransition(done, main->getExit(), EqExpr::Create(X, lit(expected)));
+
+        return main;
+    }
+
+    std::unique_ptr<VerificationResult> check()
+    {
+        PdrModelChecker checker(solverFactory, PdrSettings{true, false, false, 30});
+        return checker.check(system, traceBuilder);
+    }
+
+    GazerContext context;
+    AutomataSystem system;
+    Z3SolverFactory solverFactory;
+    RecordingTraceBuilder traceBuilder;
+};
+
+TEST_F(PdrModelCheckerTest, ProvesSafeLoop)
+{
+    Cfa* main = this->createCounter(10, 10);
+
+    auto result = this->check();
+    EXPECT_TRUE(result->isSuccess());
+
+    // The engine works on a clone, the system must be left unchanged.
+    EXPECT_EQ(1, system.getNumAutomata());
+    EXPECT_EQ(6, main->getNumLocations());
+    EXPECT_EQ(6, main->getNumTransitions());
+
+    // A second run must not be affected by the first one.
+    EXPECT_TRUE(this->check()->isSuccess());
+}
+
+TEST_F(PdrModelCheckerTest, FindsCounterexample)
+{
+    Cfa* main = this->createCounter(3, 4);
+
+    auto result = this->check();
+    ASSERT_TRUE(result->isFail());
+    EXPECT_EQ(2, llvm::cast<FailResult>(*result).getErrorID());
+
+    // Entry, three iterations through the loop head and body, the final
+    // loop head and the check. The states map back to the original automaton,
+    // except for the unique error location added by the transformation.
+    ASSERT_EQ(11, traceBuilder.states.size());
+    EXPECT_EQ(main->getEntry(), traceBuilder.states.front());
+    for (size_t i = 0; i + 1 < traceBuilder.states.size(); ++i) {
+        EXPECT_EQ(main, traceBuilder.states[i]->getAutomaton());
+    }
+
+    EXPECT_EQ(1, system.getNumAutomata());
+    EXPECT_EQ(6, main->getNumLocations());
+    EXPECT_TRUE(this->check()->isFail());
+}
+
+} // end anonymous namespace